@@ -0,0 +1,222 @@
+/////////////////////////////////////////////////////////////////////////////
+// NxWidgets/UnitTests/CGraphicsPort/cgraphicsport_main.cxx
+//
+//   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+//   Author: Gregory Nutt <gnutt@nuttx.org>
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in
+//    the documentation and/or other materials provided with the
+//    distribution.
+// 3. Neither the name NuttX, NxWidgets, nor the names of its contributors
+//    me be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+// AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Included Files
+/////////////////////////////////////////////////////////////////////////////
+
+#include <nuttx/config.h>
+
+#include <nuttx/init.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <debug.h>
+
+#include <nuttx/nx/nx.h>
+
+#include "cnxstring.hxx"
+#include "cgraphicsporttest.hxx"
+
+/////////////////////////////////////////////////////////////////////////////
+// Definitions
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Private Classes
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Private Data
+/////////////////////////////////////////////////////////////////////////////
+
+static FAR const char *g_options[] =
+{
+  "American groundnut (Apios americana)",
+  "Azuki bean (Vigna angularis)",
+  "Black-eyed pea (Vigna unguiculata subsp. unguiculata)",
+  "Chickpea (Cicer arietinum)",
+  "Common bean (Phaseolus vulgaris)",
+  "Drumstick (Moringa oleifera)",
+  "Dolichos bean (Lablab purpureus)",
+  "Fava bean (Vicia faba)",
+  "Garbanzo (Cicer arietinum)",
+  "Green bean (Phaseolus vulgaris)",
+  "Guar (Cyamopsis tetragonoloba)",
+  "Gumbo (Abelmoschus esculentus)",
+  "Horse gram (Macrotyloma uniflorum)",
+  "Indian pea (Lathyrus sativus)",
+  "Lentil (Lens culinaris)",
+  "Lima Bean (Phaseolus lunatus)",
+  "Moth bean (Vigna acontifolia)",
+  "Mung bean (Vigna radiata)",
+  "Okra (Abelmoschus esculentus)",
+  "Pea (Pisum sativum)"
+};
+#define NOPTIONS (sizeof(g_options)/sizeof(FAR const char *))
+
+static FAR const char g_text[] =
+  "The quick brown fox jumps over the lazy dog.\n"
+  "Pack my box with five dozen liquor jugs.\n"
+  "How vexingly quick daft zebras jump!\n"
+  "Sphinx of black quartz, judge my vow.\n"
+  "The five boxing wizards jump quickly.\n"
+  "Jackdaws love my big sphinx of quartz.\n"
+  "0123456789 !\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~\n"
+  "The quick brown fox jumps over the lazy dog.\n"
+  "Pack my box with five dozen liquor jugs.\n"
+  "How vexingly quick daft zebras jump!\n";
+
+/////////////////////////////////////////////////////////////////////////////
+// Public Function Prototypes
+/////////////////////////////////////////////////////////////////////////////
+
+// Suppress name-mangling
+
+extern "C" int cgraphicsport_main(int argc, char *argv[]);
+
+/////////////////////////////////////////////////////////////////////////////
+// Private Functions
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Name: measureWidget
+/////////////////////////////////////////////////////////////////////////////
+
+static void measureWidget(CGraphicsPortTest *test, CNxWidget *widget,
+                          FAR const char *name)
+{
+  // Time the first frame with no glyphs in the cache
+
+  test->flushCache();
+  unsigned long cold = test->measureFrameTime(widget, 1);
+  test->showCacheStatistics(name);
+
+  // Then time repeated redraws of the same content
+
+  unsigned long warm = test->measureFrameTime(widget, CONFIG_CGRAPHICSPORTTEST_NFRAMES);
+  message("%s: First frame: %lu usec Average of %d frames: %lu usec\n",
+          name, cold, CONFIG_CGRAPHICSPORTTEST_NFRAMES, warm);
+  test->showCacheStatistics(name);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Public Functions
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Name: cgraphicsport_main
+/////////////////////////////////////////////////////////////////////////////
+
+int cgraphicsport_main(int argc, char *argv[])
+{
+  // Create an instance of the graphics port test
+
+  message("cgraphicsport_main: Create CGraphicsPortTest instance\n");
+  CGraphicsPortTest *test = new CGraphicsPortTest();
+
+  // Connect the NX server
+
+  message("cgraphicsport_main: Connect the CGraphicsPortTest instance to the NX server\n");
+  if (!test->connect())
+    {
+      message("cgraphicsport_main: Failed to connect the CGraphicsPortTest instance to the NX server\n");
+      delete test;
+      return 1;
+    }
+
+  // Create a window to draw into
+
+  message("cgraphicsport_main: Create a Window\n");
+  if (!test->createWindow())
+    {
+      message("cgraphicsport_main: Failed to create a window\n");
+      delete test;
+      return 1;
+    }
+
+  // Create a listbox and fill it with options
+
+  message("cgraphicsport_main: Create a ListBox\n");
+  CListBox *listbox = test->createListBox();
+  if (!listbox)
+    {
+      message("cgraphicsport_main: Failed to create a listbox\n");
+      delete test;
+      return 1;
+    }
+
+  listbox->disableDrawing();
+  for (unsigned int i = 0; i < NOPTIONS; i++)
+    {
+      listbox->addOption(g_options[i], i);
+    }
+
+  // Create a multi-line text box.  The CMultiLineTextBox destructor is
+  // protected so the text box is managed through its base class.
+
+  message("cgraphicsport_main: Create a MultiLineTextBox\n");
+  CNxWidget *textbox = test->createMultiLineTextBox(CNxString(g_text));
+  if (!textbox)
+    {
+      message("cgraphicsport_main: Failed to create a multi-line text box\n");
+      delete listbox;
+      delete test;
+      return 1;
+    }
+
+  textbox->disableDrawing();
+
+  // Measure the frame times
+
+  measureWidget(test, listbox, "CListBox");
+
+  listbox->setAllowMultipleSelections(true);
+  listbox->selectOption(1);
+  listbox->selectOption(3);
+  measureWidget(test, listbox, "CListBox (selected)");
+
+  measureWidget(test, textbox, "CMultiLineTextBox");
+  sleep(1);
+
+  // Clean up and exit
+
+  message("cgraphicsport_main: Clean-up and exit\n");
+  delete textbox;
+  delete listbox;
+  delete test;
+  return 0;
+}
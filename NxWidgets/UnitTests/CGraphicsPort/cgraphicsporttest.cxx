@@ -0,0 +1,271 @@
+/////////////////////////////////////////////////////////////////////////////
+// NxWidgets/UnitTests/CGraphicsPort/cgraphicsporttest.cxx
+//
+//   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+//   Author: Gregory Nutt <gnutt@nuttx.org>
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in
+//    the documentation and/or other materials provided with the
+//    distribution.
+// 3. Neither the name NuttX, NxWidgets, nor the names of its contributors
+//    me be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+// AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Included Files
+/////////////////////////////////////////////////////////////////////////////
+
+#include <nuttx/config.h>
+
+#include <nuttx/init.h>
+#include <cstdio>
+#include <cerrno>
+#include <time.h>
+#include <debug.h>
+
+#include <nuttx/nx/nx.h>
+#include <nuttx/nx/nxfonts.h>
+
+#include <apps/benchmark.h>
+
+#include "nxconfig.hxx"
+#include "cbgwindow.hxx"
+#include "cgraphicsport.hxx"
+#include "cgraphicsporttest.hxx"
+
+/////////////////////////////////////////////////////////////////////////////
+// Definitions
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Private Classes
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Private Data
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Public Data
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Public Function Prototypes
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// CGraphicsPortTest Method Implementations
+/////////////////////////////////////////////////////////////////////////////
+
+// CGraphicsPortTest Constructor
+
+CGraphicsPortTest::CGraphicsPortTest()
+{
+  // Initialize state data
+
+  m_widgetControl = (CWidgetControl *)NULL;
+  m_bgWindow      = (CBgWindow *)NULL;
+}
+
+// CGraphicsPortTest Descriptor
+
+CGraphicsPortTest::~CGraphicsPortTest(void)
+{
+  disconnect();
+}
+
+// Connect to the NX server
+
+bool CGraphicsPortTest::connect(void)
+{
+  // Connect to the server
+
+  bool nxConnected = CNxServer::connect();
+  if (nxConnected)
+    {
+      // Set the background color
+
+      if (!setBackgroundColor(CONFIG_CGRAPHICSPORTTEST_BGCOLOR))
+        {
+          message("CGraphicsPortTest::connect: setBackgroundColor failed\n");
+        }
+    }
+
+  return nxConnected;
+}
+
+// Disconnect from the NX server
+
+void CGraphicsPortTest::disconnect(void)
+{
+  // Close the window
+
+  if (m_bgWindow)
+    {
+      delete m_bgWindow;
+      m_bgWindow = (CBgWindow *)NULL;
+    }
+
+  // Free the widget control instance
+
+  if (m_widgetControl)
+    {
+      delete m_widgetControl;
+      m_widgetControl = (CWidgetControl *)NULL;
+    }
+
+  // And disconnect from the server
+
+  CNxServer::disconnect();
+}
+
+// Create the background window instance.
+
+bool CGraphicsPortTest::createWindow(void)
+{
+  // Initialize the widget control using the default style
+
+  m_widgetControl = new CWidgetControl((CWidgetStyle *)NULL);
+
+  // Get an (uninitialized) instance of the background window as a class
+  // that derives from INxWindow.
+
+  m_bgWindow = getBgWindow(m_widgetControl);
+  if (!m_bgWindow)
+    {
+      message("CGraphicsPortTest::createWindow: Failed to create CBgWindow instance\n");
+      disconnect();
+      return false;
+    }
+
+  // Open (and initialize) the window
+
+  bool success = m_bgWindow->open();
+  if (!success)
+    {
+      message("CGraphicsPortTest::createWindow: Failed to open background window\n");
+      disconnect();
+      return false;
+    }
+
+  return true;
+}
+
+// Create a listbox in the left half of the window
+
+CListBox *CGraphicsPortTest::createListBox(void)
+{
+  // Get the size of the display
+
+  struct nxgl_size_s windowSize;
+  if (!m_bgWindow->getSize(&windowSize))
+    {
+      message("CGraphicsPortTest::createListBox: Failed to get window size\n");
+      return (CListBox *)NULL;
+    }
+
+  // Create the listbox
+
+  CListBox *listbox = new CListBox(m_widgetControl, 0, 0,
+                                   windowSize.w >> 1, windowSize.h);
+  if (!listbox)
+    {
+      message("CGraphicsPortTest::createListBox: Failed to create CListBox\n");
+    }
+
+  return listbox;
+}
+
+// Create a multi-line text box in the right half of the window
+
+CMultiLineTextBox *
+CGraphicsPortTest::createMultiLineTextBox(const CNxString &text)
+{
+  // Get the size of the display
+
+  struct nxgl_size_s windowSize;
+  if (!m_bgWindow->getSize(&windowSize))
+    {
+      message("CGraphicsPortTest::createMultiLineTextBox: Failed to get window size\n");
+      return (CMultiLineTextBox *)NULL;
+    }
+
+  // Create the text box
+
+  nxgl_coord_t halfWidth = windowSize.w >> 1;
+  CMultiLineTextBox *textbox =
+    new CMultiLineTextBox(m_widgetControl, halfWidth, 0,
+                          windowSize.w - halfWidth, windowSize.h,
+                          text, 0);
+  if (!textbox)
+    {
+      message("CGraphicsPortTest::createMultiLineTextBox: Failed to create CMultiLineTextBox\n");
+    }
+
+  return textbox;
+}
+
+// Redraw the widget nFrames times and return the average time for one
+// frame in microseconds.
+
+unsigned long CGraphicsPortTest::measureFrameTime(CNxWidget *widget, int nFrames)
+{
+  struct timespec start;
+
+  widget->enableDrawing();
+  bench_start(&start);
+
+  for (int i = 0; i < nFrames; i++)
+    {
+      widget->redraw();
+    }
+
+  unsigned long elapsed = bench_elapsed_usec(&start);
+  return nFrames > 0 ? elapsed / nFrames : 0;
+}
+
+// Discard all cached glyphs so that the next frame is drawn cold
+
+void CGraphicsPortTest::flushCache(void)
+{
+#ifdef CONFIG_NXWIDGETS_GLYPHCACHE
+  m_widgetControl->getGraphicsPort()->getGlyphCache()->flush();
+#endif
+}
+
+// Show the glyph cache statistics for the window and reset them
+
+void CGraphicsPortTest::showCacheStatistics(FAR const char *msg)
+{
+#ifdef CONFIG_NXWIDGETS_GLYPHCACHE
+  CGlyphCache *cache = m_widgetControl->getGraphicsPort()->getGlyphCache();
+
+  message("%s: Glyph cache hits: %lu misses: %lu\n", msg,
+          (unsigned long)cache->getHits(), (unsigned long)cache->getMisses());
+  cache->resetStatistics();
+#else
+  message("%s: Glyph cache is disabled\n", msg);
+#endif
+}
@@ -0,0 +1,193 @@
+/****************************************************************************
+ * NxWidgets/libnxwidgets/include/cglyphcache.hxx
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX, NxWidgets, nor the names of its contributors
+ *    me be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_CGLYPHCACHE_HXX
+#define __INCLUDE_CGLYPHCACHE_HXX
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+ 
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/nx/nxglib.h>
+#include <nuttx/nx/nxfonts.h>
+
+#include "nxconfig.hxx"
+
+#ifdef CONFIG_NXWIDGETS_GLYPHCACHE
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/**
+ * The cache is organized as a set of small, fully associative sets.  The
+ * set is selected by a hash of the glyph key so that lookups are bounded
+ * by the number of ways, not by the size of the cache.
+ */
+
+#define GLYPHCACHE_NWAYS 4
+#define GLYPHCACHE_NSETS \
+  ((CONFIG_NXWIDGETS_GLYPHCACHE_SIZE + GLYPHCACHE_NWAYS - 1) / GLYPHCACHE_NWAYS)
+#define GLYPHCACHE_NENTRIES (GLYPHCACHE_NSETS * GLYPHCACHE_NWAYS)
+
+/****************************************************************************
+ * Implementation Classes
+ ****************************************************************************/
+ 
+#if defined(__cplusplus)
+
+namespace NXWidgets
+{
+  class CNxFont;
+
+  /**
+   * CGlyphCache holds a bounded number of fully rendered glyphs.  Each
+   * glyph is rendered onto a solid background so that it can be blitted
+   * to the display without reading back from the graphics device.  Glyphs
+   * are identified by font ID, character, font color and background color;
+   * the least recently used glyph in a set is replaced on a miss.
+   */
+
+  class CGlyphCache
+  {
+  private:
+    /**
+     * One rendered glyph.
+     */
+
+    struct SGlyphCacheEntry
+    {
+      FAR uint8_t     *data;       /**< Rendered glyph, NULL if not allocated */
+      unsigned int     size;       /**< Allocated size of data (bytes) */
+      uint32_t         age;        /**< Value of m_clock at the last use */
+      enum nx_fontid_e fontId;     /**< The font the glyph was rendered with */
+      nxgl_mxpixel_t   color;      /**< Font color */
+      nxgl_mxpixel_t   background; /**< Background color */
+      nxgl_coord_t     width;      /**< Width of the rendered glyph (pixels) */
+      nxwidget_char_t  letter;     /**< The character */
+      bool             valid;      /**< True if the entry holds a glyph */
+    };
+
+    struct SGlyphCacheEntry m_entries[GLYPHCACHE_NENTRIES]; /**< Cache entries */
+    uint32_t m_clock;                                       /**< Usage clock */
+    uint32_t m_hits;                                        /**< Number of cache hits */
+    uint32_t m_misses;                                      /**< Number of cache misses */
+
+    /**
+     * Copy constructor is protected to prevent usage.
+     */
+
+    inline CGlyphCache(const CGlyphCache &cache) { }
+
+  public:
+    /**
+     * Constructor.
+     */
+
+    CGlyphCache(void);
+
+    /**
+     * Destructor.
+     */
+
+    ~CGlyphCache(void);
+
+    /**
+     * Return a glyph rendered in the current color of the font on a solid
+     * background.  The glyph is rendered and added to the cache if it is
+     * not already present.  The returned memory belongs to the cache and
+     * is only valid until the next call to getGlyph() or flush().
+     *
+     * @param font The font to render with.
+     * @param letter The character to render.
+     * @param width The width of the glyph (metrics width plus x offset).
+     * @param background The color to fill the background with.
+     * @return The rendered glyph, with a stride of
+     *   (width * CONFIG_NXWIDGETS_BPP + 7) >> 3 bytes and a height of
+     *   font->getHeight() rows, or NULL if memory could not be allocated.
+     */
+
+    FAR const uint8_t *getGlyph(CNxFont *font, nxwidget_char_t letter,
+                                nxgl_coord_t width,
+                                nxgl_mxpixel_t background);
+
+    /**
+     * Discard all cached glyphs and free the memory that holds them.
+     */
+
+    void flush(void);
+
+    /**
+     * Get the number of lookups satisfied from the cache.
+     *
+     * @return The number of cache hits.
+     */
+
+    inline const uint32_t getHits(void) const
+    {
+      return m_hits;
+    }
+
+    /**
+     * Get the number of lookups that required the glyph to be rendered.
+     *
+     * @return The number of cache misses.
+     */
+
+    inline const uint32_t getMisses(void) const
+    {
+      return m_misses;
+    }
+
+    /**
+     * Reset the hit and miss counts.
+     */
+
+    inline void resetStatistics(void)
+    {
+      m_hits   = 0;
+      m_misses = 0;
+    }
+  };
+}
+
+#endif // __cplusplus
+#endif // CONFIG_NXWIDGETS_GLYPHCACHE
+#endif // __INCLUDE_CGLYPHCACHE_HXX
@@ -81,6 +81,7 @@
 
 #include "nxconfig.hxx"
 #include "inxwindow.hxx"
+#include "cglyphcache.hxx"
 
 /****************************************************************************
  * Pre-Processor Definitions
@@ -110,6 +111,22 @@ namespace NXWidgets
 #ifdef CONFIG_NX_WRITEONLY
     nxgl_mxpixel_t m_backColor;  /**< The background color to use */
 #endif
+    FAR uint8_t   *m_glyph;      /**< Scratch memory for rendering glyphs */
+    unsigned int   m_glyphSize;  /**< Size of the scratch memory (bytes) */
+#ifdef CONFIG_NXWIDGETS_GLYPHCACHE
+    CGlyphCache    m_glyphCache; /**< Cache of rendered glyphs */
+#endif
+
+    /**
+     * Make sure that the glyph scratch memory can hold at least the
+     * specified number of bytes.  The memory is re-used across calls
+     * and only re-allocated when a larger font is encountered.
+     *
+     * @param size The required size in bytes.
+     * @return True if the scratch memory is large enough.
+     */
+
+    bool reserveGlyphMemory(unsigned int size);
 
     /**
      * The underlying implementation for drawText functions
@@ -198,6 +215,20 @@ namespace NXWidgets
     }
 #endif
 
+    /**
+     * Get the cache of rendered glyphs.  Text drawn on a solid background
+     * is rendered through this cache.
+     *
+     * @return The glyph cache used by this graphics port.
+     */
+
+#ifdef CONFIG_NXWIDGETS_GLYPHCACHE
+    inline CGlyphCache *getGlyphCache(void)
+    {
+      return &m_glyphCache;
+    }
+#endif
+
     /**
      * Draw a pixel into the window.
      *
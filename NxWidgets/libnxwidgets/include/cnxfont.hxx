@@ -106,6 +106,17 @@ namespace NXWidgets
 
     const bool isCharBlank(const nxwidget_char_t letter) const;
 
+    /**
+     * Gets the ID of the font.
+     *
+     * @return The font ID.
+     */
+
+    inline const enum nx_fontid_e getFontId() const
+    {
+      return m_fontId;
+    }
+
     /**
      * Gets the color currently being used as the drawing color.
      *
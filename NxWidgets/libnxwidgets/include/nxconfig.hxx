@@ -137,6 +137,14 @@
  * CONFIG_NXWIDGETS_CURSORCONTROL_SIZE - Size of incoming cursor control
  *   buffer, i.e., the maximum number of cursor controls that can between
  *   entered by NX polling cycles without losing data.  Default: 4
+ *
+ * Text rendering
+ *
+ * CONFIG_NXWIDGETS_GLYPHCACHE - Keep a cache of rendered glyphs so that text
+ *   drawn on a solid background does not have to be re-rendered on each
+ *   redraw.  Default: Not defined
+ * CONFIG_NXWIDGETS_GLYPHCACHE_SIZE - The maximum number of glyphs in the
+ *   cache of each CGraphicsPort (rounded up to a multiple of 4).  Default: 64
  */
 
 /* Prerequisites ************************************************************/
@@ -470,6 +478,20 @@
 #  define CONFIG_NXWIDGETS_CURSORCONTROL_SIZE 4
 #endif
 
+/* Text rendering ***********************************************************/
+/**
+ * Maximum number of rendered glyphs held in the glyph cache.
+ */
+
+#ifdef CONFIG_NXWIDGETS_GLYPHCACHE
+#  ifndef CONFIG_NXWIDGETS_GLYPHCACHE_SIZE
+#    define CONFIG_NXWIDGETS_GLYPHCACHE_SIZE 64
+#  endif
+#  if CONFIG_NXWIDGETS_GLYPHCACHE_SIZE < 1
+#    undef CONFIG_NXWIDGETS_GLYPHCACHE
+#  endif
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -0,0 +1,224 @@
+/****************************************************************************
+ * NxWidgets/libnxwidgets/src/cglyphcache.cxx
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX, NxWidgets, nor the names of its contributors
+ *    me be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <cstring>
+
+#include <nuttx/nx/nxglib.h>
+#include <nuttx/nx/nxfonts.h>
+
+#include "nxconfig.hxx"
+#include "cnxfont.hxx"
+#include "cbitmap.hxx"
+#include "cglyphcache.hxx"
+
+#ifdef CONFIG_NXWIDGETS_GLYPHCACHE
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Method Implementations
+ ****************************************************************************/
+
+using namespace NXWidgets;
+
+/**
+ * Constructor.
+ */
+
+CGlyphCache::CGlyphCache(void)
+{
+  memset(m_entries, 0, sizeof(m_entries));
+  m_clock  = 0;
+  m_hits   = 0;
+  m_misses = 0;
+}
+
+/**
+ * Destructor.
+ */
+
+CGlyphCache::~CGlyphCache(void)
+{
+  flush();
+}
+
+/**
+ * Return a glyph rendered in the current color of the font on a solid
+ * background.  The glyph is rendered and added to the cache if it is
+ * not already present.  The returned memory belongs to the cache and
+ * is only valid until the next call to getGlyph() or flush().
+ *
+ * @param font The font to render with.
+ * @param letter The character to render.
+ * @param width The width of the glyph (metrics width plus x offset).
+ * @param background The color to fill the background with.
+ * @return The rendered glyph, with a stride of
+ *   (width * CONFIG_NXWIDGETS_BPP + 7) >> 3 bytes and a height of
+ *   font->getHeight() rows, or NULL if memory could not be allocated.
+ */
+
+FAR const uint8_t *CGlyphCache::getGlyph(CNxFont *font, nxwidget_char_t letter,
+                                         nxgl_coord_t width,
+                                         nxgl_mxpixel_t background)
+{
+  enum nx_fontid_e fontId = font->getFontId();
+  nxgl_mxpixel_t   color  = font->getColor();
+
+  // Select the set.  Consecutive characters fall into consecutive sets.
+
+  unsigned int hash = (unsigned int)letter ^ ((unsigned int)fontId << 3) ^
+                      (unsigned int)(color * 7) ^ (unsigned int)(background * 13);
+
+  struct SGlyphCacheEntry *set = &m_entries[(hash % GLYPHCACHE_NSETS) * GLYPHCACHE_NWAYS];
+
+  // Search the set for the glyph, remembering the least recently used
+  // entry in case it is not there.
+
+  struct SGlyphCacheEntry *victim = set;
+  m_clock++;
+
+  for (int i = 0; i < GLYPHCACHE_NWAYS; i++)
+    {
+      struct SGlyphCacheEntry *entry = &set[i];
+      if (!entry->valid)
+        {
+          victim = entry;
+          continue;
+        }
+
+      if (entry->letter == letter && entry->fontId == fontId &&
+          entry->color == color && entry->background == background &&
+          entry->width == width)
+        {
+          entry->age = m_clock;
+          m_hits++;
+          return entry->data;
+        }
+
+      if (victim->valid && (uint32_t)(m_clock - entry->age) >
+                           (uint32_t)(m_clock - victim->age))
+        {
+          victim = entry;
+        }
+    }
+
+  // Not in the cache.  Make sure that the victim can hold the new glyph.
+  // Size the memory for whole pixels so that the background fill below
+  // cannot overrun the buffer.
+
+  m_misses++;
+
+  nxgl_coord_t height  = (nxgl_coord_t)font->getHeight();
+  unsigned int npixels = (unsigned int)width * (unsigned int)height;
+  unsigned int size    = npixels * sizeof(nxwidget_pixel_t);
+
+  victim->valid = false;
+  if (victim->size < size)
+    {
+      if (victim->data)
+        {
+          delete[] victim->data;
+        }
+
+      victim->data = new uint8_t[size];
+      if (!victim->data)
+        {
+          victim->size = 0;
+          return (FAR const uint8_t *)NULL;
+        }
+
+      victim->size = size;
+    }
+
+  // Fill the glyph memory with the background color
+
+  nxwidget_pixel_t *bmPtr = (nxwidget_pixel_t *)victim->data;
+  for (unsigned int j = 0; j < npixels; j++)
+    {
+      *bmPtr++ = background;
+    }
+
+  // Render the font into the initialized bitmap
+
+  struct SBitmap bitmap;
+  bitmap.bpp    = CONFIG_NXWIDGETS_BPP;
+  bitmap.fmt    = CONFIG_NXWIDGETS_FMT;
+  bitmap.width  = width;
+  bitmap.height = height;
+  bitmap.stride = (width * CONFIG_NXWIDGETS_BPP + 7) >> 3;
+  bitmap.data   = (FAR const nxgl_mxpixel_t*)victim->data;
+
+  font->drawChar(&bitmap, letter);
+
+  // And remember what the entry now holds
+
+  victim->fontId     = fontId;
+  victim->color      = color;
+  victim->background = background;
+  victim->width      = width;
+  victim->letter     = letter;
+  victim->age        = m_clock;
+  victim->valid      = true;
+  return victim->data;
+}
+
+/**
+ * Discard all cached glyphs and free the memory that holds them.
+ */
+
+void CGlyphCache::flush(void)
+{
+  for (int i = 0; i < GLYPHCACHE_NENTRIES; i++)
+    {
+      if (m_entries[i].data)
+        {
+          delete[] m_entries[i].data;
+        }
+    }
+
+  memset(m_entries, 0, sizeof(m_entries));
+}
+
+#endif // CONFIG_NXWIDGETS_GLYPHCACHE
@@ -115,11 +115,15 @@ CGraphicsPort::CGraphicsPort(INxWindow *pNxWnd, nxgl_mxpixel_t backColor)
 {
   m_pNxWnd    = pNxWnd;
   m_backColor = backColor;
+  m_glyph     = (FAR uint8_t *)NULL;
+  m_glyphSize = 0;
 }
 #else
 CGraphicsPort::CGraphicsPort(INxWindow *pNxWnd)
 {
-  m_pNxWnd = pNxWnd;
+  m_pNxWnd    = pNxWnd;
+  m_glyph     = (FAR uint8_t *)NULL;
+  m_glyphSize = 0;
 }
 #endif
 
@@ -132,6 +136,11 @@ CGraphicsPort::~CGraphicsPort(void)
   // m_pNxWnd is not deleted.  This is an abstract base class and
   // the caller of the CGraphicsPort instance is responsible for
   // the window destruction.
+
+  if (m_glyph)
+    {
+      delete[] m_glyph;
+    }
 };
 
 /**
@@ -728,13 +737,18 @@ void CGraphicsPort::_drawText(struct nxgl_point_s *pos, CRect *bound,
     }
 #endif
     
-  // Allocate a bit of memory to hold the largest rendered font
+  // Make sure that the scratch memory can hold the largest rendered font.
+  // Size the memory for whole pixels so that the background fill cannot
+  // overrun it.
 
-  unsigned int bmWidth   = ((unsigned int)font->getMaxWidth() * CONFIG_NXWIDGETS_BPP + 7) >> 3;
-  unsigned int bmHeight  = (unsigned int)font->getHeight();
+  unsigned int bmHeight = (unsigned int)font->getHeight();
+  unsigned int mxpixels = (unsigned int)font->getMaxWidth() * bmHeight;
 
-  unsigned int glyphSize =  bmWidth * bmHeight;
-  FAR uint8_t  *glyph    =  new uint8_t[glyphSize];
+  if (!reserveGlyphMemory(mxpixels * sizeof(nxwidget_pixel_t)))
+    {
+      gdbg("Failed to allocate glyph memory\n");
+      return;
+    }
 
   // Get the bounding rectangle in NX form
 
@@ -746,7 +760,7 @@ void CGraphicsPort::_drawText(struct nxgl_point_s *pos, CRect *bound,
   struct SBitmap bitmap;
   bitmap.bpp    = CONFIG_NXWIDGETS_BPP;
   bitmap.fmt    = CONFIG_NXWIDGETS_FMT;
-  bitmap.data   = (FAR const nxgl_mxpixel_t*)glyph;
+  bitmap.data   = (FAR const nxgl_mxpixel_t*)m_glyph;
 
   // Loop for each letter in the sub-string
 
@@ -793,36 +807,52 @@ void CGraphicsPort::_drawText(struct nxgl_point_s *pos, CRect *bound,
 
           if (!nxgl_nullrect(&intersection))
             {
-              // If we have been given a background color, use it to fill the array.
-              // Otherwise initialize the bitmap memory by reading from the display.
-              // The font renderer always renders the fonts on a transparent background.
-              
+              FAR const void *glyph = (FAR const void *)NULL;
+
+              // If we have been given a background color, the rendered
+              // glyph does not depend on the display contents and can
+              // come from the glyph cache.  Otherwise initialize the bitmap
+              // memory by reading from the display.  The font renderer
+              // always renders the fonts on a transparent background.
+
+#ifdef CONFIG_NXWIDGETS_GLYPHCACHE
               if (!transparent)
                 {
-                  // Set the glyph memory to the background color
+                  glyph = (FAR const void *)
+                    m_glyphCache.getGlyph(font, letter, fontWidth, background);
+                }
 
-                  nxwidget_pixel_t *bmPtr   = (nxwidget_pixel_t *)bitmap.data;
-                  unsigned int      npixels = fontWidth * bmHeight;
-                  for (unsigned int j = 0; j < npixels; j++)
+              if (!glyph)
+#endif
+                {
+                  if (!transparent)
                     {
-                      *bmPtr++ = background;
+                      // Set the glyph memory to the background color
+
+                      nxwidget_pixel_t *bmPtr   = (nxwidget_pixel_t *)bitmap.data;
+                      unsigned int      npixels = fontWidth * bmHeight;
+                      for (unsigned int j = 0; j < npixels; j++)
+                        {
+                          *bmPtr++ = background;
+                        }
                     }
-                }
-              else
-                {
-                  // Read the current contents of the destination into the glyph memory
+                  else
+                    {
+                      // Read the current contents of the destination into
+                      // the glyph memory
 
-                  m_pNxWnd->getRectangle(&dest, &bitmap);
-                }
+                      m_pNxWnd->getRectangle(&dest, &bitmap);
+                    }
 
-              // Render the font into the initialized bitmap
+                  // Render the font into the initialized bitmap
 
-              font->drawChar(&bitmap, letter);
+                  font->drawChar(&bitmap, letter);
+                  glyph = (FAR const void *)bitmap.data;
+                }
 
               // Then put the font on the display
 
-              if (!m_pNxWnd->bitmap(&intersection, (FAR const void *)bitmap.data,
-                                   pos, bitmap.stride))
+              if (!m_pNxWnd->bitmap(&intersection, glyph, pos, bitmap.stride))
                 {
                   gvdbg("nx_bitmapwindow failed: %d\n", errno);
                 }
@@ -833,8 +863,31 @@ void CGraphicsPort::_drawText(struct nxgl_point_s *pos, CRect *bound,
 
       pos->x += fontWidth;
     }
+}
+
+/**
+ * Make sure that the glyph scratch memory can hold at least the
+ * specified number of bytes.  The memory is re-used across calls
+ * and only re-allocated when a larger font is encountered.
+ *
+ * @param size The required size in bytes.
+ * @return True if the scratch memory is large enough.
+ */
+
+bool CGraphicsPort::reserveGlyphMemory(unsigned int size)
+{
+  if (size > m_glyphSize)
+    {
+      if (m_glyph)
+        {
+          delete[] m_glyph;
+        }
+
+      m_glyph     = new uint8_t[size];
+      m_glyphSize = m_glyph ? size : 0;
+    }
 
-  delete glyph;
+  return m_glyph != (FAR uint8_t *)NULL;
 }
 
 /**
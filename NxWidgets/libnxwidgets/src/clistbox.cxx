@@ -458,7 +458,6 @@ void CListBox::drawContents(CGraphicsPort *port)
 
   // Calculate clipping values
 
-  nxgl_coord_t clipX      = rect.getX();
   nxgl_coord_t clipY      = rect.getY();
   nxgl_coord_t clipHeight = rect.getHeight();
 
@@ -523,17 +522,23 @@ void CListBox::drawContents(CGraphicsPort *port)
           pos.x = rect.getX() + m_optionPadding;
           pos.y = rect.getY() + y + m_optionPadding;
  
+          // The background of the option is a solid color so the text can
+          // be drawn opaquely.  This avoids reading back from the display
+          // and lets the glyphs come from the glyph cache.
+
           if (isEnabled())
             {
               port->drawText(&pos, &rect, getFont(), item->getText(), 0,
                              item->getText().getLength(),
-                             item->getSelectedTextColor());
+                             item->getSelectedTextColor(),
+                             item->getSelectedBackColor());
             }
           else
             {
               port->drawText(&pos, &rect, getFont(), item->getText(), 0,
                              item->getText().getLength(),
-                             getDisabledTextColor());
+                             getDisabledTextColor(),
+                             item->getSelectedBackColor());
            }
         }
       else
@@ -542,7 +547,8 @@ void CListBox::drawContents(CGraphicsPort *port)
 
           if (item->getNormalBackColor() != getBackgroundColor())
             {
-              port->drawFilledRect(clipX, y, getWidth(), optionHeight,
+              port->drawFilledRect(rect.getX(), rect.getY() + y,
+                                   rect.getWidth(), optionHeight,
                                    item->getNormalBackColor());
             }
 
@@ -556,13 +562,15 @@ void CListBox::drawContents(CGraphicsPort *port)
             {
               port->drawText(&pos, &rect, getFont(), item->getText(), 0,
                              item->getText().getLength(),
-                             item->getNormalTextColor());
+                             item->getNormalTextColor(),
+                             item->getNormalBackColor());
             }
           else
             {
               port->drawText(&pos, &rect, getFont(), item->getText(), 0,
                              item->getText().getLength(),
-                             getDisabledTextColor());
+                             getDisabledTextColor(),
+                             item->getNormalBackColor());
             }
         }
 
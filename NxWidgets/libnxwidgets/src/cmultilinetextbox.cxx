@@ -1277,8 +1277,12 @@ void CMultiLineTextBox::drawRow(CGraphicsPort *port, int row)
       textColor = getEnabledTextColor();
     }
 
-  // And draw the text using the selected color
+  // And draw the text using the selected color.  drawBorder() has already
+  // filled the widget with the background color, so the text can be drawn
+  // opaquely.  That avoids reading back from the display and lets the
+  // glyphs come from the glyph cache.
 
   port->drawText(&pos, &rect, m_text->getFont(), *m_text,
-                 m_text->getLineStartIndex(row), rowLength, textColor);
+                 m_text->getLineStartIndex(row), rowLength, textColor,
+                 getBackgroundColor());
 }
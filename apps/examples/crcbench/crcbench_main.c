@@ -0,0 +1,323 @@
+/****************************************************************************
+ * examples/crcbench/crcbench_main.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <crc32.h>
+#include <crc16.h>
+
+#include <apps/benchmark.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_CRCBENCH_MAXSIZE
+#  define CONFIG_EXAMPLES_CRCBENCH_MAXSIZE 4096
+#endif
+
+#ifndef CONFIG_EXAMPLES_CRCBENCH_MSEC
+#  define CONFIG_EXAMPLES_CRCBENCH_MSEC 200
+#endif
+
+/* Check the time after processing about this many bytes */
+
+#define CRCBENCH_CHECKBYTES (64*1024)
+
+/* Buffers up to this size are checked against the bit-at-a-time CRC */
+
+#define CRCBENCH_VERIFYSIZE 80
+
+/* The CRCs of the standard check string "123456789".  Neither crc32() nor
+ * crc16() applies an initial or final inversion, so these differ from the
+ * values usually quoted for CRC-32 and CRC-CCITT.
+ */
+
+#define CRCBENCH_CHECKSTR   "123456789"
+#define CRCBENCH_CHECK32    0x2dfd2d88
+#define CRCBENCH_CHECK16    0xbeef
+
+#define NSIZES  (sizeof(g_sizes) / sizeof(g_sizes[0]))
+#define NCHUNKS (sizeof(g_chunks) / sizeof(g_chunks[0]))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const size_t g_sizes[] = { 16, 64, 256, 1024, 4096 };
+
+/* Chunk sizes used to test the streaming interfaces */
+
+static const size_t g_chunks[] = { 1, 3, 7, 13, 64 };
+
+static uint8_t g_buffer[CONFIG_EXAMPLES_CRCBENCH_MAXSIZE];
+
+static volatile uint32_t g_sink;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crcbench_bitwise32 and crcbench_bitwise16
+ *
+ * Description:
+ *   Bit-at-a-time reference versions of crc32() and crc16()
+ *
+ ****************************************************************************/
+
+static uint32_t crcbench_bitwise32(FAR const uint8_t *src, size_t len)
+{
+  uint32_t crc = 0;
+  int i;
+
+  while (len-- > 0)
+    {
+      crc ^= *src++;
+      for (i = 0; i < 8; i++)
+        {
+          crc = (crc >> 1) ^ ((crc & 1) ? 0xedb88320 : 0);
+        }
+    }
+
+  return crc;
+}
+
+static uint16_t crcbench_bitwise16(FAR const uint8_t *src, size_t len)
+{
+  uint16_t crc = 0;
+  uint16_t msb;
+  int i;
+
+  while (len-- > 0)
+    {
+      for (i = 7; i >= 0; i--)
+        {
+          msb = crc & 0x8000;
+          crc = (crc << 1) | ((*src >> i) & 1);
+          if (msb)
+            {
+              crc ^= 0x1021;
+            }
+        }
+
+      src++;
+    }
+
+  return crc;
+}
+
+/****************************************************************************
+ * Name: crcbench_verify
+ *
+ * Description:
+ *   Check crc32() and crc16() against known values, against the bit-at-a-
+ *   time references, and against the streaming interfaces with the data
+ *   presented in several different chunk sizes.  Returns the number of
+ *   errors.
+ *
+ ****************************************************************************/
+
+static int crcbench_verify(void)
+{
+  FAR const uint8_t *check = (FAR const uint8_t *)CRCBENCH_CHECKSTR;
+  struct crc32_s ctx32;
+  struct crc16_s ctx16;
+  uint32_t expect32;
+  uint16_t expect16;
+  size_t size;
+  size_t offset;
+  size_t chunk;
+  int nerrors = 0;
+  int i;
+
+  if (crc32(check, strlen(CRCBENCH_CHECKSTR)) != CRCBENCH_CHECK32)
+    {
+      printf("ERROR: crc32(\"%s\") = %08lx, expected %08lx\n",
+             CRCBENCH_CHECKSTR,
+             (unsigned long)crc32(check, strlen(CRCBENCH_CHECKSTR)),
+             (unsigned long)CRCBENCH_CHECK32);
+      nerrors++;
+    }
+
+  if (crc16(check, strlen(CRCBENCH_CHECKSTR)) != CRCBENCH_CHECK16)
+    {
+      printf("ERROR: crc16(\"%s\") = %04x, expected %04x\n",
+             CRCBENCH_CHECKSTR,
+             crc16(check, strlen(CRCBENCH_CHECKSTR)), CRCBENCH_CHECK16);
+      nerrors++;
+    }
+
+  for (size = 0; size < CRCBENCH_VERIFYSIZE &&
+                 size <= CONFIG_EXAMPLES_CRCBENCH_MAXSIZE; size++)
+    {
+      expect32 = crcbench_bitwise32(g_buffer, size);
+      expect16 = crcbench_bitwise16(g_buffer, size);
+
+      if (crc32(g_buffer, size) != expect32 ||
+          crc16(g_buffer, size) != expect16)
+        {
+          printf("ERROR: Size %d: crc32=%08lx/%08lx crc16=%04x/%04x\n",
+                 size, (unsigned long)crc32(g_buffer, size),
+                 (unsigned long)expect32, crc16(g_buffer, size), expect16);
+          nerrors++;
+          continue;
+        }
+
+      for (i = 0; i < NCHUNKS; i++)
+        {
+          crc32_init(&ctx32);
+          crc16_init(&ctx16);
+
+          for (offset = 0; offset < size; offset += chunk)
+            {
+              chunk = g_chunks[i];
+              if (chunk > size - offset)
+                {
+                  chunk = size - offset;
+                }
+
+              crc32_update(&ctx32, &g_buffer[offset], chunk);
+              crc16_update(&ctx16, &g_buffer[offset], chunk);
+            }
+
+          if (crc32_final(&ctx32) != expect32 ||
+              crc16_final(&ctx16) != expect16 ||
+              ctx32.nbytes != size || ctx16.nbytes != size)
+            {
+              printf("ERROR: Size %d chunk %d: "
+                     "crc32=%08lx/%08lx crc16=%04x/%04x\n",
+                     size, g_chunks[i], (unsigned long)crc32_final(&ctx32),
+                     (unsigned long)expect32, crc16_final(&ctx16), expect16);
+              nerrors++;
+            }
+        }
+    }
+
+  return nerrors;
+}
+
+/****************************************************************************
+ * Name: crcbench_run
+ *
+ * Description:
+ *   Repeat crc32() (or crc16()) on 'size' bytes for at least
+ *   CONFIG_EXAMPLES_CRCBENCH_MSEC milliseconds and return the throughput in
+ *   units of 1000 bytes per second.
+ *
+ ****************************************************************************/
+
+static unsigned long crcbench_run(bool use32, size_t size)
+{
+  struct timespec start;
+  unsigned long nbytes;
+  unsigned long msec;
+  size_t count;
+
+  nbytes = 0;
+  bench_start(&start);
+
+  do
+    {
+      for (count = 0; count < CRCBENCH_CHECKBYTES; count += size)
+        {
+          g_sink += use32 ? crc32(g_buffer, size) : crc16(g_buffer, size);
+        }
+
+      nbytes += count;
+      msec    = bench_elapsed(&start);
+    }
+  while (msec < CONFIG_EXAMPLES_CRCBENCH_MSEC);
+
+  /* Bytes per millisecond is the same as 1000 bytes per second */
+
+  return msec > 0 ? nbytes / msec : 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * crcbench_main
+ ****************************************************************************/
+
+int crcbench_main(int argc, char *argv[])
+{
+  unsigned long kbps32;
+  unsigned long kbps16;
+  int nerrors;
+  int i;
+
+  /* Fill the buffer with a pseudo-random pattern */
+
+  for (i = 0; i < CONFIG_EXAMPLES_CRCBENCH_MAXSIZE; i++)
+    {
+      g_buffer[i] = (uint8_t)((i * 2654435761u) >> 13);
+    }
+
+  nerrors = crcbench_verify();
+  if (nerrors > 0)
+    {
+      printf("crcbench: %d errors\n", nerrors);
+      return 1;
+    }
+
+  printf("crcbench: Verified crc32() and crc16()\n");
+  printf("crcbench: Throughput in MB/sec (1,000,000 bytes/sec)\n\n");
+  printf("   Size       crc32       crc16\n");
+
+  for (i = 0; i < NSIZES && g_sizes[i] <= CONFIG_EXAMPLES_CRCBENCH_MAXSIZE;
+       i++)
+    {
+      kbps32 = crcbench_run(true, g_sizes[i]);
+      kbps16 = crcbench_run(false, g_sizes[i]);
+
+      printf("  %5d  %6lu.%lu  %6lu.%lu\n", g_sizes[i],
+             kbps32 / 1000, (kbps32 % 1000) / 100,
+             kbps16 / 1000, (kbps16 % 1000) / 100);
+    }
+
+  return 0;
+}
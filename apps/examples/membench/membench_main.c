@@ -0,0 +1,291 @@
+/****************************************************************************
+ * examples/membench/membench_main.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <apps/benchmark.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_MEMBENCH_MAXSIZE
+#  define CONFIG_EXAMPLES_MEMBENCH_MAXSIZE 4096
+#endif
+
+#ifndef CONFIG_EXAMPLES_MEMBENCH_MSEC
+#  define CONFIG_EXAMPLES_MEMBENCH_MSEC 200
+#endif
+
+/* Room for the largest buffer, the largest alignment offset, and a NUL
+ * terminator, rounded up to a whole number of 64-bit words.
+ */
+
+#define MEMBENCH_BUFWORDS ((CONFIG_EXAMPLES_MEMBENCH_MAXSIZE + 16) / 8)
+
+/* Check the time after processing about this many bytes */
+
+#define MEMBENCH_CHECKBYTES (64*1024)
+
+#define NSIZES  (sizeof(g_sizes) / sizeof(g_sizes[0]))
+#define NALIGNS (sizeof(g_aligns) / sizeof(g_aligns[0]))
+#define NFUNCS  (sizeof(g_funcs) / sizeof(g_funcs[0]))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Performs one operation on 'size' bytes and returns a value that depends
+ * on the result so that the call cannot be optimized away.
+ */
+
+typedef uintptr_t (*membench_t)(FAR char *dest, FAR char *src, size_t size);
+
+struct membench_func_s
+{
+  FAR const char *name; /* Name of the function under test */
+  membench_t func;      /* Performs one operation */
+  bool string;          /* Source is a NUL terminated string */
+  bool compare;         /* Destination must be a copy of the source */
+};
+
+struct membench_align_s
+{
+  uint8_t dest;         /* Offset of the destination from word alignment */
+  uint8_t src;          /* Offset of the source from word alignment */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static uintptr_t membench_memcpy(FAR char *dest, FAR char *src, size_t size);
+static uintptr_t membench_memmove(FAR char *dest, FAR char *src, size_t size);
+static uintptr_t membench_memset(FAR char *dest, FAR char *src, size_t size);
+static uintptr_t membench_memcmp(FAR char *dest, FAR char *src, size_t size);
+static uintptr_t membench_memchr(FAR char *dest, FAR char *src, size_t size);
+static uintptr_t membench_strlen(FAR char *dest, FAR char *src, size_t size);
+static uintptr_t membench_strcpy(FAR char *dest, FAR char *src, size_t size);
+static uintptr_t membench_strcmp(FAR char *dest, FAR char *src, size_t size);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const size_t g_sizes[] = { 8, 32, 128, 512, 4096 };
+
+/* Aligned, equally misaligned, and differently aligned buffers */
+
+static const struct membench_align_s g_aligns[] =
+{
+  { 0, 0 }, { 1, 1 }, { 0, 3 }
+};
+
+static const struct membench_func_s g_funcs[] =
+{
+  { "memcpy",  membench_memcpy,  false, false },
+  { "memmove", membench_memmove, false, false },
+  { "memset",  membench_memset,  false, false },
+  { "memcmp",  membench_memcmp,  false, true  },
+  { "memchr",  membench_memchr,  false, false },
+  { "strlen",  membench_strlen,  true,  false },
+  { "strcpy",  membench_strcpy,  true,  false },
+  { "strcmp",  membench_strcmp,  true,  true  },
+};
+
+/* The buffers are declared as 64-bit words so that they are aligned for
+ * any word size.
+ */
+
+static uint64_t g_destbuf[MEMBENCH_BUFWORDS];
+static uint64_t g_srcbuf[MEMBENCH_BUFWORDS];
+
+static volatile uintptr_t g_sink;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uintptr_t membench_memcpy(FAR char *dest, FAR char *src, size_t size)
+{
+  return (uintptr_t)memcpy(dest, src, size);
+}
+
+static uintptr_t membench_memmove(FAR char *dest, FAR char *src, size_t size)
+{
+  return (uintptr_t)memmove(dest, src, size);
+}
+
+static uintptr_t membench_memset(FAR char *dest, FAR char *src, size_t size)
+{
+  return (uintptr_t)memset(dest, 0x5a, size);
+}
+
+static uintptr_t membench_memcmp(FAR char *dest, FAR char *src, size_t size)
+{
+  return (uintptr_t)memcmp(dest, src, size);
+}
+
+static uintptr_t membench_memchr(FAR char *dest, FAR char *src, size_t size)
+{
+  /* The source does not contain a NUL so the whole buffer is searched */
+
+  return (uintptr_t)memchr(src, '\0', size);
+}
+
+static uintptr_t membench_strlen(FAR char *dest, FAR char *src, size_t size)
+{
+  return (uintptr_t)strlen(src);
+}
+
+static uintptr_t membench_strcpy(FAR char *dest, FAR char *src, size_t size)
+{
+  return (uintptr_t)strcpy(dest, src);
+}
+
+static uintptr_t membench_strcmp(FAR char *dest, FAR char *src, size_t size)
+{
+  return (uintptr_t)strcmp(dest, src);
+}
+
+/****************************************************************************
+ * Name: membench_run
+ *
+ * Description:
+ *   Repeat one function for at least CONFIG_EXAMPLES_MEMBENCH_MSEC
+ *   milliseconds and return the throughput in units of 1000 bytes per
+ *   second.
+ *
+ ****************************************************************************/
+
+static unsigned long membench_run(FAR const struct membench_func_s *func,
+                                  size_t size,
+                                  FAR const struct membench_align_s *align)
+{
+  FAR char *dest = (FAR char *)g_destbuf + align->dest;
+  FAR char *src  = (FAR char *)g_srcbuf + align->src;
+  struct timespec start;
+  unsigned long nbytes;
+  unsigned long msec;
+  size_t count;
+
+  /* Prepare the buffers.  The source never contains a NUL except as the
+   * string terminator.
+   */
+
+  memset(src, 'a', size);
+  src[size] = func->string ? '\0' : 'a';
+
+  if (func->compare)
+    {
+      memcpy(dest, src, size + 1);
+    }
+
+  nbytes = 0;
+  bench_start(&start);
+
+  do
+    {
+      for (count = 0; count < MEMBENCH_CHECKBYTES; count += size)
+        {
+          g_sink += func->func(dest, src, size);
+        }
+
+      nbytes += count;
+      msec    = bench_elapsed(&start);
+    }
+  while (msec < CONFIG_EXAMPLES_MEMBENCH_MSEC);
+
+  /* Bytes per millisecond is the same as 1000 bytes per second */
+
+  return msec > 0 ? nbytes / msec : 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * membench_main
+ ****************************************************************************/
+
+int membench_main(int argc, char *argv[])
+{
+  unsigned long kbps;
+  int i;
+  int j;
+  int k;
+
+  printf("membench: Throughput in MB/sec (1,000,000 bytes/sec)\n");
+  printf("  Alignment is dest/src byte offset from word alignment\n\n");
+
+  for (i = 0; i < NFUNCS; i++)
+    {
+      printf("%-8s  Size", g_funcs[i].name);
+      for (k = 0; k < NALIGNS; k++)
+        {
+          printf("        %d/%d", g_aligns[k].dest, g_aligns[k].src);
+        }
+
+      printf("\n");
+
+      for (j = 0; j < NSIZES && g_sizes[j] <= CONFIG_EXAMPLES_MEMBENCH_MAXSIZE;
+           j++)
+        {
+          printf("         %5d", g_sizes[j]);
+          for (k = 0; k < NALIGNS; k++)
+            {
+              kbps = membench_run(&g_funcs[i], g_sizes[j], &g_aligns[k]);
+              printf("  %6lu.%lu", kbps / 1000, (kbps % 1000) / 100);
+            }
+
+          printf("\n");
+        }
+
+      printf("\n");
+    }
+
+  return 0;
+}
@@ -37,9 +37,14 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+
+#include <apps/benchmark.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -47,6 +52,27 @@
 
 #define NTEST_ALLOCS 32
 
+#ifdef CONFIG_EXAMPLES_MM_BENCHMARK
+#  ifndef CONFIG_EXAMPLES_MM_BENCH_NLOOPS
+#    define CONFIG_EXAMPLES_MM_BENCH_NLOOPS 2000
+#  endif
+#  ifndef CONFIG_EXAMPLES_MM_BENCH_NOBJS
+#    define CONFIG_EXAMPLES_MM_BENCH_NOBJS 32
+#  endif
+
+/* Small sizes are the ones that the small-object tier would serve (1..64
+ * bytes by default); large sizes are always served by the best-fit
+ * allocator.
+ */
+
+#  ifdef CONFIG_MM_SMALLOBJ_MAXSIZE
+#    define BENCH_SMALL_MAX CONFIG_MM_SMALLOBJ_MAXSIZE
+#  else
+#    define BENCH_SMALL_MAX 64
+#  endif
+#  define BENCH_LARGE_MIN   (BENCH_SMALL_MAX + 64)
+#endif
+
 /* #define STOP_ON_ERRORS do{}while(0) */
 #define STOP_ON_ERRORS exit(1)
 
@@ -118,6 +144,10 @@ static const int alignment[NTEST_ALLOCS/2] =
 static void        *allocs[NTEST_ALLOCS];
 static struct       mallinfo alloc_info;
 
+#ifdef CONFIG_EXAMPLES_MM_BENCHMARK
+static void        *bench_allocs[CONFIG_EXAMPLES_MM_BENCH_NOBJS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -262,6 +292,87 @@ static void do_frees(void **mem, const int *size, const int *seq, int n)
     }
 }
 
+#ifdef CONFIG_EXAMPLES_MM_BENCHMARK
+static void do_benchmark(const char *name, int minsize, int maxsize)
+{
+  struct timespec start;
+  unsigned int seed = 1;
+  unsigned int elapsed;
+  int nfailed = 0;
+  int size;
+  int loop;
+  int i;
+
+  bench_start(&start);
+
+  for (loop = 0; loop < CONFIG_EXAMPLES_MM_BENCH_NLOOPS; loop++)
+    {
+      /* Allocate a burst of objects with pseudo-random sizes ... */
+
+      for (i = 0; i < CONFIG_EXAMPLES_MM_BENCH_NOBJS; i++)
+        {
+          seed = seed * 1103515245 + 12345;
+          size = minsize + (seed >> 16) % (maxsize - minsize + 1);
+
+          bench_allocs[i] = malloc(size);
+          if (!bench_allocs[i])
+            {
+              nfailed++;
+            }
+        }
+
+      /* ... then free them in an interleaved order */
+
+      for (i = 0; i < CONFIG_EXAMPLES_MM_BENCH_NOBJS; i += 2)
+        {
+          free(bench_allocs[i]);
+        }
+
+      for (i = 1; i < CONFIG_EXAMPLES_MM_BENCH_NOBJS; i += 2)
+        {
+          free(bench_allocs[i]);
+        }
+    }
+
+  elapsed = bench_elapsed(&start);
+
+  printf("  %s (%d-%d bytes): %d malloc/free pairs in %u msec",
+         name, minsize, maxsize,
+         CONFIG_EXAMPLES_MM_BENCH_NLOOPS * CONFIG_EXAMPLES_MM_BENCH_NOBJS,
+         elapsed);
+  if (elapsed > 0)
+    {
+      printf(" (%u pairs/msec)",
+             (CONFIG_EXAMPLES_MM_BENCH_NLOOPS * CONFIG_EXAMPLES_MM_BENCH_NOBJS) /
+             elapsed);
+    }
+
+  printf("\n");
+  if (nfailed > 0)
+    {
+      fprintf(stderr, "  ERROR: %d allocations failed\n", nfailed);
+    }
+}
+
+static void mm_benchmark(void)
+{
+#ifdef CONFIG_MM_SMALLOBJ
+  printf("Heap benchmark: small-object tier enabled\n");
+#else
+  printf("Heap benchmark: small-object tier disabled\n");
+#endif
+
+  do_benchmark("small", 1, BENCH_SMALL_MAX);
+  do_benchmark("large", BENCH_LARGE_MIN, 2 * BENCH_LARGE_MIN);
+
+#ifdef CONFIG_MM_SMALLOBJ
+  alloc_info = mallinfo();
+  printf("  small-object tier: hits=%d misses=%d cached=%d bytes\n",
+         alloc_info.smhits, alloc_info.smmisses, alloc_info.smcached);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -295,6 +406,12 @@ int mm_main(int argc, char *argv[])
 
   do_frees(allocs, alloc_sizes, random1, NTEST_ALLOCS);
 
+#ifdef CONFIG_EXAMPLES_MM_BENCHMARK
+  /* Time small and large allocation bursts */
+
+  mm_benchmark();
+#endif
+
   printf("TEST COMPLETE\n");
   return 0;
 }
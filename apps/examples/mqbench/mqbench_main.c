@@ -0,0 +1,286 @@
+/****************************************************************************
+ * examples/mqbench/mqbench_main.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <mqueue.h>
+#include <pthread.h>
+#include <errno.h>
+
+#if defined(CONFIG_MQ_SENDREF) && !defined(CONFIG_NUTTX_KERNEL)
+#  include <nuttx/mqueue.h>
+#endif
+
+#include <apps/benchmark.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_MQBENCH_NMSGS
+#  define CONFIG_EXAMPLES_MQBENCH_NMSGS 8
+#endif
+
+#ifndef CONFIG_EXAMPLES_MQBENCH_MSEC
+#  define CONFIG_EXAMPLES_MQBENCH_MSEC 500
+#endif
+
+/* mq_sendref() is an OS-internal interface.  It can be measured only when
+ * the application is linked with the OS.
+ */
+
+#if defined(CONFIG_MQ_SENDREF) && !defined(CONFIG_NUTTX_KERNEL)
+#  define MQBENCH_HAVE_SENDREF 1
+#endif
+
+#define MQBENCH_NAME        "mqbench"
+#define MQBENCH_MAXSIZE     CONFIG_MQ_MAXMSGSIZE
+
+/* Check the time after sending this many messages */
+
+#define MQBENCH_CHECKMSGS   256
+
+#define NSIZES (sizeof(g_sizes) / sizeof(g_sizes[0]))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const size_t g_sizes[] = { 4, 16, 32, 128 };
+
+static uint8_t g_txbuffer[MQBENCH_MAXSIZE];
+static uint8_t g_rxbuffer[MQBENCH_MAXSIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mqbench_receiver
+ *
+ * Description:
+ *   Receive messages until a zero-length message is received.  Returns the
+ *   number of messages received.  The receive buffer is always
+ *   MQBENCH_MAXSIZE bytes which is at least the queue's mq_msgsize.
+ *
+ ****************************************************************************/
+
+static FAR void *mqbench_receiver(FAR void *arg)
+{
+  unsigned long nmsgs = 0;
+  mqd_t mqdes;
+  ssize_t nbytes;
+
+  mqdes = mq_open(MQBENCH_NAME, O_RDONLY);
+  if (mqdes == (mqd_t)-1)
+    {
+      printf("mqbench_receiver: mq_open failed: %d\n", errno);
+      return NULL;
+    }
+
+  for (;;)
+    {
+      nbytes = mq_receive(mqdes, (FAR char *)g_rxbuffer, MQBENCH_MAXSIZE,
+                          NULL);
+      if (nbytes < 0)
+        {
+          printf("mqbench_receiver: mq_receive failed: %d\n", errno);
+          break;
+        }
+      else if (nbytes == 0)
+        {
+          break;
+        }
+
+      nmsgs++;
+    }
+
+  mq_close(mqdes);
+  return (FAR void *)nmsgs;
+}
+
+/****************************************************************************
+ * Name: mqbench_run
+ *
+ * Description:
+ *   Send messages of 'size' bytes to a receiver thread for at least
+ *   CONFIG_EXAMPLES_MQBENCH_MSEC milliseconds and return the throughput in
+ *   messages per second (or 0 on a failure).
+ *
+ ****************************************************************************/
+
+static unsigned long mqbench_run(size_t size, bool byref)
+{
+  struct mq_attr attr;
+  struct timespec start;
+  pthread_t receiver;
+  FAR void *value;
+  unsigned long nsent;
+  unsigned long msec;
+  mqd_t mqdes;
+  int ret;
+  int i;
+
+  attr.mq_maxmsg  = CONFIG_EXAMPLES_MQBENCH_NMSGS;
+  attr.mq_msgsize = size;
+  attr.mq_flags   = 0;
+
+  mqdes = mq_open(MQBENCH_NAME, O_WRONLY | O_CREAT, 0666, &attr);
+  if (mqdes == (mqd_t)-1)
+    {
+      printf("mqbench: mq_open failed: %d\n", errno);
+      return 0;
+    }
+
+  ret = pthread_create(&receiver, NULL, mqbench_receiver, NULL);
+  if (ret != 0)
+    {
+      printf("mqbench: pthread_create failed: %d\n", ret);
+      mq_close(mqdes);
+      mq_unlink(MQBENCH_NAME);
+      return 0;
+    }
+
+  /* The sender does not modify g_txbuffer so the same buffer may also be
+   * sent by reference any number of times.
+   */
+
+  nsent = 0;
+  bench_start(&start);
+
+  do
+    {
+      for (i = 0; i < MQBENCH_CHECKMSGS; i++)
+        {
+#ifdef MQBENCH_HAVE_SENDREF
+          if (byref)
+            {
+              ret = mq_sendref(mqdes, g_txbuffer, size, 0, NULL, NULL);
+            }
+          else
+#endif
+            {
+              ret = mq_send(mqdes, (FAR const char *)g_txbuffer, size, 0);
+            }
+
+          if (ret < 0)
+            {
+              printf("mqbench: mq_send failed: %d\n", errno);
+              break;
+            }
+        }
+
+      nsent += i;
+      msec   = bench_elapsed(&start);
+    }
+  while (ret == 0 && msec < CONFIG_EXAMPLES_MQBENCH_MSEC);
+
+  /* Tell the receiver to stop and wait for it to drain the queue */
+
+  (void)mq_send(mqdes, (FAR const char *)g_txbuffer, 0, 0);
+  (void)pthread_join(receiver, &value);
+  msec = bench_elapsed(&start);
+
+  mq_close(mqdes);
+  mq_unlink(MQBENCH_NAME);
+
+  if ((unsigned long)value != nsent)
+    {
+      printf("mqbench: Sent %lu messages but %lu were received\n",
+             nsent, (unsigned long)value);
+      return 0;
+    }
+
+  return bench_rate(nsent, msec);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * mqbench_main
+ ****************************************************************************/
+
+int mqbench_main(int argc, char *argv[])
+{
+  unsigned long msgps;
+#ifdef MQBENCH_HAVE_SENDREF
+  unsigned long refps;
+#endif
+  int i;
+
+  memset(g_txbuffer, 0x5a, MQBENCH_MAXSIZE);
+
+  printf("mqbench: Messages per second through a %d message queue\n",
+         CONFIG_EXAMPLES_MQBENCH_NMSGS);
+#ifdef CONFIG_MQ_MSGPOOL
+  printf("  Per-queue message pools: Yes\n\n");
+#else
+  printf("  Per-queue message pools: No\n\n");
+#endif
+
+#ifdef MQBENCH_HAVE_SENDREF
+  printf("   Size     mq_send   KB/sec  mq_sendref   KB/sec\n");
+#else
+  printf("   Size     mq_send   KB/sec\n");
+#endif
+
+  for (i = 0; i < NSIZES && g_sizes[i] <= MQBENCH_MAXSIZE; i++)
+    {
+      msgps = mqbench_run(g_sizes[i], false);
+#ifdef MQBENCH_HAVE_SENDREF
+      refps = mqbench_run(g_sizes[i], true);
+      printf("  %5d  %10lu %8lu  %10lu %8lu\n", g_sizes[i],
+             msgps, (msgps * g_sizes[i]) / 1000,
+             refps, (refps * g_sizes[i]) / 1000);
+#else
+      printf("  %5d  %10lu %8lu\n", g_sizes[i],
+             msgps, (msgps * g_sizes[i]) / 1000);
+#endif
+    }
+
+  return 0;
+}
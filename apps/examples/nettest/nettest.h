@@ -84,6 +84,7 @@
 
 #define PORTNO     5471
 #define SENDSIZE   4096
+#define MULTISIZE  64
 
 /****************************************************************************
  * Public Function Prototypes
@@ -0,0 +1,199 @@
+/****************************************************************************
+ * examples/nettest/nettest_multiclient.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+#include <apps/benchmark.h>
+
+#include "nettest.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static int g_sockfd[CONFIG_EXAMPLES_NETTEST_NCONNS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * exchange
+ *
+ * Send one message on the connection and wait for the echo.
+ *
+ ****************************************************************************/
+
+static int exchange(int sockfd, const char *outbuf, char *inbuf)
+{
+  int nbytessent;
+  int nbytesrecvd;
+  int totalbytesrecvd;
+
+  nbytessent = send(sockfd, outbuf, MULTISIZE, 0);
+  if (nbytessent != MULTISIZE)
+    {
+      message("client: send failed: %d %d\n", nbytessent, errno);
+      return ERROR;
+    }
+
+  totalbytesrecvd = 0;
+  do
+    {
+      nbytesrecvd = recv(sockfd, &inbuf[totalbytesrecvd],
+                         MULTISIZE - totalbytesrecvd, 0);
+      if (nbytesrecvd <= 0)
+        {
+          message("client: recv failed: %d %d\n", nbytesrecvd, errno);
+          return ERROR;
+        }
+
+      totalbytesrecvd += nbytesrecvd;
+    }
+  while (totalbytesrecvd < MULTISIZE);
+
+  if (memcmp(inbuf, outbuf, MULTISIZE) != 0)
+    {
+      message("client: Received buffer does not match sent buffer\n");
+      return ERROR;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * send_client
+ *
+ * Open CONFIG_EXAMPLES_NETTEST_NCONNS connections to the server and then
+ * exchange small messages on each of them in turn.  Every segment received
+ * has to be matched against all of the open connections so the time per
+ * exchange shows the cost of the connection lookup as the number of
+ * connections grows.
+ *
+ ****************************************************************************/
+
+void send_client(void)
+{
+  struct sockaddr_in myaddr;
+  struct timespec start;
+  char outbuf[MULTISIZE];
+  char inbuf[MULTISIZE];
+  unsigned long elapsed;
+  int nconns;
+  int round;
+  int i;
+
+  /* Connect all of the sockets to the server */
+
+  myaddr.sin_family      = AF_INET;
+  myaddr.sin_port        = HTONS(PORTNO);
+  myaddr.sin_addr.s_addr = HTONL(CONFIG_EXAMPLES_NETTEST_CLIENTIP);
+
+  message("client: Connecting %d sockets...\n", CONFIG_EXAMPLES_NETTEST_NCONNS);
+  for (nconns = 0; nconns < CONFIG_EXAMPLES_NETTEST_NCONNS; nconns++)
+    {
+      g_sockfd[nconns] = socket(PF_INET, SOCK_STREAM, 0);
+      if (g_sockfd[nconns] < 0)
+        {
+          message("client socket failure %d\n", errno);
+          goto errout_with_sockets;
+        }
+
+      if (connect(g_sockfd[nconns], (struct sockaddr*)&myaddr,
+                  sizeof(struct sockaddr_in)) < 0)
+        {
+          message("client: connect failure: %d\n", errno);
+          close(g_sockfd[nconns]);
+          goto errout_with_sockets;
+        }
+    }
+
+  message("client: Connected\n");
+
+  /* Then exchange messages round-robin over all of the connections */
+
+  memset(outbuf, 0x20, MULTISIZE);
+  bench_start(&start);
+
+  for (round = 0; round < CONFIG_EXAMPLES_NETTEST_NROUNDS; round++)
+    {
+      for (i = 0; i < nconns; i++)
+        {
+          outbuf[0] = (char)round;
+          outbuf[1] = (char)i;
+
+          if (exchange(g_sockfd[i], outbuf, inbuf) < 0)
+            {
+              goto errout_with_sockets;
+            }
+        }
+    }
+
+  elapsed = bench_elapsed(&start);
+
+  message("client: %d exchanges on %d connections in %lu msec\n",
+          CONFIG_EXAMPLES_NETTEST_NROUNDS * nconns, nconns, elapsed);
+
+  for (i = 0; i < nconns; i++)
+    {
+      close(g_sockfd[i]);
+    }
+
+  return;
+
+errout_with_sockets:
+  for (i = 0; i < nconns; i++)
+    {
+      close(g_sockfd[i]);
+    }
+
+  exit(1);
+}
@@ -0,0 +1,184 @@
+/****************************************************************************
+ * examples/nettest/nettest_multiserver.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+
+#include "nettest.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * recv_server
+ *
+ * Accept any number of connections and echo everything received on each
+ * of them.  Returns when the last connection has been closed.
+ *
+ ****************************************************************************/
+
+void recv_server(void)
+{
+  struct sockaddr_in myaddr;
+  char buffer[MULTISIZE];
+  fd_set active;
+  fd_set readset;
+  int listensd;
+  int maxsd;
+  int nconns;
+  int optval;
+  int sd;
+
+  /* Create a new TCP socket to listen on */
+
+  listensd = socket(PF_INET, SOCK_STREAM, 0);
+  if (listensd < 0)
+    {
+      message("server: socket failure: %d\n", errno);
+      exit(1);
+    }
+
+  optval = 1;
+  if (setsockopt(listensd, SOL_SOCKET, SO_REUSEADDR, (void*)&optval,
+                 sizeof(int)) < 0)
+    {
+      message("server: setsockopt SO_REUSEADDR failure: %d\n", errno);
+      goto errout_with_listensd;
+    }
+
+  myaddr.sin_family      = AF_INET;
+  myaddr.sin_port        = HTONS(PORTNO);
+  myaddr.sin_addr.s_addr = INADDR_ANY;
+
+  if (bind(listensd, (struct sockaddr*)&myaddr, sizeof(struct sockaddr_in)) < 0)
+    {
+      message("server: bind failure: %d\n", errno);
+      goto errout_with_listensd;
+    }
+
+  if (listen(listensd, 16) < 0)
+    {
+      message("server: listen failure %d\n", errno);
+      goto errout_with_listensd;
+    }
+
+  message("server: Accepting connections on port %d\n", PORTNO);
+
+  FD_ZERO(&active);
+  FD_SET(listensd, &active);
+  maxsd  = listensd;
+  nconns = 0;
+
+  for (;;)
+    {
+      readset = active;
+      if (select(maxsd + 1, &readset, NULL, NULL, NULL) < 0)
+        {
+          message("server: select failure: %d\n", errno);
+          goto errout_with_listensd;
+        }
+
+      for (sd = 0; sd <= maxsd; sd++)
+        {
+          if (!FD_ISSET(sd, &readset))
+            {
+              continue;
+            }
+
+          if (sd == listensd)
+            {
+              /* A new connection */
+
+              int acceptsd = accept(listensd, NULL, NULL);
+              if (acceptsd < 0)
+                {
+                  message("server: accept failure: %d\n", errno);
+                  goto errout_with_listensd;
+                }
+
+              if (acceptsd >= FD_SETSIZE)
+                {
+                  message("server: Too many connections\n");
+                  close(acceptsd);
+                  continue;
+                }
+
+              FD_SET(acceptsd, &active);
+              if (acceptsd > maxsd)
+                {
+                  maxsd = acceptsd;
+                }
+
+              nconns++;
+            }
+          else
+            {
+              /* Echo whatever was received */
+
+              int nbytesread = recv(sd, buffer, MULTISIZE, 0);
+              if (nbytesread <= 0 ||
+                  send(sd, buffer, nbytesread, 0) != nbytesread)
+                {
+                  close(sd);
+                  FD_CLR(sd, &active);
+
+                  if (--nconns == 0)
+                    {
+                      message("server: All connections closed\n");
+                      close(listensd);
+                      return;
+                    }
+                }
+            }
+        }
+    }
+
+errout_with_listensd:
+  close(listensd);
+  exit(1);
+}
@@ -71,6 +71,14 @@
 #  define CONFIG_EXAMPLES_OSTEST_NBARRIER_THREADS 8
 #endif
 
+/* This is the largest number of background threads created by the
+ * scheduler latency benchmark.
+ */
+
+#ifndef CONFIG_EXAMPLES_OSTEST_SCHEDLAT_NTHREADS
+#  define CONFIG_EXAMPLES_OSTEST_SCHEDLAT_NTHREADS 64
+#endif
+
 /* Priority inheritance */
 
 #if defined(CONFIG_DEBUG) && defined(CONFIG_PRIORITY_INHERITANCE) && defined(CONFIG_SEM_PHDEBUG)
@@ -169,6 +177,10 @@ void rr_test(void);
 
 void barrier_test(void);
 
+/* schedlat.c ***************************************************************/
+
+void schedlat_test(void);
+
 /* prioinherit.c ************************************************************/
 
 void priority_inheritance(void);
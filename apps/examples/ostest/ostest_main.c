@@ -443,6 +443,14 @@ static int user_main(int argc, char *argv[])
       check_test_memory_usage();
 #endif
 
+#if defined(CONFIG_EXAMPLES_OSTEST_SCHEDLAT) && !defined(CONFIG_DISABLE_PTHREAD)
+      /* Measure ready-to-run list latency versus the number of tasks */
+
+      printf("\nuser_main: scheduler latency benchmark\n");
+      schedlat_test();
+      check_test_memory_usage();
+#endif
+
 #if defined(CONFIG_PRIORITY_INHERITANCE) && !defined(CONFIG_DISABLE_SIGNALS) && !defined(CONFIG_DISABLE_PTHREAD)
       /* Verify priority inheritance */
 
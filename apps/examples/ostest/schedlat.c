@@ -0,0 +1,249 @@
+/****************************************************************************
+ * examples/ostest/schedlat.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include <apps/benchmark.h>
+
+#include "ostest.h"
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+/* Each measurement moves the probe thread this many times */
+
+#define SCHEDLAT_NLOOPS 10000
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static pthread_t g_background[CONFIG_EXAMPLES_OSTEST_SCHEDLAT_NTHREADS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: schedlat_thread
+ *
+ * Description:
+ *   Background and probe threads do nothing.  They are created ready-to-run
+ *   but cannot run until the measuring thread gives up the CPU.
+ *
+ ****************************************************************************/
+
+static void *schedlat_thread(void *parameter)
+{
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: schedlat_create
+ ****************************************************************************/
+
+static int schedlat_create(pthread_t *thread, int priority)
+{
+  struct sched_param sparam;
+  pthread_attr_t attr;
+  int status;
+
+  status = pthread_attr_init(&attr);
+  if (status == OK)
+    {
+      sparam.sched_priority = priority;
+      status = pthread_attr_setschedparam(&attr, &sparam);
+    }
+
+  if (status == OK)
+    {
+      status = pthread_attr_setstacksize(&attr, STACKSIZE);
+    }
+
+  if (status == OK)
+    {
+      status = pthread_create(thread, &attr, schedlat_thread, NULL);
+    }
+
+  if (status != OK)
+    {
+      printf("schedlat_test: ERROR failed to create thread: %d\n", status);
+    }
+
+  return status;
+}
+
+/****************************************************************************
+ * Name: schedlat_measure
+ *
+ * Description:
+ *   Move the probe thread back and forth between two priorities below the
+ *   nthreads background threads.  Each move removes the probe from the
+ *   ready-to-run list and inserts it again behind all of the background
+ *   threads.
+ *
+ ****************************************************************************/
+
+static void schedlat_measure(int nthreads, pthread_t probe, int probeprio)
+{
+  struct sched_param sparam;
+  struct timespec start;
+  unsigned long elapsed;
+  int i;
+
+  bench_start(&start);
+
+  for (i = 0; i < SCHEDLAT_NLOOPS; i++)
+    {
+      sparam.sched_priority = probeprio + (i & 1);
+      (void)pthread_setschedparam(probe, SCHED_FIFO, &sparam);
+    }
+
+  elapsed = bench_elapsed_usec(&start);
+
+  printf("schedlat_test: %3d ready tasks: %lu usec for %d reprioritizations "
+         "(%lu nsec each)\n",
+         nthreads, elapsed, SCHEDLAT_NLOOPS,
+         (elapsed * 1000) / SCHEDLAT_NLOOPS);
+  FFLUSH();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: schedlat_test
+ *
+ * Description:
+ *   Measure the cost of making a thread ready-to-run as a function of the
+ *   number of ready-to-run threads of higher priority.  With the linear
+ *   ready-to-run list this grows with the thread count; with
+ *   CONFIG_SCHED_PRIOBITMAP it should stay flat.
+ *
+ ****************************************************************************/
+
+void schedlat_test(void)
+{
+  struct sched_param sparam;
+  pthread_addr_t result;
+  pthread_t probe;
+  int oldpolicy;
+  int highprio;
+  int bgprio;
+  int probeprio;
+  int nthreads;
+  int ncreated;
+  int status;
+  int i;
+
+#ifdef CONFIG_SCHED_PRIOBITMAP
+  printf("schedlat_test: Using the priority bitmap ready-to-run list\n");
+#else
+  printf("schedlat_test: Using the linear ready-to-run list\n");
+#endif
+
+  /* Run the measuring thread at a higher priority than all of the other
+   * threads so that none of them can run until we are finished.
+   */
+
+  status = pthread_getschedparam(pthread_self(), &oldpolicy, &sparam);
+  if (status != OK)
+    {
+      printf("schedlat_test: ERROR pthread_getschedparam failed: %d\n",
+             status);
+      return;
+    }
+
+  highprio  = sched_get_priority_max(SCHED_FIFO) - 1;
+  bgprio    = highprio - 10;
+  probeprio = bgprio - 10;
+
+  for (nthreads = 0;
+       nthreads <= CONFIG_EXAMPLES_OSTEST_SCHEDLAT_NTHREADS;
+       nthreads = nthreads ? nthreads << 1 : 1)
+    {
+      struct sched_param highparam;
+
+      highparam.sched_priority = highprio;
+      (void)pthread_setschedparam(pthread_self(), SCHED_FIFO, &highparam);
+
+      /* Create the probe and the background threads.  None of them will run
+       * yet.
+       */
+
+      if (schedlat_create(&probe, probeprio) != OK)
+        {
+          break;
+        }
+
+      for (ncreated = 0; ncreated < nthreads; ncreated++)
+        {
+          if (schedlat_create(&g_background[ncreated], bgprio) != OK)
+            {
+              break;
+            }
+        }
+
+      schedlat_measure(ncreated, probe, probeprio);
+
+      /* Restore our priority so that the threads can run and exit */
+
+      (void)pthread_setschedparam(pthread_self(), oldpolicy, &sparam);
+
+      for (i = 0; i < ncreated; i++)
+        {
+          (void)pthread_join(g_background[i], &result);
+        }
+
+      (void)pthread_join(probe, &result);
+
+      if (ncreated < nthreads)
+        {
+          break;
+        }
+    }
+
+  printf("schedlat_test: Done\n");
+}
@@ -70,5 +70,6 @@
 extern int transfer_test(int fdin, int fdout);
 extern int interlock_test(void);
 extern int redirection_test(void);
+extern int throughput_test(void);
 
 #endif /* __EXAMPLES_PIPE_PIPE_H */
@@ -0,0 +1,252 @@
+/****************************************************************************
+ * examples/pipe/throughput_test.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/ioctl.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <errno.h>
+
+#include <nuttx/fs/ioctl.h>
+
+#include <apps/benchmark.h>
+
+#include "pipe.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_PIPE_THROUGHPUT_NBYTES
+#  define CONFIG_EXAMPLES_PIPE_THROUGHPUT_NBYTES (256*1024)
+#endif
+
+#define THROUGHPUT_MAXXFR 1024
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct throughput_s
+{
+  int    fd;      /* The write end of the pipe */
+  size_t xfrsize; /* The size of each write */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The pipe buffer sizes to test.  Zero means the default size. */
+
+static const size_t g_pipesizes[] = { 0, 256, 4096 };
+
+/* The sizes of each read() and write() */
+
+static const size_t g_xfrsizes[] = { 1, 16, 128, THROUGHPUT_MAXXFR };
+
+static char g_wrbuffer[THROUGHPUT_MAXXFR];
+static char g_rdbuffer[THROUGHPUT_MAXXFR];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: throughput_writer
+ ****************************************************************************/
+
+static void *throughput_writer(pthread_addr_t pvarg)
+{
+  FAR struct throughput_s *parms = (FAR struct throughput_s *)pvarg;
+  size_t nbytes;
+  ssize_t ret;
+
+  for (nbytes = 0; nbytes < CONFIG_EXAMPLES_PIPE_THROUGHPUT_NBYTES; )
+    {
+      ret = write(parms->fd, g_wrbuffer, parms->xfrsize);
+      if (ret < 0)
+        {
+          fprintf(stderr, "throughput_writer: write failed, errno=%d\n", errno);
+          return (void*)1;
+        }
+
+      nbytes += ret;
+    }
+
+  return (void*)0;
+}
+
+/****************************************************************************
+ * Name: throughput_run
+ *
+ * Description:
+ *   Transfer CONFIG_EXAMPLES_PIPE_THROUGHPUT_NBYTES through a new pipe with
+ *   the given pipe buffer size and read/write size.  Returns the elapsed
+ *   time in milliseconds or a negative value on failure.
+ *
+ ****************************************************************************/
+
+static int throughput_run(size_t pipesize, size_t xfrsize)
+{
+  struct throughput_s parms;
+  struct timespec start;
+  pthread_t writerid;
+  unsigned long elapsed;
+  void *value;
+  size_t nbytes;
+  ssize_t nread;
+  int fd[2];
+  int ret;
+
+  ret = pipe(fd);
+  if (ret < 0)
+    {
+      fprintf(stderr, "throughput_run: pipe failed with errno=%d\n", errno);
+      return -1;
+    }
+
+  /* Set the pipe buffer size */
+
+  if (pipesize > 0)
+    {
+      ret = ioctl(fd[1], PIPEIOC_SETSIZE, (unsigned long)pipesize);
+      if (ret < 0)
+        {
+          fprintf(stderr, "throughput_run: PIPEIOC_SETSIZE failed, errno=%d\n",
+                  errno);
+          goto errout_with_pipe;
+        }
+    }
+
+  /* Start the writer thread, then read everything that it writes */
+
+  parms.fd      = fd[1];
+  parms.xfrsize = xfrsize;
+
+  bench_start(&start);
+  ret = pthread_create(&writerid, NULL, throughput_writer, (pthread_addr_t)&parms);
+  if (ret != 0)
+    {
+      fprintf(stderr, "throughput_run: Failed to create writer thread, error=%d\n",
+              ret);
+      ret = -1;
+      goto errout_with_pipe;
+    }
+
+  for (nbytes = 0; nbytes < CONFIG_EXAMPLES_PIPE_THROUGHPUT_NBYTES; )
+    {
+      nread = read(fd[0], g_rdbuffer, xfrsize);
+      if (nread <= 0)
+        {
+          fprintf(stderr, "throughput_run: read failed, errno=%d\n", errno);
+          break;
+        }
+
+      nbytes += nread;
+    }
+
+  ret = pthread_join(writerid, &value);
+  elapsed = bench_elapsed(&start);
+
+  if (ret != 0 || (int)value != 0 ||
+      nbytes != CONFIG_EXAMPLES_PIPE_THROUGHPUT_NBYTES)
+    {
+      fprintf(stderr, "throughput_run: Transfer failed\n");
+      ret = -1;
+      goto errout_with_pipe;
+    }
+
+  ret = (int)elapsed;
+
+errout_with_pipe:
+  (void)close(fd[0]);
+  (void)close(fd[1]);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: throughput_test
+ ****************************************************************************/
+
+int throughput_test(void)
+{
+  unsigned long kbps;
+  int msec;
+  int i;
+  int j;
+
+  printf("throughput_test: Transferring %d bytes per test\n",
+         CONFIG_EXAMPLES_PIPE_THROUGHPUT_NBYTES);
+  printf("  Pipe size  Xfr size  msec      KB/sec\n");
+
+  for (i = 0; i < sizeof(g_pipesizes) / sizeof(g_pipesizes[0]); i++)
+    {
+      for (j = 0; j < sizeof(g_xfrsizes) / sizeof(g_xfrsizes[0]); j++)
+        {
+          msec = throughput_run(g_pipesizes[i], g_xfrsizes[j]);
+          if (msec < 0)
+            {
+              return 1;
+            }
+
+          kbps = msec > 0 ?
+            (unsigned long)CONFIG_EXAMPLES_PIPE_THROUGHPUT_NBYTES / msec : 0;
+
+          if (g_pipesizes[i] > 0)
+            {
+              printf("  %9d", g_pipesizes[i]);
+            }
+          else
+            {
+              printf("    default");
+            }
+
+          printf("  %8d  %8d  %6lu\n", g_xfrsizes[j], msec, kbps);
+        }
+    }
+
+  return 0;
+}
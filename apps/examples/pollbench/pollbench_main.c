@@ -0,0 +1,306 @@
+/****************************************************************************
+ * examples/pollbench/pollbench_main.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <poll.h>
+#include <errno.h>
+
+#include <sys/epoll.h>
+
+#include <apps/benchmark.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_POLLBENCH_MAXFDS
+#  define CONFIG_EXAMPLES_POLLBENCH_MAXFDS 256
+#endif
+
+#ifndef CONFIG_EXAMPLES_POLLBENCH_MSEC
+#  define CONFIG_EXAMPLES_POLLBENCH_MSEC 500
+#endif
+
+#define POLLBENCH_FIFOFMT   "/dev/pollbench%d"
+
+/* Check the time after this many wakeups */
+
+#define POLLBENCH_CHECKWAKEUPS 64
+
+#define NSIZES (sizeof(g_nfds) / sizeof(g_nfds[0]))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const int g_nfds[] = { 8, 64, 256 };
+
+static int g_fd[CONFIG_EXAMPLES_POLLBENCH_MAXFDS];
+static struct pollfd g_pollset[CONFIG_EXAMPLES_POLLBENCH_MAXFDS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pollbench_open
+ *
+ * Description:
+ *   Create and open 'nfds' FIFOs.  Each is opened read/write so that one
+ *   descriptor can be used both to raise and to consume an event.  A FIFO
+ *   left over from an earlier run is re-used:  FIFOs cannot be unlinked
+ *   from the pseudo file system.  Returns the number of FIFOs opened.
+ *
+ ****************************************************************************/
+
+static int pollbench_open(int nfds)
+{
+  char path[32];
+  int ret;
+  int i;
+
+  for (i = 0; i < nfds; i++)
+    {
+      snprintf(path, sizeof(path), POLLBENCH_FIFOFMT, i);
+      ret = mkfifo(path, 0666);
+      if (ret < 0 && ret != -EEXIST)
+        {
+          printf("pollbench: mkfifo(%s) failed: %d\n", path, ret);
+          break;
+        }
+
+      g_fd[i] = open(path, O_RDWR);
+      if (g_fd[i] < 0)
+        {
+          printf("pollbench: open(%s) failed: %d\n", path, errno);
+          break;
+        }
+
+      g_pollset[i].fd     = g_fd[i];
+      g_pollset[i].events = POLLIN;
+    }
+
+  return i;
+}
+
+/****************************************************************************
+ * Name: pollbench_close
+ ****************************************************************************/
+
+static void pollbench_close(int nfds)
+{
+  int i;
+
+  for (i = 0; i < nfds; i++)
+    {
+      (void)close(g_fd[i]);
+    }
+}
+
+/****************************************************************************
+ * Name: pollbench_run
+ *
+ * Description:
+ *   Repeatedly make one of the 'nfds' FIFOs readable, wait for it with
+ *   poll() (epfd < 0) or epoll_wait() (epfd >= 0) and consume the byte.
+ *   The FIFOs are made readable in turn so that the ready descriptor is
+ *   at every position in the set.  Returns the number of wakeups per
+ *   second (or 0 on a failure).
+ *
+ ****************************************************************************/
+
+static unsigned long pollbench_run(int nfds, int epfd)
+{
+  struct epoll_event ev;
+  struct timespec start;
+  unsigned long nwakeups = 0;
+  unsigned long msec;
+  uint8_t byte = 0;
+  int ready = 0;
+  int ndx;
+  int ret;
+  int i;
+
+  bench_start(&start);
+
+  do
+    {
+      for (i = 0; i < POLLBENCH_CHECKWAKEUPS; i++)
+        {
+          if (write(g_fd[ready], &byte, 1) != 1)
+            {
+              printf("pollbench: write failed: %d\n", errno);
+              return 0;
+            }
+
+          if (epfd < 0)
+            {
+              ret = poll(g_pollset, nfds, -1);
+              ndx = ready;
+              if (ret != 1 || g_pollset[ndx].revents != POLLIN)
+                {
+                  printf("pollbench: poll returned %d: %d\n", ret, errno);
+                  return 0;
+                }
+            }
+          else
+            {
+              ret = epoll_wait(epfd, &ev, 1, -1);
+              ndx = ev.data.fd;
+              if (ret != 1 || ndx != ready)
+                {
+                  printf("pollbench: epoll_wait returned %d: %d\n",
+                         ret, errno);
+                  return 0;
+                }
+            }
+
+          if (read(g_fd[ndx], &byte, 1) != 1)
+            {
+              printf("pollbench: read failed: %d\n", errno);
+              return 0;
+            }
+
+          if (++ready >= nfds)
+            {
+              ready = 0;
+            }
+        }
+
+      nwakeups += i;
+      msec      = bench_elapsed(&start);
+    }
+  while (msec < CONFIG_EXAMPLES_POLLBENCH_MSEC);
+
+  return bench_rate(nwakeups, msec);
+}
+
+/****************************************************************************
+ * Name: pollbench_epoll
+ *
+ * Description:
+ *   Register the FIFOs with a new epoll instance and run the epoll_wait()
+ *   measurement.
+ *
+ ****************************************************************************/
+
+static unsigned long pollbench_epoll(int nfds)
+{
+  struct epoll_event ev;
+  unsigned long rate = 0;
+  int epfd;
+  int i;
+
+  epfd = epoll_create(nfds);
+  if (epfd < 0)
+    {
+      printf("pollbench: epoll_create failed: %d\n", errno);
+      return 0;
+    }
+
+  for (i = 0; i < nfds; i++)
+    {
+      /* Index into g_fd[] */
+
+      ev.events  = EPOLLIN;
+      ev.data.fd = i;
+
+      if (epoll_ctl(epfd, EPOLL_CTL_ADD, g_fd[i], &ev) < 0)
+        {
+          printf("pollbench: epoll_ctl failed: %d\n", errno);
+          break;
+        }
+    }
+
+  if (i == nfds)
+    {
+      rate = pollbench_run(nfds, epfd);
+    }
+
+  while (--i >= 0)
+    {
+      (void)epoll_ctl(epfd, EPOLL_CTL_DEL, g_fd[i], NULL);
+    }
+
+  (void)close(epfd);
+  return rate;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * pollbench_main
+ ****************************************************************************/
+
+int pollbench_main(int argc, char *argv[])
+{
+  unsigned long pollps;
+  unsigned long epollps;
+  int nfifos;
+  int nfds;
+  int i;
+
+  printf("pollbench: Wakeups per second with one ready descriptor\n\n");
+  printf("   nfds        poll  epoll_wait\n");
+
+  /* The FIFOs are opened once.  Each size uses the first 'nfds' of them. */
+
+  nfifos = pollbench_open(CONFIG_EXAMPLES_POLLBENCH_MAXFDS);
+
+  for (i = 0; i < NSIZES && g_nfds[i] <= nfifos; i++)
+    {
+      nfds    = g_nfds[i];
+      pollps  = pollbench_run(nfds, -1);
+      epollps = pollbench_epoll(nfds);
+      printf("  %5d  %10lu  %10lu\n", nfds, pollps, epollps);
+    }
+
+  pollbench_close(nfifos);
+  return 0;
+}
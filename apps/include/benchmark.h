@@ -0,0 +1,128 @@
+/****************************************************************************
+ * apps/include/benchmark.h
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_INCLUDE_BENCHMARK_H
+#define __APPS_INCLUDE_BENCHMARK_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <time.h>
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/* The benchmark examples time their runs with these helpers.
+ * CLOCK_MONOTONIC is used where it is available so that the measurement is
+ * not disturbed if CLOCK_REALTIME is set while the benchmark runs.
+ */
+
+#ifdef CLOCK_MONOTONIC
+#  define BENCH_CLOCK CLOCK_MONOTONIC
+#else
+#  define BENCH_CLOCK CLOCK_REALTIME
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_start
+ *
+ * Description:
+ *   Record the start time of a measurement in 'start'.
+ *
+ ****************************************************************************/
+
+static inline void bench_start(FAR struct timespec *start)
+{
+  (void)clock_gettime(BENCH_CLOCK, start);
+}
+
+/****************************************************************************
+ * Name: bench_elapsed
+ *
+ * Description:
+ *   Return the number of milliseconds since 'start'.
+ *
+ ****************************************************************************/
+
+static inline unsigned long bench_elapsed(FAR const struct timespec *start)
+{
+  struct timespec now;
+
+  (void)clock_gettime(BENCH_CLOCK, &now);
+  return (now.tv_sec - start->tv_sec) * 1000 +
+         (now.tv_nsec - start->tv_nsec) / 1000000;
+}
+
+/****************************************************************************
+ * Name: bench_elapsed_usec
+ *
+ * Description:
+ *   Return the number of microseconds since 'start'.
+ *
+ ****************************************************************************/
+
+static inline unsigned long
+bench_elapsed_usec(FAR const struct timespec *start)
+{
+  struct timespec now;
+
+  (void)clock_gettime(BENCH_CLOCK, &now);
+  return (now.tv_sec - start->tv_sec) * 1000000 +
+         (now.tv_nsec - start->tv_nsec) / 1000;
+}
+
+/****************************************************************************
+ * Name: bench_rate
+ *
+ * Description:
+ *   Return the number of events per second given 'n' events in 'msec'
+ *   milliseconds.  Avoid overflowing n * 1000.
+ *
+ ****************************************************************************/
+
+static inline unsigned long bench_rate(unsigned long n, unsigned long msec)
+{
+  return msec > 0 ? (n / msec) * 1000 + ((n % msec) * 1000) / msec : 0;
+}
+
+#endif /* __APPS_INCLUDE_BENCHMARK_H */
@@ -267,6 +267,11 @@ static inline void uip_statistics(FAR struct nsh_vtbl_s *vtbl)
 #endif
   nsh_output(vtbl, "\n");
 #endif
+
+#ifdef CONFIG_NET_ARP
+  nsh_output(vtbl, "ARP  Hits: %04x Misses: %04x Evicted: %04x\n",
+             uip_stat.arp.hit, uip_stat.arp.miss, uip_stat.arp.evict);
+#endif
   nsh_output(vtbl, "\n");
 }
 #else
@@ -98,7 +98,11 @@ void up_idle(void)
    * Hopefully, something will wake up.
    */
 
+#ifdef CONFIG_SCHED_TICKLESS
+  up_timer_update();
+#else
   sched_process_timer();
+#endif
 
   /* Run the network if enabled */
 
@@ -153,6 +153,12 @@ extern volatile int g_eventloop;
 extern int  up_setjmp(int *jb);
 extern void up_longjmp(int *jb, int val) noreturn_function;
 
+/* up_tickless.c **********************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+extern void up_timer_update(void);
+#endif
+
 /* up_devconsole.c ********************************************************/
 
 extern void up_devconsole(void);
@@ -167,6 +173,12 @@ extern char *up_deviceimage(void);
 extern size_t up_hostread(void *buffer, size_t len);
 extern size_t up_hostwrite(const void *buffer, size_t len);
 
+/* up_hostclock.c *********************************************************/
+
+#ifdef CONFIG_CLOCK_HIRES
+extern void up_hostclock(unsigned long *sec, unsigned long *nsec);
+#endif
+
 /* up_netdev.c ************************************************************/
 
 #ifdef CONFIG_NET
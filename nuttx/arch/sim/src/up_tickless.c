@@ -0,0 +1,116 @@
+/****************************************************************************
+ * arch/sim/src/up_tickless.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/arch.h>
+
+#include "up_internal.h"
+
+#ifdef CONFIG_SCHED_TICKLESS
+
+/****************************************************************************
+ * Private Definitions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The simulated free-running tick counter and one-shot timer */
+
+static uint32_t g_simticks;
+static uint32_t g_simdeadline;
+static bool     g_simarmed;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_timer_gettick
+ *
+ * Description:
+ *   Return the simulated free-running tick count.
+ *
+ ****************************************************************************/
+
+uint32_t up_timer_gettick(void)
+{
+  return g_simticks;
+}
+
+/****************************************************************************
+ * Name: up_timer_start
+ *
+ * Description:
+ *   Program the simulated one-shot timer to expire 'ticks' ticks from now.
+ *   Zero cancels the expiration.
+ *
+ ****************************************************************************/
+
+void up_timer_start(uint32_t ticks)
+{
+  g_simdeadline = g_simticks + ticks;
+  g_simarmed    = (ticks != 0);
+}
+
+/****************************************************************************
+ * Name: up_timer_update
+ *
+ * Description:
+ *   Called from the IDLE loop to advance the simulated time by one tick.
+ *   The OS is only notified when the programmed expiration is reached.
+ *
+ ****************************************************************************/
+
+void up_timer_update(void)
+{
+  g_simticks++;
+  if (g_simarmed && g_simticks == g_simdeadline)
+    {
+      g_simarmed = false;
+      sched_timer_expiration();
+    }
+}
+
+#endif /* CONFIG_SCHED_TICKLESS */
@@ -56,6 +56,7 @@
 #include <nuttx/net/uip/uip.h>
 #include <nuttx/net/uip/uip-arch.h>
 #include <nuttx/net/uip/uip-arp.h>
+#include <nuttx/net/iob.h>
 
 #include "up_internal.h"
 
@@ -65,6 +66,16 @@
 
 #define BUF ((struct ether_header*)g_sim_dev.d_buf)
 
+/* With CONFIG_NET_MULTIBUFFER, the driver provides the packet buffer.  If
+ * an I/O buffer can hold a whole packet, packets are received directly into
+ * an I/O buffer so that TCP can keep the received data without copying it.
+ */
+
+#if defined(CONFIG_NET_MULTIBUFFER) && defined(CONFIG_NET_IOB) && \
+    CONFIG_IOB_BUFSIZE >= CONFIG_NET_BUFSIZE + CONFIG_NET_GUARDSIZE
+#  define SIM_RXIOB 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -86,6 +97,12 @@ struct timer
 static struct timer g_periodic_timer;
 static struct uip_driver_s g_sim_dev;
 
+#ifdef CONFIG_NET_MULTIBUFFER
+/* The packet buffer used when no I/O buffer is available */
+
+static uint8_t g_pktbuf[CONFIG_NET_BUFSIZE + CONFIG_NET_GUARDSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -115,6 +132,34 @@ static inline int up_comparemac(uint8_t *paddr1, struct ether_addr *paddr2)
 }
 #endif
 
+#ifdef CONFIG_NET_MULTIBUFFER
+static void sim_setbuffer(void)
+{
+#ifdef SIM_RXIOB
+  /* Get a new I/O buffer if TCP kept the last one */
+
+  if (!g_sim_dev.d_iob)
+    {
+      g_sim_dev.d_iob = iob_tryalloc();
+    }
+
+  if (g_sim_dev.d_iob)
+    {
+      g_sim_dev.d_buf = g_sim_dev.d_iob->io_data;
+      return;
+    }
+#endif
+
+  /* Otherwise, receive into the driver's own buffer.  The data will then be
+   * copied if it has to be buffered.
+   */
+
+  g_sim_dev.d_buf = g_pktbuf;
+}
+#else
+#  define sim_setbuffer()
+#endif
+
 static int sim_uiptxpoll(struct uip_driver_s *dev)
 {
   /* If the polling resulted in data that should be sent out on the network,
@@ -140,6 +185,10 @@ static int sim_uiptxpoll(struct uip_driver_s *dev)
 
 void uipdriver_loop(void)
 {
+  /* Make sure that there is a buffer to receive into */
+
+  sim_setbuffer();
+
   /* netdev_read will return 0 on a timeout event and >0 on a data received event */
 
   g_sim_dev.d_len = netdev_read((unsigned char*)g_sim_dev.d_buf, CONFIG_NET_BUFSIZE);
@@ -213,6 +262,7 @@ int uipdriver_init(void)
 
   timer_set(&g_periodic_timer, 500);
   netdev_init();
+  sim_setbuffer();
 
   /* Register the device with the OS so that socket IOCTLs can be performed */
 
@@ -52,24 +52,51 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_BCH_NCACHED
+#  define CONFIG_BCH_NCACHED 1
+#endif
+
+#if CONFIG_BCH_NCACHED < 1
+#  error CONFIG_BCH_NCACHED must be at least 1
+#endif
+
 #define bchlib_semgive(d) sem_post(&(d)->sem)  /* To match bchlib_semtake */
 #define MAX_OPENCNT     (255)                  /* Limit of uint8_t */
+#define BCH_NOSECTOR    ((size_t)-1)           /* Cache entry is not in use */
 
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* One entry in the sector cache */
+
+struct bch_cache_s
+{
+  size_t   sector;     /* The sector in the buffer (BCH_NOSECTOR if none) */
+  uint32_t lastuse;    /* Value of bchlib_s::usecount at the last access */
+  bool  dirty;         /* Data has been written to the buffer */
+  FAR uint8_t *buffer; /* One sector buffer */
+};
+
 struct bchlib_s
 {
   struct inode *inode; /* I-node of the block driver */
   sem_t    sem;        /* For atomic accesses to this structure */
   size_t   nsectors;   /* Number of sectors supported by the device */
-  size_t   sector;     /* The current sector in the buffer */
+  uint32_t usecount;   /* Incremented on each cache access (for LRU) */
   uint16_t sectsize;   /* The size of one sector on the device */
   uint8_t  refs;       /* Number of references */
-  bool  dirty;         /* Data has been written to the buffer */
   bool  readonly;      /* true:  Only read operations are supported */
-  FAR uint8_t *buffer; /* One sector buffer */
+  FAR uint8_t *buffer; /* Allocated memory for all sector buffers */
+
+  /* A least-recently-used cache of CONFIG_BCH_NCACHED sectors.  Partial
+   * sector accesses go through the cache; whole sectors are transferred
+   * directly between the caller's buffer and the block driver.
+   */
+
+  struct bch_cache_s cache[CONFIG_BCH_NCACHED];
 };
 
 /****************************************************************************
@@ -91,8 +118,13 @@ EXTERN const struct file_operations bch_fops;
  ****************************************************************************/
 
 EXTERN void bchlib_semtake(FAR struct bchlib_s *bch);
-EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch);
-EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN int  bchlib_flushcache(FAR struct bchlib_s *bch);
+EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector,
+                              FAR struct bch_cache_s **entry);
+EXTERN void bchlib_mergecache(FAR struct bchlib_s *bch, FAR uint8_t *buffer,
+                              size_t sector, size_t nsectors);
+EXTERN void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector,
+                              size_t nsectors);
 
 #undef EXTERN
 #if defined(__cplusplus)
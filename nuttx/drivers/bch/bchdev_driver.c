@@ -148,7 +148,7 @@ static int bch_close(FAR struct file *filep)
   /* Flush any dirty pages remaining in the cache */
 
   bchlib_semtake(bch);
-  (void)bchlib_flushsector(bch);
+  (void)bchlib_flushcache(bch);
 
   /* Decrement the reference count (I don't use bchlib_decref() because I
    * want the entire close operation to be atomic wrt other driver operations.
@@ -249,6 +249,14 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
       bchlib_semgive(bch);
     }
+  else if (cmd == BIOC_FLUSH)
+    {
+      /* Write all dirty sectors in the cache back to the block driver */
+
+      bchlib_semtake(bch);
+      ret = bchlib_flushcache(bch);
+      bchlib_semgive(bch);
+    }
 
   return ret;
 }
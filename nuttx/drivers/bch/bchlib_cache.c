@@ -40,7 +40,9 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -65,69 +67,246 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: bchlib_findsector
+ *
+ * Description:
+ *   Return the cache entry that holds 'sector' or NULL if the sector is not
+ *   in the cache.
+ *
+ ****************************************************************************/
+
+static FAR struct bch_cache_s *bchlib_findsector(FAR struct bchlib_s *bch,
+                                                 size_t sector)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_BCH_NCACHED; i++)
+    {
+      if (bch->cache[i].sector == sector)
+        {
+          return &bch->cache[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: bchlib_victim
+ *
+ * Description:
+ *   Select the cache entry to be re-used:  An unused entry if there is one;
+ *   otherwise the least recently used entry.
+ *
+ ****************************************************************************/
+
+static FAR struct bch_cache_s *bchlib_victim(FAR struct bchlib_s *bch)
+{
+  FAR struct bch_cache_s *victim = &bch->cache[0];
+  uint32_t maxage = 0;
+  uint32_t age;
+  int i;
+
+  for (i = 0; i < CONFIG_BCH_NCACHED; i++)
+    {
+      if (bch->cache[i].sector == BCH_NOSECTOR)
+        {
+          return &bch->cache[i];
+        }
+
+      /* The age calculation is immune to wrap-around of usecount */
+
+      age = bch->usecount - bch->cache[i].lastuse;
+      if (age > maxage)
+        {
+          maxage = age;
+          victim = &bch->cache[i];
+        }
+    }
+
+  return victim;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: bchlib_flushsector
+ * Name: bchlib_flushcache
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Write all dirty sectors in the cache to the block driver.  Sectors are
+ *   written in ascending order and consecutive dirty sectors whose buffers
+ *   are also consecutive in memory are written with a single call to the
+ *   block driver.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
  *
  ****************************************************************************/
 
-int bchlib_flushsector(FAR struct bchlib_s *bch)
+int bchlib_flushcache(FAR struct bchlib_s *bch)
 {
-  FAR struct inode *inode;
+  FAR struct inode *inode = bch->inode;
+  FAR struct bch_cache_s *first;
+  FAR struct bch_cache_s *next;
+  size_t nsectors;
   ssize_t ret = OK;
+  int i;
 
-  if (bch->dirty)
+  for (;;)
     {
-      inode = bch->inode;
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
+      /* Find the lowest numbered dirty sector */
+
+      first = NULL;
+      for (i = 0; i < CONFIG_BCH_NCACHED; i++)
+        {
+          if (bch->cache[i].dirty &&
+              (!first || bch->cache[i].sector < first->sector))
+            {
+              first = &bch->cache[i];
+            }
+        }
+
+      if (!first)
+        {
+          break;
+        }
+
+      /* Extend the run while the following sector is dirty and its buffer
+       * follows the previous buffer.
+       */
+
+      first->dirty = false;
+      nsectors     = 1;
+
+      while ((next = bchlib_findsector(bch, first->sector + nsectors)) != NULL &&
+             next->dirty &&
+             next->buffer == first->buffer + nsectors * bch->sectsize)
+        {
+          next->dirty = false;
+          nsectors++;
+        }
+
+      ret = inode->u.i_bops->write(inode, first->buffer, first->sector,
+                                   nsectors);
       if (ret < 0)
         {
-          fdbg("Write failed: %d\n");
+          fdbg("Write failed: %d\n", ret);
+          break;
         }
-      bch->dirty = false;
     }
-  return (int)ret;
+
+  return ret < 0 ? (int)ret : OK;
 }
 
 /****************************************************************************
  * Name: bchlib_readsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Make sure that 'sector' is in the cache, reading it from the block
+ *   driver if necessary, and return the cache entry that holds it.  If the
+ *   least recently used entry must be re-used and it is dirty, then all
+ *   dirty sectors are flushed first (so that the writes are coalesced).
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
  *
  ****************************************************************************/
 
-int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
+int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector,
+                      FAR struct bch_cache_s **entry)
 {
   FAR struct inode *inode;
-  ssize_t ret = OK;
+  FAR struct bch_cache_s *cache;
+  ssize_t ret;
 
-  if (bch->sector != sector)
+  cache = bchlib_findsector(bch, sector);
+  if (!cache)
     {
-      inode = bch->inode;
+      cache = bchlib_victim(bch);
+      if (cache->dirty)
+        {
+          ret = bchlib_flushcache(bch);
+          if (ret < 0)
+            {
+              return (int)ret;
+            }
+        }
 
-      (void)bchlib_flushsector(bch);
-      bch->sector = (size_t)-1;
+      inode = bch->inode;
+      cache->sector = BCH_NOSECTOR;
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
+      ret = inode->u.i_bops->read(inode, cache->buffer, sector, 1);
       if (ret < 0)
         {
-          fdbg("Read failed: %d\n");
+          fdbg("Read failed: %d\n", ret);
+          return (int)ret;
+        }
+
+      cache->sector = sector;
+    }
+
+  cache->lastuse = ++bch->usecount;
+  *entry = cache;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_mergecache
+ *
+ * Description:
+ *   'buffer' holds 'nsectors' sectors, beginning with 'sector', that were
+ *   read directly from the block driver.  Replace any of those sectors that
+ *   are dirty in the cache with the more recent cached data.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_mergecache(FAR struct bchlib_s *bch, FAR uint8_t *buffer,
+                       size_t sector, size_t nsectors)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_BCH_NCACHED; i++)
+    {
+      if (bch->cache[i].dirty && bch->cache[i].sector >= sector &&
+          bch->cache[i].sector < sector + nsectors)
+        {
+          memcpy(&buffer[(bch->cache[i].sector - sector) * bch->sectsize],
+                 bch->cache[i].buffer, bch->sectsize);
         }
-      bch->sector = sector;
     }
-  return (int)ret;
 }
 
+/****************************************************************************
+ * Name: bchlib_invalidate
+ *
+ * Description:
+ *   'nsectors' sectors, beginning with 'sector', were written directly to
+ *   the block driver.  Discard any cached copies of those sectors (dirty or
+ *   not) since the data on the media is now more recent.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector,
+                       size_t nsectors)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_BCH_NCACHED; i++)
+    {
+      if (bch->cache[i].sector >= sector &&
+          bch->cache[i].sector < sector + nsectors)
+        {
+          bch->cache[i].sector = BCH_NOSECTOR;
+          bch->cache[i].dirty  = false;
+        }
+    }
+}
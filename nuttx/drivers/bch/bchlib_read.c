@@ -82,6 +82,7 @@
 ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t len)
 {
   FAR struct bchlib_s *bch = (FAR struct bchlib_s *)handle;
+  FAR struct bch_cache_s *cache;
   size_t   nsectors;
   size_t   sector;
   uint16_t sectoffset;
@@ -113,9 +114,13 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
   bytesread = 0;
   if (sectoffset > 0)
     {
-      /* Read the sector into the sector buffer */
+      /* Read the sector into the sector cache */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, &cache);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the tail end of the sector to the user buffer */
 
@@ -128,7 +133,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
           nbytes = len;
         }
 
-      memcpy(buffer, &bch->buffer[sectoffset], nbytes);
+      memcpy(buffer, &cache->buffer[sectoffset], nbytes);
 
       /* Adjust pointers and counts */
 
@@ -146,7 +151,9 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
     }
 
   /* Then read all of the full sectors following the partial sector directly
-   * into the user buffer.
+   * into the user buffer, bypassing the sector cache.  Any of those sectors
+   * that have been modified in the cache, but not yet written back, must
+   * then be replaced with the cached data.
    */
 
   if (len >= bch->sectsize )
@@ -161,10 +168,12 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
                                        sector, nsectors);
       if (ret < 0)
         {
-          fdbg("Read failed: %d\n");
+          fdbg("Read failed: %d\n", ret);
           return ret;
         }
 
+      bchlib_mergecache(bch, (FAR uint8_t *)buffer, sector, nsectors);
+
       /* Adjust pointers and counts */
 
       sectoffset = 0;
@@ -186,13 +195,17 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
 
   if (len > 0)
     {
-      /* Read the sector into the sector buffer */
+      /* Read the sector into the sector cache */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, &cache);
+      if (ret < 0)
+        {
+          return bytesread > 0 ? (ssize_t)bytesread : ret;
+        }
 
       /* Copy the head end of the sector to the user buffer */
 
-      memcpy(buffer, bch->buffer, len);
+      memcpy(buffer, cache->buffer, len);
 
       /* Adjust counts */
 
@@ -88,6 +88,7 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
   FAR struct bchlib_s *bch;
   struct geometry geo;
   int ret;
+  int i;
 
   DEBUGASSERT(blkdev);
 
@@ -137,12 +138,14 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
   sem_init(&bch->sem, 0, 1);
   bch->nsectors = geo.geo_nsectors;
   bch->sectsize = geo.geo_sectorsize;
-  bch->sector   = (size_t)-1;
   bch->readonly = readonly;
 
-  /* Allocate the sector I/O buffer */
+  /* Allocate one buffer for all of the sectors in the cache.  The cached
+   * sectors are adjacent in memory so that sequential dirty sectors can be
+   * written back to the block driver in a single transfer.
+   */
 
-  bch->buffer = (FAR uint8_t *)kmalloc(bch->sectsize);
+  bch->buffer = (FAR uint8_t *)kmalloc(CONFIG_BCH_NCACHED * bch->sectsize);
   if (!bch->buffer)
     {
       fdbg("Failed to allocate sector buffer\n");
@@ -150,6 +153,12 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
       goto errout_with_bch;
     }
 
+  for (i = 0; i < CONFIG_BCH_NCACHED; i++)
+    {
+      bch->cache[i].sector = BCH_NOSECTOR;
+      bch->cache[i].buffer = &bch->buffer[i * bch->sectsize];
+    }
+
   *handle = bch;
   return OK;
 
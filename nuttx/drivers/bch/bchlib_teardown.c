@@ -93,7 +93,7 @@ int bchlib_teardown(FAR void *handle)
 
   /* Flush any pending data to the block driver */
 
-  bchlib_flushsector(bch);
+  (void)bchlib_flushcache(bch);
 
   /* Close the block driver */
 
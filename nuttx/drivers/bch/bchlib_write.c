@@ -83,6 +83,7 @@
 ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, size_t len)
 {
   FAR struct bchlib_s *bch = (FAR struct bchlib_s *)handle;
+  FAR struct bch_cache_s *cache;
   size_t   nsectors;
   size_t   sector;
   uint16_t sectoffset;
@@ -112,9 +113,13 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
   byteswritten = 0;
   if (sectoffset > 0)
     {
-      /* Read the full sector into the sector buffer */
+      /* Read the full sector into the sector cache */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, &cache);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the tail end of the sector from the user buffer */
 
@@ -127,26 +132,27 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
           nbytes = len;
         }
 
-      memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
+      memcpy(&cache->buffer[sectoffset], buffer, nbytes);
+      cache->dirty = true;
 
       /* Adjust pointers and counts */
 
       sectoffset    = 0;
       sector++;
+      byteswritten  = nbytes;
 
       if (sector >= bch->nsectors)
         {
-          return nbytes;
+          goto flush;
         }
 
-      byteswritten  = nbytes;
       buffer       += nbytes;
       len          -= nbytes;
     }
 
   /* Then write all of the full sectors following the partial sector
-   * directly from the user buffer.
+   * directly from the user buffer, bypassing the sector cache.  Any cached
+   * copies of those sectors are now stale and must be discarded.
    */
 
   if (len >= bch->sectsize )
@@ -167,6 +173,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
           return ret;
         }
 
+      bchlib_invalidate(bch, sector, nsectors);
+
       /* Adjust pointers and counts */
 
       sectoffset    = 0;
@@ -177,7 +185,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 
       if (sector >= bch->nsectors)
         {
-          return byteswritten;
+          goto flush;
         }
 
       buffer    += nbytes;
@@ -188,28 +196,38 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 
   if (len > 0)
     {
-      /* Read the sector into the sector buffer */
+      /* Read the sector into the sector cache */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, &cache);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the head end of the sector from the user buffer */
 
-      memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
+      memcpy(cache->buffer, buffer, len);
+      cache->dirty = true;
 
       /* Adjust counts */
 
       byteswritten += len;
     }
 
-  /* Finally, flush any cached writes to the device as well */
+  /* Finally, flush any cached writes to the device as well.  With
+   * CONFIG_BCH_WRITEBACK, dirty sectors stay in the cache until they are
+   * evicted, the device is closed, or BIOC_FLUSH is received.
+   */
 
-  ret = bchlib_flushsector(bch);
+flush:
+#ifndef CONFIG_BCH_WRITEBACK
+  ret = bchlib_flushcache(bch);
   if (ret < 0)
     {
       fdbg("Flush failed: %d\n", ret);
       return ret;
     }
+#endif
 
   return byteswritten;
 }
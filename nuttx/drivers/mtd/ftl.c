@@ -60,7 +60,7 @@
  ****************************************************************************/
 
 #if defined(CONFIG_FS_READAHEAD) || (defined(CONFIG_FS_WRITABLE) && defined(CONFIG_FS_WRITEBUFFER))
-#  defined CONFIG_FTL_RWBUFFER 1
+#  define CONFIG_FTL_RWBUFFER 1
 #endif
 
 /****************************************************************************
@@ -522,7 +522,7 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
 
   /* Allocate a FTL device structure */
 
-  dev = (struct ftl_struct_s *)kmalloc(sizeof(struct ftl_struct_s));
+  dev = (struct ftl_struct_s *)kzalloc(sizeof(struct ftl_struct_s));
   if (dev)
     {
       /* Initialize the FTL device structure */
@@ -565,15 +565,18 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
       dev->rwb.blocksize   = dev->geo.blocksize;
       dev->rwb.nblocks     = dev->geo.neraseblocks * dev->blkper;
       dev->rwb.dev         = (FAR void *)dev;
+      dev->rwb.rhreload    = ftl_reload;
+
+#ifdef CONFIG_FS_WRITABLE
+      dev->rwb.wrflush     = ftl_flush;
+#endif
 
 #if defined(CONFIG_FS_WRITABLE) && defined(CONFIG_FS_WRITEBUFFER)
       dev->rwb.wrmaxblocks = dev->blkper;
-      dev->rwb.wrflush     = ftl_flush;
 #endif
 
 #ifdef CONFIG_FS_READAHEAD
       dev->rwb.rhmaxblocks = dev->blkper;
-      dev->rwb.rhreload    = ftl_reload;
 #endif
       ret = rwb_initialize(&dev->rwb);
       if (ret < 0)
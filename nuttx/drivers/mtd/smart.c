@@ -113,10 +113,27 @@
 #  define  CONFIG_MTD_SMART_SECTOR_SIZE 1024
 #endif
 
+#ifndef CONFIG_MTD_SMART_GC_BUDGET
+#  define  CONFIG_MTD_SMART_GC_BUDGET 4
+#endif
+
 #ifndef offsetof
 #define offsetof(type, member) ( (size_t) &( ( (type *) 0)->member))
 #endif
 
+/* The value of an erased 16-bit header field */
+
+#define SMART_ERASED16 \
+  ((uint16_t)((CONFIG_SMARTFS_ERASEDSTATE << 8) | CONFIG_SMARTFS_ERASEDSTATE))
+
+/* Access to the free physical sector bitmap.  A set bit means that the
+ * physical sector is erased and may be allocated.
+ */
+
+#define SMART_FREEMAP_SET(d,s)  ((d)->freemap[(s) >> 3] |= (1 << ((s) & 7)))
+#define SMART_FREEMAP_CLR(d,s)  ((d)->freemap[(s) >> 3] &= ~(1 << ((s) & 7)))
+#define SMART_FREEMAP_TST(d,s)  (((d)->freemap[(s) >> 3] & (1 << ((s) & 7))) != 0)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -131,9 +148,14 @@ struct smart_struct_s
   uint16_t              sectorsPerBlk;    /* Number of sectors per erase block */
   uint16_t              sectorsize;       /* Sector size on device */
   uint16_t              totalsectors;     /* Total number of sectors on device */
+  uint16_t              releasesectors;   /* Total number of released sectors */
+  uint16_t              allocblock;       /* Erase block that sectors are allocated from */
+  uint16_t              gcblock;          /* Erase block being garbage collected */
+  uint16_t              gcsector;         /* Next physical sector to garbage collect */
   FAR uint16_t         *sMap;             /* Virtual to physical sector map */
   FAR uint8_t          *releasecount;     /* Count of released sectors per erase block */
   FAR uint8_t          *freecount;        /* Count of free sectors per erase block */
+  FAR uint8_t          *freemap;          /* Bitmap of free physical sectors */
   FAR char             *rwbuffer;         /* Our sector read/write buffer */
   char                  partname[SMART_PARTNAME_SIZE]; /* Optional partition name */
   uint8_t               formatversion;    /* Format version on the device */
@@ -510,14 +532,15 @@ static int smart_setsectorsize(struct smart_struct_s *dev, uint16_t size)
     }
 
   /* Allocate a virtual to physical sector map buffer.  Also allocate
-   * the storage space for releasecount and freecounts.
+   * the storage space for releasecount and freecounts and for the free
+   * physical sector bitmap.
    */
 
   totalsectors = dev->neraseblocks * dev->sectorsPerBlk;
   dev->totalsectors = (uint16_t) totalsectors;
 
   dev->sMap = (uint16_t *) kmalloc(totalsectors * sizeof(uint16_t) +
-              (dev->neraseblocks << 1));
+              (dev->neraseblocks << 1) + ((totalsectors + 7) >> 3));
   if (!dev->sMap)
     {
       fdbg("Error allocating SMART virtual map buffer\n");
@@ -527,6 +550,12 @@ static int smart_setsectorsize(struct smart_struct_s *dev, uint16_t size)
 
   dev->releasecount = (uint8_t *) dev->sMap + (totalsectors * sizeof(uint16_t));
   dev->freecount = dev->releasecount + dev->neraseblocks;
+  dev->freemap = dev->freecount + dev->neraseblocks;
+
+  /* No erase block is being allocated from or garbage collected */
+
+  dev->allocblock = 0xFFFF;
+  dev->gcblock = 0xFFFF;
 
   /* Allocate a read/write buffer */
 
@@ -672,6 +701,7 @@ static int smart_scan(struct smart_struct_s *dev)
   totalsectors = dev->neraseblocks * dev->sectorsPerBlk;
   dev->formatstatus = SMART_FMT_STAT_NOFMT;
   dev->freesectors = totalsectors;
+  dev->releasesectors = 0;
 
   /* Initialize the freecount and releasecount arrays */
 
@@ -681,6 +711,12 @@ static int smart_scan(struct smart_struct_s *dev)
       dev->releasecount[sector] = 0;
     }
 
+  /* Initialize the free sector bitmap.  Free sectors are added as they are
+   * found.
+   */
+
+  memset(dev->freemap, 0, (totalsectors + 7) >> 3);
+
   /* Initialize the sector map */
 
   for (sector = 0; sector < totalsectors; sector++)
@@ -722,6 +758,25 @@ static int smart_scan(struct smart_struct_s *dev)
       if ((header.status & SMART_STATUS_COMMITTED) ==
               (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED))
         {
+          /* If the header is erased, then the sector is free.  Otherwise,
+           * the sector was written but never committed (power was lost
+           * while relocating it).  It holds no data but can't be used until
+           * it is erased, so count it as released.
+           */
+
+          if (*((uint16_t *) header.logicalsector) == SMART_ERASED16 &&
+              *((uint16_t *) header.seq) == SMART_ERASED16)
+            {
+              SMART_FREEMAP_SET(dev, sector);
+            }
+          else
+            {
+              dev->freecount[sector / dev->sectorsPerBlk]--;
+              dev->freesectors--;
+              dev->releasecount[sector / dev->sectorsPerBlk]++;
+              dev->releasesectors++;
+            }
+
           continue;
         }
 
@@ -740,6 +795,7 @@ static int smart_scan(struct smart_struct_s *dev)
               (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED))
         {
           dev->releasecount[sector / dev->sectorsPerBlk]++;
+          dev->releasesectors++;
           continue;
         }
 
@@ -911,6 +967,16 @@ static int smart_scan(struct smart_struct_s *dev)
               fdbg("Error %d releasing duplicate sector\n", -ret);
               goto err_out;
             }
+
+          dev->releasecount[loser / dev->sectorsPerBlk]++;
+          dev->releasesectors++;
+
+          /* If this sector lost, keep the original mapping */
+
+          if (loser == sector)
+            {
+              continue;
+            }
         }
 
       /* Update the logical to physical sector map */
@@ -1099,6 +1165,7 @@ static inline int smart_llformat(struct smart_struct_s *dev, unsigned long arg)
 
   dev->formatstatus = SMART_FMT_STAT_UNKNOWN;
   dev->freesectors = dev->neraseblocks * dev->sectorsPerBlk - 1;
+  dev->releasesectors = 0;
   for (x = 0; x < dev->neraseblocks; x++)
     {
       /* Initialize the released and free counts */
@@ -1107,15 +1174,20 @@ static inline int smart_llformat(struct smart_struct_s *dev, unsigned long arg)
       dev->freecount[x] = dev->sectorsPerBlk;
     }
 
+  /* All sectors are free in the bitmap */
+
+  totalsectors = dev->neraseblocks * dev->sectorsPerBlk;
+  memset(dev->freemap, 0xFF, (totalsectors + 7) >> 3);
+
   /* Account for the format sector */
 
   dev->freecount[0]--;
+  SMART_FREEMAP_CLR(dev, 0);
 
   /* Now initialize the logical to physical sector map */
 
   dev->sMap[0] = 0;     /* Logical sector zero = physical sector 0 */
 
-  totalsectors = dev->neraseblocks * dev->sectorsPerBlk;
   for (x = 1; x < totalsectors; x++)
     {
       /* Mark all other logical sectors as non-existant */
@@ -1142,7 +1214,15 @@ static inline int smart_llformat(struct smart_struct_s *dev, unsigned long arg)
  * Name: smart_findfreephyssector
  *
  * Description:  Finds a free physical sector based on free and released
- *               count logic, taking into account reserved sectors.
+ *               count logic, taking into account reserved sectors.  The
+ *               sector is removed from the free sector bitmap and the free
+ *               counts.
+ *
+ *               Sectors are allocated from the same erase block until it
+ *               is full.  Only then is the erase block with the most free
+ *               sectors selected to allocate from next.  The free sector
+ *               bitmap locates a free sector without reading the sector
+ *               headers from the device.
  *
  ****************************************************************************/
 
@@ -1150,296 +1230,403 @@ static int smart_findfreephyssector(struct smart_struct_s *dev)
 {
   uint16_t  allocfreecount;
   uint16_t  allocblock;
-  uint16_t  physicalsector;
   uint16_t  x;
-  uint32_t  readaddr;
-  struct    smart_sect_header_s header;
-  int       ret;
+  uint16_t  end;
 
-  /* Determine which erase block we should allocate the new
-   * sector from. This is based on the number of free sectors
-   * available in each erase block. */
+  /* Determine which erase block we should allocate the new sector from.
+   * Keep using the current erase block until it is full or until it is
+   * selected for garbage collection.
+   */
 
-  allocfreecount = 0;
-  allocblock = 0xFFFF;
-  physicalsector = 0xFFFF;
-  for (x = 0; x < dev->neraseblocks; x++)
+  allocblock = dev->allocblock;
+  if (allocblock == 0xFFFF || allocblock == dev->gcblock ||
+      dev->freecount[allocblock] == 0)
     {
-      /* Test if this block has more free blocks than the
-       * currently selected block */
+      /* Select a new block based on the number of free sectors available
+       * in each erase block.  Never allocate from the block that is being
+       * garbage collected.
+       */
 
-      if (dev->freecount[x] > allocfreecount)
+      allocfreecount = 0;
+      allocblock = 0xFFFF;
+      for (x = 0; x < dev->neraseblocks; x++)
         {
-          /* Assign this block to alloc from */
+          /* Test if this block has more free blocks than the
+           * currently selected block */
+
+          if (x != dev->gcblock && dev->freecount[x] > allocfreecount)
+            {
+              /* Assign this block to alloc from */
 
-          allocblock = x;
-          allocfreecount = dev->freecount[x];
+              allocblock = x;
+              allocfreecount = dev->freecount[x];
+            }
         }
-    }
 
-  /* Check if we found an allocblock. */
+      /* Check if we found an allocblock. */
 
-  if (allocblock == 0xFFFF)
-    {
-      /* No free sectors found!  Bug? */
-      return -EIO;
+      if (allocblock == 0xFFFF)
+        {
+          /* No free sectors found!  Bug? */
+
+          fdbg("No free physical sectors\n");
+          return 0xFFFF;
+        }
+
+      dev->allocblock = allocblock;
     }
 
-  /* Now find a free physical sector within this selected
-   * erase block to allocate. */
+  /* Now find a free physical sector within this selected erase block.
+   * Skip over bitmap bytes with no free sectors.
+   */
 
-  for (x = allocblock * dev->sectorsPerBlk;
-          x < (allocblock+1) * dev->sectorsPerBlk; x++)
-    {
-      /* Check if this physical sector is available */
+  x   = allocblock * dev->sectorsPerBlk;
+  end = x + dev->sectorsPerBlk;
 
-      readaddr = x * dev->mtdBlksPerSector * dev->geo.blocksize;
-      ret = MTD_READ(dev->mtd, readaddr, sizeof(struct smart_sect_header_s),
-              (uint8_t *) &header);
-      if (ret != sizeof(struct smart_sect_header_s))
+  while (x < end)
+    {
+      if ((x & 7) == 0 && x + 8 <= end && dev->freemap[x >> 3] == 0)
         {
-          fvdbg("Error reading phys sector %d\n", physicalsector);
-          return -EIO;
+          x += 8;
         }
+      else if (SMART_FREEMAP_TST(dev, x))
+        {
+          /* Allocate this physical sector */
 
-      if ((*((uint16_t *) header.logicalsector) == 0xFFFF) &&
-          (*((uint16_t *) header.seq) == 0xFFFF) &&
-          ((header.status & SMART_STATUS_COMMITTED) ==
-           (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED)))
+          SMART_FREEMAP_CLR(dev, x);
+          dev->freecount[allocblock]--;
+          dev->freesectors--;
+          return x;
+        }
+      else
         {
-          physicalsector = x;
-          break;
+          x++;
         }
     }
 
-  return physicalsector;
+  /* The free count says that there is a free sector, but the bitmap
+   * doesn't agree.  Bug in our code?
+   */
+
+  fdbg("No free sector in erase block %d, freecount=%d\n",
+       allocblock, dev->freecount[allocblock]);
+
+  dev->freesectors -= dev->freecount[allocblock];
+  dev->freecount[allocblock] = 0;
+  return 0xFFFF;
 }
 
 /****************************************************************************
- * Name: smart_garbagecollect
+ * Name: smart_eraseblock
  *
- * Description:  Performs garbage collection if needed.  This is determined
- *               by the count of released sectors relative to free and
- *               total sectors.
+ * Description:  Erases an erase block that holds no live sectors and
+ *               returns all of its sectors to the free pool.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_FS_WRITABLE
-static int smart_garbagecollect(struct smart_struct_s *dev)
+static int smart_eraseblock(struct smart_struct_s *dev, uint16_t block)
 {
-  uint16_t  releasedsectors;
-  uint16_t  collectblock;
-  uint16_t  releasemax;
-  uint16_t  newsector;
-  bool      collect = TRUE;
-  int       x;
-  int       ret;
+  uint16_t  x;
   size_t    offset;
-  struct    smart_sect_header_s *header;
   uint8_t   newstatus;
+  int       ret;
 
-  while (collect)
+  /* Erase the erase block */
+
+  ret = MTD_ERASE(dev->mtd, block, 1);
+  if (ret < 0)
     {
-      collect = FALSE;
+      fdbg("Error %d erasing block %d\n", -ret, block);
+      return ret;
+    }
+
+  /* Update the variables.  All of the sectors in the erase block are now
+   * free.
+   */
 
-      /* Calculate the number of released sectors on the device */
+  dev->freesectors += dev->releasecount[block];
+  dev->releasesectors -= dev->releasecount[block];
+  dev->freecount[block] = dev->sectorsPerBlk;
+  dev->releasecount[block] = 0;
 
-      releasedsectors = 0;
-      collectblock = 0xFFFF;
-      releasemax = 0;
-      for (x = 0; x < dev->neraseblocks; x++)
-        {
-          releasedsectors += dev->releasecount[x];
-          if (dev->releasecount[x] > releasemax)
-            {
-              releasemax = dev->releasecount[x];
-              collectblock = x;
-            }
-        }
+  for (x = block * dev->sectorsPerBlk;
+       x < (block + 1) * dev->sectorsPerBlk; x++)
+    {
+      SMART_FREEMAP_SET(dev, x);
+    }
 
-      /* Test if the released sectors count is greater than the
-       * free sectors.  If it is, then we will do garbage collection.
-       */
+  /* If this block was being garbage collected, then that is finished */
 
-      if (releasedsectors > dev->freesectors)
-        collect = TRUE;
+  if (block == dev->gcblock)
+    {
+      dev->gcblock = 0xFFFF;
+    }
 
-      /* Test if we have more reached our reserved free sector limit */
+  /* If this is block zero, then be sure to write the sector size */
 
-      if (dev->freesectors <= (dev->sectorsPerBlk << 0) + 4)
-        collect = TRUE;
+  if (block == 0)
+    {
+      /* Set the sector size in the 1st header */
 
-      /* Test if we need to garbage collect */
+      uint8_t sectsize = dev->sectorsize >> 7;
+#if ( CONFIG_SMARTFS_ERASEDSTATE == 0xFF )
+      newstatus = (uint8_t) ~SMART_STATUS_SIZEBITS | sectsize;
+#else
+      newstatus = (uint8_t) sectsize;
+#endif
+      /* Write the sector size to the device */
 
-      if (collect)
+      offset = offsetof(struct smart_sect_header_s, status);
+      ret = smart_bytewrite(dev, offset, 1, &newstatus);
+      if (ret < 0)
         {
-          if (collectblock == 0xFFFF)
-            {
-              /* Need to collect, but no sectors with released blocks! */
+          fdbg("Error %d setting sector 0 size\n", -ret);
+        }
+    }
 
-              ret = -ENOSPC;
-              goto errout;
-            }
+  /* Update the block aging information in the format signature sector */
 
-          fdbg("Collecting block %d, free=%d released=%d\n",
-              collectblock, dev->freecount[collectblock],
-              dev->releasecount[collectblock]);
+  return OK;
+}
+#endif /* CONFIG_FS_WRITABLE */
 
-          if (dev->freecount[collectblock] == 6)
-            {
-              fdbg("here!\n");
-            }
+/****************************************************************************
+ * Name: smart_gcstep
+ *
+ * Description:  Performs one step of the garbage collection of the erase
+ *               block dev->gcblock:  Live sectors are moved from the block
+ *               to a new home until 'budget' sectors have been read from
+ *               the device.  Free sectors are skipped without reading them.
+ *               When all of the sectors in the block have been processed,
+ *               the block is erased.
+ *
+ ****************************************************************************/
 
-          /* Perform collection on block with the most released sectors.
-           * First mark the block as having no free sectors so we don't
-           * try to move sectors into the block we are trying to erase.
-           */
+#ifdef CONFIG_FS_WRITABLE
+static int smart_gcstep(struct smart_struct_s *dev, int budget)
+{
+  uint16_t  newsector;
+  uint16_t  end;
+  uint16_t  x;
+  int       ret;
+  size_t    offset;
+  struct    smart_sect_header_s *header;
+  uint8_t   newstatus;
 
-          dev->freecount[collectblock] = 0;
+  /* Move live data in the block to a new home, starting where the
+   * last step stopped.
+   */
 
-          /* Next move all live data in the block to a new home. */
+  end = (dev->gcblock + 1) * dev->sectorsPerBlk;
+  for (x = dev->gcsector; x < end && budget > 0; x++)
+    {
+      /* Free sectors have no data to move */
 
-          for (x = collectblock * dev->sectorsPerBlk; x <
-             (collectblock + 1) * dev->sectorsPerBlk; x++)
-            {
-              /* Read the next sector from this erase block */
+      if (SMART_FREEMAP_TST(dev, x))
+        {
+          continue;
+        }
 
-              ret = MTD_BREAD(dev->mtd, x * dev->mtdBlksPerSector,
-                  dev->mtdBlksPerSector, (uint8_t *) dev->rwbuffer);
-              if (ret != dev->mtdBlksPerSector)
-                {
-                  fdbg("Error reading sector %d\n", x);
-                  ret = -EIO;
-                  goto errout;
-                }
+      /* Read the next sector from this erase block */
 
-              /* Test if if the block is in use */
+      budget--;
+      ret = MTD_BREAD(dev->mtd, x * dev->mtdBlksPerSector,
+          dev->mtdBlksPerSector, (uint8_t *) dev->rwbuffer);
+      if (ret != dev->mtdBlksPerSector)
+        {
+          fdbg("Error reading sector %d\n", x);
+          ret = -EIO;
+          goto errout;
+        }
 
-              header = (struct smart_sect_header_s *) dev->rwbuffer;
-              if (((header->status & SMART_STATUS_COMMITTED) ==
-                  (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED)) ||
-                  ((header->status & SMART_STATUS_RELEASED) !=
-                   (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED)))
-                {
-                  /* This sector doesn't have live data (free or released).
-                   * just continue to the next sector and don't move it.
-                   */
+      /* Test if if the block is in use */
 
-                  continue;
-                }
+      header = (struct smart_sect_header_s *) dev->rwbuffer;
+      if (((header->status & SMART_STATUS_COMMITTED) ==
+          (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED)) ||
+          ((header->status & SMART_STATUS_RELEASED) !=
+           (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED)))
+        {
+          /* This sector doesn't have live data (free or released).
+           * just continue to the next sector and don't move it.
+           */
 
-              /* Find a new sector where it can live, NOT in this erase block */
+          continue;
+        }
 
-              newsector = smart_findfreephyssector(dev);
-              if (newsector == 0xFFFF)
-                {
-                  /* Unable to find a free sector!!! */
+      /* Find a new sector where it can live, NOT in this erase block */
 
-                  fdbg("Can't find a free sector for relocation\n");
-                  ret = -EIO;
-                  goto errout;
-                }
+      newsector = smart_findfreephyssector(dev);
+      if (newsector == 0xFFFF)
+        {
+          /* Unable to find a free sector!!! */
 
-              /* Increment the sequence number and clear the "commit" flag */
+          fdbg("Can't find a free sector for relocation\n");
+          ret = -EIO;
+          goto errout;
+        }
 
-              (*((uint16_t *) header->seq))++;
-              if (*((uint16_t *) header->seq) == 0xFFFF)
-                {
-                  *((uint16_t *) header->seq) = 1;
-                }
+      /* Increment the sequence number and clear the "commit" flag */
+
+      (*((uint16_t *) header->seq))++;
+      if (*((uint16_t *) header->seq) == 0xFFFF)
+        {
+          *((uint16_t *) header->seq) = 1;
+        }
 #if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
-              header->status |= SMART_STATUS_COMMITTED;
+      header->status |= SMART_STATUS_COMMITTED;
 #else
-              header->status &= ~SMART_STATUS_COMMITTED;
+      header->status &= ~SMART_STATUS_COMMITTED;
 #endif
 
-              /* Write the data to the new physical sector location */
+      /* Write the data to the new physical sector location */
 
-              ret = MTD_BWRITE(dev->mtd, newsector * dev->mtdBlksPerSector,
-                               dev->mtdBlksPerSector, (uint8_t *) dev->rwbuffer);
+      ret = MTD_BWRITE(dev->mtd, newsector * dev->mtdBlksPerSector,
+                       dev->mtdBlksPerSector, (uint8_t *) dev->rwbuffer);
 
-              /* Commit the sector */
+      /* Commit the sector */
 
-              offset = newsector * dev->mtdBlksPerSector * dev->geo.blocksize +
-                  offsetof(struct smart_sect_header_s, status);
+      offset = newsector * dev->mtdBlksPerSector * dev->geo.blocksize +
+          offsetof(struct smart_sect_header_s, status);
 #if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
-              newstatus = header->status & ~SMART_STATUS_COMMITTED;
+      newstatus = header->status & ~SMART_STATUS_COMMITTED;
 #else
-              newstatus = header->status | SMART_STATUS_COMMITTED;
+      newstatus = header->status | SMART_STATUS_COMMITTED;
 #endif
-              ret = smart_bytewrite(dev, offset, 1, &newstatus);
-              if (ret < 0)
-                {
-                  fdbg("Error %d committing new sector %d\n" -ret, newsector);
-                  goto errout;
-                }
+      ret = smart_bytewrite(dev, offset, 1, &newstatus);
+      if (ret < 0)
+        {
+          fdbg("Error %d committing new sector %d\n", -ret, newsector);
+          goto errout;
+        }
 
-              /* Release the old physical sector */
+      /* Release the old physical sector */
 
 #if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
-              newstatus = header->status & ~SMART_STATUS_RELEASED;
+      newstatus = header->status & ~SMART_STATUS_RELEASED;
 #else
-              newstatus = header->status | SMART_STATUS_RELEASED;
+      newstatus = header->status | SMART_STATUS_RELEASED;
 #endif
-              offset = x * dev->mtdBlksPerSector * dev->geo.blocksize +
-                  offsetof(struct smart_sect_header_s, status);
-              ret = smart_bytewrite(dev, offset, 1, &newstatus);
-              if (ret < 0)
-                {
-                  fdbg("Error %d releasing old sector %d\n" -ret, x);
-                  goto errout;
-                }
+      offset = x * dev->mtdBlksPerSector * dev->geo.blocksize +
+          offsetof(struct smart_sect_header_s, status);
+      ret = smart_bytewrite(dev, offset, 1, &newstatus);
+      if (ret < 0)
+        {
+          fdbg("Error %d releasing old sector %d\n", -ret, x);
+          goto errout;
+        }
 
-              /* Update the variables */
+      /* Update the variables */
 
-              dev->sMap[*((uint16_t *) header->logicalsector)] = newsector;
-              dev->freecount[newsector / dev->sectorsPerBlk]--;
-            }
+      dev->sMap[*((uint16_t *) header->logicalsector)] = newsector;
+      dev->releasecount[dev->gcblock]++;
+      dev->releasesectors++;
+    }
+
+  /* Remember where to continue with the next step */
+
+  dev->gcsector = x;
+
+  /* Now erase the erase block if all of its sectors have been processed */
+
+  if (x >= end)
+    {
+      return smart_eraseblock(dev, dev->gcblock);
+    }
+
+  return OK;
+
+errout:
+  dev->gcsector = x;
+  return ret;
+}
+#endif /* CONFIG_FS_WRITABLE */
 
-          /* Now erase the erase block */
+/****************************************************************************
+ * Name: smart_garbagecollect
+ *
+ * Description:  Performs garbage collection if needed.  This is determined
+ *               by the count of released sectors relative to free and
+ *               total sectors.
+ *
+ *               Garbage collection is incremental:  Each call reads at most
+ *               CONFIG_MTD_SMART_GC_BUDGET sectors from the block being
+ *               collected so that the latency of each write stays bounded.
+ *               Only when the free sectors fall to the reserve that is
+ *               needed for relocation are blocks collected completely.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static int smart_garbagecollect(struct smart_struct_s *dev)
+{
+  uint16_t  collectblock;
+  uint16_t  releasemax;
+  bool      collect;
+  int       x;
+  int       ret;
+
+  for (;;)
+    {
+      /* Test if we have reached our reserved free sector limit.  If
+       * so, then we must free sectors now.
+       */
 
-          MTD_ERASE(dev->mtd, collectblock, 1);
+      collect = (dev->freesectors <= (dev->sectorsPerBlk << 0) + 4);
 
-          dev->freesectors += dev->releasecount[collectblock];
-          dev->freecount[collectblock] = dev->sectorsPerBlk;
-          dev->releasecount[collectblock] = 0;
+      /* Test if a new garbage collection must be started */
 
-          /* If this is block zero, then be sure to write the sector size */
+      if (dev->gcblock == 0xFFFF)
+        {
+          /* Test if the released sectors count is greater than the
+           * free sectors.  If it is, then we will do garbage collection.
+           */
 
-          if (collectblock == 0)
+          if (!collect && dev->releasesectors <= dev->freesectors)
             {
-              /* Set the sector size in the 1st header */
+              return OK;
+            }
 
-              uint8_t sectsize = dev->sectorsize >> 7;
-#if ( CONFIG_SMARTFS_ERASEDSTATE == 0xFF )
-              newstatus = (uint8_t) ~SMART_STATUS_SIZEBITS | sectsize;
-#else
-              newstatus = (uint8_t) sectsize;
-#endif
-              /* Write the sector size to the device */
+          /* Collect the block with the most released sectors */
 
-              offset = offsetof(struct smart_sect_header_s, status);
-              ret = smart_bytewrite(dev, offset, 1, &newstatus);
-              if (ret < 0)
+          collectblock = 0xFFFF;
+          releasemax = 0;
+          for (x = 0; x < dev->neraseblocks; x++)
+            {
+              if (dev->releasecount[x] > releasemax)
                 {
-                  fdbg("Error %d setting sector 0 size\n", -ret);
+                  releasemax = dev->releasecount[x];
+                  collectblock = x;
                 }
             }
 
-          /* Update the block aging information in the format signature sector */
+          if (collectblock == 0xFFFF)
+            {
+              /* Need to collect, but no sectors with released blocks! */
+
+              return -ENOSPC;
+            }
+
+          fvdbg("Collecting block %d, free=%d released=%d\n",
+              collectblock, dev->freecount[collectblock],
+              dev->releasecount[collectblock]);
+
+          dev->gcblock  = collectblock;
+          dev->gcsector = collectblock * dev->sectorsPerBlk;
         }
-      else
+
+      /* Perform one bounded step of the collection, or collect the whole
+       * block if we are at the reserved free sector limit.
+       */
+
+      ret = smart_gcstep(dev, collect ? dev->sectorsPerBlk :
+                         CONFIG_MTD_SMART_GC_BUDGET);
+      if (ret < 0 || !collect)
         {
-          /* Test for aging sectors and push them to a new location
-           * so we wear evenly.
-           */
+          return ret;
         }
     }
-
-  return OK;
-
-errout:
-  return ret;
 }
 #endif /* CONFIG_FS_WRITABLE */
 
@@ -1595,12 +1782,11 @@ static inline int smart_writesector(struct smart_struct_s *dev, unsigned long ar
           offsetof(struct smart_sect_header_s, status);
       ret = smart_bytewrite(dev, offset, 1, &byte);
 
-      /* Update releasecount for released sector and freecount for the
-       * newly allocated physical sector. */
+      /* Update releasecount for released sector.  The freecount for the
+       * newly allocated physical sector was updated when it was found. */
 
       dev->releasecount[dev->sMap[req->logsector] / dev->sectorsPerBlk]++;
-      dev->freecount[physsector / dev->sectorsPerBlk]--;
-      dev->freesectors--;
+      dev->releasesectors++;
 
       /* Update the sector map */
 
@@ -1726,7 +1912,6 @@ static inline int smart_allocsector(struct smart_struct_s *dev, unsigned long re
   int       ret;
   uint16_t  logsector = 0xFFFF; /* Logical sector number selected */
   uint16_t  physicalsector;     /* The selected physical sector */
-  uint16_t  releasecount;
   struct    smart_sect_header_s  *header;
   uint8_t   sectsize;
 
@@ -1734,18 +1919,12 @@ static inline int smart_allocsector(struct smart_struct_s *dev, unsigned long re
    * allocation.  We have to ensure we keep enough reserved sectors
    * on hand to do released sector garbage collection. */
 
-  releasecount = 0;
-  for (x = 0; x < dev->neraseblocks; x++)
-    {
-      releasecount += dev->releasecount[x];
-    }
-
   if (dev->freesectors <= (dev->sectorsPerBlk << 0) + 4)
     {
       /* We are at our free sector limit.  Test if we have
        * sectors we can release */
 
-      if (releasecount == 0)
+      if (dev->releasesectors == 0)
         {
           /* No space left!! */
 
@@ -1811,9 +1990,14 @@ static inline int smart_allocsector(struct smart_struct_s *dev, unsigned long re
   /* Find a free physical sector */
 
   physicalsector = smart_findfreephyssector(dev);
+  if (physicalsector == 0xFFFF)
+    {
+      return -ENOSPC;
+    }
+
   fvdbg("Alloc: log=%d, phys=%d, erase block=%d, free=%d, released=%d\n",
           logsector, physicalsector, physicalsector /
-          dev->sectorsPerBlk, dev->freesectors, releasecount);
+          dev->sectorsPerBlk, dev->freesectors, dev->releasesectors);
 
   /* Create a header to assign the logical sector */
 
@@ -1847,11 +2031,11 @@ static inline int smart_allocsector(struct smart_struct_s *dev, unsigned long re
       return -EIO;
     }
 
-  /* Map the sector and update the free sector counts */
+  /* Map the sector.  The free sector counts were updated when the
+   * physical sector was found.
+   */
 
   dev->sMap[logsector] = physicalsector;
-  dev->freecount[physicalsector / dev->sectorsPerBlk]--;
-  dev->freesectors--;
 
   /* Return the logical sector number */
 
@@ -1937,6 +2121,7 @@ static inline int smart_freesector(struct smart_struct_s *dev, unsigned long
 
   block = physsector / dev->sectorsPerBlk;
   dev->releasecount[block]++;
+  dev->releasesectors++;
 
   /* Unmap this logical sector */
 
@@ -1948,11 +2133,11 @@ static inline int smart_freesector(struct smart_struct_s *dev, unsigned long
     {
       /* Erase the block */
 
-      MTD_ERASE(dev->mtd, block, 1);
-
-      dev->freesectors += dev->releasecount[block];
-      dev->releasecount[block] = 0;
-      dev->freecount[block] = dev->sectorsPerBlk;
+      ret = smart_eraseblock(dev, block);
+      if (ret < 0)
+        {
+          goto errout;
+        }
     }
 
   ret = OK;
@@ -54,6 +54,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #if CONFIG_DEBUG
 #  include <nuttx/arch.h>
 #endif
@@ -85,6 +86,8 @@
  ****************************************************************************/
 
 static void pipecommon_semtake(sem_t *sem);
+static inline size_t pipecommon_nbytes(FAR struct pipe_dev_s *dev);
+static void pipecommon_wakeup(sem_t *sem);
 
 /****************************************************************************
  * Private Data
@@ -110,6 +113,46 @@ static void pipecommon_semtake(sem_t *sem)
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_nbytes
+ *
+ * Description:
+ *   Return the number of bytes in the pipe buffer.  The pipe can hold at
+ *   most d_bufsize-1 bytes so that a full pipe can be distinguished from an
+ *   empty one.
+ *
+ ****************************************************************************/
+
+static inline size_t pipecommon_nbytes(FAR struct pipe_dev_s *dev)
+{
+  if (dev->d_wrndx >= dev->d_rdndx)
+    {
+      return dev->d_wrndx - dev->d_rdndx;
+    }
+  else
+    {
+      return dev->d_bufsize + dev->d_wrndx - dev->d_rdndx;
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_wakeup
+ *
+ * Description:
+ *   Wake up all of the threads waiting on a semaphore.
+ *
+ ****************************************************************************/
+
+static void pipecommon_wakeup(sem_t *sem)
+{
+  int sval;
+
+  while (sem_getvalue(sem, &sval) == 0 && sval < 0)
+    {
+      sem_post(sem);
+    }
+}
+
 /****************************************************************************
  * Name: pipecommon_pollnotify
  ****************************************************************************/
@@ -157,6 +200,7 @@ FAR struct pipe_dev_s *pipecommon_allocdev(void)
       /* Initialize the private structure */
 
       memset(dev, 0, sizeof(struct pipe_dev_s));
+      dev->d_bufsize = CONFIG_DEV_PIPE_SIZE;
       sem_init(&dev->d_bfsem, 0, 1);
       sem_init(&dev->d_rdsem, 0, 0);
       sem_init(&dev->d_wrsem, 0, 0);
@@ -185,7 +229,6 @@ int pipecommon_open(FAR struct file *filep)
 {
   struct inode      *inode = filep->f_inode;
   struct pipe_dev_s *dev   = inode->i_private;
-  int                sval;
   int                ret;
  
   /* Some sanity checking */
@@ -212,7 +255,7 @@ int pipecommon_open(FAR struct file *filep)
 
   if (dev->d_refs == 0)
     {
-      dev->d_buffer = (uint8_t*)kmalloc(CONFIG_DEV_PIPE_SIZE);
+      dev->d_buffer = (uint8_t*)kmalloc(dev->d_bufsize);
       if (!dev->d_buffer)
         {
           (void)sem_post(&dev->d_bfsem);
@@ -236,10 +279,7 @@ int pipecommon_open(FAR struct file *filep)
 
       if (dev->d_nwriters == 1)
         {
-          while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-            {
-              sem_post(&dev->d_rdsem);
-            }
+          pipecommon_wakeup(&dev->d_rdsem);
         }
     }
 
@@ -287,7 +327,6 @@ int pipecommon_close(FAR struct file *filep)
 {
   struct inode      *inode = filep->f_inode;
   struct pipe_dev_s *dev   = inode->i_private;
-  int                sval;
 
   /* Some sanity checking */
 #if CONFIG_DEBUG
@@ -322,10 +361,7 @@ int pipecommon_close(FAR struct file *filep)
 
           if (--dev->d_nwriters <= 0)
             {
-              while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  sem_post(&dev->d_rdsem);
-                }
+              pipecommon_wakeup(&dev->d_rdsem);
             }
         }
     }
@@ -336,10 +372,11 @@ int pipecommon_close(FAR struct file *filep)
       kfree(dev->d_buffer);
       dev->d_buffer = NULL;
 
-      /* And reset all counts and indices */
+      /* And reset all counts, indices, and the buffer size */
  
       dev->d_wrndx    = 0;
       dev->d_rdndx    = 0;
+      dev->d_bufsize  = CONFIG_DEV_PIPE_SIZE;
       dev->d_refs     = 0;
       dev->d_nwriters = 0;
    }
@@ -360,7 +397,9 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
   FAR uint8_t       *start  = (uint8_t*)buffer;
 #endif
   ssize_t            nread  = 0;
-  int                sval;
+  size_t             nbytes;
+  size_t             span;
+  size_t             rdndx;
   int                ret;
 
   /* Some sanity checking */
@@ -411,24 +450,38 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
         }
     }
 
-  /* Then return whatever is available in the pipe (which is at least one byte) */
+  /* Then return whatever is available in the pipe (which is at least one
+   * byte).  The data is copied in at most two contiguous spans:  From the
+   * read index up to the end of the buffer, then from the beginning of the
+   * buffer.
+   */
+
+  nbytes = pipecommon_nbytes(dev);
+  nread  = nbytes < len ? nbytes : len;
+  rdndx  = dev->d_rdndx;
+  span   = dev->d_bufsize - rdndx;
 
-  nread = 0;
-  while (nread < len && dev->d_wrndx != dev->d_rdndx)
+  if (span >= nread)
     {
-      *buffer++ = dev->d_buffer[dev->d_rdndx];
-      if (++dev->d_rdndx >= CONFIG_DEV_PIPE_SIZE)
-        {
-          dev->d_rdndx = 0; 
-        }
-      nread++;
+      memcpy(buffer, &dev->d_buffer[rdndx], nread);
+      rdndx += nread;
+    }
+  else
+    {
+      memcpy(buffer, &dev->d_buffer[rdndx], span);
+      memcpy(&buffer[span], dev->d_buffer, nread - span);
+      rdndx = nread - span;
     }
 
-  /* Notify all waiting writers that bytes have been removed from the buffer */
+  dev->d_rdndx = rdndx < dev->d_bufsize ? rdndx : 0;
+
+  /* Notify all waiting writers that bytes have been removed from the buffer.
+   * Writers wait only when the buffer is full.
+   */
 
-  while (sem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0)
+  if (nbytes >= dev->d_bufsize - 1)
     {
-      sem_post(&dev->d_wrsem);
+      pipecommon_wakeup(&dev->d_wrsem);
     }
 
   /* Notify all poll/select waiters that they can write to the FIFO */
@@ -449,9 +502,11 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer, size_t
   struct inode      *inode    = filep->f_inode;
   struct pipe_dev_s *dev      = inode->i_private;
   ssize_t            nwritten = 0;
-  ssize_t            last;
-  int                nxtwrndx;
-  int                sval;
+  size_t             nbytes;
+  size_t             navail;
+  size_t             nxfr;
+  size_t             span;
+  size_t             wrndx;
 
   /* Some sanity checking */
 
@@ -487,83 +542,197 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer, size_t
 
   /* Loop until all of the bytes have been written */
 
-  last = 0;
   for (;;)
     {
-      /* Calculate the write index AFTER the next byte is written */
+      /* How much room is there in the circular buffer? */
 
-      nxtwrndx = dev->d_wrndx + 1;
-      if (nxtwrndx >= CONFIG_DEV_PIPE_SIZE)
+      nbytes = pipecommon_nbytes(dev);
+      navail = dev->d_bufsize - 1 - nbytes;
+      if (navail > 0)
         {
-          nxtwrndx = 0;
-        }
+          /* Copy as much as will fit in at most two contiguous spans:  From
+           * the write index up to the end of the buffer, then from the
+           * beginning of the buffer.
+           */
 
-      /* Would the next write overflow the circular buffer? */
+          nxfr  = len - nwritten;
+          nxfr  = nxfr < navail ? nxfr : navail;
+          wrndx = dev->d_wrndx;
+          span  = dev->d_bufsize - wrndx;
 
-      if (nxtwrndx != dev->d_rdndx)
-        {
-          /* No... copy the byte */
+          if (span >= nxfr)
+            {
+              memcpy(&dev->d_buffer[wrndx], buffer, nxfr);
+              wrndx += nxfr;
+            }
+          else
+            {
+              memcpy(&dev->d_buffer[wrndx], buffer, span);
+              memcpy(dev->d_buffer, &buffer[span], nxfr - span);
+              wrndx = nxfr - span;
+            }
 
-          dev->d_buffer[dev->d_wrndx] = *buffer++;
-          dev->d_wrndx = nxtwrndx;
+          dev->d_wrndx = wrndx < dev->d_bufsize ? wrndx : 0;
+          buffer      += nxfr;
+          nwritten    += nxfr;
 
-          /* Is the write complete? */
+          /* Notify all of the waiting readers that more data is available.
+           * Readers wait only when the buffer is empty.
+           */
 
-          if (++nwritten >= len)
+          if (nbytes == 0)
             {
-              /* Yes.. Notify all of the waiting readers that more data is available */
+              pipecommon_wakeup(&dev->d_rdsem);
+            }
 
-              while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  sem_post(&dev->d_rdsem);
-                }
+          /* Notify all poll/select waiters that they can read from the FIFO */
 
-              /* Notify all poll/select waiters that they can write to the FIFO */
+          pipecommon_pollnotify(dev, POLLIN);
 
-              pipecommon_pollnotify(dev, POLLIN);
+          /* Is the write complete? */
 
-              /* Return the number of bytes written */
+          if (nwritten >= len)
+            {
+              /* Yes.. Return the number of bytes written */
 
               sem_post(&dev->d_bfsem);
               return len;
             }
         }
-      else
+
+      /* There is no room for the next byte.  If O_NONBLOCK was set, then
+       * return partial bytes written or EGAIN.
+       */
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          if (nwritten == 0)
+            {
+              nwritten = -EAGAIN;
+            }
+
+          sem_post(&dev->d_bfsem);
+          return nwritten;
+        }
+
+      /* There is more to be written.. wait for data to be removed from the pipe */
+
+      sched_lock();
+      sem_post(&dev->d_bfsem);
+      pipecommon_semtake(&dev->d_wrsem);
+      sched_unlock();
+      pipecommon_semtake(&dev->d_bfsem);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_ioctl
+ ****************************************************************************/
+
+int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct inode      *inode  = filep->f_inode;
+  FAR struct pipe_dev_s *dev    = inode->i_private;
+  FAR uint8_t           *buffer;
+  size_t                 nbytes;
+  size_t                 span;
+  int                    ret    = OK;
+
+  /* Some sanity checking */
+
+#if CONFIG_DEBUG
+  if (!dev)
+    {
+      return -ENODEV;
+    }
+#endif
+
+  pipecommon_semtake(&dev->d_bfsem);
+  switch (cmd)
+    {
+      /* Set the size of the pipe buffer.  Any data in the buffer is
+       * retained.
+       */
+
+      case PIPEIOC_SETSIZE:
         {
-          /* There is not enough room for the next byte.  Was anything written in this pass? */
+          if (arg < 2 || arg > CONFIG_DEV_PIPE_MAXSIZE)
+            {
+              ret = -EINVAL;
+              break;
+            }
 
-          if (last < nwritten)
+          /* Make sure that the data in the pipe will fit in the new buffer */
+
+          nbytes = pipecommon_nbytes(dev);
+          if (nbytes >= arg)
+            {
+              ret = -EBUSY;
+              break;
+            }
+
+          /* Allocate the new buffer and move the data to its beginning */
+
+          if (dev->d_buffer)
             {
-              /* Yes.. Notify all of the waiting readers that more data is available */
+              buffer = (FAR uint8_t *)kmalloc(arg);
+              if (!buffer)
+                {
+                  ret = -ENOMEM;
+                  break;
+                }
 
-              while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
+              span = dev->d_bufsize - dev->d_rdndx;
+              if (span >= nbytes)
                 {
-                  sem_post(&dev->d_rdsem);
+                  memcpy(buffer, &dev->d_buffer[dev->d_rdndx], nbytes);
                 }
+              else
+                {
+                  memcpy(buffer, &dev->d_buffer[dev->d_rdndx], span);
+                  memcpy(&buffer[span], dev->d_buffer, nbytes - span);
+                }
+
+              kfree(dev->d_buffer);
+              dev->d_buffer = buffer;
+              dev->d_rdndx  = 0;
+              dev->d_wrndx  = nbytes;
             }
-          last = nwritten;
 
-          /* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
+          dev->d_bufsize = arg;
+
+          /* There may be more room for waiting writers now */
 
-          if (filep->f_oflags & O_NONBLOCK)
+          pipecommon_wakeup(&dev->d_wrsem);
+          if (nbytes < arg - 1)
             {
-              if (nwritten == 0)
-                {
-                  nwritten = -EAGAIN;
-                }
-              sem_post(&dev->d_bfsem);
-              return nwritten;
+              pipecommon_pollnotify(dev, POLLOUT);
             }
+        }
+        break;
 
-          /* There is more to be written.. wait for data to be removed from the pipe */
+      /* Get the size of the pipe buffer */
 
-          sched_lock();
-          sem_post(&dev->d_bfsem);
-          pipecommon_semtake(&dev->d_wrsem);
-          sched_unlock();
-          pipecommon_semtake(&dev->d_bfsem);
+      case PIPEIOC_GETSIZE:
+        {
+          FAR size_t *size = (FAR size_t *)((uintptr_t)arg);
+          if (!size)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          *size = dev->d_bufsize;
         }
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
     }
+
+  sem_post(&dev->d_bfsem);
+  return ret;
 }
 
 /****************************************************************************
@@ -577,7 +746,7 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
   FAR struct inode      *inode    = filep->f_inode;
   FAR struct pipe_dev_s *dev      = inode->i_private;
   pollevent_t            eventset;
-  pipe_ndx_t             nbytes;
+  size_t                 nbytes;
   int                    ret      = OK;
   int                    i;
 
@@ -624,19 +793,12 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
        * First, determine how many bytes are in the buffer
        */
 
-      if (dev->d_wrndx >= dev->d_rdndx)
-        {
-          nbytes = dev->d_wrndx - dev->d_rdndx;
-        }
-      else
-        {
-          nbytes = (CONFIG_DEV_PIPE_SIZE-1) + dev->d_wrndx - dev->d_rdndx;
-        }
+      nbytes = pipecommon_nbytes(dev);
 
       /* Notify the POLLOUT event if the pipe is not full */
 
       eventset = 0;
-      if (nbytes < (CONFIG_DEV_PIPE_SIZE-1))
+      if (nbytes < (dev->d_bufsize - 1))
         {
           eventset |= POLLOUT;
         }
@@ -50,7 +50,9 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <arch/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/rwbuffer.h>
 
@@ -62,7 +64,7 @@
 
 /* Configuration ************************************************************/
 
-#ifndef CONFIG_SCHED_WORKQUEUE
+#if defined(CONFIG_FS_WRITEBUFFER) && !defined(CONFIG_SCHED_WORKQUEUE)
 #  error "Worker thread support is required (CONFIG_SCHED_WORKQUEUE)"
 #endif
 
@@ -70,6 +72,12 @@
 #  define CONFIG_FS_WRDELAY 350
 #endif
 
+#if CONFIG_FS_NWRSEGS < 1 || CONFIG_FS_NRHSEGS < 1
+#  error "CONFIG_FS_NWRSEGS and CONFIG_FS_NRHSEGS must be at least 1"
+#endif
+
+#define RWB_NOBLOCK ((off_t)-1)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -120,10 +128,13 @@ static inline bool rwb_overlap(off_t blockstart1, size_t nblocks1,
   off_t blockend1 = blockstart1 + nblocks1;
   off_t blockend2 = blockstart2 + nblocks2;
 
-  /* If the buffer 1 is wholly outside of buffer 2, return false */
+  /* Empty ranges overlap nothing.  Otherwise, return false if buffer 1 is
+   * wholly outside of buffer 2.
+   */
 
-  if ((blockend1   < blockstart2) || /* Wholly "below" */
-      (blockstart1 > blockend2))     /* Wholly "above" */
+  if (nblocks1 == 0 || nblocks2 == 0 ||
+      (blockend1   <= blockstart2) || /* Wholly "below" */
+      (blockstart1 >= blockend2))     /* Wholly "above" */
     {
       return false;
     }
@@ -134,52 +145,353 @@ static inline bool rwb_overlap(off_t blockstart1, size_t nblocks1,
 }
 
 /****************************************************************************
- * Name: rwb_resetwrbuffer
+ * Name: rwb_copyoverlap
+ *
+ * Description:
+ *   Copy the blocks that are common to a segment and a range of blocks.
+ *   If 'toseg' is true, the data is copied from 'buffer' into the segment;
+ *   otherwise it is copied from the segment into 'buffer'.
+ *
+ ****************************************************************************/
+
+static void rwb_copyoverlap(FAR struct rwbuffer_s *rwb,
+                            FAR struct rwbseg_s *seg, off_t startblock,
+                            size_t nblocks, FAR uint8_t *buffer, bool toseg)
+{
+  off_t first;
+  off_t last;
+  size_t nbytes;
+  FAR uint8_t *segptr;
+  FAR uint8_t *bufptr;
+
+  first = seg->blockstart > startblock ? seg->blockstart : startblock;
+  last  = seg->blockstart + seg->nblocks;
+  if (startblock + (off_t)nblocks < last)
+    {
+      last = startblock + nblocks;
+    }
+
+  nbytes = (last - first) * rwb->blocksize;
+  segptr = &seg->buffer[(first - seg->blockstart) * rwb->blocksize];
+  bufptr = &buffer[(first - startblock) * rwb->blocksize];
+
+  if (toseg)
+    {
+      memcpy(segptr, bufptr, nbytes);
+    }
+  else
+    {
+      memcpy(bufptr, segptr, nbytes);
+    }
+}
+
+/****************************************************************************
+ * Name: rwb_resetseg
+ ****************************************************************************/
+
+static inline void rwb_resetseg(FAR struct rwbseg_s *seg)
+{
+  seg->blockstart = RWB_NOBLOCK;
+  seg->nblocks    = 0;
+}
+
+/****************************************************************************
+ * Name: rwb_mdreload and rwb_mdflush
+ *
+ * Description:
+ *   Transfer blocks to or from the media through the callouts.  The worker
+ *   thread writes full segments without holding the wrsem, so the callouts
+ *   are serialized by the mdsem.  The mdsem is always taken last.
+ *
  ****************************************************************************/
 
+static ssize_t rwb_mdreload(FAR struct rwbuffer_s *rwb, FAR uint8_t *buffer,
+                            off_t startblock, size_t nblocks)
+{
 #ifdef CONFIG_FS_WRITEBUFFER
-static inline void rwb_resetwrbuffer(struct rwbuffer_s *rwb)
+  ssize_t ret;
+
+  rwb_semtake(&rwb->mdsem);
+  ret = rwb->rhreload(rwb->dev, buffer, startblock, nblocks);
+  rwb_semgive(&rwb->mdsem);
+  return ret;
+#else
+  return rwb->rhreload(rwb->dev, buffer, startblock, nblocks);
+#endif
+}
+
+#ifdef CONFIG_FS_WRITEBUFFER
+static ssize_t rwb_mdflush(FAR struct rwbuffer_s *rwb,
+                           FAR const uint8_t *buffer, off_t startblock,
+                           size_t nblocks)
 {
-  /* We assume that the caller holds the wrsem */
+  ssize_t ret;
 
-  rwb->wrnblocks       = 0;
-  rwb->wrblockstart    = (off_t)-1;
-  rwb->wrexpectedblock = (off_t)-1;
+  rwb_semtake(&rwb->mdsem);
+  ret = rwb->wrflush(rwb->dev, buffer, startblock, nblocks);
+  rwb_semgive(&rwb->mdsem);
+  return ret;
 }
 #endif
 
 /****************************************************************************
- * Name: rwb_wrflush
+ * Name: rwb_wrwait
+ *
+ * Description:
+ *   Release the wrsem and wait until the worker has finished writing a
+ *   segment to the media (or has finished altogether), then re-take the
+ *   wrsem.  The caller must re-examine the write segments afterward.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_FS_WRITEBUFFER
-static void rwb_wrflush(struct rwbuffer_s *rwb)
+static void rwb_wrwait(FAR struct rwbuffer_s *rwb)
 {
-  int ret;
+  /* We assume that the caller holds the wrsem */
 
-  fvdbg("Timeout!\n");
-  
+  rwb->wrnwaiters++;
+  rwb_semgive(&rwb->wrsem);
+  rwb_semtake(&rwb->wrdone);
   rwb_semtake(&rwb->wrsem);
-  if (rwb->wrnblocks)
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrwakeup
+ *
+ * Description:
+ *   Wake up every thread waiting in rwb_wrwait().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITEBUFFER
+static void rwb_wrwakeup(FAR struct rwbuffer_s *rwb)
+{
+  /* We assume that the caller holds the wrsem */
+
+  while (rwb->wrnwaiters > 0)
+    {
+      rwb->wrnwaiters--;
+      rwb_semgive(&rwb->wrdone);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrwaitrange
+ *
+ * Description:
+ *   Wait until the worker is not writing any segment that holds blocks in
+ *   the range and is not writing every segment, so that the caller can
+ *   flush or re-use segments without releasing the wrsem.  If 'nblocks'
+ *   is zero, wait until the worker is not writing any segment.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITEBUFFER
+static void rwb_wrwaitrange(FAR struct rwbuffer_s *rwb, off_t startblock,
+                            size_t nblocks)
+{
+  FAR struct rwbseg_s *seg;
+  int nflushing;
+  int i;
+
+  /* We assume that the caller holds the wrsem */
+
+  do
+    {
+      nflushing = 0;
+      for (i = 0; i < CONFIG_FS_NWRSEGS; i++)
+        {
+          seg = &rwb->wrseg[i];
+          if (seg->flushing)
+            {
+              if (nblocks == 0 ||
+                  rwb_overlap(seg->blockstart, seg->nblocks,
+                              startblock, nblocks))
+                {
+                  break;
+                }
+
+              nflushing++;
+            }
+        }
+
+      if (i >= CONFIG_FS_NWRSEGS && nflushing < CONFIG_FS_NWRSEGS)
+        {
+          return;
+        }
+
+      rwb_wrwait(rwb);
+    }
+  while (true);
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrqueue
+ *
+ * Description:
+ *   Queue write buffer work on the low priority work queue and count it as
+ *   pending until the worker function has finished.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITEBUFFER
+static void rwb_wrqueue(FAR struct rwbuffer_s *rwb, FAR struct work_s *work,
+                        worker_t worker, uint32_t delay)
+{
+  /* We assume that the caller holds the wrsem */
+
+  rwb->wrpending++;
+  (void)work_queue(LPWORK, work, worker, (FAR void *)rwb, delay);
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrcancel
+ *
+ * Description:
+ *   Cancel write buffer work that has not yet been started.  Work that the
+ *   worker thread has already taken from the queue cannot be cancelled; it
+ *   remains pending until the worker function has finished.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITEBUFFER
+static void rwb_wrcancel(FAR struct rwbuffer_s *rwb, FAR struct work_s *work)
+{
+  irqstate_t flags;
+
+  /* We assume that the caller holds the wrsem.  The work is taken from the
+   * queue with interrupts disabled, so it cannot be started while we look.
+   */
+
+  flags = irqsave();
+  if (!work_available(work))
+    {
+      (void)work_cancel(LPWORK, work);
+      rwb->wrpending--;
+    }
+
+  irqrestore(flags);
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrflushseg
+ *
+ * Description:
+ *   Write one segment of the write buffer to the media and empty it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITEBUFFER
+static int rwb_wrflushseg(FAR struct rwbuffer_s *rwb,
+                          FAR struct rwbseg_s *seg)
+{
+  ssize_t ret = OK;
+
+  /* We assume that the caller holds the wrsem and that the worker is not
+   * writing this segment.
+   */
+
+  DEBUGASSERT(!seg->flushing);
+  if (seg->nblocks > 0)
     {
       fvdbg("Flushing: blockstart=0x%08lx nblocks=%d from buffer=%p\n",
-      (long)rwb->wrblockstart, rwb->wrnblocks, rwb->wrbuffer);
+            (long)seg->blockstart, seg->nblocks, seg->buffer);
 
-      /* Flush cache.  On success, the flush method will return the number
-       * of blocks written.  Anything other than the number requested is
-       * an error.
+      /* On success, the flush method will return the number of blocks
+       * written.  Anything other than the number requested is an error.
        */
 
-      ret = rwb->wrflush(rwb->dev, rwb->wrbuffer, rwb->wrblockstart, rwb->wrnblocks);
-      if (ret != rwb->wrnblocks)
+      ret = rwb_mdflush(rwb, seg->buffer, seg->blockstart, seg->nblocks);
+      if (ret != seg->nblocks)
         {
           fdbg("ERROR: Error flushing write buffer: %d\n", ret);
+          ret = ret < 0 ? ret : -EIO;
         }
-      
-      rwb_resetwrbuffer(rwb);
+      else
+        {
+          ret = OK;
+        }
+
+      rwb_resetseg(seg);
     }
 
-  rwb_semgive(&rwb->wrsem);
+  return (int)ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrflushrange
+ *
+ * Description:
+ *   Flush every write segment that holds any of the blocks in the range.
+ *   If 'nblocks' is zero, all write segments are flushed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITEBUFFER
+static int rwb_wrflushrange(FAR struct rwbuffer_s *rwb, off_t startblock,
+                            size_t nblocks)
+{
+  FAR struct rwbseg_s *seg;
+  int result = OK;
+  int ret;
+  int i;
+
+  /* We assume that the caller holds the wrsem.  Segments that the worker
+   * is writing are finished first; the wrsem is not released after that.
+   */
+
+  rwb_wrwaitrange(rwb, startblock, nblocks);
+  for (i = 0; i < CONFIG_FS_NWRSEGS; i++)
+    {
+      seg = &rwb->wrseg[i];
+      if (nblocks == 0 ||
+          rwb_overlap(seg->blockstart, seg->nblocks, startblock, nblocks))
+        {
+          ret = rwb_wrflushseg(rwb, seg);
+          if (ret < 0)
+            {
+              result = ret;
+            }
+        }
+    }
+
+  return result;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrmerge
+ *
+ * Description:
+ *   Copy any buffered write data for the range of blocks into 'buffer'.
+ *   This is used to update data just read from the media with data that
+ *   has not yet been written to the media.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITEBUFFER
+static void rwb_wrmerge(FAR struct rwbuffer_s *rwb, off_t startblock,
+                        size_t nblocks, FAR uint8_t *buffer)
+{
+  FAR struct rwbseg_s *seg;
+  int i;
+
+  /* We assume that the caller holds the wrsem */
+
+  for (i = 0; i < CONFIG_FS_NWRSEGS; i++)
+    {
+      seg = &rwb->wrseg[i];
+      if (rwb_overlap(seg->blockstart, seg->nblocks, startblock, nblocks))
+        {
+          rwb_copyoverlap(rwb, seg, startblock, nblocks, buffer, false);
+        }
+    }
 }
 #endif
 
@@ -187,6 +499,7 @@ static void rwb_wrflush(struct rwbuffer_s *rwb)
  * Name: rwb_wrtimeout
  ****************************************************************************/
 
+#ifdef CONFIG_FS_WRITEBUFFER
 static void rwb_wrtimeout(FAR void *arg)
 {
   /* The following assumes that the size of a pointer is 4-bytes or less */
@@ -196,188 +509,481 @@ static void rwb_wrtimeout(FAR void *arg)
 
   /* If a timeout elpases with with write buffer activity, this watchdog
    * handler function will be evoked on the thread of execution of the
-   * worker thread.
+   * worker thread.  Flush all of the write segments.
    */
 
-  rwb_wrflush(rwb);
+  fvdbg("Timeout!\n");
+
+  rwb_semtake(&rwb->wrsem);
+  (void)rwb_wrflushrange(rwb, 0, 0);
+
+  /* Let rwb_uninitialize() know that the worker is finished with rwb */
+
+  rwb->wrpending--;
+  rwb_wrwakeup(rwb);
+  rwb_semgive(&rwb->wrsem);
 }
+#endif
 
 /****************************************************************************
- * Name: rwb_wrstarttimeout
+ * Name: rwb_wrworker
+ *
+ * Description:
+ *   Flush all full write segments.  This runs on the worker thread so that
+ *   the writer can continue to fill other segments while the full ones are
+ *   written to the media.
+ *
+ *   Each full segment is marked as flushing while the wrsem is held and
+ *   then written without the wrsem.  A flushing segment is neither
+ *   modified nor re-used, but its data is still merged into reads.
+ *   Writers that need the segment wait in rwb_wrwaitrange().
+ *
  ****************************************************************************/
 
-static void rwb_wrstarttimeout(FAR struct rwbuffer_s *rwb)
+#ifdef CONFIG_FS_WRITEBUFFER
+static void rwb_wrworker(FAR void *arg)
 {
-  /* CONFIG_FS_WRDELAY provides the delay period in milliseconds. CLK_TCK
-   * provides the clock tick of the system (frequency in Hz).
-   */
+  FAR struct rwbuffer_s *rwb = (struct rwbuffer_s *)arg;
+  FAR struct rwbseg_s *seg;
+  off_t blockstart;
+  uint16_t nblocks;
+  ssize_t ret;
+  int i;
+
+  DEBUGASSERT(rwb != NULL);
+
+  rwb_semtake(&rwb->wrsem);
+  do
+    {
+      /* Find a full segment that is not already being written */
 
-  int ticks = (CONFIG_FS_WRDELAY + CLK_TCK/2) / CLK_TCK;
-  (void)work_queue(LPWORK, &rwb->work, rwb_wrtimeout, (FAR void *)rwb, ticks);
+      for (i = 0; i < CONFIG_FS_NWRSEGS; i++)
+        {
+          seg = &rwb->wrseg[i];
+          if (!seg->flushing && seg->nblocks >= rwb->wrmaxblocks)
+            {
+              break;
+            }
+        }
+
+      if (i < CONFIG_FS_NWRSEGS)
+        {
+          /* Detach the segment and write it to the media without the
+           * wrsem.
+           */
+
+          blockstart    = seg->blockstart;
+          nblocks       = seg->nblocks;
+          seg->flushing = true;
+          rwb_semgive(&rwb->wrsem);
+
+          fvdbg("Flushing: blockstart=0x%08lx nblocks=%d from buffer=%p\n",
+                (long)blockstart, nblocks, seg->buffer);
+
+          ret = rwb_mdflush(rwb, seg->buffer, blockstart, nblocks);
+          if (ret != nblocks)
+            {
+              fdbg("ERROR: Error flushing write buffer: %d\n", ret);
+            }
+
+          /* Then empty the segment and wake up anyone waiting for it */
+
+          rwb_semtake(&rwb->wrsem);
+          seg->flushing = false;
+          rwb_resetseg(seg);
+          rwb_wrwakeup(rwb);
+        }
+    }
+  while (i < CONFIG_FS_NWRSEGS);
+
+  /* Let rwb_uninitialize() know that the worker is finished with rwb */
+
+  rwb->wrpending--;
+  rwb_wrwakeup(rwb);
+  rwb_semgive(&rwb->wrsem);
 }
+#endif
 
 /****************************************************************************
- * Name: rwb_wrcanceltimeout
+ * Name: rwb_wrstarttimeout
  ****************************************************************************/
 
-static inline void rwb_wrcanceltimeout(struct rwbuffer_s *rwb)
+#ifdef CONFIG_FS_WRITEBUFFER
+static void rwb_wrstarttimeout(FAR struct rwbuffer_s *rwb)
 {
-  (void)work_cancel(LPWORK, &rwb->work);
+  /* CONFIG_FS_WRDELAY provides the delay period in milliseconds.  The
+   * work must be cancelled before it can be re-queued.
+   */
+
+  rwb_wrcancel(rwb, &rwb->work);
+  rwb_wrqueue(rwb, &rwb->work, rwb_wrtimeout, MSEC2TICK(CONFIG_FS_WRDELAY));
 }
+#endif
 
 /****************************************************************************
  * Name: rwb_writebuffer
+ *
+ * Description:
+ *   Add blocks to the write buffer.  Blocks that rewrite data already in a
+ *   segment are updated in place; blocks that follow the last block of a
+ *   segment are appended to it so that each sequential stream of writes
+ *   accumulates in its own segment.  Otherwise a new segment is started,
+ *   re-using an empty segment, a full segment, or the least recently used
+ *   segment (in that order of preference).
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_FS_WRITEBUFFER
 static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
-                               off_t startblock, uint32_t nblocks,
+                               off_t startblock, size_t nblocks,
                                FAR const uint8_t *wrbuffer)
 {
+  FAR struct rwbseg_s *seg;
+  FAR struct rwbseg_s *victim;
+  uint32_t maxage;
+  uint32_t age;
   int ret;
+  int i;
+
+  /* We assume that the caller holds the wrsem.  Wait until none of the
+   * blocks is in a segment that the worker is writing and there is a
+   * segment that can be used.  The wrsem is not released after that.
+   */
+
+  DEBUGASSERT(nblocks <= rwb->wrmaxblocks);
+  rwb_wrwaitrange(rwb, startblock, nblocks);
+  rwb->wrusecount++;
+
+  /* Are all of the blocks already in one segment?  Then just update them */
 
-  /* Write writebuffer Logic */
+  for (i = 0; i < CONFIG_FS_NWRSEGS; i++)
+    {
+      seg = &rwb->wrseg[i];
+      if (seg->nblocks > 0 && startblock >= seg->blockstart &&
+          startblock + nblocks <= seg->blockstart + seg->nblocks)
+        {
+          rwb_copyoverlap(rwb, seg, startblock, nblocks,
+                          (FAR uint8_t *)wrbuffer, true);
+          seg->lastuse = rwb->wrusecount;
+          return nblocks;
+        }
+    }
 
-  rwb_wrcanceltimeout(rwb);
-  
-  /* First: Should we flush out our cache? We would do that if (1) we already
-   * buffering blocks and the next block writing is not in the same sequence,
-   * or (2) the number of blocks would exceed our allocated buffer capacity
+  /* Any segment that holds some, but not all, of the blocks must be written
+   * to the media first so that the older data does not later overwrite the
+   * new data.
    */
 
-  if (((startblock != rwb->wrexpectedblock) && (rwb->wrnblocks)) ||
-      ((rwb->wrnblocks + nblocks) > rwb->wrmaxblocks))
+  ret = rwb_wrflushrange(rwb, startblock, nblocks);
+  if (ret < 0)
     {
-      fvdbg("writebuffer miss, expected: %08x, given: %08x\n",
-            rwb->wrexpectedblock, startblock);
-    
-      /* Flush the write buffer */
+      return ret;
+    }
+
+  /* Look for a segment that these blocks can be appended to */
 
-      ret = rwb->wrflush(rwb, rwb->wrbuffer, rwb->wrblockstart, rwb->wrnblocks);
+  victim = NULL;
+  for (i = 0; i < CONFIG_FS_NWRSEGS; i++)
+    {
+      seg = &rwb->wrseg[i];
+      if (!seg->flushing && seg->nblocks > 0 &&
+          startblock == seg->blockstart + seg->nblocks &&
+          seg->nblocks + nblocks <= rwb->wrmaxblocks)
+        {
+          victim = seg;
+          break;
+        }
+    }
+
+  /* Otherwise, select the segment to start the new run in */
+
+  if (!victim)
+    {
+      maxage = 0;
+      for (i = 0; i < CONFIG_FS_NWRSEGS; i++)
+        {
+          seg = &rwb->wrseg[i];
+          if (seg->flushing)
+            {
+              continue;
+            }
+
+          if (seg->nblocks == 0)
+            {
+              victim = seg;
+              break;
+            }
+
+          age = rwb->wrusecount - seg->lastuse;
+          if (seg->nblocks >= rwb->wrmaxblocks)
+            {
+              /* Full segments will be flushed anyway; prefer them */
+
+              age |= 0x80000000;
+            }
+
+          if (!victim || age > maxage)
+            {
+              victim = seg;
+              maxage = age;
+            }
+        }
+
+      fvdbg("writebuffer miss, starting new segment at: %08lx\n",
+            (long)startblock);
+
+      ret = rwb_wrflushseg(rwb, victim);
       if (ret < 0)
         {
-          fdbg("ERROR: Error writing multiple from cache: %d\n", -ret);
           return ret;
         }
 
-      rwb_resetwrbuffer(rwb);
+      victim->blockstart = startblock;
     }
-  
-  /* writebuffer is empty? Then initialize it */
 
-  if (!rwb->wrnblocks)
+  /* Add data to the segment */
+
+  memcpy(&victim->buffer[victim->nblocks * rwb->blocksize], wrbuffer,
+         nblocks * rwb->blocksize);
+
+  victim->nblocks += nblocks;
+  victim->lastuse  = rwb->wrusecount;
+
+  /* If the segment is now full, then start writing it to the media on the
+   * worker thread.
+   */
+
+  if (victim->nblocks >= rwb->wrmaxblocks && work_available(&rwb->flwork))
     {
-      fvdbg("Fresh cache starting at block: 0x%08x\n", startblock);
-      rwb->wrblockstart = startblock;
+      rwb_wrqueue(rwb, &rwb->flwork, rwb_wrworker, 0);
     }
-  
-  /* Add data to cache */
-
-  fvdbg("writebuffer: copying %d bytes from %p to %p\n",
-        nblocks * rwb->blocksize, wrbuffer,
-        &rwb->wrbuffer[rwb->wrnblocks * rwb->blocksize]);
-  memcpy(&rwb->wrbuffer[rwb->wrnblocks * rwb->blocksize],
-         wrbuffer, nblocks * rwb->blocksize);
 
-  rwb->wrnblocks      += nblocks;
-  rwb->wrexpectedblock = rwb->wrblockstart + rwb->wrnblocks;
-  rwb_wrstarttimeout(rwb);
   return nblocks;
 }
 #endif
 
 /****************************************************************************
- * Name: rwb_resetrhbuffer
+ * Name: rwb_rhstream
+ *
+ * Description:
+ *   A read of 'startblock' missed the read-ahead buffer.  Select the segment
+ *   to be reloaded and return the first block to be loaded into it.
+ *
+ *   If the read continues the stream of reads served by a segment (either
+ *   sequentially or with the same stride as the previous two reads), then
+ *   that segment is re-used.  Otherwise, an empty segment or the least
+ *   recently used segment starts a new stream.  The stride of the stream
+ *   selects the window to read ahead:  Forward streams read ahead from
+ *   'startblock', backward streams read the blocks preceding 'startblock',
+ *   and streams whose stride is larger than the segment do not read ahead
+ *   at all.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_FS_READAHEAD
-static inline void rwb_resetrhbuffer(struct rwbuffer_s *rwb)
+static FAR struct rwbseg_s *rwb_rhstream(FAR struct rwbuffer_s *rwb,
+                                         off_t startblock, size_t nblocks,
+                                         FAR off_t *loadstart,
+                                         FAR size_t *nload)
 {
-  /* We assume that the caller holds the readAheadBufferSemphore */
+  FAR struct rwbseg_s *seg;
+  FAR struct rwbseg_s *victim = NULL;
+  off_t stride = 0;
+  off_t endblock;
+  uint32_t maxage = 0;
+  uint32_t age;
+  int i;
+
+  /* Look for a stream that this read continues */
+
+  for (i = 0; i < CONFIG_FS_NRHSEGS; i++)
+    {
+      seg = &rwb->rhseg[i];
+      if (seg->nblocks == 0)
+        {
+          continue;
+        }
+
+      if (startblock == seg->nextblock ||
+          (seg->stride != 0 && startblock == seg->laststart + seg->stride))
+        {
+          victim = seg;
+          stride = startblock - seg->laststart;
+          break;
+        }
+    }
+
+  /* Otherwise, start a new stream in an empty or the LRU segment */
+
+  if (!victim)
+    {
+      for (i = 0; i < CONFIG_FS_NRHSEGS; i++)
+        {
+          seg = &rwb->rhseg[i];
+          if (seg->nblocks == 0)
+            {
+              victim = seg;
+              break;
+            }
+
+          age = rwb->rhusecount - seg->lastuse;
+          if (!victim || age > maxage)
+            {
+              victim = seg;
+              maxage = age;
+            }
+        }
 
-  rwb->rhnblocks    = 0;
-  rwb->rhblockstart = (off_t)-1;
+      victim->laststart = startblock;
+      victim->stride    = 0;
+    }
+
+  /* Select the window to be loaded */
+
+  if (stride < 0)
+    {
+      endblock = startblock + nblocks;
+      *loadstart = endblock - rwb->rhmaxblocks;
+      if (*loadstart < 0)
+        {
+          *loadstart = 0;
+        }
+
+      *nload = endblock - *loadstart;
+    }
+  else
+    {
+      *loadstart = startblock;
+      *nload     = stride > rwb->rhmaxblocks ? nblocks : rwb->rhmaxblocks;
+      if (*loadstart + *nload > rwb->nblocks)
+        {
+          *nload = rwb->nblocks - *loadstart;
+        }
+    }
+
+  return victim;
 }
 #endif
 
 /****************************************************************************
- * Name: rwb_bufferread
+ * Name: rwb_rhreload
  ****************************************************************************/
 
 #ifdef CONFIG_FS_READAHEAD
-static inline void
-rwb_bufferread(struct rwbuffer_s *rwb,  off_t startblock,
-               size_t nblocks, uint8_t **rdbuffer)
+static int rwb_rhreload(FAR struct rwbuffer_s *rwb, FAR struct rwbseg_s *seg,
+                        off_t startblock, size_t nblocks)
 {
-  /* We assume that (1) the caller holds the readAheadBufferSemphore, and (2)
-   * that the caller already knows that all of the blocks are in the
-   * read-ahead buffer.
-   */
+  ssize_t ret;
 
-  /* Convert the units from blocks to bytes */
+  /* Reset the segment */
 
-  off_t  blockoffset = startblock - rwb->rhblockstart;
-  off_t  byteoffset  = rwb->blocksize * blockoffset;
-  size_t nbytes      = rwb->blocksize * nblocks;
+  rwb_resetseg(seg);
 
-  /* Get the byte address in the read-ahead buffer */
+  /* Now perform the read */
 
-  uint8_t *rhbuffer    = rwb->rhbuffer + byteoffset;
+  ret = rwb_mdreload(rwb, seg->buffer, startblock, nblocks);
+  if (ret != nblocks)
+    {
+      return ret < 0 ? (int)ret : -EIO;
+    }
 
-  /* Copy the data from the read-ahead buffer into the IO buffer */
+  /* The media may not yet hold the most recent data */
 
-  memcpy(*rdbuffer, rhbuffer, nbytes);
+#ifdef CONFIG_FS_WRITEBUFFER
+  rwb_wrmerge(rwb, startblock, nblocks, seg->buffer);
+#endif
 
-  /* Update the caller's copy for the next address */
+  /* Update information about what is in the read-ahead segment */
 
-  *rdbuffer += nbytes;
+  seg->nblocks    = nblocks;
+  seg->blockstart = startblock;
+  return OK;
 }
 #endif
 
 /****************************************************************************
- * Name: rwb_rhreload
+ * Name: rwb_readbuffer
+ *
+ * Description:
+ *   Read blocks through the read-ahead buffer.  The request may be satisfied
+ *   from several segments.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_FS_READAHEAD
-static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
+static ssize_t rwb_readbuffer(FAR struct rwbuffer_s *rwb, off_t startblock,
+                              size_t nblocks, FAR uint8_t *rdbuffer)
 {
-  /* Get the block number +1 of the last block that will fit in the
-   * read-ahead buffer
-   */
-
-  off_t  endblock  = startblock + rwb->rhmaxblocks;
-  size_t nblocks;
+  FAR struct rwbseg_s *stream = NULL;
+  FAR struct rwbseg_s *seg;
+  off_t  block     = startblock;
+  size_t remaining = nblocks;
+  size_t ncopy;
+  off_t  loadstart;
+  size_t nload;
   int    ret;
+  int    i;
 
-  /* Reset the read buffer */
+  /* We assume that the caller holds the rhsem */
 
-  rwb_resetrhbuffer(rwb);
+  rwb->rhusecount++;
+  while (remaining > 0)
+    {
+      /* Find the segment that holds the next block */
 
-  /* Make sure that we don't read past the end of the device */
+      seg = NULL;
+      for (i = 0; i < CONFIG_FS_NRHSEGS; i++)
+        {
+          if (rwb_overlap(rwb->rhseg[i].blockstart, rwb->rhseg[i].nblocks,
+                          block, 1))
+            {
+              seg = &rwb->rhseg[i];
+              break;
+            }
+        }
 
-  if (endblock > rwb->nblocks)
-    {
-      endblock = rwb->nblocks;
-    }
+      /* If it is not in the buffer, then we have to reload a segment */
 
-  nblocks = endblock - startblock;
+      if (!seg)
+        {
+          seg = rwb_rhstream(rwb, block, remaining, &loadstart, &nload);
+          ret = rwb_rhreload(rwb, seg, loadstart, nload);
+          if (ret < 0)
+            {
+              fdbg("ERROR: Failed to fill the read-ahead buffer: %d\n", -ret);
+              return ret;
+            }
+        }
 
-  /* Now perform the read */
+      /* The stream state is kept in the segment holding the first block */
 
-  ret = rwb->rhreload(rwb->dev, rwb->rhbuffer, startblock, nblocks);
-  if (ret == nblocks)
-    {
-      /* Update information about what is in the read-ahead buffer */
+      if (!stream)
+        {
+          stream = seg;
+        }
 
-      rwb->rhnblocks    = nblocks;
-      rwb->rhblockstart = startblock;
+      /* Copy as many blocks as this segment holds */
 
-      /* The return value is not the number of blocks we asked to be loaded. */
+      ncopy = seg->blockstart + seg->nblocks - block;
+      if (ncopy > remaining)
+        {
+          ncopy = remaining;
+        }
+
+      rwb_copyoverlap(rwb, seg, block, ncopy, rdbuffer, false);
+      seg->lastuse = rwb->rhusecount;
 
-      return nblocks;
+      block     += ncopy;
+      rdbuffer  += ncopy * rwb->blocksize;
+      remaining -= ncopy;
     }
 
-  return -EIO;
+  /* Update the stream state */
+
+  stream->stride    = startblock - stream->laststart;
+  stream->laststart = startblock;
+  stream->nextblock = startblock + nblocks;
+  return nblocks;
 }
 #endif
 
@@ -391,6 +997,7 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
 int rwb_initialize(FAR struct rwbuffer_s *rwb)
 {
   uint32_t allocsize;
+  int i;
 
   /* Sanity checking */
 
@@ -398,15 +1005,14 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
   DEBUGASSERT(rwb->blocksize > 0);
   DEBUGASSERT(rwb->nblocks > 0);
   DEBUGASSERT(rwb->dev != NULL);
+  DEBUGASSERT(rwb->rhreload != NULL);
 
   /* Setup so that rwb_uninitialize can handle a failure */
 
 #ifdef CONFIG_FS_WRITEBUFFER
-  DEBUGASSERT(rwb->wrflush!= NULL);
   rwb->wrbuffer = NULL;
 #endif
 #ifdef CONFIG_FS_READAHEAD
-  DEBUGASSERT(rwb->rhreload != NULL);
   rwb->rhbuffer = NULL;
 #endif
 
@@ -416,26 +1022,40 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
   /* Initialize the write buffer access semaphore */
 
   sem_init(&rwb->wrsem, 0, 1);
+  sem_init(&rwb->wrdone, 0, 0);
+  sem_init(&rwb->mdsem, 0, 1);
 
   /* Initialize write buffer parameters */
 
-  rwb_resetwrbuffer(rwb);
+  memset(&rwb->work, 0, sizeof(struct work_s));
+  memset(&rwb->flwork, 0, sizeof(struct work_s));
+  rwb->wrusecount = 0;
+  rwb->wrpending  = 0;
+  rwb->wrnwaiters = 0;
 
-  /* Allocate the write buffer */
+  /* Allocate the write buffer.  All of the segments share one allocation */
 
-  rwb->wrbuffer = NULL;
   if (rwb->wrmaxblocks > 0)
     {
-      allocsize     = rwb->wrmaxblocks * rwb->blocksize;
+      allocsize     = CONFIG_FS_NWRSEGS * rwb->wrmaxblocks * rwb->blocksize;
       rwb->wrbuffer = kmalloc(allocsize);
       if (!rwb->wrbuffer)
         {
           fdbg("Write buffer kmalloc(%d) failed\n", allocsize);
           return -ENOMEM;
         }
+
+      fvdbg("Write buffer size: %d bytes\n", allocsize);
+    }
+
+  for (i = 0; i < CONFIG_FS_NWRSEGS; i++)
+    {
+      rwb_resetseg(&rwb->wrseg[i]);
+      rwb->wrseg[i].lastuse  = 0;
+      rwb->wrseg[i].flushing = false;
+      rwb->wrseg[i].buffer   = rwb->wrbuffer ?
+        &rwb->wrbuffer[i * rwb->wrmaxblocks * rwb->blocksize] : NULL;
     }
-  
-  fvdbg("Write buffer size: %d bytes\n", allocsize);
 #endif /* CONFIG_FS_WRITEBUFFER */
 
 #ifdef CONFIG_FS_READAHEAD
@@ -447,24 +1067,37 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 
   /* Initialize read-ahead buffer parameters */
 
-  rwb_resetrhbuffer(rwb);
+  rwb->rhusecount = 0;
 
-  /* Allocate the read-ahead buffer */
+  /* Allocate the read-ahead buffer.  All of the segments share one
+   * allocation.
+   */
 
-  rwb->rhbuffer = NULL;
   if (rwb->rhmaxblocks > 0)
     {
-      allocsize     = rwb->rhmaxblocks * rwb->blocksize;
+      allocsize     = CONFIG_FS_NRHSEGS * rwb->rhmaxblocks * rwb->blocksize;
       rwb->rhbuffer = kmalloc(allocsize);
       if (!rwb->rhbuffer)
         {
           fdbg("Read-ahead buffer kmalloc(%d) failed\n", allocsize);
           return -ENOMEM;
         }
+
+      fvdbg("Read-ahead buffer size: %d bytes\n", allocsize);
+    }
+
+  for (i = 0; i < CONFIG_FS_NRHSEGS; i++)
+    {
+      rwb_resetseg(&rwb->rhseg[i]);
+      rwb->rhseg[i].lastuse   = 0;
+      rwb->rhseg[i].laststart = RWB_NOBLOCK;
+      rwb->rhseg[i].stride    = 0;
+      rwb->rhseg[i].nextblock = RWB_NOBLOCK;
+      rwb->rhseg[i].buffer    = rwb->rhbuffer ?
+        &rwb->rhbuffer[i * rwb->rhmaxblocks * rwb->blocksize] : NULL;
     }
-  
-  fvdbg("Read-ahead buffer size: %d bytes\n", allocsize);
 #endif /* CONFIG_FS_READAHEAD */
+
   return 0;
 }
 
@@ -475,8 +1108,27 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
 {
 #ifdef CONFIG_FS_WRITEBUFFER
-  rwb_wrcanceltimeout(rwb);
+  /* Cancel the work that has not been started and wait for the work that
+   * has:  The worker must be finished with rwb before it is freed.
+   */
+
+  rwb_semtake(&rwb->wrsem);
+  rwb_wrcancel(rwb, &rwb->work);
+  rwb_wrcancel(rwb, &rwb->flwork);
+
+  while (rwb->wrpending > 0)
+    {
+      rwb_wrwait(rwb);
+    }
+
+  /* Write any buffered data to the media before discarding the buffer */
+
+  (void)rwb_wrflushrange(rwb, 0, 0);
+  rwb_semgive(&rwb->wrsem);
+
   sem_destroy(&rwb->wrsem);
+  sem_destroy(&rwb->wrdone);
+  sem_destroy(&rwb->mdsem);
   if (rwb->wrbuffer)
     {
       kfree(rwb->wrbuffer);
@@ -494,164 +1146,156 @@ void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
 
 /****************************************************************************
  * Name: rwb_read
+ *
+ * Description:
+ *   Read blocks through the read-ahead buffer.  Reads that are at least as
+ *   large as a read-ahead segment go directly to the media.  In either
+ *   case, the returned data includes any data that is still in the write
+ *   buffer.
+ *
+ *   To keep the buffers coherent, the write buffer semaphore is held
+ *   (and always taken before the read-ahead buffer semaphore) for the
+ *   duration of the read.
+ *
  ****************************************************************************/
 
-int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks,
-             FAR uint8_t *rdbuffer)
+ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
+                 size_t nblocks, FAR uint8_t *rdbuffer)
 {
-  uint32_t remaining;
- 
+  ssize_t ret;
+
   fvdbg("startblock=%ld nblocks=%ld rdbuffer=%p\n",
         (long)startblock, (long)nblocks, rdbuffer);
 
-#ifdef CONFIG_FS_WRITEBUFFER
-  /* If the new read data overlaps any part of the write buffer, then
-   * flush the write data onto the physical media before reading.  We
-   * could attempt some more exotic handling -- but this simple logic
-   * is well-suited for simple streaming applications.
-   */
-
-  if (rwb->wrmaxblocks > 0)
+  if (startblock < 0 || startblock + nblocks > rwb->nblocks)
     {
-      /* If the write buffer overlaps the block(s) requested, then flush the
-       * write buffer.
-       */
-
-      rwb_semtake(&rwb->wrsem);
-      if (rwb_overlap(rwb->wrblockstart, rwb->wrnblocks, startblock, nblocks))
-        {
-          rwb_wrflush(rwb);
-        }
-      rwb_semgive(&rwb->wrsem);
+      return -EINVAL;
     }
+
+#ifdef CONFIG_FS_WRITEBUFFER
+  rwb_semtake(&rwb->wrsem);
 #endif
 
 #ifdef CONFIG_FS_READAHEAD
-  /* Loop until we have read all of the requested blocks */
-
-  rwb_semtake(&rwb->rhsem);
-  for (remaining = nblocks; remaining > 0;)
+  if (rwb->rhmaxblocks > 0 && nblocks < rwb->rhmaxblocks)
     {
-      /* Is there anything in the read-ahead buffer? */
-
-      if (rwb->rhnblocks > 0)
-        {
-          off_t  startblock = startblock;
-          size_t nbufblocks = 0;
-          off_t  bufferend;
-
-          /* Loop for each block we find in the read-head buffer.  Count the
-           * number of buffers that we can read from read-ahead buffer.
-           */
-
-          bufferend = rwb->rhblockstart + rwb->rhnblocks;
-
-          while ((startblock >= rwb->rhblockstart) &&
-                 (startblock < bufferend) &&
-                 (remaining > 0))
-            {
-              /* This is one more that we will read from the read ahead buffer */
-
-              nbufblocks++;
-
-              /* And one less that we will read from the media */
-
-              startblock++;
-              remaining--;
-            }
-
-          /* Then read the data from the read-ahead buffer */
-
-          rwb_bufferread(rwb, startblock, nbufblocks, &rdbuffer);
-        }
+      rwb_semtake(&rwb->rhsem);
+      ret = rwb_readbuffer(rwb, startblock, nblocks, rdbuffer);
+      rwb_semgive(&rwb->rhsem);
+    }
+  else
+#endif
+    {
+      /* Read the data directly from the media */
 
-      /* If we did not get all of the data from the buffer, then we have to refill
-       * the buffer and try again.
-       */
+      ret = rwb_mdreload(rwb, rdbuffer, startblock, nblocks);
 
-      if (remaining > 0)
+#ifdef CONFIG_FS_WRITEBUFFER
+      if (ret == nblocks)
         {
-          int ret = rwb_rhreload(rwb, startblock);
-          if (ret < 0)
-            {
-              fdbg("ERROR: Failed to fill the read-ahead buffer: %d\n", -ret);
-              return ret;
-            }
+          rwb_wrmerge(rwb, startblock, nblocks, rdbuffer);
         }
+#endif
     }
 
+#ifdef CONFIG_FS_WRITEBUFFER
+  rwb_semgive(&rwb->wrsem);
+#endif
+
   /* On success, return the number of blocks that we were requested to read.
    * This is for compatibility with the normal return of a block driver read
    * method
    */
 
-  rwb_semgive(&rwb->rhsem);
-  return 0;
-#else
-  return rwb->rhreload(rwb->dev, startblock, nblocks, rdbuffer);
-#endif
+  return ret;
 }
 
 /****************************************************************************
  * Name: rwb_write
+ *
+ * Description:
+ *   Write blocks through the write buffer.  Writes that are larger than a
+ *   write segment go directly to the media.  Any copies of the blocks in
+ *   the read-ahead buffer are updated in place.
+ *
  ****************************************************************************/
 
-int rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
-              size_t nblocks, FAR const uint8_t *wrbuffer)
+ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
+                  size_t nblocks, FAR const uint8_t *wrbuffer)
 {
-  int ret;
+  ssize_t ret;
+#ifdef CONFIG_FS_READAHEAD
+  int i;
+#endif
+
+  fvdbg("startblock=%ld nblocks=%ld wrbuffer=%p\n",
+        (long)startblock, (long)nblocks, wrbuffer);
+  DEBUGASSERT(rwb->wrflush != NULL);
+
+  if (startblock < 0 || startblock + nblocks > rwb->nblocks)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_FS_WRITEBUFFER
+  rwb_semtake(&rwb->wrsem);
+#endif
 
 #ifdef CONFIG_FS_READAHEAD
-  /* If the new write data overlaps any part of the read buffer, then
-   * flush the data from the read buffer.  We could attempt some more
-   * exotic handling -- but this simple logic is well-suited for simple
-   * streaming applications.
+  /* If the new write data overlaps any part of the read-ahead buffer, then
+   * update the data in the read-ahead buffer.
    */
 
   rwb_semtake(&rwb->rhsem);
-  if (rwb_overlap(rwb->rhblockstart, rwb->rhnblocks, startblock, nblocks))
+  for (i = 0; i < CONFIG_FS_NRHSEGS; i++)
     {
-      rwb_resetrhbuffer(rwb);
+      if (rwb_overlap(rwb->rhseg[i].blockstart, rwb->rhseg[i].nblocks,
+                      startblock, nblocks))
+        {
+          rwb_copyoverlap(rwb, &rwb->rhseg[i], startblock, nblocks,
+                          (FAR uint8_t *)wrbuffer, true);
+        }
     }
+
   rwb_semgive(&rwb->rhsem);
 #endif
 
 #ifdef CONFIG_FS_WRITEBUFFER
-  fvdbg("startblock=%d wrbuffer=%p\n", startblock, wrbuffer);
+  /* Use the write buffer unless the transfer is bigger than one segment */
 
-  /* Use the block cache unless the buffer size is bigger than block cache */   
-     
-  if (nblocks > rwb->wrmaxblocks)
+  if (rwb->wrmaxblocks > 0 && nblocks <= rwb->wrmaxblocks)
     {
-      /* First flush the cache */
-
-      rwb_semtake(&rwb->wrsem);
-      rwb_wrflush(rwb);
-      rwb_semgive(&rwb->wrsem);
-
-      /* Then transfer the data directly to the media */
+      /* Buffer the data in the write buffer and (re-)start the timeout
+       * that flushes the buffer if there is no further write activity.
+       */
 
-      ret = rwb->wrflush(rwb->dev, startblock, nblocks, wrbuffer);
+      ret = rwb_writebuffer(rwb, startblock, nblocks, wrbuffer);
+      rwb_wrstarttimeout(rwb);
     }
   else
     {
-      /* Buffer the data in the write buffer */
+      /* First flush any older buffered data for these blocks, then
+       * transfer the data directly to the media.
+       */
 
-      ret = rwb_writebuffer(rwb, startblock, nblocks, wrbuffer);
+      ret = rwb_wrflushrange(rwb, startblock, nblocks);
+      if (ret >= 0)
+        {
+          ret = rwb_mdflush(rwb, wrbuffer, startblock, nblocks);
+        }
     }
 
+  rwb_semgive(&rwb->wrsem);
+#else
+  ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
+#endif
+
   /* On success, return the number of blocks that we were requested to write.
    * This is for compatibility with the normal return of a block driver write
    * method
    */
 
   return ret;
-
-#else
-
-  return rwb->wrflush(rwb->dev, startblock, nblocks, wrbuffer);
-
-#endif
 }
 
 /****************************************************************************
@@ -664,19 +1308,50 @@ int rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
 
 int rwb_mediaremoved(FAR struct rwbuffer_s *rwb)
 {
+  int i;
+
 #ifdef CONFIG_FS_WRITEBUFFER
   rwb_semtake(&rwb->wrsem);
-  rwb_resetwrbuffer(rwb);
+  for (i = 0; i < CONFIG_FS_NWRSEGS; i++)
+    {
+      rwb_resetseg(&rwb->wrseg[i]);
+    }
+
   rwb_semgive(&rwb->wrsem);
 #endif
 
 #ifdef CONFIG_FS_READAHEAD
   rwb_semtake(&rwb->rhsem);
-  rwb_resetrhbuffer(rwb);
+  for (i = 0; i < CONFIG_FS_NRHSEGS; i++)
+    {
+      rwb_resetseg(&rwb->rhseg[i]);
+    }
+
   rwb_semgive(&rwb->rhsem);
 #endif
   return 0;
 }
 
-#endif /* CONFIG_FS_WRITEBUFFER || CONFIG_FS_READAHEAD */
+/****************************************************************************
+ * Name: rwb_flush
+ *
+ * Description:
+ *   Write all buffered data to the media now, in the caller's context.
+ *
+ ****************************************************************************/
+
+int rwb_flush(FAR struct rwbuffer_s *rwb)
+{
+#ifdef CONFIG_FS_WRITEBUFFER
+  int ret;
+
+  rwb_semtake(&rwb->wrsem);
+  ret = rwb_wrflushrange(rwb, 0, 0);
+  rwb_semgive(&rwb->wrsem);
+  return ret;
+#else
+  return OK;
+#endif
+}
 
+#endif /* CONFIG_FS_WRITEBUFFER || CONFIG_FS_READAHEAD */
@@ -70,6 +70,18 @@
  * Definitions
  ****************************************************************************/
 
+/* The number of clusters that a write of 'n' more bytes will need.  This is
+ * used to find a contiguous run of free clusters for large writes.
+ */
+
+#ifdef CONFIG_FAT_CONTIGALLOC
+#  define FAT_WRITECLUSTERS(fs,n) \
+     ((n) > 0 ? ((n) + (fs)->fs_hwsectorsize * (fs)->fs_fatsecperclus - 1) / \
+                ((fs)->fs_hwsectorsize * (fs)->fs_fatsecperclus) : 1)
+#else
+#  define FAT_WRITECLUSTERS(fs,n) 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -551,6 +563,12 @@ fat_read_restart:
 
           /* Read all of the sectors directly into user memory */
 
+          ret = fat_fscacheinvalidate(fs, ff->ff_currentsector, nsectors);
+          if (ret < 0)
+            {
+              goto errout_with_semaphore;
+            }
+
           ret = fat_hwread(fs, userbuffer, ff->ff_currentsector, nsectors);
           if (ret < 0)
             {
@@ -728,7 +746,8 @@ static ssize_t fat_write(FAR struct file *filep, const char *buffer,
         {
           /* No.. we have to create a new cluster chain */
 
-          ff->ff_startcluster     = fat_createchain(fs);
+          ff->ff_startcluster     =
+            fat_extendchainrun(fs, 0, FAT_WRITECLUSTERS(fs, buflen));
           ff->ff_currentcluster   = ff->ff_startcluster;
           ff->ff_sectorsincluster = fs->fs_fatsecperclus;
         }
@@ -787,6 +806,12 @@ fat_write_restart:
 
           /* Write all of the sectors directly from user memory */
 
+          ret = fat_fscacheinvalidate(fs, ff->ff_currentsector, nsectors);
+          if (ret < 0)
+            {
+              goto errout_with_semaphore;
+            }
+
           ret = fat_hwwrite(fs, userbuffer, ff->ff_currentsector, nsectors);
           if (ret < 0)
             {
@@ -905,7 +930,8 @@ fat_write_restart:
            * move the file position back from the end of the file)
            */
 
-          cluster = fat_extendchain(fs, ff->ff_currentcluster);
+          cluster = fat_extendchainrun(fs, ff->ff_currentcluster,
+                                       FAT_WRITECLUSTERS(fs, buflen));
 
           /* Verify the cluster number */
 
@@ -1817,6 +1843,15 @@ static int fat_unbind(void *handle, FAR struct inode **blkdriver)
     }
   else
     {
+#ifdef CONFIG_FAT_SECTORCACHE
+      /* Write back any sectors still dirty in the sector cache */
+
+      if (fs->fs_mounted && fs->fs_cachebuffer)
+        {
+          (void)fat_fscacheflush(fs);
+        }
+
+#endif
        /* Unmount ... close the block driver */
 
       if (fs->fs_blkdriver)
@@ -1844,10 +1879,17 @@ static int fat_unbind(void *handle, FAR struct inode **blkdriver)
 
       /* Release the mountpoint private data */
 
+#ifdef CONFIG_FAT_FREEBITMAP
+      fat_freemaprelease(fs);
+#endif
+#ifdef CONFIG_FAT_SECTORCACHE
+      fat_fscacherelease(fs);
+#else
       if (fs->fs_buffer)
         {
           fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
         }
+#endif
 
       kfree(fs);
     }
@@ -2069,6 +2111,14 @@ static int fat_mkdir(struct inode *mountpt, const char *relpath, mode_t mode)
       goto errout_with_semaphore;
     }
 
+  /* Discard any stale copies of the directory cluster in the sector cache */
+
+  ret = fat_fscacheinvalidate(fs, dirsector, fs->fs_fatsecperclus);
+  if (ret < 0)
+    {
+      goto errout_with_semaphore;
+    }
+
   /* Get a pointer to the first directory entry in the sector */
 
   direntry = fs->fs_buffer;
@@ -50,11 +50,33 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/dirent.h>
+#include <nuttx/fs/fat.h>
 
 /****************************************************************************
  * Definitions
  ****************************************************************************/
 
+/* Configuration ************************************************************/
+
+#ifdef CONFIG_FAT_SECTORCACHE
+#  ifndef CONFIG_FAT_SECTORCACHE_NSECTORS
+#    define CONFIG_FAT_SECTORCACHE_NSECTORS 8
+#  endif
+#  if CONFIG_FAT_SECTORCACHE_NSECTORS < 1 || CONFIG_FAT_SECTORCACHE_NSECTORS > 255
+#    error "CONFIG_FAT_SECTORCACHE_NSECTORS must be in the range 1-255"
+#  endif
+#  ifndef CONFIG_FAT_SECTORCACHE_READAHEAD
+#    define CONFIG_FAT_SECTORCACHE_READAHEAD 4
+#  endif
+#  if CONFIG_FAT_SECTORCACHE_READAHEAD < 1
+#    undef  CONFIG_FAT_SECTORCACHE_READAHEAD
+#    define CONFIG_FAT_SECTORCACHE_READAHEAD 1
+#  elif CONFIG_FAT_SECTORCACHE_READAHEAD > CONFIG_FAT_SECTORCACHE_NSECTORS
+#    undef  CONFIG_FAT_SECTORCACHE_READAHEAD
+#    define CONFIG_FAT_SECTORCACHE_READAHEAD CONFIG_FAT_SECTORCACHE_NSECTORS
+#  endif
+#endif
+
 /****************************************************************************
  * These offsets describes the master boot record.
  *
@@ -709,6 +731,21 @@
  * Public Types
  ****************************************************************************/
 
+/* This structure describes one sector in the mountpoint sector cache.  The
+ * entry that holds the sector currently in fs_buffer is described by
+ * fs_currentsector and fs_dirty instead;  its entry is brought up to date
+ * whenever the cache is accessed.
+ */
+
+#ifdef CONFIG_FAT_SECTORCACHE
+struct fat_cacheentry_s
+{
+  off_t    ce_sector;              /* The sector held in this entry */
+  uint32_t ce_age;                 /* Value of fs_cacheclock when last used */
+  uint8_t  ce_flags;               /* See FATCACHE_* definitions */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a fat32 filesystem.
@@ -743,6 +780,19 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one sector
                                     * from the device */
+#ifdef CONFIG_FAT_SECTORCACHE
+  uint8_t  fs_cacheindex;          /* Cache entry in fs_buffer */
+  uint32_t fs_cacheclock;          /* Incremented on each cache access */
+  uint8_t *fs_cachebuffer;         /* Allocated buffer holding all cached sectors;
+                                    * fs_buffer points into this buffer */
+  struct fat_cacheentry_s fs_cache[CONFIG_FAT_SECTORCACHE_NSECTORS];
+  struct fat_cachestats_s fs_cachestats;
+#endif
+#ifdef CONFIG_FAT_FREEBITMAP
+  bool      fs_freemaptried;       /* true: Creation of fs_freemap was attempted */
+  uint32_t  fs_nfreemap;           /* Number of free clusters in fs_freemap */
+  uint32_t *fs_freemap;            /* One bit per cluster, set if free (may be NULL) */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -858,6 +908,10 @@ extern "C" {
 #define EXTERN extern
 #endif
 
+/* The FAT mountpoint operations (defined in fs_fat32.c) */
+
+EXTERN const struct mountpt_operations fat_operations;
+
 /* Utitilies to handle unaligned or byte swapped accesses */
 
 EXTERN uint16_t fat_getuint16(uint8_t *ptr);
@@ -894,9 +948,23 @@ EXTERN off_t  fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno);
 EXTERN int    fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
                              off_t startsector);
 EXTERN int    fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster);
-EXTERN int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster);
-
-#define fat_createchain(fs) fat_extendchain(fs, 0)
+EXTERN int32_t fat_extendchainrun(struct fat_mountpt_s *fs, uint32_t cluster,
+                                  uint32_t nclusters);
+
+#define fat_extendchain(fs,c) fat_extendchainrun(fs, c, 1)
+#define fat_createchain(fs)   fat_extendchain(fs, 0)
+
+/* Free cluster bitmap */
+
+#ifdef CONFIG_FAT_FREEBITMAP
+EXTERN int    fat_freemapinitialize(struct fat_mountpt_s *fs);
+EXTERN void   fat_freemaprelease(struct fat_mountpt_s *fs);
+EXTERN bool   fat_freemapready(struct fat_mountpt_s *fs);
+EXTERN void   fat_freemapupdate(struct fat_mountpt_s *fs, uint32_t cluster,
+                                bool free);
+EXTERN uint32_t fat_freemapfind(struct fat_mountpt_s *fs, uint32_t start,
+                                uint32_t nclusters);
+#endif
 
 /* Help for traversing directory trees and accessing directory entries */
 
@@ -918,6 +986,14 @@ EXTERN int    fat_remove(struct fat_mountpt_s *fs, const char *relpath, bool dir
 
 /* Mountpoint and file buffer cache (for partial sector accesses) */
 
+#ifdef CONFIG_FAT_SECTORCACHE
+EXTERN int    fat_fscacheinitialize(struct fat_mountpt_s *fs);
+EXTERN void   fat_fscacherelease(struct fat_mountpt_s *fs);
+EXTERN int    fat_fscacheinvalidate(struct fat_mountpt_s *fs, off_t sector,
+                                    unsigned int nsectors);
+#else
+#  define     fat_fscacheinvalidate(fs,s,n) (OK)
+#endif
 EXTERN int    fat_fscacheflush(struct fat_mountpt_s *fs);
 EXTERN int    fat_fscacheread(struct fat_mountpt_s *fs, off_t sector);
 EXTERN int    fat_ffcacheflush(struct fat_mountpt_s *fs, struct fat_file_s *ff);
@@ -0,0 +1,345 @@
+/****************************************************************************
+ * fs/fat/fs_fat32bitmap.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+
+#include "fs_internal.h"
+#include "fs_fat32.h"
+
+#ifdef CONFIG_FAT_FREEBITMAP
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+/* Access to the bit for one cluster.  A set bit means that the cluster is
+ * free.
+ */
+
+#define FREEMAP_WORD(c)    ((c) >> 5)
+#define FREEMAP_BIT(c)     ((uint32_t)1 << ((c) & 31))
+#define FREEMAP_ISFREE(fs,c) \
+  (((fs)->fs_freemap[FREEMAP_WORD(c)] & FREEMAP_BIT(c)) != 0)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_freemapbuild
+ *
+ * Desciption: Scan the FAT and set the bit for each free cluster.
+ *
+ ****************************************************************************/
+
+static int fat_freemapbuild(struct fat_mountpt_s *fs)
+{
+  uint32_t cluster;
+  int ret;
+
+  fs->fs_nfreemap = 0;
+
+  if (fs->fs_type == FSTYPE_FAT12)
+    {
+      off_t next;
+
+      /* FAT12 entries straddle sector boundaries;  let fat_getcluster()
+       * deal with that.  FAT12 volumes are small.
+       */
+
+      for (cluster = 2; cluster < fs->fs_nclusters; cluster++)
+        {
+          next = fat_getcluster(fs, cluster);
+          if (next < 0)
+            {
+              return next;
+            }
+          else if (next == 0)
+            {
+              fs->fs_freemap[FREEMAP_WORD(cluster)] |= FREEMAP_BIT(cluster);
+              fs->fs_nfreemap++;
+            }
+        }
+    }
+  else
+    {
+      off_t        fatsector = fs->fs_fatbase;
+      unsigned int offset    = fs->fs_hwsectorsize;
+      uint32_t     value;
+
+      /* Examine each FAT entry, one FAT sector at a time */
+
+      for (cluster = 0; cluster < fs->fs_nclusters; cluster++)
+        {
+          if (offset >= fs->fs_hwsectorsize)
+            {
+              ret = fat_fscacheread(fs, fatsector++);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              offset = 0;
+            }
+
+          if (fs->fs_type == FSTYPE_FAT16)
+            {
+              value   = FAT_GETFAT16(fs->fs_buffer, offset);
+              offset += 2;
+            }
+          else
+            {
+              value   = FAT_GETFAT32(fs->fs_buffer, offset) & 0x0fffffff;
+              offset += 4;
+            }
+
+          if (value == 0 && cluster >= 2)
+            {
+              fs->fs_freemap[FREEMAP_WORD(cluster)] |= FREEMAP_BIT(cluster);
+              fs->fs_nfreemap++;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_freemapsearch
+ *
+ * Desciption: Return the first cluster in [first, last) that begins a run
+ *   of 'nclusters' free clusters, or zero if there is no such run.
+ *
+ ****************************************************************************/
+
+static uint32_t fat_freemapsearch(struct fat_mountpt_s *fs, uint32_t first,
+                                  uint32_t last, uint32_t nclusters)
+{
+  uint32_t cluster = first;
+  uint32_t runstart = 0;
+  uint32_t run = 0;
+  uint32_t word;
+
+  while (cluster < last)
+    {
+      /* Skip over whole words of allocated clusters */
+
+      word = fs->fs_freemap[FREEMAP_WORD(cluster)];
+      if ((cluster & 31) == 0 && word == 0)
+        {
+          run      = 0;
+          cluster += 32;
+          continue;
+        }
+
+      /* Then check one cluster */
+
+      if ((word & FREEMAP_BIT(cluster)) != 0)
+        {
+          if (run++ == 0)
+            {
+              runstart = cluster;
+            }
+
+          if (run >= nclusters)
+            {
+              return runstart;
+            }
+        }
+      else
+        {
+          run = 0;
+        }
+
+      cluster++;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_freemapinitialize
+ *
+ * Desciption: Allocate and build the free cluster bitmap.  On failure, the
+ *   bitmap is not used and free clusters are found by searching the FAT.
+ *
+ ****************************************************************************/
+
+int fat_freemapinitialize(struct fat_mountpt_s *fs)
+{
+  size_t size;
+  int ret;
+
+  fs->fs_freemaptried = true;
+
+  size = ((fs->fs_nclusters + 31) >> 5) * sizeof(uint32_t);
+  fs->fs_freemap = (uint32_t *)kzalloc(size);
+  if (!fs->fs_freemap)
+    {
+      fdbg("ERROR: Failed to allocate %d byte free cluster bitmap\n", size);
+      return -ENOMEM;
+    }
+
+  ret = fat_freemapbuild(fs);
+  if (ret < 0)
+    {
+      fdbg("ERROR: Failed to read the FAT: %d\n", ret);
+      fat_freemaprelease(fs);
+      return ret;
+    }
+
+  fvdbg("%d of %d clusters are free\n", fs->fs_nfreemap, fs->fs_nclusters - 2);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_freemaprelease
+ *
+ * Desciption: Free the free cluster bitmap.
+ *
+ ****************************************************************************/
+
+void fat_freemaprelease(struct fat_mountpt_s *fs)
+{
+  if (fs->fs_freemap)
+    {
+      kfree(fs->fs_freemap);
+      fs->fs_freemap = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: fat_freemapready
+ *
+ * Desciption: Return true if the free cluster bitmap is available, building
+ *   it on first use if CONFIG_FAT_FREEBITMAP_LAZY is selected.
+ *
+ ****************************************************************************/
+
+bool fat_freemapready(struct fat_mountpt_s *fs)
+{
+#ifdef CONFIG_FAT_FREEBITMAP_LAZY
+  if (!fs->fs_freemap && !fs->fs_freemaptried)
+    {
+      (void)fat_freemapinitialize(fs);
+    }
+#endif
+
+  return fs->fs_freemap != NULL;
+}
+
+/****************************************************************************
+ * Name: fat_freemapupdate
+ *
+ * Desciption: Record that a cluster has been freed or allocated.  This is
+ *   called by fat_putcluster() for every change to the FAT.
+ *
+ ****************************************************************************/
+
+void fat_freemapupdate(struct fat_mountpt_s *fs, uint32_t cluster, bool free)
+{
+  if (fs->fs_freemap && cluster >= 2 && cluster < fs->fs_nclusters)
+    {
+      if (free && !FREEMAP_ISFREE(fs, cluster))
+        {
+          fs->fs_freemap[FREEMAP_WORD(cluster)] |= FREEMAP_BIT(cluster);
+          fs->fs_nfreemap++;
+        }
+      else if (!free && FREEMAP_ISFREE(fs, cluster))
+        {
+          fs->fs_freemap[FREEMAP_WORD(cluster)] &= ~FREEMAP_BIT(cluster);
+          fs->fs_nfreemap--;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fat_freemapfind
+ *
+ * Desciption: Find the first run of 'nclusters' free clusters, searching
+ *   from 'start' to the end of the volume and then from the beginning of
+ *   the volume.  Returns the first cluster of the run or zero if there is
+ *   no such run.
+ *
+ ****************************************************************************/
+
+uint32_t fat_freemapfind(struct fat_mountpt_s *fs, uint32_t start,
+                         uint32_t nclusters)
+{
+  uint32_t cluster;
+
+  if (fs->fs_nfreemap < nclusters)
+    {
+      return 0;
+    }
+
+  if (start < 2 || start >= fs->fs_nclusters)
+    {
+      start = 2;
+    }
+
+  cluster = fat_freemapsearch(fs, start, fs->fs_nclusters, nclusters);
+  if (cluster == 0 && start > 2)
+    {
+      /* Wrap around.  The run may extend past the original starting
+       * cluster.
+       */
+
+      cluster = fat_freemapsearch(fs, 2,
+                                  MIN(start + nclusters - 1, fs->fs_nclusters),
+                                  nclusters);
+    }
+
+  return cluster;
+}
+
+#endif /* CONFIG_FAT_FREEBITMAP */
@@ -0,0 +1,692 @@
+/****************************************************************************
+ * fs/fat/fs_fat32cache.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/fat.h>
+
+#include "fs_internal.h"
+#include "fs_fat32.h"
+
+#ifdef CONFIG_FAT_SECTORCACHE
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+/* Cache entry flags */
+
+#define FATCACHE_VALID     0x01  /* The entry holds a sector */
+#define FATCACHE_DIRTY     0x02  /* The sector must be written back */
+
+/* Cache geometry */
+
+#define FATCACHE_NSECTORS  CONFIG_FAT_SECTORCACHE_NSECTORS
+#define FATCACHE_READAHEAD CONFIG_FAT_SECTORCACHE_READAHEAD
+
+/* Address of the sector data of a cache entry */
+
+#define FATCACHE_BUFFER(fs,i) (&(fs)->fs_cachebuffer[(i) * (fs)->fs_hwsectorsize])
+
+/* Is the sector in the (first) FAT? */
+
+#define FATCACHE_INFAT(fs,s) \
+  ((s) >= (fs)->fs_fatbase && (s) < (fs)->fs_fatbase + (fs)->fs_nfatsects)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_cachesynccurrent
+ *
+ * Desciption: Bring the cache entry for the sector in fs_buffer up to date.
+ *   Callers may have modified fs_buffer (setting fs_dirty) or may have
+ *   claimed fs_buffer for a new sector (setting fs_currentsector) after
+ *   flushing the cache.  In the latter case, any other copy of that sector
+ *   in the cache is stale and is discarded.
+ *
+ ****************************************************************************/
+
+static void fat_cachesynccurrent(struct fat_mountpt_s *fs)
+{
+  struct fat_cacheentry_s *ce = &fs->fs_cache[fs->fs_cacheindex];
+  int i;
+
+  ce->ce_sector = fs->fs_currentsector;
+  ce->ce_flags  = fs->fs_dirty ? (FATCACHE_VALID|FATCACHE_DIRTY) : FATCACHE_VALID;
+  ce->ce_age    = ++fs->fs_cacheclock;
+
+  for (i = 0; i < FATCACHE_NSECTORS; i++)
+    {
+      if (i != fs->fs_cacheindex &&
+          (fs->fs_cache[i].ce_flags & FATCACHE_VALID) != 0 &&
+          fs->fs_cache[i].ce_sector == ce->ce_sector)
+        {
+          DEBUGASSERT((fs->fs_cache[i].ce_flags & FATCACHE_DIRTY) == 0);
+          fs->fs_cache[i].ce_flags = 0;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fat_cachefind
+ *
+ * Desciption: Return the index of the cache entry holding the sector or
+ *   -ENOENT if the sector is not in the cache.
+ *
+ ****************************************************************************/
+
+static int fat_cachefind(struct fat_mountpt_s *fs, off_t sector)
+{
+  int i;
+
+  for (i = 0; i < FATCACHE_NSECTORS; i++)
+    {
+      if ((fs->fs_cache[i].ce_flags & FATCACHE_VALID) != 0 &&
+          fs->fs_cache[i].ce_sector == sector)
+        {
+          return i;
+        }
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: fat_cacheselect
+ *
+ * Desciption: Make a cache entry the one in fs_buffer.
+ *
+ ****************************************************************************/
+
+static void fat_cacheselect(struct fat_mountpt_s *fs, int index)
+{
+  struct fat_cacheentry_s *ce = &fs->fs_cache[index];
+
+  ce->ce_age           = ++fs->fs_cacheclock;
+  fs->fs_cacheindex    = index;
+  fs->fs_buffer        = FATCACHE_BUFFER(fs, index);
+  fs->fs_currentsector = ce->ce_sector;
+  fs->fs_dirty         = (ce->ce_flags & FATCACHE_DIRTY) != 0;
+}
+
+/****************************************************************************
+ * Name: fat_cachewriteback
+ *
+ * Desciption: Write back the dirty sectors held in the cache entries
+ *   [first, first+nentries).  Dirty sectors that are adjacent both in the
+ *   cache and on the media are written with a single block driver call.
+ *   Sectors in the FAT are written to each copy of the FAT.
+ *
+ ****************************************************************************/
+
+static int fat_cachewriteback(struct fat_mountpt_s *fs, int first,
+                              int nentries)
+{
+  struct fat_cacheentry_s *ce;
+  off_t sector;
+  int last = first + nentries;
+  int nrun;
+  int ret;
+  int i;
+  int j;
+
+  for (i = first; i < last; i += nrun)
+    {
+      ce = &fs->fs_cache[i];
+      if ((ce->ce_flags & FATCACHE_DIRTY) == 0)
+        {
+          nrun = 1;
+          continue;
+        }
+
+      /* Find the run of dirty, consecutive sectors that starts here */
+
+      sector = ce->ce_sector;
+      for (nrun = 1; i + nrun < last; nrun++)
+        {
+          struct fat_cacheentry_s *next = &fs->fs_cache[i + nrun];
+
+          if ((next->ce_flags & FATCACHE_DIRTY) == 0 ||
+              next->ce_sector != sector + nrun ||
+              FATCACHE_INFAT(fs, next->ce_sector) != FATCACHE_INFAT(fs, sector))
+            {
+              break;
+            }
+        }
+
+      /* Write the run */
+
+      ret = fat_hwwrite(fs, FATCACHE_BUFFER(fs, i), sector, nrun);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      fs->fs_cachestats.cs_wrcalls++;
+      fs->fs_cachestats.cs_wrsectors += nrun;
+
+      /* Does the run lie in the FAT region?  If so, then make the change in
+       * the FAT copies as well.
+       */
+
+      if (FATCACHE_INFAT(fs, sector))
+        {
+          for (j = fs->fs_fatnumfats; j >= 2; j--)
+            {
+              sector += fs->fs_nfatsects;
+              ret = fat_hwwrite(fs, FATCACHE_BUFFER(fs, i), sector, nrun);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+        }
+
+      /* No longer dirty */
+
+      for (j = i; j < i + nrun; j++)
+        {
+          fs->fs_cache[j].ce_flags &= ~FATCACHE_DIRTY;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cachegetcluster
+ *
+ * Desciption: Like fat_getcluster(), get the next cluster in a chain from
+ *   the FAT, but only if the FAT sector(s) holding the entry are already in
+ *   the cache.  No I/O is performed and the current sector is not changed.
+ *
+ * Return:  The next cluster number or -ENOENT if the entry is not cached.
+ *
+ ****************************************************************************/
+
+static off_t fat_cachegetcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
+{
+  unsigned int fatoffset;
+  unsigned int cluster;
+  int index;
+
+  if (clusterno < 2 || clusterno >= fs->fs_nclusters)
+    {
+      return -EINVAL;
+    }
+
+  switch (fs->fs_type)
+    {
+      case FSTYPE_FAT12 :
+        {
+          /* The two bytes of a FAT12 entry may lie in different sectors */
+
+          fatoffset = (clusterno * 3) / 2;
+          index = fat_cachefind(fs, fs->fs_fatbase + SEC_NSECTORS(fs, fatoffset));
+          if (index < 0)
+            {
+              return index;
+            }
+
+          cluster = FATCACHE_BUFFER(fs, index)[fatoffset & SEC_NDXMASK(fs)];
+
+          fatoffset++;
+          index = fat_cachefind(fs, fs->fs_fatbase + SEC_NSECTORS(fs, fatoffset));
+          if (index < 0)
+            {
+              return index;
+            }
+
+          cluster |= (unsigned int)FATCACHE_BUFFER(fs, index)[fatoffset & SEC_NDXMASK(fs)] << 8;
+          return (clusterno & 1) != 0 ? cluster >> 4 : cluster & 0x0fff;
+        }
+
+      case FSTYPE_FAT16 :
+        {
+          fatoffset = 2 * clusterno;
+          index = fat_cachefind(fs, fs->fs_fatbase + SEC_NSECTORS(fs, fatoffset));
+          if (index < 0)
+            {
+              return index;
+            }
+
+          return FAT_GETFAT16(FATCACHE_BUFFER(fs, index), fatoffset & SEC_NDXMASK(fs));
+        }
+
+      case FSTYPE_FAT32 :
+        {
+          fatoffset = 4 * clusterno;
+          index = fat_cachefind(fs, fs->fs_fatbase + SEC_NSECTORS(fs, fatoffset));
+          if (index < 0)
+            {
+              return index;
+            }
+
+          return FAT_GETFAT32(FATCACHE_BUFFER(fs, index), fatoffset & SEC_NDXMASK(fs)) & 0x0fffffff;
+        }
+
+      default:
+        return -EINVAL;
+    }
+}
+
+/****************************************************************************
+ * Name: fat_cachereadahead
+ *
+ * Desciption: Return the number of sectors to read, starting with 'sector',
+ *   on a cache miss.  Read-ahead continues to the end of the FAT, the root
+ *   directory region, or the cluster containing the sector, but stops at
+ *   the first sector that is already in the cache.  In the data region,
+ *   read-ahead continues into the following clusters as long as the cached
+ *   FAT shows that each is the next cluster in the same chain.
+ *
+ ****************************************************************************/
+
+static int fat_cachereadahead(struct fat_mountpt_s *fs, off_t sector)
+{
+  uint32_t cluster;
+  off_t end;
+  int nsectors;
+  int i;
+
+  if (FATCACHE_INFAT(fs, sector))
+    {
+      end = fs->fs_fatbase + fs->fs_nfatsects;
+    }
+  else if (sector >= fs->fs_database)
+    {
+      /* Get the cluster containing the sector and the end of that cluster.
+       * Then extend the read over contiguous clusters of the same chain.
+       */
+
+      cluster = (sector - fs->fs_database) / fs->fs_fatsecperclus + 2;
+      end     = fs->fs_database + (off_t)(cluster - 1) * fs->fs_fatsecperclus;
+
+      while (end - sector < FATCACHE_READAHEAD &&
+             fat_cachegetcluster(fs, cluster) == cluster + 1)
+        {
+          cluster++;
+          end += fs->fs_fatsecperclus;
+        }
+    }
+  else if (fs->fs_type != FSTYPE_FAT32 &&
+           sector >= fs->fs_fatbase + fs->fs_fatnumfats * fs->fs_nfatsects)
+    {
+      /* FAT12/16 root directory region */
+
+      end = fs->fs_database;
+    }
+  else
+    {
+      end = sector + 1;
+    }
+
+  nsectors = MIN(end - sector, FATCACHE_READAHEAD);
+  for (i = 1; i < nsectors; i++)
+    {
+      if (fat_cachefind(fs, sector + i) >= 0)
+        {
+          break;
+        }
+    }
+
+  return i < nsectors ? i : nsectors;
+}
+
+/****************************************************************************
+ * Name: fat_cachevictims
+ *
+ * Desciption: Select 'nsectors' adjacent cache entries to be replaced.
+ *   The run whose most recently used entry is the oldest is selected.
+ *
+ ****************************************************************************/
+
+static int fat_cachevictims(struct fat_mountpt_s *fs, int nsectors)
+{
+  uint32_t bestage = UINT32_MAX;
+  uint32_t age;
+  int best = 0;
+  int i;
+  int j;
+
+  for (i = 0; i + nsectors <= FATCACHE_NSECTORS; i++)
+    {
+      /* Get the age of the most recently used entry in this run.  Unused
+       * entries have an age of zero.
+       */
+
+      for (age = 0, j = i; j < i + nsectors; j++)
+        {
+          if ((fs->fs_cache[j].ce_flags & FATCACHE_VALID) != 0 &&
+              fs->fs_cache[j].ce_age > age)
+            {
+              age = fs->fs_cache[j].ce_age;
+            }
+        }
+
+      if (age < bestage)
+        {
+          bestage = age;
+          best    = i;
+        }
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_fscacheinitialize
+ *
+ * Desciption: Allocate the sector cache.  On return, fs_buffer refers to
+ *   the first (empty) cache entry.
+ *
+ ****************************************************************************/
+
+int fat_fscacheinitialize(struct fat_mountpt_s *fs)
+{
+  fs->fs_cachebuffer = (uint8_t*)fat_io_alloc(FATCACHE_NSECTORS * fs->fs_hwsectorsize);
+  if (!fs->fs_cachebuffer)
+    {
+      return -ENOMEM;
+    }
+
+  memset(fs->fs_cache, 0, sizeof(fs->fs_cache));
+  memset(&fs->fs_cachestats, 0, sizeof(struct fat_cachestats_s));
+
+  fs->fs_cacheindex    = 0;
+  fs->fs_cacheclock    = 0;
+  fs->fs_buffer        = fs->fs_cachebuffer;
+  fs->fs_currentsector = -1;
+  fs->fs_dirty         = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_fscacherelease
+ *
+ * Desciption: Free the sector cache.  Any dirty sectors are discarded.
+ *
+ ****************************************************************************/
+
+void fat_fscacherelease(struct fat_mountpt_s *fs)
+{
+  if (fs->fs_cachebuffer)
+    {
+      fat_io_free(fs->fs_cachebuffer, FATCACHE_NSECTORS * fs->fs_hwsectorsize);
+      fs->fs_cachebuffer = NULL;
+    }
+
+  fs->fs_buffer = NULL;
+}
+
+/****************************************************************************
+ * Name: fat_fscacheflush
+ *
+ * Desciption: Write back all dirty sectors in the sector cache.
+ *
+ ****************************************************************************/
+
+int fat_fscacheflush(struct fat_mountpt_s *fs)
+{
+  int ret;
+
+  fat_cachesynccurrent(fs);
+  ret = fat_cachewriteback(fs, 0, FATCACHE_NSECTORS);
+  fs->fs_dirty = (fs->fs_cache[fs->fs_cacheindex].ce_flags & FATCACHE_DIRTY) != 0;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_fscacheread
+ *
+ * Desciption: Make the specified sector the one in fs_buffer.  On a cache
+ *   miss, the sector (and possibly following sectors) are read into the
+ *   least recently used cache entries, writing back any dirty sectors that
+ *   they held.
+ *
+ ****************************************************************************/
+
+int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
+{
+  int nsectors;
+  int index;
+  int ret;
+  int i;
+
+  /* Is the sector already in fs_buffer? */
+
+  if (fs->fs_currentsector == sector)
+    {
+      fs->fs_cachestats.cs_hits++;
+      return OK;
+    }
+
+  fat_cachesynccurrent(fs);
+
+  /* Is the sector elsewhere in the cache? */
+
+  index = fat_cachefind(fs, sector);
+  if (index >= 0)
+    {
+      fs->fs_cachestats.cs_hits++;
+      fat_cacheselect(fs, index);
+      return OK;
+    }
+
+  /* No.. select the entries to replace and write back any dirty sectors
+   * that they hold.
+   */
+
+  fs->fs_cachestats.cs_misses++;
+
+  nsectors = fat_cachereadahead(fs, sector);
+  index    = fat_cachevictims(fs, nsectors);
+
+  ret = fat_cachewriteback(fs, index, nsectors);
+  if (ret < 0)
+    {
+      fs->fs_dirty = (fs->fs_cache[fs->fs_cacheindex].ce_flags & FATCACHE_DIRTY) != 0;
+      return ret;
+    }
+
+  /* Then read the sectors into the cache with a single block driver call */
+
+  for (i = index; i < index + nsectors; i++)
+    {
+      fs->fs_cache[i].ce_flags = 0;
+    }
+
+  ret = fat_hwread(fs, FATCACHE_BUFFER(fs, index), sector, nsectors);
+  if (ret < 0 && nsectors > 1)
+    {
+      /* The read-ahead may have failed.  Try again with just one sector. */
+
+      nsectors = 1;
+      ret = fat_hwread(fs, FATCACHE_BUFFER(fs, index), sector, 1);
+    }
+
+  if (ret < 0)
+    {
+      /* fs_buffer may have been overwritten.  Make sure that the failed
+       * entry will not be used.
+       */
+
+      fs->fs_cacheindex    = index;
+      fs->fs_buffer        = FATCACHE_BUFFER(fs, index);
+      fs->fs_currentsector = -1;
+      fs->fs_dirty         = false;
+      return ret;
+    }
+
+  fs->fs_cachestats.cs_rdsectors += nsectors;
+
+  for (i = 0; i < nsectors; i++)
+    {
+      fs->fs_cache[index + i].ce_sector = sector + i;
+      fs->fs_cache[index + i].ce_flags  = FATCACHE_VALID;
+      fs->fs_cache[index + i].ce_age    = 0;
+    }
+
+  /* The read-ahead sectors are not used yet.  Give them the same age as the
+   * requested sector so that they are not the first to be replaced.
+   */
+
+  fat_cacheselect(fs, index);
+  for (i = 1; i < nsectors; i++)
+    {
+      fs->fs_cache[index + i].ce_age = fs->fs_cacheclock;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_fscacheinvalidate
+ *
+ * Desciption: Write back and discard any cached copies of the sectors
+ *   [sector, sector+nsectors).  This must be called before the sectors are
+ *   read or written directly with fat_hwread() or fat_hwwrite().
+ *
+ ****************************************************************************/
+
+int fat_fscacheinvalidate(struct fat_mountpt_s *fs, off_t sector,
+                          unsigned int nsectors)
+{
+  struct fat_cacheentry_s *ce;
+  int ret;
+  int i;
+
+  fat_cachesynccurrent(fs);
+
+  for (i = 0; i < FATCACHE_NSECTORS; i++)
+    {
+      ce = &fs->fs_cache[i];
+      if ((ce->ce_flags & FATCACHE_VALID) != 0 &&
+          ce->ce_sector >= sector && ce->ce_sector < sector + nsectors)
+        {
+          ret = fat_cachewriteback(fs, i, 1);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          ce->ce_flags = 0;
+          if (i == fs->fs_cacheindex)
+            {
+              fs->fs_currentsector = -1;
+              fs->fs_dirty         = false;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_getcachestats
+ *
+ * Description:
+ *   Non-standard function to return the sector cache statistics of the FAT
+ *   volume that contains the path.  If 'reset' is true, the statistics are
+ *   zeroed after they are returned.
+ *
+ ****************************************************************************/
+
+int fat_getcachestats(const char *path, FAR struct fat_cachestats_s *stats,
+                      bool reset)
+{
+  struct fat_mountpt_s *fs;
+  FAR struct inode     *inode;
+  const char           *relpath = NULL;
+  int                   ret;
+
+  /* Get the inode of the mountpoint containing this path */
+
+  inode = inode_find(path, &relpath);
+  if (!inode)
+    {
+      ret = ENOENT;
+      goto errout;
+    }
+
+  /* Verify that the inode is a valid FAT mountpoint. */
+
+  if (!INODE_IS_MOUNTPT(inode) || inode->u.i_mops != &fat_operations ||
+      !inode->i_private)
+    {
+      ret = ENXIO;
+      goto errout_with_inode;
+    }
+
+  fs = inode->i_private;
+
+  fat_semtake(fs);
+  memcpy(stats, &fs->fs_cachestats, sizeof(struct fat_cachestats_s));
+  if (reset)
+    {
+      memset(&fs->fs_cachestats, 0, sizeof(struct fat_cachestats_s));
+    }
+
+  fat_semgive(fs);
+  inode_release(inode);
+  return OK;
+
+errout_with_inode:
+  inode_release(inode);
+errout:
+  *get_errno_ptr() = ret;
+  return ERROR;
+}
+
+#endif /* CONFIG_FAT_SECTORCACHE */
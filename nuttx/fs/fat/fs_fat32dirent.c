@@ -2523,12 +2523,22 @@ int fat_allocatedirentry(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo
           return ret;
         }
 
+      /* Discard any stale copies of the new directory cluster in the
+       * sector cache.
+       */
+
+      sector = fat_cluster2sector(fs, cluster);
+      ret    = fat_fscacheinvalidate(fs, sector, fs->fs_fatsecperclus);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
       /* Clear all sectors comprising the new directory cluster */
 
-      fs->fs_currentsector = fat_cluster2sector(fs, cluster);
+      fs->fs_currentsector = sector;
       memset(fs->fs_buffer, 0, fs->fs_hwsectorsize);
 
-      sector = fs->fs_currentsector;
       for (i = fs->fs_fatsecperclus; i; i--)
         {
           ret = fat_hwwrite(fs, fs->fs_buffer, sector, 1);
@@ -541,14 +541,22 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   fs->fs_hwsectorsize = geo.geo_sectorsize;
   fs->fs_hwnsectors   = geo.geo_nsectors;
 
-  /* Allocate a buffer to hold one hardware sector */
+  /* Allocate a buffer to hold one hardware sector (or the sector cache) */
 
+#ifdef CONFIG_FAT_SECTORCACHE
+  ret = fat_fscacheinitialize(fs);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+#else
   fs->fs_buffer = (uint8_t*)fat_io_alloc(fs->fs_hwsectorsize);
   if (!fs->fs_buffer)
     {
       ret = -ENOMEM;
       goto errout;
     }
+#endif
 
   /* Search FAT boot record on the drive.  First check at sector zero.  This
    * could be either the boot record or a partition that refers to the boot
@@ -651,6 +659,14 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
       }
   }
 
+#if defined(CONFIG_FAT_FREEBITMAP) && !defined(CONFIG_FAT_FREEBITMAP_LAZY)
+  /* Build the free cluster bitmap now.  If this fails, the mount still
+   * succeeds but free clusters will be found by searching the FAT.
+   */
+
+  (void)fat_freemapinitialize(fs);
+
+#endif
   /* We did it! */
 
   fdbg("FAT%d:\n", fs->fs_type == 0 ? 12 : fs->fs_type == 1  ? 16 : 32);
@@ -673,8 +689,12 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
  errout_with_buffer:
+#ifdef CONFIG_FAT_SECTORCACHE
+  fat_fscacherelease(fs);
+#else
   fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
   fs->fs_buffer = 0;
+#endif
 
  errout:
   fs->fs_mounted = false;
@@ -1091,6 +1111,12 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno, off_t nextclust
       /* Mark the modified sector as "dirty" and return success */
 
       fs->fs_dirty = true;
+
+#ifdef CONFIG_FAT_FREEBITMAP
+      /* Keep the free cluster bitmap in step with the FAT */
+
+      fat_freemapupdate(fs, clusterno, nextcluster == 0);
+#endif
       return OK;
     }
 
@@ -1147,19 +1173,99 @@ int fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster)
 }
 
 /****************************************************************************
- * Name: fat_extendchain
+ * Name: fat_findfreecluster
+ *
+ * Desciption: Search the FAT for the next free cluster after startcluster.
+ *
+ * Return: <0:error, 0: no free cluster, >=2: free cluster number
+ *
+ ****************************************************************************/
+
+static int32_t fat_findfreecluster(struct fat_mountpt_s *fs,
+                                   uint32_t startcluster)
+{
+  off_t    startsector;
+  uint32_t newcluster;
+
+  /* Loop until (1) we discover that there are not free clusters
+   * (return 0), an errors occurs (return -errno), or (3) we find
+   * the next cluster (return the new cluster number).
+   */
+
+  newcluster = startcluster;
+  for (;;)
+    {
+      /* Examine the next cluster in the FAT */
+
+      newcluster++;
+      if (newcluster >= fs->fs_nclusters)
+        {
+          /* If we hit the end of the available clusters, then
+           * wrap back to the beginning because we might have
+           * started at a non-optimal place.  But don't continue
+           * past the start cluster.
+           */
+
+          newcluster = 2;
+          if (newcluster > startcluster)
+            {
+              /* We are back past the starting cluster, then there
+               * is no free cluster.
+               */
+
+              return 0;
+            }
+        }
+
+      /* We have a candidate cluster.  Check if the cluster number is
+       * mapped to a group of sectors.
+       */
+
+      startsector = fat_getcluster(fs, newcluster);
+      if (startsector == 0)
+        {
+          /* Found have found a free cluster */
+
+          return newcluster;
+        }
+      else if (startsector < 0)
+        {
+          /* Some error occurred, return the error number */
+
+          return startsector;
+        }
+
+      /* We wrap all the back to the starting cluster?  If so, then
+       * there are no free clusters.
+       */
+
+      if (newcluster == startcluster)
+        {
+          return 0;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fat_extendchainrun
  *
  * Desciption: Add a new cluster to the chain following cluster (if cluster
  *   is non-NULL).  if cluster is zero, then a new chain is created.
  *
+ *   nclusters is the number of clusters that the caller expects to add to
+ *   the chain.  If the free cluster bitmap is available, the new cluster is
+ *   taken from the start of the next free run of that length (if there is
+ *   one) so that the following clusters can be allocated contiguously.
+ *
  * Return: <0:error, 0: no free cluster, >=2: new cluster number
  *
  ****************************************************************************/
 
-int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
+int32_t fat_extendchainrun(struct fat_mountpt_s *fs, uint32_t cluster,
+                           uint32_t nclusters)
 {
   off_t    startsector;
-  uint32_t newcluster;
+  int32_t  newcluster;
   uint32_t startcluster;
   int      ret;
 
@@ -1209,62 +1315,37 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       startcluster = cluster;
     }
 
-  /* Loop until (1) we discover that there are not free clusters
-   * (return 0), an errors occurs (return -errno), or (3) we find
-   * the next cluster (return the new cluster number).
+#ifdef CONFIG_FAT_FREEBITMAP
+  /* Find the next free cluster in the free cluster bitmap, if available
+   * (next fit, starting after startcluster).
    */
 
-  newcluster = startcluster;
-  for (;;)
+  if (fat_freemapready(fs))
     {
-      /* Examine the next cluster in the FAT */
-
-      newcluster++;
-      if (newcluster >= fs->fs_nclusters)
+      newcluster = 0;
+      if (nclusters > 1)
         {
-          /* If we hit the end of the available clusters, then
-           * wrap back to the beginning because we might have
-           * started at a non-optimal place.  But don't continue
-           * past the start cluster.
-           */
-
-          newcluster = 2;
-          if (newcluster > startcluster)
-            {
-              /* We are back past the starting cluster, then there
-               * is no free cluster.
-               */
-
-              return 0;
-            }
+          newcluster = fat_freemapfind(fs, startcluster + 1, nclusters);
         }
 
-      /* We have a candidate cluster.  Check if the cluster number is
-       * mapped to a group of sectors.
-       */
-
-      startsector = fat_getcluster(fs, newcluster);
-      if (startsector == 0)
+      if (newcluster == 0)
         {
-          /* Found have found a free cluster break out */
-
-          break;
+          newcluster = fat_freemapfind(fs, startcluster + 1, 1);
         }
-      else if (startsector < 0)
-        {
-          /* Some error occurred, return the error number */
+    }
+  else
+#endif
+    {
+      /* Otherwise, search the FAT */
 
-          return startsector;
-        }
+      newcluster = fat_findfreecluster(fs, startcluster);
+    }
 
-      /* We wrap all the back to the starting cluster?  If so, then
-       * there are no free clusters.
-       */
+  if (newcluster <= 0)
+    {
+      /* No free cluster (0) or an error (<0) */
 
-      if (newcluster == startcluster)
-        {
-          return 0;
-        }
+      return newcluster;
     }
 
   /* We get here only if we break out with an available cluster
@@ -1468,10 +1549,13 @@ int  fat_dirtruncate(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo)
 /****************************************************************************
  * Name: fat_fscacheflush
  *
- * Desciption: Flush any dirty sector if fs_buffer as necessary
+ * Desciption: Flush any dirty sector if fs_buffer as necessary.  The multi-
+ *   sector versions of fat_fscacheflush() and fat_fscacheread() are in
+ *   fs_fat32cache.c.
  *
  ****************************************************************************/
 
+#ifndef CONFIG_FAT_SECTORCACHE
 int fat_fscacheflush(struct fat_mountpt_s *fs)
 {
   int ret;
@@ -1560,6 +1644,7 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
 
     return OK;
 }
+#endif /* CONFIG_FAT_SECTORCACHE */
 
 /****************************************************************************
  * Name: fat_ffcacheflush
@@ -1579,7 +1664,15 @@ int fat_ffcacheflush(struct fat_mountpt_s *fs, struct fat_file_s *ff)
   if (ff->ff_cachesector &&
       (ff->ff_bflags & (FFBUFF_DIRTY|FFBUFF_VALID)) == (FFBUFF_DIRTY|FFBUFF_VALID))
     {
-      /* Write the dirty sector */
+      /* Write the dirty sector (after discarding any copy in the sector
+       * cache).
+       */
+
+      ret = fat_fscacheinvalidate(fs, ff->ff_cachesector, 1);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       ret = fat_hwwrite(fs, ff->ff_buffer, ff->ff_cachesector, 1);
       if (ret < 0)
@@ -1624,7 +1717,15 @@ int fat_ffcacheread(struct fat_mountpt_s *fs, struct fat_file_s *ff, off_t secto
           return ret;
         }
 
-      /* Then read the specified sector into the cache */
+      /* Then read the specified sector into the cache (after writing back
+       * any copy in the sector cache).
+       */
+
+      ret = fat_fscacheinvalidate(fs, sector, 1);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       ret = fat_hwread(fs, ff->ff_buffer, sector, 1);
       if (ret < 0)
@@ -1733,6 +1834,25 @@ int fat_nfreeclusters(struct fat_mountpt_s *fs, off_t *pfreeclusters)
 {
   uint32_t nfreeclusters;
 
+#ifdef CONFIG_FAT_FREEBITMAP
+  /* The free cluster bitmap always holds the exact count */
+
+  if (fat_freemapready(fs))
+    {
+      if (fs->fs_fsifreecount != fs->fs_nfreemap)
+        {
+          fs->fs_fsifreecount = fs->fs_nfreemap;
+          if (fs->fs_type == FSTYPE_FAT32)
+            {
+              fs->fs_fsidirty = true;
+            }
+        }
+
+      *pfreeclusters = fs->fs_nfreemap;
+      return OK;
+    }
+
+#endif
   /* If number of the first free cluster is valid, then just return that value. */
 
   if (fs->fs_fsifreecount <= fs->fs_nclusters - 2)
@@ -1779,7 +1899,7 @@ int fat_nfreeclusters(struct fat_mountpt_s *fs, off_t *pfreeclusters)
 
           if (offset >= fs->fs_hwsectorsize)
             {
-              ret = fat_fscacheread(fs, fatsector++);
+              ret = fat_fscacheread(fs, fatsector);
               if (ret < 0)
                 {
                   return ret;
@@ -0,0 +1,981 @@
+/****************************************************************************
+ * fs/fs_epoll.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <wdog.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <sys/epoll.h>
+#include <arch/irq.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "fs_internal.h"
+
+#if !defined(CONFIG_DISABLE_POLL) && CONFIG_NFILE_DESCRIPTORS > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The poll events that are passed to the drivers */
+
+#define EPOLL_POLLMASK  (POLLIN | POLLOUT | POLLERR | POLLHUP)
+
+/* Entry flags */
+
+#define EPOLL_FLAG_INUSE     (1 << 0)  /* Entry holds a registration */
+#define EPOLL_FLAG_ARMED     (1 << 1)  /* Registered with the driver */
+#define EPOLL_FLAG_ET        (1 << 2)  /* Edge-triggered */
+#define EPOLL_FLAG_ONESHOT   (1 << 3)  /* Disarm after one report */
+#define EPOLL_FLAG_SOCKET    (1 << 4)  /* obj is a struct socket */
+
+#define epoll_semgive(sem) sem_post(sem)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One registered descriptor.  The pollfd structure stays registered with
+ * the driver from EPOLL_CTL_ADD until EPOLL_CTL_DEL, until the registered
+ * file or socket is closed, or until the instance is closed, so it must not
+ * move in memory:  All entries are allocated with the instance.
+ *
+ * The registration belongs to the open file (struct file) or socket
+ * (struct socket) that the descriptor referred to at EPOLL_CTL_ADD time,
+ * not to the descriptor number:  epoll_wait() may be called by any task
+ * and the descriptor number means nothing in that task's tables.
+ */
+
+struct epoll_entry_s
+{
+  struct pollfd pfd;                  /* Registered with the driver */
+  FAR void     *obj;                  /* struct file or struct socket */
+  epoll_data_t  data;                 /* Caller data returned with events */
+  uint8_t       flags;                /* See EPOLL_FLAG_* definitions */
+};
+
+/* One epoll instance.  The instance is the private data of an inode that
+ * is not in the pseudo-filesystem tree, so the epoll descriptor is an
+ * ordinary file descriptor that is shared by dup() and by child tasks and
+ * is released by close() or when the task exits.
+ */
+
+struct epoll_head_s
+{
+  FAR struct epoll_head_s *flink;     /* Next instance in g_epollhead */
+  sem_t         exclsem;              /* Protects the entry list */
+  sem_t         sem;                  /* Posted by drivers (via pfd.sem) */
+  uint16_t      size;                 /* Number of entries */
+  uint16_t      next;                 /* Where the next scan starts */
+  uint8_t       crefs;                /* Number of open descriptors */
+  struct epoll_entry_s entry[1];      /* Actual size is 'size' */
+};
+
+#define SIZEOF_EPOLL_HEAD_S(n) \
+  (sizeof(struct epoll_head_s) + ((n) - 1) * sizeof(struct epoll_entry_s))
+
+/* State shared with the epoll_wait() timeout watchdog */
+
+struct epoll_wait_s
+{
+  FAR sem_t    *sem;
+  volatile bool timedout;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int epoll_fileopen(FAR struct file *filep);
+static int epoll_fileclose(FAR struct file *filep);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_epoll_ops =
+{
+  epoll_fileopen,    /* open */
+  epoll_fileclose,   /* close */
+  0,                 /* read */
+  0,                 /* write */
+  0,                 /* seek */
+  0,                 /* ioctl */
+  0                  /* poll */
+};
+
+/* All epoll instances so that epoll_release() can find the registrations
+ * of a file or socket that is being closed.
+ */
+
+static sem_t g_epollsem = SEM_INITIALIZER(1);
+static FAR struct epoll_head_s *g_epollhead;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_semtake
+ ****************************************************************************/
+
+static void epoll_semtake(FAR sem_t *sem)
+{
+  /* Take the semaphore (perhaps waiting) */
+
+  while (sem_wait(sem) != 0)
+    {
+      /* The only case that an error should occur here is if
+       * the wait was awakened by a signal.
+       */
+
+      ASSERT(get_errno() == EINTR);
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_head
+ *
+ * Description:
+ *   Map an epoll descriptor to the instance.  Returns NULL if the
+ *   descriptor is not an epoll descriptor.
+ *
+ ****************************************************************************/
+
+static FAR struct epoll_head_s *epoll_head(int epfd)
+{
+  FAR struct filelist *list;
+  FAR struct inode *inode;
+
+  if ((unsigned int)epfd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return NULL;
+    }
+
+  list = sched_getfiles();
+  DEBUGASSERT(list);
+
+  inode = list->fl_files[epfd].f_inode;
+  if (!inode || inode->u.i_ops != &g_epoll_ops)
+    {
+      return NULL;
+    }
+
+  return (FAR struct epoll_head_s *)inode->i_private;
+}
+
+/****************************************************************************
+ * Name: epoll_object
+ *
+ * Description:
+ *   Map a file or socket descriptor of the calling task to the open file
+ *   or socket.  Returns the EPOLL_FLAG_SOCKET flag if the descriptor is a
+ *   socket, zero if it is a file or a negated errno value if it is not
+ *   valid.
+ *
+ ****************************************************************************/
+
+static int epoll_object(int fd, FAR void **obj)
+{
+  FAR struct filelist *list;
+  FAR struct file *filep;
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+  FAR struct socket *psock;
+#endif
+
+  if ((unsigned int)fd < CONFIG_NFILE_DESCRIPTORS)
+    {
+      list = sched_getfiles();
+      DEBUGASSERT(list);
+
+      filep = &list->fl_files[fd];
+      if (!filep->f_inode)
+        {
+          return -EBADF;
+        }
+
+      *obj = filep;
+      return 0;
+    }
+
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+  if ((unsigned int)fd < (CONFIG_NFILE_DESCRIPTORS+CONFIG_NSOCKET_DESCRIPTORS))
+    {
+      psock = sockfd_socket(fd);
+      if (!psock || psock->s_crefs <= 0)
+        {
+          return -EBADF;
+        }
+
+      *obj = psock;
+      return EPOLL_FLAG_SOCKET;
+    }
+#endif
+
+  return -EBADF;
+}
+
+/****************************************************************************
+ * Name: epoll_find
+ *
+ * Description:
+ *   Return the entry registered for the file or socket 'obj' or NULL if
+ *   there is none.
+ *
+ ****************************************************************************/
+
+static FAR struct epoll_entry_s *epoll_find(FAR struct epoll_head_s *eph,
+                                            FAR const void *obj)
+{
+  int i;
+
+  for (i = 0; i < eph->size; i++)
+    {
+      if ((eph->entry[i].flags & EPOLL_FLAG_INUSE) != 0 &&
+          eph->entry[i].obj == obj)
+        {
+          return &eph->entry[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: epoll_poll
+ *
+ * Description:
+ *   Set up or tear down the driver poll of an entry.  The stored file or
+ *   socket is used, so this works from any task.
+ *
+ ****************************************************************************/
+
+static int epoll_poll(FAR struct epoll_entry_s *entry, bool setup)
+{
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+  if ((entry->flags & EPOLL_FLAG_SOCKET) != 0)
+    {
+      return psock_poll((FAR struct socket *)entry->obj, &entry->pfd, setup);
+    }
+#endif
+
+  return file_poll((FAR struct file *)entry->obj, &entry->pfd, setup);
+}
+
+/****************************************************************************
+ * Name: epoll_arm
+ *
+ * Description:
+ *   Register the entry's pollfd with the driver.  If the descriptor is
+ *   already ready, the driver sets revents and posts the semaphore now.
+ *
+ ****************************************************************************/
+
+static int epoll_arm(FAR struct epoll_head_s *eph,
+                     FAR struct epoll_entry_s *entry)
+{
+  int ret;
+
+  entry->pfd.sem     = &eph->sem;
+  entry->pfd.revents = 0;
+  entry->pfd.priv    = NULL;
+
+  ret = epoll_poll(entry, true);
+  if (ret >= 0)
+    {
+      entry->flags |= EPOLL_FLAG_ARMED;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: epoll_disarm
+ *
+ * Description:
+ *   Remove the entry's pollfd from the driver.
+ *
+ ****************************************************************************/
+
+static void epoll_disarm(FAR struct epoll_entry_s *entry)
+{
+  irqstate_t flags;
+
+  if ((entry->flags & EPOLL_FLAG_ARMED) != 0)
+    {
+      (void)epoll_poll(entry, false);
+      entry->flags &= ~EPOLL_FLAG_ARMED;
+    }
+
+  flags = irqsave();
+  entry->pfd.revents = 0;
+  entry->pfd.sem     = NULL;
+  irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_remove
+ *
+ * Description:
+ *   Remove the registration held by an entry.
+ *
+ ****************************************************************************/
+
+static void epoll_remove(FAR struct epoll_entry_s *entry)
+{
+  epoll_disarm(entry);
+  entry->flags  = 0;
+  entry->obj    = NULL;
+  entry->pfd.fd = -1;
+}
+
+/****************************************************************************
+ * Name: epoll_collect
+ *
+ * Description:
+ *   Move up to 'maxevents' ready entries to the caller's event list.
+ *
+ *   The drivers report readiness by setting revents in the registered
+ *   pollfd and posting the shared semaphore.  Nothing has to be set up
+ *   or torn down here for the descriptors that are not ready; only the
+ *   entries that are reported are touched:
+ *
+ *   - Level-triggered entries are re-registered so that the driver
+ *     re-evaluates the current state.  If the descriptor is still ready,
+ *     it is reported again by the next epoll_wait().
+ *   - Edge-triggered entries stay registered; revents is just cleared.
+ *   - One-shot entries are removed from the driver until EPOLL_CTL_MOD.
+ *
+ *   The scan resumes after the last reported entry so that a busy
+ *   descriptor cannot starve the others when maxevents is small.
+ *
+ ****************************************************************************/
+
+static int epoll_collect(FAR struct epoll_head_s *eph,
+                         FAR struct epoll_event *evs, int maxevents)
+{
+  FAR struct epoll_entry_s *entry;
+  irqstate_t flags;
+  pollevent_t revents;
+  int nevents = 0;
+  int ndx = eph->next;
+  int i;
+
+  for (i = 0; i < eph->size && nevents < maxevents; i++)
+    {
+      entry = &eph->entry[ndx];
+      if (++ndx >= eph->size)
+        {
+          ndx = 0;
+        }
+
+      /* revents is a single byte, so the unlocked test is safe.  Fetch and
+       * clear it with interrupts disabled because drivers may update it
+       * from interrupt handlers.
+       */
+
+      if ((entry->flags & EPOLL_FLAG_ARMED) == 0 || entry->pfd.revents == 0)
+        {
+          continue;
+        }
+
+      flags = irqsave();
+      revents = entry->pfd.revents;
+      entry->pfd.revents = 0;
+      irqrestore(flags);
+
+      evs[nevents].events = revents;
+      evs[nevents].data   = entry->data;
+      nevents++;
+      eph->next = ndx;
+
+      if ((entry->flags & EPOLL_FLAG_ONESHOT) != 0)
+        {
+          epoll_disarm(entry);
+        }
+      else if ((entry->flags & EPOLL_FLAG_ET) == 0)
+        {
+          epoll_disarm(entry);
+          if (epoll_arm(eph, entry) < 0)
+            {
+              fdbg("Failed to re-arm fd %d\n", entry->pfd.fd);
+            }
+        }
+    }
+
+  return nevents;
+}
+
+/****************************************************************************
+ * Name: epoll_timeout
+ *
+ * Description:
+ *   The wdog expired before any other events were received.
+ *
+ ****************************************************************************/
+
+static void epoll_timeout(int argc, uint32_t arg, ...)
+{
+  FAR struct epoll_wait_s *wait = (FAR struct epoll_wait_s *)arg;
+
+  /* Wake up the waiter */
+
+  wait->timedout = true;
+  epoll_semgive(wait->sem);
+}
+
+/****************************************************************************
+ * Name: epoll_fileopen
+ *
+ * Description:
+ *   The epoll descriptor was duplicated by dup(), dup2() or by the creation
+ *   of a child task.
+ *
+ ****************************************************************************/
+
+static int epoll_fileopen(FAR struct file *filep)
+{
+  FAR struct epoll_head_s *eph =
+    (FAR struct epoll_head_s *)filep->f_inode->i_private;
+
+  epoll_semtake(&eph->exclsem);
+  eph->crefs++;
+  epoll_semgive(&eph->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_fileclose
+ *
+ * Description:
+ *   An epoll descriptor was closed.  When the last one is closed, remove
+ *   all registrations and free the instance.  The inode itself is freed by
+ *   inode_release() after this returns.
+ *
+ ****************************************************************************/
+
+static int epoll_fileclose(FAR struct file *filep)
+{
+  FAR struct epoll_head_s *eph =
+    (FAR struct epoll_head_s *)filep->f_inode->i_private;
+  FAR struct epoll_head_s *prev;
+  FAR struct epoll_head_s *curr;
+  int i;
+
+  epoll_semtake(&eph->exclsem);
+  if (--eph->crefs > 0)
+    {
+      epoll_semgive(&eph->exclsem);
+      return OK;
+    }
+
+  epoll_semgive(&eph->exclsem);
+
+  /* Remove the instance from the list */
+
+  epoll_semtake(&g_epollsem);
+  for (prev = NULL, curr = g_epollhead;
+       curr && curr != eph;
+       prev = curr, curr = curr->flink);
+
+  if (curr)
+    {
+      if (prev)
+        {
+          prev->flink = eph->flink;
+        }
+      else
+        {
+          g_epollhead = eph->flink;
+        }
+    }
+
+  epoll_semgive(&g_epollsem);
+
+  /* No other descriptor refers to the instance now */
+
+  for (i = 0; i < eph->size; i++)
+    {
+      if ((eph->entry[i].flags & EPOLL_FLAG_INUSE) != 0)
+        {
+          epoll_disarm(&eph->entry[i]);
+        }
+    }
+
+  sem_destroy(&eph->sem);
+  sem_destroy(&eph->exclsem);
+  kfree(eph);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_create
+ *
+ * Description:
+ *   Create an epoll instance.  Unlike poll(), descriptors are registered
+ *   with their drivers once, by epoll_ctl(), and remain registered across
+ *   calls to epoll_wait().
+ *
+ * Inputs:
+ *   size - The maximum number of descriptors that may be registered with
+ *     the instance.  The entries are allocated up front because the
+ *     drivers hold references to them.
+ *
+ * Return:
+ *   A file descriptor for use with epoll_ctl() and epoll_wait().  The
+ *   instance is freed when the last descriptor that refers to it is
+ *   closed.  On error, -1 is returned and errno is set:
+ *
+ *   EINVAL - size is not positive
+ *   EMFILE - There are no free file descriptors
+ *   ENOMEM - The instance could not be allocated
+ *
+ ****************************************************************************/
+
+int epoll_create(int size)
+{
+  FAR struct epoll_head_s *eph;
+  FAR struct inode *inode;
+  int epfd;
+  int i;
+
+  if (size <= 0 || size > UINT16_MAX)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  eph = (FAR struct epoll_head_s *)kzalloc(SIZEOF_EPOLL_HEAD_S(size));
+  if (!eph)
+    {
+      set_errno(ENOMEM);
+      return ERROR;
+    }
+
+  sem_init(&eph->exclsem, 0, 1);
+  sem_init(&eph->sem, 0, 0);
+  eph->size  = size;
+  eph->crefs = 1;
+
+  for (i = 0; i < size; i++)
+    {
+      eph->entry[i].pfd.fd = -1;
+    }
+
+  /* The inode is not in the pseudo-filesystem tree.  It is marked deleted
+   * so that inode_release() frees it when the last descriptor is closed.
+   */
+
+  inode = (FAR struct inode *)kzalloc(FSNODE_SIZE(0));
+  if (!inode)
+    {
+      set_errno(ENOMEM);
+      goto errout_with_eph;
+    }
+
+  inode->i_crefs   = 1;
+  inode->i_flags   = FSNODEFLAG_DELETED;
+  inode->u.i_ops   = &g_epoll_ops;
+  inode->i_private = eph;
+
+  epfd = files_allocate(inode, O_RDOK, 0, 0);
+  if (epfd < 0)
+    {
+      kfree(inode);
+      set_errno(EMFILE);
+      goto errout_with_eph;
+    }
+
+  /* Make the instance visible to epoll_release() */
+
+  epoll_semtake(&g_epollsem);
+  eph->flink  = g_epollhead;
+  g_epollhead = eph;
+  epoll_semgive(&g_epollsem);
+
+  return epfd;
+
+errout_with_eph:
+  sem_destroy(&eph->sem);
+  sem_destroy(&eph->exclsem);
+  kfree(eph);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: epoll_ctl
+ *
+ * Description:
+ *   Add, modify or remove the registration of a descriptor.  The
+ *   registration belongs to the open file or socket that 'fd' refers to; it
+ *   is removed automatically when that file or socket is closed.
+ *
+ * Inputs:
+ *   epfd - The epoll descriptor returned by epoll_create()
+ *   op - EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL
+ *   fd - The file or socket descriptor
+ *   ev - The events of interest and the caller data (ignored for
+ *     EPOLL_CTL_DEL)
+ *
+ * Return:
+ *   Zero on success.  On error, -1 is returned and errno is set:
+ *
+ *   EBADF - epfd or fd is not valid
+ *   EEXIST - op is EPOLL_CTL_ADD and fd is already registered
+ *   EINVAL - op is not valid or ev is NULL
+ *   ENOENT - op is EPOLL_CTL_MOD or EPOLL_CTL_DEL and fd is not registered
+ *   ENOMEM - op is EPOLL_CTL_ADD and the instance is full
+ *   ENOSYS - The driver does not support the poll method
+ *
+ ****************************************************************************/
+
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
+{
+  FAR struct epoll_head_s *eph;
+  FAR struct epoll_entry_s *entry;
+  FAR void *obj;
+  int objflags;
+  int ret = OK;
+  int i;
+
+  eph = epoll_head(epfd);
+  if (!eph)
+    {
+      set_errno(EBADF);
+      return ERROR;
+    }
+
+  objflags = epoll_object(fd, &obj);
+  if (objflags < 0)
+    {
+      set_errno(-objflags);
+      return ERROR;
+    }
+
+  if (op != EPOLL_CTL_DEL && !ev)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  epoll_semtake(&eph->exclsem);
+  entry = epoll_find(eph, obj);
+
+  switch (op)
+    {
+      case EPOLL_CTL_ADD:
+        {
+          if (entry)
+            {
+              ret = -EEXIST;
+              break;
+            }
+
+          for (i = 0; i < eph->size; i++)
+            {
+              if ((eph->entry[i].flags & EPOLL_FLAG_INUSE) == 0)
+                {
+                  entry = &eph->entry[i];
+                  break;
+                }
+            }
+
+          if (!entry)
+            {
+              ret = -ENOMEM;
+              break;
+            }
+
+          entry->obj    = obj;
+          entry->pfd.fd = fd;
+        }
+
+        /* Fall through to configure the new entry */
+
+      case EPOLL_CTL_MOD:
+        {
+          if (!entry)
+            {
+              ret = -ENOENT;
+              break;
+            }
+
+          epoll_disarm(entry);
+
+          entry->pfd.events = (pollevent_t)(ev->events & EPOLL_POLLMASK);
+          entry->data       = ev->data;
+          entry->flags      = EPOLL_FLAG_INUSE | objflags;
+
+          if ((ev->events & EPOLLET) != 0)
+            {
+              entry->flags |= EPOLL_FLAG_ET;
+            }
+
+          if ((ev->events & EPOLLONESHOT) != 0)
+            {
+              entry->flags |= EPOLL_FLAG_ONESHOT;
+            }
+
+          ret = epoll_arm(eph, entry);
+          if (ret < 0 && op == EPOLL_CTL_ADD)
+            {
+              epoll_remove(entry);
+            }
+        }
+        break;
+
+      case EPOLL_CTL_DEL:
+        {
+          if (!entry)
+            {
+              ret = -ENOENT;
+              break;
+            }
+
+          epoll_remove(entry);
+        }
+        break;
+
+      default:
+        ret = -EINVAL;
+        break;
+    }
+
+  epoll_semgive(&eph->exclsem);
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_wait
+ *
+ * Description:
+ *   Wait for events on the registered descriptors.  Only the descriptors
+ *   that became ready are re-registered with their drivers, so the cost of
+ *   a wakeup does not grow with the number of registered descriptors the
+ *   way that it does for poll() and select().
+ *
+ * Inputs:
+ *   epfd - The epoll descriptor returned by epoll_create()
+ *   evs - The location to return the events
+ *   maxevents - The maximum number of events to return
+ *   timeout - Specifies an upper limit on the time for which epoll_wait()
+ *     will block in milliseconds.  A negative value of timeout means an
+ *     infinite timeout.
+ *
+ * Return:
+ *   On success, the number of events returned in evs.  Zero indicates that
+ *   the call timed out.  On error, -1 is returned and errno is set:
+ *
+ *   EBADF - epfd is not valid
+ *   EINTR - A signal occurred before any requested event
+ *   EINVAL - evs is NULL or maxevents is not positive
+ *   ENOMEM - timeout is positive and no watchdog timer is available
+ *
+ ****************************************************************************/
+
+int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents,
+               int timeout)
+{
+  FAR struct epoll_head_s *eph;
+  struct epoll_wait_s wait;
+  WDOG_ID wdog = NULL;
+  int nevents;
+  int errcode = 0;
+
+  eph = epoll_head(epfd);
+  if (!eph)
+    {
+      set_errno(EBADF);
+      return ERROR;
+    }
+
+  if (!evs || maxevents <= 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  wait.sem      = &eph->sem;
+  wait.timedout = false;
+
+  if (timeout > 0)
+    {
+      /* Note that the millisecond timeout has to be converted to system
+       * clock ticks for wd_start
+       */
+
+      wdog = wd_create();
+      if (!wdog)
+        {
+          set_errno(ENOMEM);
+          return ERROR;
+        }
+
+      wd_start(wdog, MSEC2TICK(timeout), epoll_timeout, 1, (uint32_t)&wait);
+    }
+
+  for (;;)
+    {
+      /* Discard the pending notifications before scanning:  Any event that
+       * is posted after this point is either seen by the scan or leaves
+       * the semaphore count non-zero for the wait below.
+       */
+
+      while (sem_trywait(&eph->sem) == OK);
+
+      epoll_semtake(&eph->exclsem);
+      nevents = epoll_collect(eph, evs, maxevents);
+      epoll_semgive(&eph->exclsem);
+
+      if (nevents > 0 || timeout == 0 || wait.timedout)
+        {
+          break;
+        }
+
+      if (sem_wait(&eph->sem) != OK)
+        {
+          errcode = get_errno();
+          break;
+        }
+    }
+
+  if (wdog)
+    {
+      wd_delete(wdog);
+    }
+
+  if (errcode != 0)
+    {
+      set_errno(errcode);
+      return ERROR;
+    }
+
+  return nevents;
+}
+
+/****************************************************************************
+ * Name: epoll_close
+ *
+ * Description:
+ *   Equivalent to close(epfd).  Retained for the applications that were
+ *   written when the epoll handle was not a file descriptor.
+ *
+ * Inputs:
+ *   epfd - The epoll descriptor returned by epoll_create()
+ *
+ ****************************************************************************/
+
+void epoll_close(int epfd)
+{
+  (void)close(epfd);
+}
+
+/****************************************************************************
+ * Name: epoll_release
+ *
+ * Description:
+ *   Called by the close logic before a file (struct file) or a socket
+ *   (struct socket) is closed.  Removes the registrations of the object
+ *   from every epoll instance so that no driver is left holding a pollfd
+ *   of a closed descriptor.  This covers close(), dup2() over a registered
+ *   descriptor and the release of the descriptors when a task exits.
+ *
+ * Inputs:
+ *   obj - The struct file or struct socket being closed
+ *
+ ****************************************************************************/
+
+void epoll_release(FAR const void *obj)
+{
+  FAR struct epoll_head_s *eph;
+  int i;
+
+  /* Nothing to do if epoll is not in use.  A new instance cannot hold a
+   * registration of an object that is being closed.
+   */
+
+  if (!g_epollhead)
+    {
+      return;
+    }
+
+  epoll_semtake(&g_epollsem);
+  for (eph = g_epollhead; eph; eph = eph->flink)
+    {
+      epoll_semtake(&eph->exclsem);
+      for (i = 0; i < eph->size; i++)
+        {
+          if ((eph->entry[i].flags & EPOLL_FLAG_INUSE) != 0 &&
+              eph->entry[i].obj == obj)
+            {
+              epoll_remove(&eph->entry[i]);
+            }
+        }
+
+      epoll_semgive(&eph->exclsem);
+    }
+
+  epoll_semgive(&g_epollsem);
+}
+
+#endif /* !CONFIG_DISABLE_POLL && CONFIG_NFILE_DESCRIPTORS > 0 */
@@ -115,6 +115,10 @@ static int _files_close(FAR struct file *filep)
 
   if (inode)
     {
+      /* Drop any epoll registrations of the file before it goes away */
+
+      epoll_release(filep);
+
       /* Close the file, driver, or mountpoint. */
 
       if (inode->u.i_ops && inode->u.i_ops->close)
@@ -39,6 +39,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+#include <string.h>
 #include <assert.h>
 #include <semaphore.h>
 #include <errno.h>
@@ -54,22 +56,42 @@
 
 #define NO_HOLDER (pid_t)-1;
 
+/* Configuration ************************************************************/
+
+#ifdef CONFIG_FS_INODE_HASH
+#  ifndef CONFIG_FS_INODE_NHASH
+#    define CONFIG_FS_INODE_NHASH 32
+#  endif
+#  if (CONFIG_FS_INODE_NHASH & (CONFIG_FS_INODE_NHASH - 1)) != 0
+#    error CONFIG_FS_INODE_NHASH must be a power of two
+#  endif
+#  define INODE_HASH_MASK (CONFIG_FS_INODE_NHASH - 1)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
-/* Implements a re-entrant mutex for inode access.  This must be re-entrant
- * because there can be cycles.  For example, it may be necessary to destroy
- * a block driver inode on umount() after a removable block device has been
- * removed.  In that case umount() hold the inode semaphore, but the block
- * driver may callback to unregister_blockdriver() after the un-mount,
- * requiring the seamphore again.
+/* Implements a re-entrant reader/writer lock for inode access.  Exclusive
+ * (writer) access must be re-entrant because there can be cycles.  For
+ * example, it may be necessary to destroy a block driver inode on umount()
+ * after a removable block device has been removed.  In that case umount()
+ * hold the inode semaphore, but the block driver may callback to
+ * unregister_blockdriver() after the un-mount, requiring the seamphore
+ * again.
+ *
+ * Shared (reader) access lets path lookups run concurrently.  'sem' is
+ * also the turnstile that readers pass through so that a waiting writer
+ * holds off new readers; 'empty' is held while there are any readers.
  */
 
 struct inode_sem_s
 {
-  sem_t   sem;     /* The semaphore */
-  pid_t   holder;  /* The current holder of the semaphore */
-  int16_t count;   /* Number of counts held */
+  sem_t   sem;      /* The semaphore */
+  sem_t   rdsem;    /* Protects nreaders */
+  sem_t   empty;    /* Held while nreaders > 0 */
+  pid_t   holder;   /* The current holder of the semaphore */
+  int16_t count;    /* Number of counts held */
+  int16_t nreaders; /* Number of threads with shared access */
 };
 
 /****************************************************************************
@@ -78,6 +100,12 @@ struct inode_sem_s
 
 static struct inode_sem_s g_inode_sem;
 
+#ifdef CONFIG_FS_INODE_HASH
+/* Index of all inodes in the tree by (parent, name) */
+
+static FAR struct inode *g_inode_hash[CONFIG_FS_INODE_NHASH];
+#endif
+
 /****************************************************************************
  * Public Variables
  ****************************************************************************/
@@ -165,6 +193,79 @@ static int _inode_compare(FAR const char *fname,
     }
 }
 
+/****************************************************************************
+ * Name: inode_semwait
+ ****************************************************************************/
+
+static void inode_semwait(FAR sem_t *sem)
+{
+  while (sem_wait(sem) != 0)
+    {
+      /* The only case that an error should occr here is if
+       * the wait was awakened by a signal.
+       */
+
+      ASSERT(get_errno() == EINTR);
+    }
+}
+
+/****************************************************************************
+ * Name: inode_hash
+ *
+ * Description:
+ *   Return the hash bucket for the path segment 'name' (terminated by '/'
+ *   or NUL) below 'parent'.  The length of the segment is also returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_HASH
+static unsigned int inode_hash(FAR struct inode *parent,
+                               FAR const char *name, FAR size_t *namelen)
+{
+  FAR const char *ptr = name;
+  uint32_t hash = (uint32_t)((uintptr_t)parent >> 2);
+
+  while (*ptr && *ptr != '/')
+    {
+      hash = hash * 31 + (uint8_t)*ptr++;
+    }
+
+  *namelen = ptr - name;
+  return (unsigned int)(hash ^ (hash >> 16)) & INODE_HASH_MASK;
+}
+#endif
+
+/****************************************************************************
+ * Name: inode_hashfind
+ *
+ * Description:
+ *   Find the child of 'parent' (or the top-level node if 'parent' is NULL)
+ *   named by the path segment 'name'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_HASH
+static FAR struct inode *inode_hashfind(FAR struct inode *parent,
+                                        FAR const char *name)
+{
+  FAR struct inode *node;
+  size_t namelen;
+
+  node = g_inode_hash[inode_hash(parent, name, &namelen)];
+  for (; node; node = node->i_hnext)
+    {
+      if (node->i_parent == parent &&
+          strncmp(node->i_name, name, namelen) == 0 &&
+          node->i_name[namelen] == '\0')
+        {
+          break;
+        }
+    }
+
+  return node;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -185,8 +286,11 @@ void fs_initialize(void)
    */
 
   (void)sem_init(&g_inode_sem.sem, 0, 1);
-  g_inode_sem.holder = NO_HOLDER;
-  g_inode_sem.count  = 0;
+  (void)sem_init(&g_inode_sem.rdsem, 0, 1);
+  (void)sem_init(&g_inode_sem.empty, 0, 1);
+  g_inode_sem.holder   = NO_HOLDER;
+  g_inode_sem.count    = 0;
+  g_inode_sem.nreaders = 0;
 
   /* Initialize files array (if it is used) */
 
@@ -225,14 +329,12 @@ void inode_semtake(void)
 
   else
     {
-      while (sem_wait(&g_inode_sem.sem) != 0)
-        {
-          /* The only case that an error should occr here is if
-           * the wait was awakened by a signal.
-           */
+      /* Holding the semaphore keeps out new readers; then wait for the
+       * current readers to finish.
+       */
 
-          ASSERT(get_errno() == EINTR);
-        }
+      inode_semwait(&g_inode_sem.sem);
+      inode_semwait(&g_inode_sem.empty);
 
       /* No we hold the semaphore */
 
@@ -268,7 +370,76 @@ void inode_semgive(void)
     {
       g_inode_sem.holder = NO_HOLDER;
       g_inode_sem.count  = 0;
+      sem_post(&g_inode_sem.empty);
+      sem_post(&g_inode_sem.sem);
+    }
+}
+
+/****************************************************************************
+ * Name: inode_rdsemtake
+ *
+ * Description:
+ *   Get shared access to the in-memory inode tree (g_inode_sem).  Any
+ *   number of threads may hold shared access at the same time, but shared
+ *   access excludes inode_semtake().  The caller may only read the tree.
+ *   If the caller already holds exclusive access, this is the same as
+ *   inode_semtake().
+ *
+ ****************************************************************************/
+
+void inode_rdsemtake(void)
+{
+  if (getpid() == g_inode_sem.holder)
+    {
+      inode_semtake();
+    }
+  else
+    {
+      /* Pass through the turnstile.  This waits if a writer holds (or is
+       * waiting for) the tree.
+       */
+
+      inode_semwait(&g_inode_sem.sem);
       sem_post(&g_inode_sem.sem);
+
+      /* The first reader locks out writers */
+
+      inode_semwait(&g_inode_sem.rdsem);
+      if (++g_inode_sem.nreaders == 1)
+        {
+          inode_semwait(&g_inode_sem.empty);
+        }
+
+      sem_post(&g_inode_sem.rdsem);
+    }
+}
+
+/****************************************************************************
+ * Name: inode_rdsemgive
+ *
+ * Description:
+ *   Relinquish shared access to the in-memory inode tree (g_inode_sem).
+ *
+ ****************************************************************************/
+
+void inode_rdsemgive(void)
+{
+  if (getpid() == g_inode_sem.holder)
+    {
+      inode_semgive();
+    }
+  else
+    {
+      /* The last reader lets writers in */
+
+      inode_semwait(&g_inode_sem.rdsem);
+      DEBUGASSERT(g_inode_sem.nreaders > 0);
+      if (--g_inode_sem.nreaders == 0)
+        {
+          sem_post(&g_inode_sem.empty);
+        }
+
+      sem_post(&g_inode_sem.rdsem);
     }
 }
 
@@ -279,8 +450,12 @@ void inode_semgive(void)
  *   Find the inode associated with 'path' returning the inode references
  *   and references to its companion nodes.
  *
+ *   If the companion nodes are not needed, then each path segment is found
+ *   in the inode hash index (if CONFIG_FS_INODE_HASH is selected) rather
+ *   than by searching the ordered list of peers.
+ *
  * Assumptions:
- *   The caller holds the g_inode_sem semaphore
+ *   The caller holds the g_inode_sem semaphore (shared access is sufficient)
  *
  ****************************************************************************/
 
@@ -294,6 +469,42 @@ FAR struct inode *inode_search(const char **path,
   FAR struct inode *left  = NULL;
   FAR struct inode *above = NULL;
 
+#ifdef CONFIG_FS_INODE_HASH
+  if (!peer && !parent)
+    {
+      for (;;)
+        {
+          node = inode_hashfind(above, name);
+          if (!node)
+            {
+              break;
+            }
+
+          /* Is this the node we are looking for or a mountpoint that will
+           * handle the remaining part of the pathname?
+           */
+
+          name = inode_nextname(name);
+          if (!*name || INODE_IS_MOUNTPT(node))
+            {
+              if (relpath)
+                {
+                  *relpath = name;
+                }
+
+              break;
+            }
+
+          /* More to go, keep looking at the next level "down" */
+
+          above = node;
+        }
+
+      *path = name;
+      return node;
+    }
+#endif
+
   while (node)
     {
       int result = _inode_compare(name, node);
@@ -386,6 +597,71 @@ FAR struct inode *inode_search(const char **path,
   return node;
 }
 
+/****************************************************************************
+ * Name: inode_hashinsert
+ *
+ * Description:
+ *   Add an inode that has just been inserted into the tree below 'parent'
+ *   to the inode hash index.
+ *
+ * Assumptions:
+ *   The caller holds exclusive access to the inode tree
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_HASH
+void inode_hashinsert(FAR struct inode *node, FAR struct inode *parent)
+{
+  size_t namelen;
+  unsigned int ndx;
+
+  ndx               = inode_hash(parent, node->i_name, &namelen);
+  node->i_parent    = parent;
+  node->i_hnext     = g_inode_hash[ndx];
+  g_inode_hash[ndx] = node;
+}
+#endif
+
+/****************************************************************************
+ * Name: inode_hashremove
+ *
+ * Description:
+ *   Remove an inode and all of the inodes below it from the inode hash
+ *   index.  This is done when the subtree is unlinked from the tree (even
+ *   if it cannot be freed yet) so that the hash index only ever refers to
+ *   inodes in the tree.
+ *
+ * Assumptions:
+ *   The caller holds exclusive access to the inode tree
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_HASH
+void inode_hashremove(FAR struct inode *node)
+{
+  FAR struct inode **link;
+  FAR struct inode *child;
+  size_t namelen;
+
+  link = &g_inode_hash[inode_hash(node->i_parent, node->i_name, &namelen)];
+  for (; *link; link = &(*link)->i_hnext)
+    {
+      if (*link == node)
+        {
+          *link = node->i_hnext;
+          break;
+        }
+    }
+
+  node->i_hnext = NULL;
+
+  for (child = node->i_child; child; child = child->i_peer)
+    {
+      inode_hashremove(child);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: inode_free
  *
@@ -42,6 +42,8 @@
 #include <errno.h>
 #include <nuttx/fs/fs.h>
 
+#include <arch/irq.h>
+
 #include "fs_internal.h"
 
 /****************************************************************************
@@ -76,6 +78,7 @@
 FAR struct inode *inode_find(FAR const char *path, FAR const char **relpath)
 {
   FAR struct inode *node;
+  irqstate_t flags;
 
   if (!*path || path[0] != '/')
     {
@@ -83,17 +86,24 @@ FAR struct inode *inode_find(FAR const char *path, FAR const char **relpath)
     }
 
   /* Find the node matching the path.  If found, increment the count of
-   * references on the node.
+   * references on the node.  Only shared access to the tree is needed so
+   * that lookups by different threads do not serialize.
    */
 
-  inode_semtake();
+  inode_rdsemtake();
   node = inode_search(&path, (FAR struct inode**)NULL, (FAR struct inode**)NULL, relpath);
   if (node)
     {
+      /* Other threads may be doing the same with only shared access to
+       * the tree.
+       */
+
+      flags = irqsave();
       node->i_crefs++;
+      irqrestore(flags);
     }
 
-  inode_semgive();
+  inode_rdsemgive();
   return node;
 }
 
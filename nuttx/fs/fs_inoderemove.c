@@ -133,6 +133,12 @@ int inode_remove(FAR const char *path)
 
       inode_unlink(node, left, parent);
 
+#ifdef CONFIG_FS_INODE_HASH
+      /* The subtree can no longer be found in the hash index either */
+
+      inode_hashremove(node);
+#endif
+
       /* We cannot delete it if there reference to the inode */
 
       if (node->i_crefs)
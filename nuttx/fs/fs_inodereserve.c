@@ -135,6 +135,12 @@ static void inode_insert(FAR struct inode *node,
       node->i_peer = root_inode;
       root_inode   = node;
     }
+
+#ifdef CONFIG_FS_INODE_HASH
+  /* And add it to the hash index */
+
+  inode_hashinsert(node, parent);
+#endif
 }
 
 /****************************************************************************
@@ -131,6 +131,27 @@ void inode_semtake(void);
 
 void inode_semgive(void);
 
+/****************************************************************************
+ * Name: inode_rdsemtake
+ *
+ * Description:
+ *   Get shared access to the in-memory inode tree (tree_sem).  The caller
+ *   may search the tree, but must not modify it.
+ *
+ ****************************************************************************/
+
+void inode_rdsemtake(void);
+
+/****************************************************************************
+ * Name: inode_rdsemgive
+ *
+ * Description:
+ *   Relinquish shared access to the in-memory inode tree (tree_sem).
+ *
+ ****************************************************************************/
+
+void inode_rdsemgive(void);
+
 /****************************************************************************
  * Name: inode_search
  *
@@ -148,6 +169,30 @@ FAR struct inode *inode_search(FAR const char **path,
                                FAR struct inode **parent,
                                FAR const char **relpath);
 
+/****************************************************************************
+ * Name: inode_hashinsert
+ *
+ * Description:
+ *   Add a newly inserted inode to the inode hash index
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_HASH
+void inode_hashinsert(FAR struct inode *node, FAR struct inode *parent);
+#endif
+
+/****************************************************************************
+ * Name: inode_hashremove
+ *
+ * Description:
+ *   Remove an inode and its subtree from the inode hash index
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_HASH
+void inode_hashremove(FAR struct inode *node);
+#endif
+
 /****************************************************************************
  * Name: inode_free
  *
@@ -319,6 +364,21 @@ void files_release(int fd);
 int find_blockdriver(FAR const char *pathname, int mountflags,
                      FAR struct inode **ppinode);
 
+/* fs_poll.c ****************************************************************/
+/****************************************************************************
+ * Name: file_poll
+ *
+ * Description:
+ *   Configure (or unconfigure) the poll operation on an open file.  Used
+ *   by poll() and by the persistent epoll registrations.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_DISABLE_POLL) && CONFIG_NFILE_DESCRIPTORS > 0
+struct pollfd;
+int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
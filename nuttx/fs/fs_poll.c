@@ -83,6 +83,36 @@ static void poll_semtake(FAR sem_t *sem)
     }
 }
 
+/****************************************************************************
+ * Name: file_poll
+ *
+ * Description:
+ *   Configure (or unconfigure) the poll operation on an open file.  Used
+ *   by poll() and by the persistent epoll registrations, which keep the
+ *   struct file and not the descriptor.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+
+  /* Is a driver registered? Does it support the poll method?
+   * If not, return -ENOSYS
+   */
+
+  if (inode && inode->u.i_ops && inode->u.i_ops->poll)
+    {
+      /* Yes, then setup the poll */
+
+      return (int)inode->u.i_ops->poll(filep, fds, setup);
+    }
+
+  return -ENOSYS;
+}
+#endif
+
 /****************************************************************************
  * Name: poll_fdsetup
  *
@@ -97,9 +127,6 @@ static void poll_semtake(FAR sem_t *sem)
 static int poll_fdsetup(int fd, FAR struct pollfd *fds, bool setup)
 {
   FAR struct filelist *list;
-  FAR struct file     *filep;
-  FAR struct inode    *inode;
-  int                  ret = -ENOSYS;
 
   /* Check for a valid file descriptor */
 
@@ -124,21 +151,7 @@ static int poll_fdsetup(int fd, FAR struct pollfd *fds, bool setup)
   list = sched_getfiles();
   DEBUGASSERT(list);
 
-  /* Is a driver registered? Does it support the poll method?
-   * If not, return -ENOSYS
-   */
-
-  filep = &list->fl_files[fd];
-  inode = filep->f_inode;
-
-  if (inode && inode->u.i_ops && inode->u.i_ops->poll)
-    {
-      /* Yes, then setup the poll */
-
-      ret = (int)inode->u.i_ops->poll(filep, fds, setup);
-    }
-
-  return ret;
+  return file_poll(&list->fl_files[fd], fds, setup);
 }
 #endif
 
@@ -52,6 +52,10 @@
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/fs/nxffs.h>
 
+#ifdef CONFIG_NXFFS_BGPACK
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -265,6 +269,15 @@ struct nxffs_ofile_s
   int16_t                   crefs;     /* Reference count */
   mode_t                    oflags;    /* Open mode */
   struct nxffs_entry_s      entry;     /* Describes the NXFFS inode entry */
+
+  /* Read cursor.  This remembers the data block used by the last read so
+   * that sequential reads do not have to search from the beginning of the
+   * file.  The cursor is not valid if rdoffset is zero.
+   */
+
+  off_t                     rdoffset;  /* FLASH offset to the data block header */
+  off_t                     rdpos;     /* File position of the first byte in the block */
+  uint16_t                  rddatlen;  /* Length of data in the block */
 };
 
 /* A file opened for writing require some additional information */
@@ -283,6 +296,63 @@ struct nxffs_wrfile_s
   uint32_t                  crc;        /* Accumulated data block CRC */
 };
 
+/* This structure describes one entry in the in-memory inode index.  The
+ * index maps an inode name to the FLASH offset of its inode header so that
+ * inodes can be found without scanning the FLASH.
+ */
+
+#ifdef CONFIG_NXFFS_INODE_INDEX
+struct nxffs_idxentry_s
+{
+  FAR struct nxffs_idxentry_s *flink;  /* Next entry in the hash bucket */
+  off_t                     hoffset;   /* FLASH offset to the inode header */
+  char                      name[1];   /* Inode name (actual size varies) */
+};
+#endif
+
+/* This structure supports access to one inode data stream during packing */
+
+struct nxffs_packstream_s
+{
+  struct nxffs_entry_s      entry;     /* Describes the inode header */
+  off_t                     fpos;      /* Current file position */
+  off_t                     blkoffset; /* Offset to the current data block */
+  uint16_t                  blklen;    /* Size of this block */
+  uint16_t                  blkpos;    /* Position in block corresponding to fpos */
+};
+
+/* The structure supports the overall packing operation.  Packing proceeds
+ * one erase block at a time so that this state can be retained between
+ * the steps of a background packing operation.
+ */
+
+struct nxffs_pack_s
+{
+  /* These describe the source and destination streams */
+
+  struct nxffs_packstream_s src;
+  struct nxffs_packstream_s dest;
+
+  /* These describe the state of the current contents of the (destination)
+   * volume->pack buffer.
+   */
+
+  FAR uint8_t              *iobuffer;  /* I/O block start position */
+  off_t                     ioblock;   /* I/O block number */
+  off_t                     block0;    /* First I/O block number in the erase block */
+  uint16_t                  iooffset;  /* I/O block offset */
+
+  /* These describe the progress through the volume */
+
+  bool                      packed;    /* True: All normal inodes have been packed */
+  off_t                     eblock;    /* Next erase block to be packed */
+  FAR struct nxffs_wrfile_s *wrfile;   /* Writer whose data must still be packed */
+#ifdef CONFIG_NXFFS_BGPACK
+  off_t                     froffset;  /* Free FLASH offset before packing */
+  off_t                     dfroffset; /* Destination offset between steps */
+#endif
+};
+
 /* This structure represents the overall state of on NXFFS instance. */
 
 struct nxffs_volume_s
@@ -301,6 +371,17 @@ struct nxffs_volume_s
   FAR struct nxffs_ofile_s *ofiles;    /* A singly-linked list of open files */
   FAR uint8_t              *cache;     /* On cached erase block for general I/O */
   FAR uint8_t              *pack;      /* A full erase block to support packing */
+#ifdef CONFIG_NXFFS_INODE_INDEX
+  bool                      idxvalid;  /* True: The index holds every inode */
+  FAR struct nxffs_idxentry_s *index[CONFIG_NXFFS_INDEX_NBUCKETS];
+#endif
+#ifdef CONFIG_NXFFS_BGPACK
+  bool                      bgactive;  /* True: A background pack is in progress */
+  bool                      bgreclaim; /* True: Inodes deleted since the last pack */
+  struct work_s             bgwork;    /* Schedules the background packer */
+  struct nxffs_pack_s       bgpack;    /* State of the background pack */
+  struct nxffs_packstats_s  bgstats;   /* Packing statistics */
+#endif
 };
 
 /* This structure describes the state of the blocks on the NXFFS volume */
@@ -1041,6 +1122,111 @@ int nxffs_rdblkhdr(FAR struct nxffs_volume_s *volume, off_t offset,
 
 int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name);
 
+/****************************************************************************
+ * Name: nxffs_idxadd
+ *
+ * Description:
+ *   Add an inode to the in-memory inode index or, if an inode of the same
+ *   name is already in the index, update the FLASH offset of its inode
+ *   header.  If memory cannot be allocated for the new entry, the index is
+ *   marked incomplete and inode look-ups will fall back to scanning FLASH.
+ *
+ * Input Parameters:
+ *   volume  - Describes the NXFFS volume.
+ *   name    - The name of the inode.
+ *   hoffset - FLASH offset to the inode header.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INODE_INDEX
+void nxffs_idxadd(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                  off_t hoffset);
+#else
+#  define nxffs_idxadd(v,n,o)
+#endif
+
+/****************************************************************************
+ * Name: nxffs_idxremove
+ *
+ * Description:
+ *   Remove an inode from the in-memory inode index.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume.
+ *   name   - The name of the inode.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INODE_INDEX
+void nxffs_idxremove(FAR struct nxffs_volume_s *volume, FAR const char *name);
+#else
+#  define nxffs_idxremove(v,n)
+#endif
+
+/****************************************************************************
+ * Name: nxffs_idxreset
+ *
+ * Description:
+ *   Discard all entries in the in-memory inode index.  After this call the
+ *   index is empty and complete, which describes a freshly formatted
+ *   volume.  Callers that are about to re-scan FLASH add each inode that
+ *   they find with nxffs_idxadd().
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INODE_INDEX
+void nxffs_idxreset(FAR struct nxffs_volume_s *volume);
+#else
+#  define nxffs_idxreset(v)
+#endif
+
+/****************************************************************************
+ * Name: nxffs_idxfind
+ *
+ * Description:
+ *   Look up the FLASH offset of an inode header in the in-memory inode
+ *   index.
+ *
+ * Input Parameters:
+ *   volume  - Describes the NXFFS volume.
+ *   name    - The name of the inode to find.
+ *   hoffset - The location to return the FLASH offset of the inode header.
+ *
+ * Returned Value:
+ *   OK     - The inode is in the index and its offset was returned.
+ *   ENOENT - The inode does not exist.
+ *   ENOSYS - The inode is not in the index, but the index is incomplete so
+ *            the FLASH must be searched.
+ *
+ *   Errors are returned as negated errno values.
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INODE_INDEX
+int nxffs_idxfind(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                  FAR off_t *hoffset);
+#endif
+
 /****************************************************************************
  * Name: nxffs_pack
  *
@@ -1059,6 +1245,143 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name);
 
 int nxffs_pack(FAR struct nxffs_volume_s *volume);
 
+/****************************************************************************
+ * Name: nxffs_packstep
+ *
+ * Description:
+ *   Perform one bounded step of a background pack.  A new packing operation
+ *   is started if none is in progress.  Then up to 'neblocks' erase blocks
+ *   are packed and written back to FLASH.  The state of the packing
+ *   operation is retained in the volume structure between steps.
+ *
+ *   Between steps, the inodes that have already been moved are found at
+ *   their new location (ahead of their old copies) and the inodes that have
+ *   not yet been moved are still intact.  Only the inode that is being
+ *   moved is unusable.  After the last inode has been moved, the new free
+ *   FLASH region begins behind the erase blocks that remain to be packed.
+ *   See nxffs_bgrdsync() and nxffs_bgwrsync() for the operations that must
+ *   step the packing operation first.  If there is an open writer, it must
+ *   not have a partially written data block.
+ *
+ * Input Parameters:
+ *   volume   - The volume to be packed.
+ *   neblocks - The maximum number of erase blocks to pack in this step.
+ *
+ * Returned Values:
+ *   Zero is returned if the packing operation is complete.  -EINPROGRESS is
+ *   returned if more steps are required.  Otherwise, a negated errno value
+ *   is returned to indicate the nature of the failure.
+ *
+ * Defined in nxffs_pack.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+int nxffs_packstep(FAR struct nxffs_volume_s *volume, int neblocks);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_bgschedule
+ *
+ * Description:
+ *   Called with the volume locked after operations that may leave
+ *   reclaimable FLASH behind (closing a file or removing an inode).  If the
+ *   volume is idle and packing is worthwhile, the background packer is
+ *   (re-)scheduled to run after CONFIG_NXFFS_BGPACK_DELAY milliseconds.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_bgpack.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+void nxffs_bgschedule(FAR struct nxffs_volume_s *volume);
+#else
+#  define nxffs_bgschedule(v)
+#endif
+
+/****************************************************************************
+ * Name: nxffs_bgsync, nxffs_bgrdsync, and nxffs_bgwrsync
+ *
+ * Description:
+ *   Called with the volume locked before an operation that accesses the
+ *   FLASH.  If a background packing operation was interrupted and the
+ *   operation could be affected by it, the packing operation is stepped
+ *   now.
+ *
+ *   nxffs_bgsync()   - Complete the packing operation.  Used before the
+ *                      volume is unmounted or packed in the foreground.
+ *   nxffs_bgrdsync() - Step the packing operation until the inode 'name'
+ *                      is no longer being moved.  Used before an inode is
+ *                      opened, read, removed, or examined.
+ *   nxffs_bgwrsync() - Step the packing operation until the erase block
+ *                      containing 'block' has been packed.  Used before a
+ *                      writer uses a block in the free FLASH region.
+ *
+ *   Other operations are not stalled:  Inodes are moved one erase block at
+ *   a time, so each step costs at most one erase block plus the size of one
+ *   inode.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume.
+ *   name   - The name of the inode to be accessed.
+ *   block  - The FLASH block to be written.
+ *
+ * Returned Value:
+ *   Zero on success; Otherwise, a negated errno value is returned to
+ *   indicate the nature of the failure.
+ *
+ * Defined in nxffs_bgpack.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+int nxffs_bgsync(FAR struct nxffs_volume_s *volume);
+int nxffs_bgrdsync(FAR struct nxffs_volume_s *volume, FAR const char *name);
+int nxffs_bgwrsync(FAR struct nxffs_volume_s *volume, off_t block);
+#else
+#  define nxffs_bgsync(v)     (OK)
+#  define nxffs_bgrdsync(v,n) (OK)
+#  define nxffs_bgwrsync(v,b) (OK)
+#endif
+
+/****************************************************************************
+ * Name: nxffs_bgnextentry and nxffs_bgmoving
+ *
+ * Description:
+ *   Enumerate inodes between the steps of a background pack.
+ *
+ *   nxffs_bgnextentry() - Like nxffs_nextentry(), but stale inode headers
+ *                         left behind by the packing operation are skipped.
+ *   nxffs_bgmoving()    - Return the name of the inode that is being moved
+ *                         if its old inode header lies at or after
+ *                         'offset'; its old position is returned in
+ *                         'hoffset'.  NULL is returned otherwise.
+ *
+ * Input Parameters:
+ *   volume  - Describes the NXFFS volume.
+ *   offset  - The FLASH memory offset to begin searching.
+ *   entry   - The location to return the inode description.
+ *   hoffset - The location to return the old position of the inode.
+ *
+ * Defined in nxffs_bgpack.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+int nxffs_bgnextentry(FAR struct nxffs_volume_s *volume, off_t offset,
+                      FAR struct nxffs_entry_s *entry);
+FAR const char *nxffs_bgmoving(FAR struct nxffs_volume_s *volume,
+                               off_t offset, FAR off_t *hoffset);
+#else
+#  define nxffs_bgnextentry(v,o,e) nxffs_nextentry(v,o,e)
+#endif
+
 /****************************************************************************
  * Standard mountpoint operation methods
  *
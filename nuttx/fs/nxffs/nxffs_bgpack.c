@@ -0,0 +1,543 @@
+/****************************************************************************
+ * fs/nxffs/nxffs_bgpack.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+
+#include "nxffs.h"
+
+#ifdef CONFIG_NXFFS_BGPACK
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void nxffs_bgworker(FAR void *arg);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_bgneeded
+ *
+ * Description:
+ *   Return true if a background pack is in progress or if one should be
+ *   started:  Some inodes have been deleted since the volume was last
+ *   packed and the free space at the end of FLASH has fallen below
+ *   CONFIG_NXFFS_BGPACK_THRESHOLD percent of the volume.
+ *
+ ****************************************************************************/
+
+static bool nxffs_bgneeded(FAR struct nxffs_volume_s *volume)
+{
+  off_t total;
+  off_t avail;
+
+  if (volume->bgactive)
+    {
+      return true;
+    }
+
+  if (!volume->bgreclaim)
+    {
+      return false;
+    }
+
+  total = volume->nblocks * volume->geo.blocksize;
+  avail = total > volume->froffset ? total - volume->froffset : 0;
+  return avail < (total / 100) * CONFIG_NXFFS_BGPACK_THRESHOLD;
+}
+
+/****************************************************************************
+ * Name: nxffs_bgqueue
+ *
+ * Description:
+ *   (Re-)queue the background packer to run after 'msec' milliseconds.
+ *   Any pending work is cancelled first so that the work structure is
+ *   never queued twice.
+ *
+ ****************************************************************************/
+
+static void nxffs_bgqueue(FAR struct nxffs_volume_s *volume, uint32_t msec)
+{
+  (void)work_cancel(LPWORK, &volume->bgwork);
+  (void)work_queue(LPWORK, &volume->bgwork, nxffs_bgworker,
+                   (FAR void *)volume, MSEC2TICK(msec));
+}
+
+/****************************************************************************
+ * Name: nxffs_bgflush
+ *
+ * Description:
+ *   The packing logic can only move the data of an open writer if the
+ *   writer has no partially written data block.  Write the header of such
+ *   a data block now; the writer will simply continue in a new data block.
+ *
+ ****************************************************************************/
+
+static int nxffs_bgflush(FAR struct nxffs_volume_s *volume)
+{
+  FAR struct nxffs_wrfile_s *wrfile;
+  int ret = OK;
+
+  wrfile = nxffs_findwriter(volume);
+  if (wrfile && wrfile->doffset > 0)
+    {
+      if (wrfile->datlen > 0)
+        {
+          /* The partial data block has already been written to FLASH.
+           * Just add the data block header.
+           */
+
+          ret = nxffs_wrblkhdr(volume, wrfile);
+        }
+      else
+        {
+          /* Nothing has been written to the data block; just forget it */
+
+          wrfile->doffset = 0;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxffs_bgstep
+ *
+ * Description:
+ *   Perform one single erase block step of the background pack on behalf
+ *   of a file system operation that cannot proceed until the step is done.
+ *
+ ****************************************************************************/
+
+static int nxffs_bgstep(FAR struct nxffs_volume_s *volume)
+{
+  uint32_t start = clock_systimer();
+  uint32_t elapsed;
+  int ret;
+
+  ret = nxffs_bgflush(volume);
+  if (ret == OK)
+    {
+      ret = nxffs_packstep(volume, 1);
+    }
+
+  /* The caller was stalled for the duration of the step */
+
+  elapsed = (clock_systimer() - start) * MSEC_PER_TICK;
+  if (elapsed > volume->bgstats.ps_maxstall)
+    {
+      volume->bgstats.ps_maxstall = elapsed;
+    }
+
+  volume->bgstats.ps_fgsteps++;
+  return ret == -EINPROGRESS ? OK : ret;
+}
+
+/****************************************************************************
+ * Name: nxffs_bgwindow
+ *
+ * Description:
+ *   Return the range of FLASH offsets that holds stale inode headers
+ *   between the steps of a background pack.  While inodes are being
+ *   packed, these are the old copies of inodes that have already been
+ *   moved plus the old copy of the inode that is being moved.  After the
+ *   last inode has been packed, everything that has not been packed yet
+ *   is stale.  Returns false if there is no such range.
+ *
+ ****************************************************************************/
+
+static bool nxffs_bgwindow(FAR struct nxffs_volume_s *volume,
+                           FAR off_t *start, FAR off_t *end)
+{
+  FAR struct nxffs_pack_s *pack = &volume->bgpack;
+  off_t esize = volume->geo.erasesize;
+
+  if (!volume->bgactive)
+    {
+      return false;
+    }
+
+  *start = pack->eblock * esize;
+  if (pack->packed)
+    {
+      *end = volume->geo.neraseblocks * esize;
+    }
+  else
+    {
+      *end = pack->src.entry.hoffset + 1;
+    }
+
+  return *end > *start;
+}
+
+/****************************************************************************
+ * Name: nxffs_bgworker
+ *
+ * Description:
+ *   Runs on the low priority work queue.  Performs one step of the
+ *   background pack and re-queues itself if more steps are needed.  Files
+ *   that are open for reading are moved along with their inodes, but
+ *   nothing is done while a file is open for writing; the background
+ *   packer will be re-scheduled when the writer is closed.
+ *
+ ****************************************************************************/
+
+static void nxffs_bgworker(FAR void *arg)
+{
+  FAR struct nxffs_volume_s *volume = (FAR struct nxffs_volume_s *)arg;
+  int ret;
+
+  /* Get exclusive access to the volume.  The wait may be interrupted by
+   * signals sent to the worker thread.
+   */
+
+  while (sem_wait(&volume->exclsem) != OK)
+    {
+      DEBUGASSERT(errno == EINTR);
+    }
+
+  if (nxffs_findwriter(volume) == NULL && nxffs_bgneeded(volume))
+    {
+      fvdbg("Packing from erase block %d\n",
+            volume->bgactive ? volume->bgpack.eblock : 0);
+
+      ret = nxffs_packstep(volume, CONFIG_NXFFS_BGPACK_BUDGET);
+      volume->bgstats.ps_bgsteps++;
+
+      if (ret == -EINPROGRESS)
+        {
+          /* Give other users of the work queue and the volume a chance
+           * before packing the next erase blocks.
+           */
+
+          nxffs_bgqueue(volume, CONFIG_NXFFS_BGPACK_INTERVAL);
+        }
+      else if (ret < 0)
+        {
+          fdbg("ERROR: Background pack failed: %d\n", -ret);
+        }
+    }
+
+  sem_post(&volume->exclsem);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_bgschedule
+ *
+ * Description:
+ *   Called with the volume locked after operations that may leave
+ *   reclaimable FLASH behind (closing a file or removing an inode).  If no
+ *   file is open for writing and packing is worthwhile, the background
+ *   packer is (re-)scheduled to run after CONFIG_NXFFS_BGPACK_DELAY
+ *   milliseconds.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxffs_bgschedule(FAR struct nxffs_volume_s *volume)
+{
+  if (nxffs_findwriter(volume) == NULL && nxffs_bgneeded(volume))
+    {
+      nxffs_bgqueue(volume, CONFIG_NXFFS_BGPACK_DELAY);
+    }
+}
+
+/****************************************************************************
+ * Name: nxffs_bgsync
+ *
+ * Description:
+ *   Called with the volume locked.  If a background packing operation was
+ *   interrupted, it is completed now.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume.
+ *
+ * Returned Value:
+ *   Zero on success; Otherwise, a negated errno value is returned to
+ *   indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+int nxffs_bgsync(FAR struct nxffs_volume_s *volume)
+{
+  int ret;
+
+  if (volume->bgactive)
+    {
+      fvdbg("Finishing background pack at erase block %d\n",
+            volume->bgpack.eblock);
+
+      ret = nxffs_bgflush(volume);
+      if (ret == OK)
+        {
+          ret = nxffs_packstep(volume, volume->geo.neraseblocks);
+        }
+
+      return ret;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxffs_bgrdsync
+ *
+ * Description:
+ *   Called with the volume locked before an inode is accessed by name.
+ *   Between the steps of a background pack, all inodes can be accessed
+ *   except for the one inode that is being moved:  Some of its old data
+ *   blocks may already have been overwritten and its new inode header has
+ *   not yet been written.  If 'name' refers to that inode, the background
+ *   pack is stepped until the inode has been moved.  That costs at most
+ *   one erase block more than the size of the inode.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume.
+ *   name   - The name of the inode to be accessed.
+ *
+ * Returned Value:
+ *   Zero on success; Otherwise, a negated errno value is returned to
+ *   indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+int nxffs_bgrdsync(FAR struct nxffs_volume_s *volume, FAR const char *name)
+{
+  FAR struct nxffs_pack_s *pack = &volume->bgpack;
+  int ret;
+
+  while (volume->bgactive && !pack->packed && pack->dest.entry.name &&
+         strcmp(name, pack->dest.entry.name) == 0)
+    {
+      fvdbg("Moving %s at erase block %d\n", name, pack->eblock);
+
+      ret = nxffs_bgstep(volume);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxffs_bgwrsync
+ *
+ * Description:
+ *   Called with the volume locked before a writer uses the FLASH 'block'.
+ *   After the last inode has been packed, the free FLASH region begins
+ *   behind the background packer, but erase blocks that have not yet been
+ *   packed still hold the stale data that was there before.  The
+ *   background pack is stepped until the erase block containing 'block'
+ *   has been packed.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume.
+ *   block  - The FLASH block to be written.
+ *
+ * Returned Value:
+ *   Zero on success; Otherwise, a negated errno value is returned to
+ *   indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+int nxffs_bgwrsync(FAR struct nxffs_volume_s *volume, off_t block)
+{
+  FAR struct nxffs_pack_s *pack = &volume->bgpack;
+  off_t ioblock = volume->ioblock;
+  uint16_t iooffset = volume->iooffset;
+  int ret = OK;
+
+  while (volume->bgactive && pack->packed &&
+         block / volume->blkper >= pack->eblock)
+    {
+      fvdbg("Packing erase block %d for block %d\n", pack->eblock, block);
+
+      ret = nxffs_bgstep(volume);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  /* Restore the caller's I/O position */
+
+  volume->ioblock  = ioblock;
+  volume->iooffset = iooffset;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxffs_bgnextentry
+ *
+ * Description:
+ *   Like nxffs_nextentry(), but the stale inode headers that are left on
+ *   FLASH between the steps of a background pack are skipped.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume.
+ *   offset - The FLASH memory offset to begin searching.
+ *   entry  - A pointer to memory provided by the caller in which to return
+ *     the inode description.
+ *
+ * Returned Value:
+ *   Zero is returned on success. Otherwise, a negated errno is returned
+ *   that indicates the nature of the failure.
+ *
+ ****************************************************************************/
+
+int nxffs_bgnextentry(FAR struct nxffs_volume_s *volume, off_t offset,
+                      FAR struct nxffs_entry_s *entry)
+{
+  off_t start;
+  off_t end;
+  int ret;
+
+  for (;;)
+    {
+      ret = nxffs_nextentry(volume, offset, entry);
+      if (ret < 0 || !nxffs_bgwindow(volume, &start, &end) ||
+          entry->hoffset < start || entry->hoffset >= end)
+        {
+          return ret;
+        }
+
+      /* Skip over the stale inode headers */
+
+      nxffs_freeentry(entry);
+      offset = end;
+    }
+}
+
+/****************************************************************************
+ * Name: nxffs_bgmoving
+ *
+ * Description:
+ *   Return the name of the inode that is being moved by a background pack
+ *   if its old inode header lies at or after 'offset'.  That inode has no
+ *   valid inode header on FLASH and so cannot be found by
+ *   nxffs_bgnextentry().  Its old position is returned in 'hoffset'.
+ *
+ * Input Parameters:
+ *   volume  - Describes the NXFFS volume.
+ *   offset  - The FLASH memory offset to begin searching.
+ *   hoffset - The location to return the old position of the inode.
+ *
+ * Returned Value:
+ *   The name of the inode being moved or NULL if there is no such inode.
+ *
+ ****************************************************************************/
+
+FAR const char *nxffs_bgmoving(FAR struct nxffs_volume_s *volume,
+                               off_t offset, FAR off_t *hoffset)
+{
+  FAR struct nxffs_pack_s *pack = &volume->bgpack;
+
+  if (volume->bgactive && !pack->packed && pack->dest.entry.name &&
+      pack->src.entry.hoffset >= offset)
+    {
+      *hoffset = pack->src.entry.hoffset;
+      return pack->dest.entry.name;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: nxffs_getpackstats
+ *
+ * Description:
+ *   Return the packing statistics of the NXFFS volume.
+ *
+ * Input Parameters:
+ *   stats - The location to return the statistics.
+ *
+ * Returned Value:
+ *   Zero is returned on success.  Otherwise, a negated errno value is
+ *   returned to indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+int nxffs_getpackstats(FAR struct nxffs_packstats_s *stats)
+{
+  FAR struct nxffs_volume_s *volume = &g_volume;
+  int ret;
+
+  DEBUGASSERT(stats != NULL);
+
+  /* Has the volume been initialized? */
+
+  if (volume->cache == NULL)
+    {
+      return -ENODEV;
+    }
+
+  ret = sem_wait(&volume->exclsem);
+  if (ret != OK)
+    {
+      return -errno;
+    }
+
+  memcpy(stats, &volume->bgstats, sizeof(struct nxffs_packstats_s));
+  sem_post(&volume->exclsem);
+  return OK;
+}
+
+#endif /* CONFIG_NXFFS_BGPACK */
@@ -216,6 +216,14 @@ int nxffs_getc(FAR struct nxffs_volume_s *volume, uint16_t reserve)
 
   do
     {
+      /* The caller may have seeked to the very end of FLASH */
+
+      if (volume->ioblock >= volume->nblocks)
+        {
+          fvdbg("End of FLASH encountered\n");
+          return -ENOSPC;
+        }
+
       /* Check if we have the reserve amount at the end of the current block */
 
       if (volume->iooffset + reserve > volume->geo.blocksize)
@@ -132,6 +132,10 @@ int nxffs_readdir(FAR struct inode *mountpt, FAR struct fs_dirent_s *dir)
 {
   FAR struct nxffs_volume_s *volume;
   FAR struct nxffs_entry_s entry;
+#ifdef CONFIG_NXFFS_BGPACK
+  FAR const char *name;
+  off_t hoffset;
+#endif
   off_t offset;
   int ret;
 
@@ -151,7 +155,32 @@ int nxffs_readdir(FAR struct inode *mountpt, FAR struct fs_dirent_s *dir)
   /* Read the next inode header from the offset */
 
   offset = dir->u.nxffs.nx_offset;
-  ret = nxffs_nextentry(volume, offset, &entry);
+  ret = nxffs_bgnextentry(volume, offset, &entry);
+
+#ifdef CONFIG_NXFFS_BGPACK
+  /* The inode that is being moved by an interrupted background pack has no
+   * valid inode header on FLASH.  Report it at its old position.
+   */
+
+  name = nxffs_bgmoving(volume, offset, &hoffset);
+  if (name && (ret == -ENOENT || (ret == OK && hoffset < entry.hoffset)))
+    {
+      fvdbg("Offset %d: \"%s\" (moving)\n", hoffset, name);
+      dir->fd_dir.d_type = DTYPE_FILE;
+      strncpy(dir->fd_dir.d_name, name, NAME_MAX+1);
+
+      /* Continue with the inode that follows it. */
+
+      if (ret == OK)
+        {
+          nxffs_freeentry(&entry);
+        }
+
+      dir->u.nxffs.nx_offset = hoffset + 1;
+      ret = OK;
+    }
+  else
+#endif
 
   /* If the read was successful, then handle the reported inode.  Note
    * that when the last inode has been reported, the value -ENOENT will
@@ -0,0 +1,278 @@
+/****************************************************************************
+ * fs/nxffs/nxffs_index.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/nxffs.h>
+
+#include "nxffs.h"
+
+#ifdef CONFIG_NXFFS_INODE_INDEX
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NXFFS_INDEX_MASK (CONFIG_NXFFS_INDEX_NBUCKETS - 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_idxhash
+ *
+ * Description:
+ *   Return the hash bucket index for an inode name.
+ *
+ ****************************************************************************/
+
+static unsigned int nxffs_idxhash(FAR const char *name)
+{
+  unsigned int hash = 5381;
+
+  while (*name)
+    {
+      hash = ((hash << 5) + hash) ^ (unsigned char)*name++;
+    }
+
+  return hash & NXFFS_INDEX_MASK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_idxadd
+ *
+ * Description:
+ *   Add an inode to the in-memory inode index or, if an inode of the same
+ *   name is already in the index, update the FLASH offset of its inode
+ *   header.  If memory cannot be allocated for the new entry, the index is
+ *   marked incomplete and inode look-ups will fall back to scanning FLASH.
+ *
+ * Input Parameters:
+ *   volume  - Describes the NXFFS volume.
+ *   name    - The name of the inode.
+ *   hoffset - FLASH offset to the inode header.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxffs_idxadd(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                  off_t hoffset)
+{
+  FAR struct nxffs_idxentry_s *idx;
+  unsigned int hash = nxffs_idxhash(name);
+  size_t namlen;
+
+  /* Is there already an entry with this name?  That will be the case when
+   * an inode is moved by the packing logic.
+   */
+
+  for (idx = volume->index[hash]; idx; idx = idx->flink)
+    {
+      if (strcmp(idx->name, name) == 0)
+        {
+          idx->hoffset = hoffset;
+          return;
+        }
+    }
+
+  /* No.. allocate a new entry, including space for the name */
+
+  namlen = strlen(name);
+  idx = (FAR struct nxffs_idxentry_s *)
+    kmalloc(sizeof(struct nxffs_idxentry_s) + namlen);
+
+  if (!idx)
+    {
+      /* Without this entry, the absence of a name from the index no
+       * longer means that the inode does not exist.
+       */
+
+      fdbg("ERROR: Failed to allocate index entry\n");
+      volume->idxvalid = false;
+      return;
+    }
+
+  idx->hoffset = hoffset;
+  memcpy(idx->name, name, namlen + 1);
+
+  idx->flink          = volume->index[hash];
+  volume->index[hash] = idx;
+}
+
+/****************************************************************************
+ * Name: nxffs_idxremove
+ *
+ * Description:
+ *   Remove an inode from the in-memory inode index.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume.
+ *   name   - The name of the inode.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxffs_idxremove(FAR struct nxffs_volume_s *volume, FAR const char *name)
+{
+  FAR struct nxffs_idxentry_s *prev;
+  FAR struct nxffs_idxentry_s *idx;
+  unsigned int hash = nxffs_idxhash(name);
+
+  for (prev = NULL, idx = volume->index[hash];
+       idx;
+       prev = idx, idx = idx->flink)
+    {
+      if (strcmp(idx->name, name) == 0)
+        {
+          if (prev)
+            {
+              prev->flink = idx->flink;
+            }
+          else
+            {
+              volume->index[hash] = idx->flink;
+            }
+
+          kfree(idx);
+          return;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxffs_idxreset
+ *
+ * Description:
+ *   Discard all entries in the in-memory inode index.  After this call the
+ *   index is empty and complete, which describes a freshly formatted
+ *   volume.  Callers that are about to re-scan FLASH add each inode that
+ *   they find with nxffs_idxadd().
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxffs_idxreset(FAR struct nxffs_volume_s *volume)
+{
+  FAR struct nxffs_idxentry_s *next;
+  FAR struct nxffs_idxentry_s *idx;
+  int i;
+
+  for (i = 0; i < CONFIG_NXFFS_INDEX_NBUCKETS; i++)
+    {
+      for (idx = volume->index[i]; idx; idx = next)
+        {
+          next = idx->flink;
+          kfree(idx);
+        }
+
+      volume->index[i] = NULL;
+    }
+
+  volume->idxvalid = true;
+}
+
+/****************************************************************************
+ * Name: nxffs_idxfind
+ *
+ * Description:
+ *   Look up the FLASH offset of an inode header in the in-memory inode
+ *   index.
+ *
+ * Input Parameters:
+ *   volume  - Describes the NXFFS volume.
+ *   name    - The name of the inode to find.
+ *   hoffset - The location to return the FLASH offset of the inode header.
+ *
+ * Returned Value:
+ *   OK     - The inode is in the index and its offset was returned.
+ *   ENOENT - The inode does not exist.
+ *   ENOSYS - The inode is not in the index, but the index is incomplete so
+ *            the FLASH must be searched.
+ *
+ *   Errors are returned as negated errno values.
+ *
+ ****************************************************************************/
+
+int nxffs_idxfind(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                  FAR off_t *hoffset)
+{
+  FAR struct nxffs_idxentry_s *idx;
+
+  for (idx = volume->index[nxffs_idxhash(name)]; idx; idx = idx->flink)
+    {
+      if (strcmp(idx->name, name) == 0)
+        {
+          *hoffset = idx->hoffset;
+          return OK;
+        }
+    }
+
+  return volume->idxvalid ? -ENOENT : -ENOSYS;
+}
+
+#endif /* CONFIG_NXFFS_INODE_INDEX */
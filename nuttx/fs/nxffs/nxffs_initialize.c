@@ -367,6 +367,12 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
       return ret;
     }
 
+  /* All inodes are about to be re-discovered.  Start with an empty inode
+   * index and add each inode as it is found.
+   */
+
+  nxffs_idxreset(volume);
+
   /* Then find the first valid inode in or beyond the first valid block */
 
   offset = block * volume->geo.blocksize;
@@ -400,7 +406,11 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
       volume->inoffset = entry.hoffset;
       fvdbg("First inode at offset %d\n", volume->inoffset);
 
-      /* Discard this entry and set the next offset. */
+      /* Add the inode to the index.  Discard this entry and set the next
+       * offset.
+       */
+
+      nxffs_idxadd(volume, entry.name, entry.hoffset);
 
       offset = nxffs_inodeend(volume, &entry);
       nxffs_freeentry(&entry);
@@ -412,12 +422,27 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
     {
       while ((ret = nxffs_nextentry(volume, offset, &entry)) == OK)
         {
-          /* Discard the entry and guess the next offset. */
+          /* Add the inode to the index.  Discard the entry and guess the
+           * next offset.
+           */
 
+          nxffs_idxadd(volume, entry.name, entry.hoffset);
           offset = nxffs_inodeend(volume, &entry);
           nxffs_freeentry(&entry);
         }
 
+#ifdef CONFIG_NXFFS_INODE_INDEX
+      /* -ENOENT means that the search reached the end of the inodes.  Any
+       * other failure means that there may be inodes that are not in the
+       * index.
+       */
+
+      if (ret != -ENOENT)
+        {
+          volume->idxvalid = false;
+        }
+#endif
+
       fvdbg("Last inode before offset %d\n", offset);
     }
 
@@ -555,6 +580,26 @@ int nxffs_unbind(FAR void *handle, FAR struct inode **blkdriver)
 #ifndef CONFIG_NXFFS_PREALLOCATED
 #  error "No design to support dynamic allocation of volumes"
 #else
-  return g_volume.ofiles ? -EBUSY : OK;
+  int ret = OK;
+
+  if (g_volume.ofiles)
+    {
+      return -EBUSY;
+    }
+
+#ifdef CONFIG_NXFFS_BGPACK
+  /* Stop the background packer and finish any interrupted pack */
+
+  while (sem_wait(&g_volume.exclsem) != OK)
+    {
+      DEBUGASSERT(errno == EINTR);
+    }
+
+  (void)work_cancel(LPWORK, &g_volume.bgwork);
+  ret = nxffs_bgsync(&g_volume);
+  sem_post(&g_volume.exclsem);
+#endif
+
+  return ret;
 #endif
 }
@@ -72,7 +72,9 @@
  * Name: nxffs_rdentry
  *
  * Description:
- *   Read the inode entry at this offset.  Called only from nxffs_nextentry().
+ *   Read the inode entry at this offset.  Called from nxffs_nextentry()
+ *   and, to verify entries in the inode index, from nxffs_findinode().  The
+ *   block containing the inode header must already be in the cache.
  *
  * Input Parameters:
  *   volume - Describes the current volume.
@@ -281,7 +283,14 @@ int nxffs_nextentry(FAR struct nxffs_volume_s *volume, off_t offset,
       /* Read the next character */
 
       ch = nxffs_getc(volume, SIZEOF_NXFFS_INODE_HDR - nmagic);
-      if (ch < 0)
+      if (ch == -ENOSPC)
+        {
+          /* The end of FLASH was reached without finding an entry */
+
+          fvdbg("No entry found\n");
+          return -ENOENT;
+        }
+      else if (ch < 0)
         {
           fdbg("ERROR: nxffs_getc failed: %d\n", -ch);
           return ch;
@@ -390,6 +399,46 @@ int nxffs_findinode(FAR struct nxffs_volume_s *volume, FAR const char *name,
   off_t offset;
   int ret;
 
+#ifdef CONFIG_NXFFS_INODE_INDEX
+  /* Check the in-memory inode index first.  If the index is complete, then
+   * it can tell us that the inode does not exist without searching FLASH.
+   */
+
+  ret = nxffs_idxfind(volume, name, &offset);
+  if (ret == -ENOENT)
+    {
+      fvdbg("No inode found in index\n");
+      return ret;
+    }
+  else if (ret == OK)
+    {
+      /* Read and verify the inode header at the indexed offset */
+
+      nxffs_ioseek(volume, offset);
+      ret = nxffs_rdcache(volume, volume->ioblock);
+      if (ret == OK)
+        {
+          ret = nxffs_rdentry(volume, offset, entry);
+          if (ret == OK)
+            {
+              if (strcmp(name, entry->name) == 0)
+                {
+                  return OK;
+                }
+
+              nxffs_freeentry(entry);
+            }
+        }
+
+      /* The index entry is stale.  That should not happen, but we can
+       * recover by discarding it and searching FLASH.
+       */
+
+      fdbg("WARNING: Stale index entry for %s at %d\n", name, offset);
+      nxffs_idxremove(volume, name);
+    }
+#endif
+
   /* Start with the first valid inode that was discovered when the volume
    * was created (or modified after the last file system re-packing).
    */
@@ -405,7 +454,7 @@ int nxffs_findinode(FAR struct nxffs_volume_s *volume, FAR const char *name,
    {
       /* Get the next, valid NXFFS inode entry */
 
-      ret = nxffs_nextentry(volume, offset, entry);
+      ret = nxffs_bgnextentry(volume, offset, entry);
       if (ret < 0)
         {
           fvdbg("No inode found: %d\n", -ret);
@@ -416,8 +465,11 @@ int nxffs_findinode(FAR struct nxffs_volume_s *volume, FAR const char *name,
 
       else if (strcmp(name, entry->name) == 0)
         {
-          /* Yes, return success with the entry data in 'entry' */
+          /* Yes, return success with the entry data in 'entry'.  Make sure
+           * that the inode index knows where it is next time.
+           */
 
+          nxffs_idxadd(volume, name, entry->hoffset);
           return OK;
         }
 
@@ -421,6 +421,16 @@ static inline int nxffs_wropen(FAR struct nxffs_volume_s *volume,
       goto errout_with_wrsem;
     }
 
+  /* Finish moving the inode if an interrupted background pack is moving
+   * it.
+   */
+
+  ret = nxffs_bgrdsync(volume, name);
+  if (ret < 0)
+    {
+      goto errout_with_exclsem;
+    }
+
   /* Check if the file exists */
 
   ret = nxffs_findinode(volume, name, &entry);
@@ -715,6 +725,16 @@ static inline int nxffs_rdopen(FAR struct nxffs_volume_s *volume,
       goto errout;
     }
 
+  /* Finish moving the inode if an interrupted background pack is moving
+   * it.
+   */
+
+  ret = nxffs_bgrdsync(volume, name);
+  if (ret < 0)
+    {
+      goto errout_with_exclsem;
+    }
+
   /* Check if the file has already been opened (for reading) */
 
   ofile = nxffs_findofile(volume, name);
@@ -1168,7 +1188,17 @@ int nxffs_close(FAR struct file *filep)
     {
       /* Decrementing the reference count would take it zero.
        *
-       * Remove the entry from the open file list.  We do this early
+       * A writer may replace an older version of the file.  If that version
+       * is being moved by an interrupted background pack, finish moving it
+       * now while the packing logic can still find the writer.
+       */
+
+      if ((ofile->oflags & O_WROK) != 0)
+        {
+          ret = nxffs_bgrdsync(volume, ofile->entry.name);
+        }
+
+      /* Remove the entry from the open file list.  We do this early
        * to avoid some chick-and-egg problems with file truncation.
        */
 
@@ -1178,12 +1208,20 @@ int nxffs_close(FAR struct file *filep)
 
       if ((ofile->oflags & O_WROK) != 0)
         {
-          ret = nxffs_wrclose(volume, (FAR struct nxffs_wrfile_s *)ofile);
+          int wrret = nxffs_wrclose(volume, (FAR struct nxffs_wrfile_s *)ofile);
+          if (ret == OK)
+            {
+              ret = wrret;
+            }
         }
 
       /* Release all resouces held by the open file */
 
       nxffs_freeofile(volume, ofile);
+
+      /* If that was the writer, the volume may be packed when it is idle */
+
+      nxffs_bgschedule(volume);
     }
   else
     {
@@ -1280,11 +1318,18 @@ int nxffs_wrinode(FAR struct nxffs_volume_s *volume,
       fdbg("ERROR: Failed to write inode header block %d: %d\n",
            volume->ioblock, -ret);
     }
+  else
+    {
+      /* Remember where the inode header is in the inode index */
 
-  /* The volume is now available for other writers */
+      nxffs_idxadd(volume, entry->name, entry->hoffset);
+    }
+
+  /* The write semaphore is released by nxffs_wrclose().  This function is
+   * also called by the packing logic which does not hold it.
+   */
 
 errout:
-  sem_post(&volume->wrsem);
   return ret;
 }
 
@@ -1313,14 +1358,26 @@ int nxffs_updateinode(FAR struct nxffs_volume_s *volume,
   /* Find the open inode structure matching this name */
 
   ofile = nxffs_findofile(volume, entry->name);
-  if (ofile)
+  if (ofile && (ofile->oflags & O_WROK) == 0)
     {
-      /* Yes.. the file is open.  Update the FLASH offsets to inode headers */
+      /* Yes.. the file is open for reading.  Update the FLASH offsets to
+       * inode headers.  An open writer of the same name is creating a new
+       * inode; the inode being moved is the old version that it replaces.
+       */
 
       ofile->entry.hoffset = entry->hoffset;
       ofile->entry.noffset = entry->noffset;
       ofile->entry.doffset = entry->doffset;
+
+      /* The data blocks have moved too so the read cursor is no longer
+       * valid.
+       */
+
+      ofile->rdoffset      = 0;
     }
 
+  /* Update the location of the inode in the inode index */
+
+  nxffs_idxadd(volume, entry->name, entry->hoffset);
   return OK;
 }
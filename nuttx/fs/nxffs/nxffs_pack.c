@@ -48,6 +48,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
 
 #include "nxffs.h"
 
@@ -58,35 +59,6 @@
 /****************************************************************************
  * Public Types
  ****************************************************************************/
-/* This structure supports access to one inode data stream */
-
-struct nxffs_packstream_s
-{
-  struct nxffs_entry_s entry;      /* Describes the inode header */
-  off_t                fpos;       /* Current file position */
-  off_t                blkoffset;  /* Offset to the current data block */
-  uint16_t             blklen;     /* Size of this block */
-  uint16_t             blkpos;     /* Position in block corresponding to fpos */
-};
-
-/* The structure supports the overall packing operation */
-
-struct nxffs_pack_s
-{
-  /* These describe the source and destination streams */
-
-  struct nxffs_packstream_s src;
-  struct nxffs_packstream_s dest;
-
-  /* These describe the state of the current contents of the (destination)
-   * volume->pack buffer.
-   */
-
-  FAR uint8_t         *iobuffer;   /* I/O block start position */
-  off_t                ioblock;    /* I/O block number */
-  off_t                block0;     /* First I/O block number in the erase block */
-  uint16_t             iooffset;   /* I/O block offset */
-};
 
 /****************************************************************************
  * Public Variables
@@ -317,16 +289,24 @@ static inline int nxffs_startpos(FAR struct nxffs_volume_s *volume,
           return OK;
         }
 
-      /* Free the allocated memory in the entry */
-
-      nxffs_freeentry(&pack->src.entry);
-
       /* Update the offset to the first byte at the end of the last data
-       * block.
+       * block.  A zero length file will have no data blocks; in that case
+       * the inode ends with the inode name.
        */
 
       nbytes = 0;
-      offset = pack->src.entry.doffset;
+      if (pack->src.entry.doffset > 0)
+        {
+          offset = pack->src.entry.doffset;
+        }
+      else
+        {
+          offset = nxffs_inodeend(volume, &pack->src.entry);
+        }
+
+      /* Free the allocated memory in the entry */
+
+      nxffs_freeentry(&pack->src.entry);
 
       while (nbytes < pack->src.entry.datlen)
         {
@@ -347,14 +327,22 @@ static inline int nxffs_startpos(FAR struct nxffs_volume_s *volume,
           offset  = blkentry.hoffset + SIZEOF_NXFFS_DATA_HDR + blkentry.datlen;
         }
 
-      /* Make sure there is space at this location for an inode header */
+      /* Make sure there is space at this location for an inode header.  If
+       * the data ended exactly at the end of an I/O block, then this is the
+       * position of the next block header; that is not valid either.
+       */
 
       nxffs_ioseek(volume, offset);
-      if (volume->iooffset + SIZEOF_NXFFS_INODE_HDR > volume->geo.blocksize)
+      if (volume->iooffset == 0 ||
+          volume->iooffset + SIZEOF_NXFFS_INODE_HDR > volume->geo.blocksize)
         {
           /* No.. not enough space here. Find the next valid block */
 
-          volume->ioblock++;
+          if (volume->iooffset > 0)
+            {
+              volume->ioblock++;
+            }
+
           ret = nxffs_validblock(volume, &volume->ioblock);
           if (ret < 0)
             {
@@ -666,6 +654,14 @@ static int nxffs_wrinodehdr(FAR struct nxffs_volume_s *volume,
        */
 
       ret = nxffs_wrinode(volume, &pack->dest.entry);
+      if (ret == OK)
+        {
+          /* If any open files reference this inode, then update the open
+           * file state.
+           */
+
+          ret = nxffs_updateinode(volume, &pack->dest.entry);
+        }
     }
   else
     {
@@ -952,12 +948,26 @@ static inline int nxffs_packblock(FAR struct nxffs_volume_s *volume,
            * headers.
            */
 
+          /* The next valid source inode follows the last source data
+           * block.  A zero-length file has no data block; the search then
+           * resumes just after its name.
+           */
+
+          if (pack->src.blkoffset > 0)
+            {
+              offset = pack->src.blkoffset + pack->src.blklen;
+            }
+          else
+            {
+              offset = pack->src.entry.noffset +
+                       strlen(pack->dest.entry.name);
+            }
+
           nxffs_wrdathdr(volume, pack);
           nxffs_wrinodehdr(volume, pack);
 
           /* Find the next valid source inode */
 
-          offset = pack->src.blkoffset + pack->src.blklen;
           memset(&pack->src, 0, sizeof(struct nxffs_packstream_s));
 
           ret = nxffs_nextentry(volume, offset, &pack->src.entry);
@@ -1247,19 +1257,18 @@ static inline int nxffs_packwriter(FAR struct nxffs_volume_s *volume,
   return -ENOSYS;
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
 
 /****************************************************************************
- * Name: nxffs_pack
+ * Name: nxffs_packsetup
  *
  * Description:
- *   Pack and re-write the filesystem in order to free up memory at the end
- *   of FLASH.
+ *   Find the position in FLASH where packing should begin and initialize
+ *   the packing state.  If there is nothing to be packed, the packing state
+ *   is initialized so that no erase blocks remain to be processed.
  *
  * Input Parameters:
  *   volume - The volume to be packed.
+ *   pack   - The volume packing state structure.
  *
  * Returned Values:
  *   Zero on success; Otherwise, a negated errno value is returned to
@@ -1267,23 +1276,24 @@ static inline int nxffs_packwriter(FAR struct nxffs_volume_s *volume,
  *
  ****************************************************************************/
 
-int nxffs_pack(FAR struct nxffs_volume_s *volume)
+static int nxffs_packsetup(FAR struct nxffs_volume_s *volume,
+                           FAR struct nxffs_pack_s *pack)
 {
-  struct nxffs_pack_s pack;
-  FAR struct nxffs_wrfile_s *wrfile;
   off_t iooffset;
-  off_t eblock;
   off_t block;
-  bool packed;
-  int i;
-  int ret = OK;
+  int ret;
 
   /* Get the offset to the first valid inode entry */
 
-  wrfile = NULL;
-  packed = false;
+  iooffset = nxffs_mediacheck(volume, pack);
+
+  /* Until we know better, assume that there is nothing to pack */
+
+  pack->eblock = volume->geo.neraseblocks;
+#ifdef CONFIG_NXFFS_BGPACK
+  pack->froffset = volume->froffset;
+#endif
 
-  iooffset = nxffs_mediacheck(volume, &pack);
   if (iooffset == 0)
     {
       /* Offset zero is only returned if no valid blocks were found on the
@@ -1295,16 +1305,16 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
 
       /* Is there a writer? */
 
-      wrfile = nxffs_setupwriter(volume, &pack);
-      if (wrfile)
+      pack->wrfile = nxffs_setupwriter(volume, pack);
+      if (pack->wrfile)
         {
           /* If there is a write, just set ioffset to the offset of data in
            * first block. Setting 'packed' to true will supress normal inode
            * packing operation.  Then we can start compacting the FLASH.
            */
 
-          iooffset = SIZEOF_NXFFS_BLOCK_HDR;
-          packed   = true;
+          iooffset     = SIZEOF_NXFFS_BLOCK_HDR;
+          pack->packed = true;
           goto start_pack;
         }
       else
@@ -1342,7 +1352,7 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
    * begin the packing operation.
    */
 
-  ret = nxffs_startpos(volume, &pack, &iooffset);
+  ret = nxffs_startpos(volume, pack, &iooffset);
   if (ret < 0)
     {
       /* This is a normal situation if the volume is full */
@@ -1363,14 +1373,14 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
                 * operation.
                 */
 
-               packed = true;
+               pack->packed = true;
 
                /* Writing is performed at the end of the free FLASH region.
                 * If we are not packing files, we could still need to pack
                 * the partially written file at the end of FLASH.
                 */
 
-               wrfile = nxffs_setupwriter(volume, &pack);
+               pack->wrfile = nxffs_setupwriter(volume, pack);
              }
 
           /* Otherwise return OK.. meaning that there is nothing more we can
@@ -1397,211 +1407,444 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
 
 start_pack:
 
-  pack.ioblock     = nxffs_getblock(volume, iooffset);
-  pack.iooffset    = nxffs_getoffset(volume, iooffset, pack.ioblock);
+  pack->ioblock    = nxffs_getblock(volume, iooffset);
+  pack->iooffset   = nxffs_getoffset(volume, iooffset, pack->ioblock);
   volume->froffset = iooffset;
 
+  /* Inodes may be moved to FLASH before the first inode that was found
+   * when the volume was mounted.  Make sure that searches for inodes still
+   * start early enough to find them.
+   */
+
+  if (iooffset < volume->inoffset)
+    {
+      volume->inoffset = iooffset;
+    }
+
   /* Then pack all erase blocks starting with the erase block that contains
    * the ioblock and through the final erase block on the FLASH.
    */
 
-  for (eblock = pack.ioblock / volume->blkper;
-       eblock < volume->geo.neraseblocks;
-       eblock++)
-    {
-      /* Get the starting block number of the erase block */
+  pack->eblock = pack->ioblock / volume->blkper;
+  return OK;
+}
 
-      pack.block0 = eblock * volume->blkper;
+/****************************************************************************
+ * Name: nxffs_packeblock
+ *
+ * Description:
+ *   Pack the next erase block (pack->eblock) and write it back to FLASH.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *   pack   - The volume packing state structure.
+ *
+ * Returned Values:
+ *   Zero on success; Otherwise, a negated errno value is returned to
+ *   indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+static int nxffs_packeblock(FAR struct nxffs_volume_s *volume,
+                            FAR struct nxffs_pack_s *pack)
+{
+  off_t eblock = pack->eblock;
+  off_t block;
+  int i;
+  int ret;
+
+  /* Get the starting block number of the erase block */
+
+  pack->block0 = eblock * volume->blkper;
 
 #ifndef CONFIG_NXFFS_NAND
-      /* Read the erase block into the pack buffer.  We need to do this even
-       * if we are overwriting the entire block so that we skip over
-       * previously marked bad blocks.
-       */
+  /* Read the erase block into the pack buffer.  We need to do this even
+   * if we are overwriting the entire block so that we skip over
+   * previously marked bad blocks.
+   */
 
-      ret = MTD_BREAD(volume->mtd, pack.block0, volume->blkper, volume->pack);
+  ret = MTD_BREAD(volume->mtd, pack->block0, volume->blkper, volume->pack);
+  if (ret < 0)
+    {
+      fdbg("ERROR: Failed to read erase block %d: %d\n", eblock,-ret);
+      return ret;
+    }
+
+#else
+  /* Read the entire erase block into the pack buffer, one-block-at-a-
+   * time.  We need to do this even if we are overwriting the entire
+   * block so that (1) we skip over previously marked bad blocks, and
+   * (2) we can handle individual block read failures.
+   *
+   * For most FLASH, a read failure indicates a fatal hardware failure.
+   * But for NAND FLASH, the read failure probably indicates a block
+   * with uncorrectable bit errors.
+   */
+
+  /* Read each I/O block */
+
+  for (i = 0, block = pack->block0, pack->iobuffer = volume->pack;
+       i < volume->blkper;
+       i++, block++, pack->iobuffer += volume->geo.blocksize)
+    {
+      /* Read the next block in the erase block */
+
+      ret = MTD_BREAD(volume->mtd, block, 1, pack->iobuffer);
       if (ret < 0)
         {
-          fdbg("ERROR: Failed to read erase block %d: %d\n", eblock,-ret);
-          goto errout_with_pack;
+          /* Force a the block to be an NXFFS bad block */
+
+          fdbg("ERROR: Failed to read block %d: %d\n", block, ret);
+          nxffs_blkinit(volume, pack->iobuffer, BLOCK_STATE_BAD);
         }
+    }
+#endif
 
-#else
-      /* Read the entire erase block into the pack buffer, one-block-at-a-
-       * time.  We need to do this even if we are overwriting the entire
-       * block so that (1) we skip over previously marked bad blocks, and
-       * (2) we can handle individual block read failures.
-       *
-       * For most FLASH, a read failure indicates a fatal hardware failure.
-       * But for NAND FLASH, the read failure probably indicates a block
-       * with uncorrectable bit errors.
-       */
+  /* Now pack each I/O block */
 
-      /* Read each I/O block */
+  for (i = 0, block = pack->block0, pack->iobuffer = volume->pack;
+       i < volume->blkper;
+       i++, block++, pack->iobuffer += volume->geo.blocksize)
+    {
+      /* The first time here, the ioblock may point to an offset into
+       * the erase block.  We just need to skip over those cases.
+       */
 
-      for (i = 0, block = pack.block0, pack.iobuffer = volume->pack;
-           i < volume->blkper;
-           i++, block++, pack.iobuffer += volume->geo.blocksize)
+      if (block >= pack->ioblock)
         {
-          /* Read the next block in the erase block */
+          /* Set the I/O position.  Note on the first time we get
+           * pack->iooffset will hold the offset in the first I/O block
+           * to the first inode header.  After that, it will always
+           * refer to the first byte after the block header.
+           */
 
-          ret = MTD_BREAD(volume->mtd, block, 1, pack.iobuffer);
-          if (ret < 0)
+          pack->ioblock = block;
+
+          /* If this is not a valid block or if we have already
+           * finished packing the valid inode entries, then just fall
+           * through, reset the FLASH memory to the erase state, and
+           * write the reset values to FLASH.  (The first block that
+           * we want to process will always be valid -- we have
+           * already verified that).
+           */
+
+          if (nxffs_packvalid(pack))
             {
-              /* Force a the block to be an NXFFS bad block */
+              /* Have we finished packing inodes? */
+
+              if (!pack->packed)
+                {
+                  DEBUGASSERT(pack->wrfile == NULL);
+
+                  /* Pack inode data into this block */
+
+                  ret = nxffs_packblock(volume, pack);
+                  if (ret < 0)
+                    {
+                      /* The error -ENOSPC is a special value that simply
+                       * means that there is nothing further to be packed.
+                       */
+
+                      if (ret == -ENOSPC)
+                        {
+                          pack->packed = true;
+
+                          /* Writing is performed at the end of the free
+                           * FLASH region and this implemenation is restricted
+                           * to a single writer.  The new inode is not
+                           * written to FLASH until the writer is closed
+                           * and so will not be found by nxffs_packblock().
+                           */
+
+                          pack->wrfile = nxffs_setupwriter(volume, pack);
+                        }
+                      else
+                        {
+                          /* Otherwise, something really bad happened */
+
+                          fdbg("ERROR: Failed to pack into block %d: %d\n",
+                               block, ret);
+                          return ret;
+                        }
+                    }
+                }
+
+              /* If all of the "normal" inodes have been packed, then check if
+               * we need to pack the current, in-progress write operation.
+               */
+
+              if (pack->wrfile)
+                {
+                  DEBUGASSERT(pack->packed == true);
+
+                  /* Pack write data into this block */
+
+                  ret = nxffs_packwriter(volume, pack, pack->wrfile);
+                  if (ret < 0)
+                    {
+                      /* The error -ENOSPC is a special value that simply
+                       * means that there is nothing further to be packed.
+                       */
+
+                      if (ret == -ENOSPC)
+                        {
+                          pack->wrfile = NULL;
+                        }
+                      else
+                        {
+                          /* Otherwise, something really bad happened */
+
+                          fdbg("ERROR: Failed to pack into block %d: %d\n",
+                               block, ret);
+                          return ret;
+                        }
+                    }
+                }
+            }
+
+          /* Set any unused portion at the end of the block to the
+           * erased state.
+           */
 
-              fdbg("ERROR: Failed to read block %d: %d\n", block, ret);
-              nxffs_blkinit(volume, pack.iobuffer, BLOCK_STATE_BAD);
+          if (pack->iooffset < volume->geo.blocksize)
+            {
+              memset(&pack->iobuffer[pack->iooffset],
+                     CONFIG_NXFFS_ERASEDSTATE,
+                     volume->geo.blocksize - pack->iooffset);
             }
+
+          /* Next time through the loop, pack->iooffset will point to the
+           * first byte after the block header.
+           */
+
+          pack->iooffset = SIZEOF_NXFFS_BLOCK_HDR;
         }
+    }
+
+  /* We now have an in-memory image of how we want this erase block to
+   * appear. Now it is safe to erase the block.
+   */
+
+  ret = MTD_ERASE(volume->mtd, eblock, 1);
+  if (ret < 0)
+    {
+      fdbg("ERROR: Failed to erase block %d [%d]: %d\n",
+           eblock, pack->block0, -ret);
+      return ret;
+    }
+
+  /* Write the packed I/O block to FLASH */
+
+  ret = MTD_BWRITE(volume->mtd, pack->block0, volume->blkper, volume->pack);
+  if (ret < 0)
+    {
+      fdbg("ERROR: Failed to write erase block %d [%d]: %d\n",
+           eblock, pack->block0, -ret);
+      return ret;
+    }
+
+  pack->eblock = eblock + 1;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxffs_packend
+ *
+ * Description:
+ *   Release the resources held by the packing state and, if packing was
+ *   successful, update the packing statistics.
+ *
+ * Input Parameters:
+ *   volume - The volume that was packed.
+ *   pack   - The volume packing state structure.
+ *   result - The result of the packing operation.
+ *
+ * Returned Values:
+ *   None
+ *
+ ****************************************************************************/
+
+static void nxffs_packend(FAR struct nxffs_volume_s *volume,
+                          FAR struct nxffs_pack_s *pack, int result)
+{
+  nxffs_freeentry(&pack->src.entry);
+  nxffs_freeentry(&pack->dest.entry);
+
+#ifdef CONFIG_NXFFS_BGPACK
+  if (result >= 0)
+    {
+      /* Account for the FLASH that was returned to the free region */
+
+      if (pack->froffset > volume->froffset)
+        {
+          volume->bgstats.ps_reclaimed +=
+            (pack->froffset - volume->froffset) / volume->geo.blocksize;
+        }
+
+      volume->bgstats.ps_packs++;
+      volume->bgreclaim = false;
+    }
 #endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_pack
+ *
+ * Description:
+ *   Pack and re-write the filesystem in order to free up memory at the end
+ *   of FLASH.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *
+ * Returned Values:
+ *   Zero on success; Otherwise, a negated errno value is returned to
+ *   indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+int nxffs_pack(FAR struct nxffs_volume_s *volume)
+{
+  struct nxffs_pack_s pack;
+  int ret;
+#ifdef CONFIG_NXFFS_BGPACK
+  uint32_t start = clock_systimer();
+  uint32_t elapsed;
 
-      /* Now pack each I/O block */
+  /* If a background pack was interrupted, then finish it first.  Inodes
+   * that were deleted behind the background packer are recovered by the
+   * full packing operation that follows.
+   */
+
+  ret = nxffs_bgsync(volume);
+  if (ret >= 0)
+#endif
+    {
+      /* Set up to begin packing, then pack each erase block through the
+       * final erase block on the FLASH.
+       */
 
-      for (i = 0, block = pack.block0, pack.iobuffer = volume->pack;
-           i < volume->blkper;
-           i++, block++, pack.iobuffer += volume->geo.blocksize)
+      ret = nxffs_packsetup(volume, &pack);
+      while (ret >= 0 && pack.eblock < volume->geo.neraseblocks)
         {
-           /* The first time here, the ioblock may point to an offset into
-            * the erase block.  We just need to skip over those cases.
-            */
+          ret = nxffs_packeblock(volume, &pack);
+        }
 
-           if (block >= pack.ioblock)
-              {
-                /* Set the I/O position.  Note on the first time we get
-                 * pack.iooffset will hold the offset in the first I/O block
-                 * to the first inode header.  After that, it will always
-                 * refer to the first byte after the block header.
-                 */
-
-                pack.ioblock = block;
-
-                /* If this is not a valid block or if we have already
-                 * finished packing the valid inode entries, then just fall
-                 * through, reset the FLASH memory to the erase state, and
-                 * write the reset values to FLASH.  (The first block that
-                 * we want to process will always be valid -- we have
-                 * already verified that).
-                 */
-
-                if (nxffs_packvalid(&pack))
-                  {
-                    /* Have we finished packing inodes? */
-
-                    if (!packed)
-                      {
-                         DEBUGASSERT(wrfile == NULL);
-
-                         /* Pack inode data into this block */
-
-                         ret = nxffs_packblock(volume, &pack);
-                         if (ret < 0)
-                           {
-                             /* The error -ENOSPC is a special value that simply
-                              * means that there is nothing further to be packed.
-                              */
-
-                             if (ret == -ENOSPC)
-                               {
-                                 packed = true;
-
-                                 /* Writing is performed at the end of the free
-                                  * FLASH region and this implemenation is restricted
-                                  * to a single writer.  The new inode is not
-                                  * written to FLASH until the writer is closed
-                                  * and so will not be found by nxffs_packblock().
-                                  */
-
-                                 wrfile = nxffs_setupwriter(volume, &pack);
-                               }
-                             else
-                               {
-                                 /* Otherwise, something really bad happened */
-
-                                 fdbg("ERROR: Failed to pack into block %d: %d\n",
-                                      block, ret);
-                                 goto errout_with_pack;
-                               }
-                           }
-                       }
-
-                     /* If all of the "normal" inodes have been packed, then check if
-                      * we need to pack the current, in-progress write operation.
-                      */
-
-                     if (wrfile)
-                       {
-                         DEBUGASSERT(packed == true);
-
-                         /* Pack write data into this block */
-
-                         ret = nxffs_packwriter(volume, &pack, wrfile);
-                         if (ret < 0)
-                           {
-                             /* The error -ENOSPC is a special value that simply
-                              * means that there is nothing further to be packed.
-                              */
-
-                             if (ret == -ENOSPC)
-                               {
-                                 wrfile = NULL;
-                               }
-                             else
-                               {
-                                 /* Otherwise, something really bad happened */
-
-                                 fdbg("ERROR: Failed to pack into block %d: %d\n",
-                                      block, ret);
-                                 goto errout_with_pack;
-                               }
-                           }
-                       }
-                   }
-
-                 /* Set any unused portion at the end of the block to the
-                  * erased state.
-                  */
-
-                 if (pack.iooffset < volume->geo.blocksize)
-                   {
-                     memset(&pack.iobuffer[pack.iooffset],
-                            CONFIG_NXFFS_ERASEDSTATE,
-                            volume->geo.blocksize - pack.iooffset);
-                   }
-
-                 /* Next time through the loop, pack.iooffset will point to the
-                  * first byte after the block header.
-                  */
-
-                 pack.iooffset = SIZEOF_NXFFS_BLOCK_HDR;
-              }
-         }
+      nxffs_packend(volume, &pack, ret);
+    }
+
+  /* Blocks in the volume cache may have been re-written */
+
+  volume->cblock = (off_t)-1;
+
+#ifdef CONFIG_NXFFS_BGPACK
+  /* The caller was stalled for the entire packing operation */
 
-      /* We now have an in-memory image of how we want this erase block to
-       * appear. Now it is safe to erase the block.
+  elapsed = (clock_systimer() - start) * MSEC_PER_TICK;
+  if (elapsed > volume->bgstats.ps_maxstall)
+    {
+      volume->bgstats.ps_maxstall = elapsed;
+    }
+
+  volume->bgstats.ps_fgpacks++;
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxffs_packstep
+ *
+ * Description:
+ *   Perform one bounded step of a background pack.  A new packing operation
+ *   is started if none is in progress.  Then up to 'neblocks' erase blocks
+ *   are packed and written back to FLASH.  If there is an open writer, it
+ *   must not have a partially written data block.
+ *
+ * Input Parameters:
+ *   volume   - The volume to be packed.
+ *   neblocks - The maximum number of erase blocks to pack in this step.
+ *
+ * Returned Values:
+ *   Zero is returned if the packing operation is complete.  -EINPROGRESS is
+ *   returned if more steps are required.  Otherwise, a negated errno value
+ *   is returned to indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+int nxffs_packstep(FAR struct nxffs_volume_s *volume, int neblocks)
+{
+  FAR struct nxffs_pack_s *pack = &volume->bgpack;
+  off_t froffset = volume->froffset;
+  int ret = OK;
+
+  /* Start a new packing operation if necessary */
+
+  if (!volume->bgactive)
+    {
+      ret = nxffs_packsetup(volume, pack);
+      volume->bgactive = true;
+    }
+  else if (!pack->packed)
+    {
+      /* Resume packing inodes.  Between steps, volume->froffset refers to
+       * the end of the data written by other operations.  Restore the
+       * packing destination offset.  The volume cache may also have been
+       * used by other operations, so reload the source data block.
        */
 
-      ret = MTD_ERASE(volume->mtd, eblock, 1);
-      if (ret < 0)
+      volume->froffset = pack->dfroffset;
+      if (pack->src.blkoffset > 0)
         {
-          fdbg("ERROR: Failed to erase block %d [%d]: %d\n",
-               eblock, pack.block0, -ret);
-          goto errout_with_pack;
+          nxffs_ioseek(volume, pack->src.blkoffset);
+          ret = nxffs_rdcache(volume, volume->ioblock);
         }
+    }
 
-      /* Write the packed I/O block to FLASH */
+  /* Pack up to 'neblocks' erase blocks.  If the writer is being packed,
+   * continue until all of its data has been moved:  The writer cannot
+   * resume until its open file state refers to the new location.
+   */
 
-      ret = MTD_BWRITE(volume->mtd, pack.block0, volume->blkper, volume->pack);
-      if (ret < 0)
+  for (; ret >= 0 && pack->eblock < volume->geo.neraseblocks &&
+         (neblocks > 0 || pack->wrfile != NULL);
+       neblocks--)
+    {
+      ret = nxffs_packeblock(volume, pack);
+    }
+
+  /* Blocks in the volume cache may have been re-written */
+
+  volume->cblock = (off_t)-1;
+
+  /* Is there more to do? */
+
+  if (ret >= 0 && pack->eblock < volume->geo.neraseblocks)
+    {
+      /* Yes.. While inodes are being packed, volume->froffset must continue
+       * to refer to the end of the data that is on the FLASH.  After the
+       * last inode has been packed, volume->froffset refers to the new free
+       * FLASH region and only erase blocks beyond it remain to be packed.
+       */
+
+      if (!pack->packed)
         {
-          fdbg("ERROR: Failed to write erase block %d [%d]: %d\n",
-               eblock, pack.block0, -ret);
-          goto errout_with_pack;
+          pack->dfroffset  = volume->froffset;
+          volume->froffset = froffset;
         }
+
+      return -EINPROGRESS;
     }
 
-errout_with_pack:
-  nxffs_freeentry(&pack.src.entry);
-  nxffs_freeentry(&pack.dest.entry);
+  /* No.. the packing operation is complete (or failed) */
+
+  nxffs_packend(volume, pack, ret);
+  volume->bgactive = false;
   return ret;
 }
+#endif
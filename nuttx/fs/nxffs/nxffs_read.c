@@ -78,16 +78,21 @@
  *   are not easily mapped to FLASH offsets due to intervening block and
  *   data headers.
  *
+ *   The open file read cursor remembers the last data block that was
+ *   accessed.  If the file position lies in or beyond that data block, the
+ *   search starts there instead of at the beginning of the file so that
+ *   sequential reads do not have to re-walk the data blocks.
+ *
  * Input Parameters:
  *   volume   - Describes the current volume
- *   entry    - Describes the open inode
+ *   ofile    - Describes the open file
  *   fpos     - The desired file position
  *   blkentry - Describes the block entry that we are positioned in
  *
  ****************************************************************************/
 
 static ssize_t nxffs_rdseek(FAR struct nxffs_volume_s *volume,
-                            FAR struct nxffs_entry_s *entry,
+                            FAR struct nxffs_ofile_s *ofile,
                             off_t fpos,
                             FAR struct nxffs_blkentry_s *blkentry)
 {
@@ -96,21 +101,50 @@ static ssize_t nxffs_rdseek(FAR struct nxffs_volume_s *volume,
   off_t offset;
   int ret;
 
-  /* The initial FLASH offset will be the offset to first data block of
-   * the inode
+  /* Is the position within the data block under the read cursor?  If so,
+   * that data block was already verified and we only need to make sure
+   * that it is in the cache.
    */
 
-  offset = entry->doffset;
-  if (offset == 0)
+  if (ofile->rdoffset != 0 && fpos >= ofile->rdpos)
     {
-      /* Zero length files will have no data blocks */
+      datend = ofile->rdpos + ofile->rddatlen;
+      if (fpos < datend)
+        {
+          blkentry->hoffset = ofile->rdoffset;
+          blkentry->datlen  = ofile->rddatlen;
+          blkentry->foffset = fpos - ofile->rdpos;
+
+          nxffs_ioseek(volume, blkentry->hoffset + SIZEOF_NXFFS_DATA_HDR +
+                       blkentry->foffset);
+          return nxffs_rdcache(volume, volume->ioblock);
+        }
+
+      /* No.. but the position is beyond the cursor.  Start searching with
+       * the data block that follows the cursor.
+       */
 
-      return -ENOSPC;
+      offset = ofile->rdoffset + SIZEOF_NXFFS_DATA_HDR + ofile->rddatlen;
+    }
+  else
+    {
+      /* The initial FLASH offset will be the offset to first data block of
+       * the inode
+       */
+
+      offset = ofile->entry.doffset;
+      if (offset == 0)
+        {
+          /* Zero length files will have no data blocks */
+
+          return -ENOSPC;
+        }
+
+      datend = 0;
     }
 
   /* Loop until we read the data block containing the desired position */
 
-  datend = 0;
   do
     {
       /* Check if the next data block contains the sought after file position */
@@ -119,6 +153,7 @@ static ssize_t nxffs_rdseek(FAR struct nxffs_volume_s *volume,
       if (ret < 0)
         {
           fdbg("ERROR: nxffs_nextblock failed: %d\n", -ret);
+          ofile->rdoffset = 0;
           return ret;
         }
 
@@ -133,6 +168,12 @@ static ssize_t nxffs_rdseek(FAR struct nxffs_volume_s *volume,
     }
   while (datend <= fpos);
 
+  /* Move the read cursor to this data block */
+
+  ofile->rdoffset = blkentry->hoffset;
+  ofile->rdpos    = datstart;
+  ofile->rddatlen = blkentry->datlen;
+
   /* Return the offset to the data within the current data block */
 
   blkentry->foffset = fpos - datstart;
@@ -198,6 +239,16 @@ ssize_t nxffs_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
       goto errout_with_semaphore;
     }
 
+  /* Finish moving the inode if an interrupted background pack is moving
+   * it.
+   */
+
+  ret = nxffs_bgrdsync(volume, ofile->entry.name);
+  if (ret < 0)
+    {
+      goto errout_with_semaphore;
+    }
+
   /* Loop until all bytes have been read */
 
   for (total = 0; total < buflen; )
@@ -214,7 +265,7 @@ ssize_t nxffs_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
 
       /* Seek to the current file offset */
 
-      ret = nxffs_rdseek(volume, &ofile->entry, filep->f_pos, &blkentry);
+      ret = nxffs_rdseek(volume, ofile, filep->f_pos, &blkentry);
       if (ret < 0)
         {
           fdbg("ERROR: nxffs_rdseek failed: %d\n", -ret);
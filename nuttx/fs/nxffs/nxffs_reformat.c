@@ -299,6 +299,10 @@ int nxffs_reformat(FAR struct nxffs_volume_s *volume)
       return ret;
     }
 
+  /* The volume no longer holds any inodes */
+
+  nxffs_idxreset(volume);
+
   /* Check for bad blocks */
 
   ret = nxffs_badblocks(volume);
@@ -157,7 +157,15 @@ int nxffs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   if (relpath && relpath[0] != '\0')
     {
-      /* Not the top directory.. find the NXFFS inode with this name */
+      /* Not the top directory.. finish any interrupted background pack
+       * that is moving this inode, then find the NXFFS inode with this name.
+       */
+
+      ret = nxffs_bgrdsync(volume, relpath);
+      if (ret < 0)
+        {
+          goto errout_with_semaphore;
+        }
 
       ret = nxffs_findinode(volume, relpath, &entry);
       if (ret < 0)
@@ -145,6 +145,18 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name)
       fdbg("ERROR: Failed to write block %d: %d\n",
            volume->ioblock, ret);
     }
+  else
+    {
+      /* The inode no longer exists.  Remove it from the inode index */
+
+      nxffs_idxremove(volume, name);
+
+#ifdef CONFIG_NXFFS_BGPACK
+      /* The FLASH used by the inode can now be recovered by packing */
+
+      volume->bgreclaim = true;
+#endif
+    }
 
 errout_with_entry:
   nxffs_freeentry(&entry);
@@ -179,10 +191,27 @@ int nxffs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
       goto errout;
     }
 
+  /* Finish moving the inode if an interrupted background pack is moving
+   * it.
+   */
+
+  ret = nxffs_bgrdsync(volume, relpath);
+  if (ret < 0)
+    {
+      goto errout_with_semaphore;
+    }
+
   /* Then remove the NXFFS inode */
 
   ret = nxffs_rminode(volume, relpath);
+  if (ret == OK)
+    {
+      /* Pack the volume when it is idle */
+
+      nxffs_bgschedule(volume);
+    }
 
+errout_with_semaphore:
   sem_post(&volume->exclsem);
 errout:
   return ret;
@@ -511,9 +511,18 @@ ssize_t nxffs_write(FAR struct file *filep, FAR const char *buffer, size_t bufle
             }
         }
 
-      /* Seek to the FLASH block containing the data block */
+      /* Seek to the FLASH block containing the data block.  Other
+       * operations may have used the volume cache since the last write.
+       */
 
       nxffs_ioseek(volume, wrfile->doffset);
+      ret = nxffs_rdcache(volume, volume->ioblock);
+      if (ret < 0)
+        {
+          fdbg("ERROR: Failed to read data block %d: %d\n",
+               volume->ioblock, -ret);
+          goto errout_with_semaphore;
+        }
 
       /* Verify that the FLASH data that was previously written is still intact */
 
@@ -701,6 +710,16 @@ int nxffs_wrverify(FAR struct nxffs_volume_s *volume, size_t size)
 
   while (volume->ioblock < volume->nblocks)
     {
+      /* The block may lie in an erase block that an interrupted background
+       * pack has not yet reset to the erased state.
+       */
+
+      ret = nxffs_bgwrsync(volume, volume->ioblock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
       /* Make sure that the block is in memory */
 
       ret = nxffs_rdcache(volume, volume->ioblock);
@@ -810,9 +829,21 @@ int nxffs_wrblkhdr(FAR struct nxffs_volume_s *volume,
   FAR struct nxffs_data_s *dathdr;
   int ret;
 
-  /* Write the data block header to memory */
+  /* Make sure that the data block is in the cache.  Other operations may
+   * have used the volume cache since the data was written.
+   */
 
   nxffs_ioseek(volume, wrfile->doffset);
+  ret = nxffs_rdcache(volume, volume->ioblock);
+  if (ret < 0)
+    {
+      fdbg("ERROR: Failed to read data block %d: %d\n",
+           volume->ioblock, -ret);
+      goto errout;
+    }
+
+  /* Write the data block header to memory */
+
   dathdr = (FAR struct nxffs_data_s *)&volume->cache[volume->iooffset];
   memcpy(dathdr->magic, g_datamagic, NXFFS_MAGICSIZE);
   nxffs_wrle32(dathdr->crc, 0);
@@ -87,6 +87,9 @@ enum proc_node_e
   PROC_STATUS,                        /* Task/thread status */
   PROC_CMDLINE,                       /* Task command line */
   PROC_STACK,                         /* Task stack info */
+#ifdef CONFIG_MM_TASKCACHE
+  PROC_MMCACHE,                       /* Task allocation cache info */
+#endif
   PROC_GROUP,                         /* Group directory */
   PROC_GROUP_STATUS,                  /* Task group status */
   PROC_GROUP_FD                       /* Group file descriptors */
@@ -139,6 +142,11 @@ static ssize_t proc_cmdline(FAR struct proc_file_s *procfile,
 static ssize_t proc_stack(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
+#ifdef CONFIG_MM_TASKCACHE
+static ssize_t proc_mmcache(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+#endif
 static ssize_t proc_groupstatus(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
@@ -216,6 +224,13 @@ static const struct proc_node_s g_stack =
   "stack",        "stack",   (uint8_t)PROC_STACK,        DTYPE_FILE        /* Task stack info */
 };
 
+#ifdef CONFIG_MM_TASKCACHE
+static const struct proc_node_s g_mmcache =
+{
+  "mmcache",      "mmcache", (uint8_t)PROC_MMCACHE,      DTYPE_FILE        /* Task allocation cache info */
+};
+#endif
+
 static const struct proc_node_s g_group =
 {
   "group",        "group",   (uint8_t)PROC_GROUP,        DTYPE_DIRECTORY   /* Group directory */
@@ -238,6 +253,9 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
   &g_status,       /* Task/thread status */
   &g_cmdline,      /* Task command line */
   &g_stack,        /* Task stack info */
+#ifdef CONFIG_MM_TASKCACHE
+  &g_mmcache,      /* Task allocation cache info */
+#endif
   &g_group,        /* Group directory */
   &g_groupstatus,  /* Task group status */
   &g_groupfd       /* Group file descriptors */
@@ -251,6 +269,9 @@ static const struct proc_node_s * const g_level0info[] =
   &g_status,       /* Task/thread status */
   &g_cmdline,      /* Task command line */
   &g_stack,        /* Task stack info */
+#ifdef CONFIG_MM_TASKCACHE
+  &g_mmcache,      /* Task allocation cache info */
+#endif
   &g_group,        /* Group directory */
 };
 #define PROC_NLEVEL0NODES (sizeof(g_level0info)/sizeof(FAR const struct proc_node_s * const))
@@ -578,6 +599,80 @@ static ssize_t proc_stack(FAR struct proc_file_s *procfile,
   return totalsize;
 }
 
+/****************************************************************************
+ * Name: proc_mmcache
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_TASKCACHE
+static ssize_t proc_mmcache(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset)
+{
+  FAR struct mm_taskcache_s *cache = &tcb->mmcache;
+  size_t remaining;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+
+  remaining = buflen;
+  totalsize = 0;
+
+  /* Show the number of bytes held in the cache */
+
+  linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n",
+                        "Cached:", (unsigned long)cache->mc_cached);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show the number of allocations satisfied from the cache */
+
+  linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n",
+                        "Hits:", (unsigned long)cache->mc_hits);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show the number of small allocations passed to the heap */
+
+  linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n",
+                        "Misses:", (unsigned long)cache->mc_misses);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show the number of frees absorbed by the cache */
+
+  linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n",
+                        "Frees:", (unsigned long)cache->mc_frees);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+  totalsize += copysize;
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_groupstatus
  ****************************************************************************/
@@ -990,6 +1085,12 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
       ret = proc_stack(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
 
+#ifdef CONFIG_MM_TASKCACHE
+    case PROC_MMCACHE: /* Task allocation cache info */
+      ret = proc_mmcache(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
+
     case PROC_GROUP_STATUS: /* Task group status */
       ret = proc_groupstatus(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
@@ -383,6 +383,19 @@ static ssize_t romfs_read(FAR struct file *filep, FAR char *buffer,
       buflen = bytesleft;
     }
 
+  /* In XIP mode, the file data is directly addressable.  Copy all of it
+   * at once without going through the sector logic.
+   */
+
+  if (rm->rm_xipbase)
+    {
+      memcpy(userbuffer,
+             rm->rm_xipbase + rf->rf_startoffset + filep->f_pos, buflen);
+      filep->f_pos += buflen;
+      romfs_semgive(rm);
+      return buflen;
+    }
+
   /* Loop until either (1) all data has been transferred, or (2) an
    * error occurs.
    */
@@ -951,6 +964,18 @@ static int romfs_bind(FAR struct inode *blkdriver, FAR const void *data,
       goto errout_with_buffer;
     }
 
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+  /* Build the directory index.  This is only an optimization:  Without
+   * it, directories are searched entry-by-entry.
+   */
+
+  ret = romfs_buildindex(rm);
+  if (ret < 0)
+    {
+      fdbg("romfs_buildindex failed: %d\n", ret);
+    }
+#endif
+
   /* Mounted! */
 
   *handle = (void*)rm;
@@ -1030,6 +1055,10 @@ static int romfs_unbind(FAR void *handle, FAR struct inode **blkdriver)
 
       /* Release the mountpoint private data */
 
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+      romfs_freeindex(rm);
+#endif
+
       if (!rm->rm_xipbase && rm->rm_buffer)
         {
           kfree(rm->rm_buffer);
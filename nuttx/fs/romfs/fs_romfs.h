@@ -125,6 +125,10 @@
 
 #define ROMF_MAX_LINKS 64
 
+/* Marks the end of a chain in the directory index */
+
+#define ROMFS_NOINDEX  0xffffffff
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -134,6 +138,21 @@
  * mounted with a fat32 filesystem.
  */
 
+/* One entry in the directory index that is built when the file system is
+ * mounted.  Entries whose hash of (parent directory, name) selects the same
+ * hash chain are linked by index through ri_next.
+ */
+
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+struct romfs_index_s
+{
+  uint32_t ri_parent;               /* Offset to the first entry in the directory */
+  uint32_t ri_offset;               /* Offset to the file header of the entry */
+  uint32_t ri_hash;                 /* Hash of the parent offset and the name */
+  uint32_t ri_next;                 /* Next entry in the hash chain */
+};
+#endif
+
 struct romfs_file_s;
 struct romfs_mountpt_s
 {
@@ -149,6 +168,12 @@ struct romfs_mountpt_s
   uint32_t rm_cachesector;          /* Current sector in the rm_buffer */
   uint8_t *rm_xipbase;              /* Base address of directly accessible media */
   uint8_t *rm_buffer;               /* Device sector buffer, allocated if rm_xipbase==0 */
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+  struct romfs_index_s *rm_index;   /* Directory index (NULL if there is none) */
+  uint32_t *rm_hashtab;             /* Index of the first entry in each hash chain */
+  uint32_t rm_nindex;               /* Number of entries in rm_index */
+  uint32_t rm_hashmask;             /* Number of hash chains - 1 */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -221,6 +246,10 @@ EXTERN int  romfs_parsefilename(struct romfs_mountpt_s *rm, uint32_t offset,
                   char *pname);
 EXTERN int  romfs_datastart(struct romfs_mountpt_s *rm, uint32_t offset,
                   uint32_t *start);
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+EXTERN int  romfs_buildindex(struct romfs_mountpt_s *rm);
+EXTERN void romfs_freeindex(struct romfs_mountpt_s *rm);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
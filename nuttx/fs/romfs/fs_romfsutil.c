@@ -118,6 +118,30 @@ static uint32_t romfs_devread32(struct romfs_mountpt_s *rm, int ndx)
 #endif
 }
 
+/****************************************************************************
+ * Name: romfs_namehash
+ *
+ * Desciption:
+ *   Return the directory index hash of the name of an entry in the
+ *   directory whose first entry is at 'parent'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+static uint32_t romfs_namehash(uint32_t parent, const char *name, int namelen)
+{
+  uint32_t hash = 2166136261u ^ parent;
+
+  while (namelen-- > 0)
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_checkentry
  *
@@ -311,6 +335,35 @@ static inline int romfs_searchdir(struct romfs_mountpt_s *rm,
   int16_t  ndx;
   int      ret;
 
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+  /* If there is a directory index, then only the entries in the hash chain
+   * for this name need to be checked.
+   */
+
+  if (rm->rm_index)
+    {
+      FAR struct romfs_index_s *entry;
+      uint32_t parent = dirinfo->rd_dir.fr_firstoffset;
+      uint32_t hash   = romfs_namehash(parent, entryname, entrylen);
+      uint32_t i;
+
+      for (i = rm->rm_hashtab[hash & rm->rm_hashmask];
+           i != ROMFS_NOINDEX;
+           i = entry->ri_next)
+        {
+          entry = &rm->rm_index[i];
+          if (entry->ri_hash == hash && entry->ri_parent == parent &&
+              romfs_checkentry(rm, entry->ri_offset, entryname, entrylen,
+                               dirinfo) == OK)
+            {
+              return OK;
+            }
+        }
+
+      return -ENOENT;
+    }
+#endif
+
   /* Then loop through the current directory until the directory
    * with the matching name is found.  Or until all of the entries
    * the directory have been examined.
@@ -979,3 +1032,176 @@ int romfs_datastart(struct romfs_mountpt_s *rm, uint32_t offset,
 
   return -EINVAL; /* Won't get here */
 }
+
+/****************************************************************************
+ * Name: romfs_buildindex
+ *
+ * Desciption:
+ *   This function is called as part of the ROMFS mount operation.  It walks
+ *   every directory in the file system once and builds an index that maps
+ *   the hash of (parent directory, name) to the offset of the file header
+ *   so that each path segment can be found without reading every entry
+ *   of the directory.
+ *
+ *   Directories are walked breadth-first using the index itself as the
+ *   queue.  The number of entries is limited by the size of the volume so
+ *   that a corrupted image cannot cause an endless walk.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+int romfs_buildindex(struct romfs_mountpt_s *rm)
+{
+  struct romfs_index_s *index = NULL;
+  struct romfs_index_s *newindex;
+  char     name[NAME_MAX+1];
+  uint32_t maxentries = rm->rm_volsize / (2 * ROMFS_ALIGNMENT);
+  uint32_t nalloc = 0;
+  uint32_t nentries = 0;
+  uint32_t i = 0;
+  uint32_t nbuckets;
+  uint32_t parent;
+  uint32_t offset;
+  uint32_t next;
+  uint32_t info;
+  uint32_t j;
+  int16_t  ndx;
+  int      ret;
+
+  /* Walk the root directory, then each directory that has been added to
+   * the index.
+   */
+
+  parent = rm->rm_rootoffset;
+  while (parent != 0)
+    {
+      /* Add all of the entries of this directory, unless it has already
+       * been walked (as when there is more than one path to it).
+       */
+
+      for (j = 0; j < nentries && index[j].ri_parent != parent; j++);
+      for (offset = (j < nentries) ? 0 : parent; offset != 0; offset = next)
+        {
+          if (nentries >= maxentries)
+            {
+              ret = -EINVAL;
+              goto errout;
+            }
+
+          ndx = romfs_devcacheread(rm, offset);
+          if (ndx < 0)
+            {
+              ret = ndx;
+              goto errout;
+            }
+
+          next = romfs_devread32(rm, ndx + ROMFS_FHDR_NEXT) & RFNEXT_OFFSETMASK;
+
+          ret = romfs_parsefilename(rm, offset, name);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+
+          if (nentries >= nalloc)
+            {
+              nalloc   = nalloc ? 2 * nalloc : 32;
+              newindex = (struct romfs_index_s *)
+                krealloc(index, nalloc * sizeof(struct romfs_index_s));
+              if (!newindex)
+                {
+                  ret = -ENOMEM;
+                  goto errout;
+                }
+
+              index = newindex;
+            }
+
+          index[nentries].ri_parent = parent;
+          index[nentries].ri_offset = offset;
+          index[nentries].ri_hash   = romfs_namehash(parent, name, strlen(name));
+          nentries++;
+        }
+
+      /* Find the next entry that is a directory (not a hard link to one) */
+
+      for (parent = 0; parent == 0 && i < nentries; i++)
+        {
+          ndx = romfs_devcacheread(rm, index[i].ri_offset);
+          if (ndx < 0)
+            {
+              ret = ndx;
+              goto errout;
+            }
+
+          next = romfs_devread32(rm, ndx + ROMFS_FHDR_NEXT);
+          info = romfs_devread32(rm, ndx + ROMFS_FHDR_INFO);
+          if (IS_DIRECTORY(next))
+            {
+              parent = info;
+            }
+        }
+    }
+
+  /* Now link the entries into hash chains.  Use at least as many chains as
+   * there are entries.
+   */
+
+  for (nbuckets = 1; nbuckets < nentries; nbuckets <<= 1);
+
+  rm->rm_hashtab = (uint32_t *)kmalloc(nbuckets * sizeof(uint32_t));
+  if (!rm->rm_hashtab)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  for (j = 0; j < nbuckets; j++)
+    {
+      rm->rm_hashtab[j] = ROMFS_NOINDEX;
+    }
+
+  for (j = 0; j < nentries; j++)
+    {
+      index[j].ri_next = rm->rm_hashtab[index[j].ri_hash & (nbuckets - 1)];
+      rm->rm_hashtab[index[j].ri_hash & (nbuckets - 1)] = j;
+    }
+
+  rm->rm_index    = index;
+  rm->rm_nindex   = nentries;
+  rm->rm_hashmask = nbuckets - 1;
+
+  fvdbg("Indexed %d entries in %d hash chains\n", nentries, nbuckets);
+  return OK;
+
+errout:
+  if (index)
+    {
+      kfree(index);
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: romfs_freeindex
+ *
+ * Desciption:
+ *   Release the directory index when the file system is unmounted.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+void romfs_freeindex(struct romfs_mountpt_s *rm)
+{
+  if (rm->rm_index)
+    {
+      kfree(rm->rm_index);
+      kfree(rm->rm_hashtab);
+      rm->rm_index   = NULL;
+      rm->rm_hashtab = NULL;
+      rm->rm_nindex  = 0;
+    }
+}
+#endif
@@ -43,6 +43,20 @@
 #include <sys/types.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This structure holds the state of an incremental (streaming) CRC
+ * calculation.  See crc16_init(), crc16_update(), and crc16_final().
+ */
+
+struct crc16_s
+{
+  uint16_t crc;        /* The CRC of the data seen so far */
+  size_t nbytes;       /* The number of bytes seen so far */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -75,6 +89,38 @@ uint16_t crc16part(FAR const uint8_t *src, size_t len, uint16_t crc16val);
 
 uint16_t crc16(FAR const uint8_t *src, size_t len);
 
+/****************************************************************************
+ * Name: crc16_init
+ *
+ * Description:
+ *   Initialize a streaming CRC context.  The sequence crc16_init(),
+ *   crc16_update() (any number of times), crc16_final() gives the same
+ *   result as crc16() on the concatenation of all of the data.
+ *
+ ****************************************************************************/
+
+void crc16_init(FAR struct crc16_s *ctx);
+
+/****************************************************************************
+ * Name: crc16_update
+ *
+ * Description:
+ *   Add the next 'len' bytes from 'src' to the streaming CRC calculation.
+ *
+ ****************************************************************************/
+
+void crc16_update(FAR struct crc16_s *ctx, FAR const uint8_t *src, size_t len);
+
+/****************************************************************************
+ * Name: crc16_final
+ *
+ * Description:
+ *   Return the CRC of all data added since crc16_init().
+ *
+ ****************************************************************************/
+
+uint16_t crc16_final(FAR const struct crc16_s *ctx);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
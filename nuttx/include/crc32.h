@@ -43,6 +43,20 @@
 #include <sys/types.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This structure holds the state of an incremental (streaming) CRC
+ * calculation.  See crc32_init(), crc32_update(), and crc32_final().
+ */
+
+struct crc32_s
+{
+  uint32_t crc;        /* The CRC of the data seen so far */
+  size_t nbytes;       /* The number of bytes seen so far */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -75,6 +89,38 @@ uint32_t crc32part(FAR const uint8_t *src, size_t len, uint32_t crc32val);
 
 uint32_t crc32(FAR const uint8_t *src, size_t len);
 
+/****************************************************************************
+ * Name: crc32_init
+ *
+ * Description:
+ *   Initialize a streaming CRC context.  The sequence crc32_init(),
+ *   crc32_update() (any number of times), crc32_final() gives the same
+ *   result as crc32() on the concatenation of all of the data.
+ *
+ ****************************************************************************/
+
+void crc32_init(FAR struct crc32_s *ctx);
+
+/****************************************************************************
+ * Name: crc32_update
+ *
+ * Description:
+ *   Add the next 'len' bytes from 'src' to the streaming CRC calculation.
+ *
+ ****************************************************************************/
+
+void crc32_update(FAR struct crc32_s *ctx, FAR const uint8_t *src, size_t len);
+
+/****************************************************************************
+ * Name: crc32_final
+ *
+ * Description:
+ *   Return the CRC of all data added since crc32_init().
+ *
+ ****************************************************************************/
+
+uint32_t crc32_final(FAR const struct crc32_s *ctx);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
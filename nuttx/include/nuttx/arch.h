@@ -955,6 +955,56 @@ void up_udelay(useconds_t microseconds);
 void up_cxxinitialize(void);
 #endif
 
+/****************************************************************************
+ * Name: up_hrclock_gettime
+ *
+ * Description:
+ *   If CONFIG_CLOCK_HIRES is selected, the architecture specific logic must
+ *   provide a free-running, monotonic, high-resolution clock.  This
+ *   function returns the time elapsed on that clock since start-up.  It
+ *   may be called from interrupt handlers and before the system timer is
+ *   started.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CLOCK_HIRES
+void up_hrclock_gettime(FAR struct timespec *ts);
+#endif
+
+/****************************************************************************
+ * Name: up_timer_gettick
+ *
+ * Description:
+ *   In tickless mode (CONFIG_SCHED_TICKLESS), the architecture specific
+ *   logic must provide a free-running count of system timer ticks (units
+ *   of MSEC_PER_TICK).  This count replaces the periodic system timer
+ *   interrupt as the time base of the OS.  It must read zero until the
+ *   system timer is started and must increment without interrupting the
+ *   CPU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+uint32_t up_timer_gettick(void);
+#endif
+
+/****************************************************************************
+ * Name: up_timer_start
+ *
+ * Description:
+ *   In tickless mode (CONFIG_SCHED_TICKLESS), program the system timer to
+ *   interrupt once, 'ticks' system timer ticks from now, and then call
+ *   sched_timer_expiration().  Any previously programmed expiration is
+ *   replaced.  A value of zero cancels the expiration.  The timer may
+ *   expire earlier than requested (for example, if the hardware cannot
+ *   represent so long an interval) but never later.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+void up_timer_start(uint32_t ticks);
+#endif
+
 /****************************************************************************
  * These are standard interfaces that are exported by the OS
  * for use by the architecture specific logic
@@ -974,6 +1024,21 @@ void up_cxxinitialize(void);
 
 void sched_process_timer(void);
 
+/****************************************************************************
+ * Name: sched_timer_expiration
+ *
+ * Description:
+ *   In tickless mode (CONFIG_SCHED_TICKLESS), the architecture specific
+ *   logic does not call sched_process_timer() periodically.  Instead, it
+ *   must call this function from the system timer interrupt when the
+ *   expiration programmed by up_timer_start() occurs.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+void sched_timer_expiration(void);
+#endif
+
 /****************************************************************************
  * Name: irq_dispatch
  *
@@ -134,17 +134,26 @@
  * access to kernel global data
  */
 
+/* In tickless mode (CONFIG_SCHED_TICKLESS), g_system_timer is updated only
+ * when the architecture timer expires; clock_systimer() must then be called
+ * as a function to obtain the current time.
+ */
+
 #if __HAVE_KERNEL_GLOBALS
 #  ifdef CONFIG_SYSTEM_TIME64
 
 extern volatile uint64_t g_system_timer;
+#ifndef CONFIG_SCHED_TICKLESS
 #define clock_systimer()  (uint32_t)(g_system_timer & 0x00000000ffffffff)
 #define clock_systimer64() g_system_timer
+#endif
 
 #  else
 
 extern volatile uint32_t g_system_timer;
+#ifndef CONFIG_SCHED_TICKLESS
 #define clock_systimer() g_system_timer
+#endif
 
 #  endif
 #endif
@@ -211,7 +220,7 @@ EXTERN void clock_synchronize(void);
  *
  ****************************************************************************/
 
-#if !__HAVE_KERNEL_GLOBALS
+#if !__HAVE_KERNEL_GLOBALS || defined(CONFIG_SCHED_TICKLESS)
 #  ifdef CONFIG_SYSTEM_TIME64
 #    define clock_systimer()  (uint32_t)(clock_systimer64() & 0x00000000ffffffff)
 #  else
@@ -42,6 +42,7 @@
 
 #include <nuttx/config.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -65,6 +66,19 @@
 
 typedef uint8_t fat_attrib_t;
 
+/* Statistics for the mountpoint sector cache (see fat_getcachestats()) */
+
+#ifdef CONFIG_FAT_SECTORCACHE
+struct fat_cachestats_s
+{
+  uint32_t cs_hits;                /* Sector lookups satisfied from the cache */
+  uint32_t cs_misses;              /* Sector lookups that required a read */
+  uint32_t cs_rdsectors;           /* Sectors read, including read-ahead */
+  uint32_t cs_wrcalls;             /* Block driver write calls for write-back */
+  uint32_t cs_wrsectors;           /* Sectors written back (excluding FAT copies) */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -87,6 +101,21 @@ extern "C" {
 EXTERN int fat_getattrib(const char *path, fat_attrib_t *attrib);
 EXTERN int fat_setattrib(const char *path, fat_attrib_t setbits, fat_attrib_t clearbits);
 
+/****************************************************************************
+ * Name: fat_getcachestats
+ *
+ * Description:
+ *   Non-standard function to return the sector cache statistics of the FAT
+ *   volume that contains the path.  If 'reset' is true, the statistics are
+ *   zeroed after they are returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_SECTORCACHE
+EXTERN int fat_getcachestats(const char *path,
+                             FAR struct fat_cachestats_s *stats, bool reset);
+#endif
+
 /****************************************************************************
  * Name: fat_dma_alloc and fat_dma_free
  *
@@ -210,6 +210,10 @@ struct inode
 {
   FAR struct inode *i_peer;       /* Pointer to same level inode */
   FAR struct inode *i_child;      /* Pointer to lower level inode */
+#ifdef CONFIG_FS_INODE_HASH
+  FAR struct inode *i_parent;     /* Pointer to upper level inode */
+  FAR struct inode *i_hnext;      /* Next inode in the same hash bucket */
+#endif
   int16_t           i_crefs;      /* References to inode */
   uint16_t          i_flags;      /* Flags for inode */
   union inode_ops_u u;            /* Inode operations */
@@ -651,6 +655,23 @@ ssize_t file_read(FAR struct file *filep, FAR void *buf, size_t nbytes);
 off_t file_seek(FAR struct file *filep, off_t offset, int whence);
 #endif
 
+/* fs/fs_epoll.c ************************************************************/
+/****************************************************************************
+ * Name: epoll_release
+ *
+ * Description:
+ *   Called when a file (struct file) or a socket (struct socket) is closed.
+ *   Removes the object from every epoll instance that it is registered
+ *   with so that no driver keeps a reference to a stale registration.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_DISABLE_POLL) && CONFIG_NFILE_DESCRIPTORS > 0
+void epoll_release(FAR const void *obj);
+#else
+#  define epoll_release(obj)
+#endif
+
 /* drivers/dev_null.c *******************************************************/
 /****************************************************************************
  * Name: devnull_register
@@ -70,6 +70,7 @@
 #define _SLCDIOCBASE    (0x1100) /* Segment LCD ioctl commands */
 #define _WLIOCBASE      (0x1200) /* Wireless modules ioctl commands */
 #define _CFGDIOCBASE    (0x1300) /* Config Data device (app config) ioctl commands */
+#define _PIPEIOCBASE    (0x1400) /* Pipe and FIFO ioctl commands */
 
 /* Macros used to manage ioctl commands */
 
@@ -186,6 +187,11 @@
                                            *      buffer address
                                            * OUT: None (ioctl return value provides
                                            *      success/failure indication). */
+#define BIOC_FLUSH      _BIOC(0x000a)     /* Write all cached, modified sectors
+                                           * back to the block device
+                                           * IN:  None
+                                           * OUT: None (ioctl return value provides
+                                           *      success/failure indication). */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -276,6 +282,19 @@
 #define _CFGDIOCVALID(c)   (_IOC_TYPE(c)==_CFGDIOCBASE)
 #define _CFGDIOC(nr)         _IOC(_CFGDIOCBASE,nr)
 
+/* Pipe and FIFO driver ioctl definitions ***********************************/
+
+#define _PIPEIOCVALID(c)   (_IOC_TYPE(c)==_PIPEIOCBASE)
+#define _PIPEIOC(nr)       _IOC(_PIPEIOCBASE,nr)
+
+#define PIPEIOC_SETSIZE    _PIPEIOC(0x0001) /* Set the size of the pipe buffer
+                                             * IN:  New size in bytes (2 through
+                                             *      CONFIG_DEV_PIPE_MAXSIZE)
+                                             * OUT: None */
+#define PIPEIOC_GETSIZE    _PIPEIOC(0x0002) /* Get the size of the pipe buffer
+                                             * IN:  Pointer to size_t
+                                             * OUT: The size in bytes */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
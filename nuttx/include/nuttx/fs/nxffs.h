@@ -41,6 +41,9 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdint.h>
+
 #include <nuttx/fs/fs.h>
 
 /****************************************************************************
@@ -85,6 +88,51 @@
 #  define CONFIG_NXFFS_TAILTHRESHOLD (8*1024)
 #endif
 
+/* If the in-memory inode index is enabled, this is the number of hash
+ * buckets used to look up inodes by name.  Must be a power of two.
+ */
+
+#ifdef CONFIG_NXFFS_INODE_INDEX
+#  ifndef CONFIG_NXFFS_INDEX_NBUCKETS
+#    define CONFIG_NXFFS_INDEX_NBUCKETS 16
+#  endif
+#  if (CONFIG_NXFFS_INDEX_NBUCKETS & (CONFIG_NXFFS_INDEX_NBUCKETS - 1)) != 0
+#    error CONFIG_NXFFS_INDEX_NBUCKETS must be a power of two
+#  endif
+#endif
+
+/* Background packing.  When the volume has been idle for
+ * CONFIG_NXFFS_BGPACK_DELAY milliseconds, inodes have been deleted, and
+ * less than CONFIG_NXFFS_BGPACK_THRESHOLD percent of the volume is free,
+ * the volume is packed on the low priority work queue.  At most
+ * CONFIG_NXFFS_BGPACK_BUDGET erase blocks are packed in each step and
+ * steps are separated by CONFIG_NXFFS_BGPACK_INTERVAL milliseconds.
+ */
+
+#ifdef CONFIG_NXFFS_BGPACK
+#  ifndef CONFIG_SCHED_WORKQUEUE
+#    error "Background packing requires CONFIG_SCHED_WORKQUEUE"
+#  endif
+#  ifndef CONFIG_NXFFS_BGPACK_DELAY
+#    define CONFIG_NXFFS_BGPACK_DELAY 1000
+#  endif
+#  ifndef CONFIG_NXFFS_BGPACK_INTERVAL
+#    define CONFIG_NXFFS_BGPACK_INTERVAL 50
+#  endif
+#  ifndef CONFIG_NXFFS_BGPACK_BUDGET
+#    define CONFIG_NXFFS_BGPACK_BUDGET 1
+#  endif
+#  if CONFIG_NXFFS_BGPACK_BUDGET < 1
+#    error CONFIG_NXFFS_BGPACK_BUDGET must be at least one erase block
+#  endif
+#  ifndef CONFIG_NXFFS_BGPACK_THRESHOLD
+#    define CONFIG_NXFFS_BGPACK_THRESHOLD 25
+#  endif
+#  if CONFIG_NXFFS_BGPACK_THRESHOLD < 0 || CONFIG_NXFFS_BGPACK_THRESHOLD > 100
+#    error CONFIG_NXFFS_BGPACK_THRESHOLD is not a valid percentage
+#  endif
+#endif
+
 /* At present, only a single pre-allocated NXFFS volume is supported.  This
  * is because here can be only a single NXFFS volume mounted at any time.
  * This has to do with the fact that we bind to an MTD driver (instead of a
@@ -107,6 +155,24 @@
 #  endif
 #endif
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Volume packing statistics (see nxffs_getpackstats()) */
+
+#ifdef CONFIG_NXFFS_BGPACK
+struct nxffs_packstats_s
+{
+  uint32_t ps_packs;               /* Completed packing operations */
+  uint32_t ps_bgsteps;             /* Steps performed by the background packer */
+  uint32_t ps_fgpacks;             /* Packs that stalled a file system operation */
+  uint32_t ps_fgsteps;             /* Steps performed for a file system operation */
+  uint32_t ps_reclaimed;           /* FLASH blocks returned to the free region */
+  uint32_t ps_maxstall;            /* Longest stall in milliseconds */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -155,6 +221,28 @@ EXTERN int nxffs_initialize(FAR struct mtd_dev_s *mtd);
 
 EXTERN int nxffs_dump(FAR struct mtd_dev_s *mtd, bool verbose);
 
+/****************************************************************************
+ * Name: nxffs_getpackstats
+ *
+ * Description:
+ *   Return the packing statistics of the NXFFS volume.  Packs performed in
+ *   the foreground (because a write ran out of FLASH or because a file
+ *   system operation had to finish an interrupted background pack) are
+ *   timed and the longest is reported as ps_maxstall.
+ *
+ * Input Parameters:
+ *   stats - The location to return the statistics.
+ *
+ * Returned Value:
+ *   Zero is returned on success.  Otherwise, a negated errno value is
+ *   returned to indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+EXTERN int nxffs_getpackstats(FAR struct nxffs_packstats_s *stats);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
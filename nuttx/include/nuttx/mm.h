@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <semaphore.h>
 
 /****************************************************************************
@@ -113,6 +114,46 @@
 #define MM_IS_ALLOCATED(n) \
   ((int)((struct mm_allocnode_s*)(n)->preceding) < 0))
 
+/* Small-object tier.  Freed chunks no larger than MM_SMALLOBJ_MAXCHUNK are
+ * held (still marked as allocated) in per-size-class free lists so that
+ * they can be recycled in constant time without taking the MM semaphore.
+ * There is one size class per MM_MIN_CHUNK granule.
+ */
+
+#ifdef CONFIG_MM_SMALLOBJ
+#  ifndef CONFIG_MM_SMALLOBJ_MAXSIZE
+#    define CONFIG_MM_SMALLOBJ_MAXSIZE 64
+#  endif
+#  ifndef CONFIG_MM_SMALLOBJ_DEPTH
+#    define CONFIG_MM_SMALLOBJ_DEPTH 32
+#  endif
+
+#  define MM_SMALLOBJ_MAXCHUNK \
+     MM_ALIGN_UP(CONFIG_MM_SMALLOBJ_MAXSIZE + SIZEOF_MM_ALLOCNODE)
+#  define MM_SMALLOBJ_NCLASSES (MM_SMALLOBJ_MAXCHUNK >> MM_MIN_SHIFT)
+#  define MM_SMALLOBJ_NDX(s)   (((s) >> MM_MIN_SHIFT) - 1)
+#endif
+
+/* Per-task allocation caches.  Each task keeps a small "magazine" of the
+ * chunks that it freed most recently (one list per MM_MIN_CHUNK size class)
+ * and satisfies its own small user heap allocations from it without taking
+ * the MM semaphore.
+ */
+
+#ifdef CONFIG_MM_TASKCACHE
+#  ifndef CONFIG_MM_TASKCACHE_MAXSIZE
+#    define CONFIG_MM_TASKCACHE_MAXSIZE 64
+#  endif
+#  ifndef CONFIG_MM_TASKCACHE_DEPTH
+#    define CONFIG_MM_TASKCACHE_DEPTH 8
+#  endif
+
+#  define MM_TASKCACHE_MAXCHUNK \
+     MM_ALIGN_UP(CONFIG_MM_TASKCACHE_MAXSIZE + SIZEOF_MM_ALLOCNODE)
+#  define MM_TASKCACHE_NCLASSES (MM_TASKCACHE_MAXCHUNK >> MM_MIN_SHIFT)
+#  define MM_TASKCACHE_NDX(s)   (((s) >> MM_MIN_SHIFT) - 1)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -174,6 +215,39 @@ struct mm_freenode_s
 #define CHECK_FREENODE_SIZE \
   DEBUGASSERT(sizeof(struct mm_freenode_s) == SIZEOF_MM_FREENODE)
 
+/* This describes a chunk held in one of the small-object free lists or in
+ * a per-task allocation cache.  The chunk header is left as-is (i.e., the
+ * chunk is still allocated from the point of view of the main heap) and
+ * only a single forward link is kept in the payload.
+ */
+
+#if defined(CONFIG_MM_SMALLOBJ) || defined(CONFIG_MM_TASKCACHE)
+struct mm_smallnode_s
+{
+  mmsize_t size;                    /* Size of this chunk */
+  mmsize_t preceding;               /* Size of the preceding chunk */
+  FAR struct mm_smallnode_s *flink; /* Supports a singly linked list */
+};
+#endif
+
+/* This describes the allocation cache of one task.  It is embedded in the
+ * TCB and is only ever modified by the task that owns it (or by the exit
+ * logic after the task has stopped running), so no locking is needed.
+ */
+
+#ifdef CONFIG_MM_TASKCACHE
+struct mm_taskcache_s
+{
+  FAR struct mm_smallnode_s *mc_free[MM_TASKCACHE_NCLASSES];
+  uint8_t  mc_count[MM_TASKCACHE_NCLASSES];
+  bool     mc_closed;       /* The task is exiting; cache no more chunks */
+  size_t   mc_cached;       /* Bytes currently held in the cache */
+  uint32_t mc_hits;         /* Allocations satisfied from the cache */
+  uint32_t mc_misses;       /* Small allocations passed to the heap */
+  uint32_t mc_frees;        /* Frees absorbed by the cache */
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -205,6 +279,21 @@ struct mm_heap_s
    */
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
+
+#ifdef CONFIG_MM_SMALLOBJ
+  /* Small-object free lists, one per size class.  These are protected by
+   * disabling interrupts, not by the MM semaphore.
+   */
+
+  FAR struct mm_smallnode_s *mm_smfree[MM_SMALLOBJ_NCLASSES];
+  uint16_t mm_smcount[MM_SMALLOBJ_NCLASSES];
+
+  /* Small-object statistics */
+
+  size_t   mm_smcached;     /* Bytes held in the small-object lists */
+  uint32_t mm_smhits;       /* Small requests satisfied from the lists */
+  uint32_t mm_smmisses;     /* Small requests passed to the main heap */
+#endif
 };
 
 /****************************************************************************
@@ -313,6 +402,29 @@ int  mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info);
 void mm_shrinkchunk(FAR struct mm_heap_s *heap,
                     FAR struct mm_allocnode_s *node, size_t size);
 
+/* Functions contained in mm_freechunk.c ************************************/
+
+void mm_freechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node);
+
+/* Functions contained in mm_smallobj.c *************************************/
+
+#ifdef CONFIG_MM_SMALLOBJ
+void mm_smallobj_initialize(FAR struct mm_heap_s *heap);
+FAR void *mm_smallobj_alloc(FAR struct mm_heap_s *heap, size_t size);
+bool mm_smallobj_free(FAR struct mm_heap_s *heap,
+                      FAR struct mm_allocnode_s *node);
+int  mm_smallobj_release(FAR struct mm_heap_s *heap);
+#endif
+
+/* Functions contained in mm_taskcache.c ************************************/
+
+#ifdef CONFIG_MM_TASKCACHE
+struct tcb_s; /* Forward reference */
+FAR void *mm_taskcache_alloc(size_t size);
+bool mm_taskcache_free(FAR void *mem);
+FAR void *mm_taskcache_remove(FAR struct tcb_s *tcb);
+#endif
+
 /* Functions contained in mm_addfreechunk.c *********************************/
 
 void mm_addfreechunk(FAR struct mm_heap_s *heap,
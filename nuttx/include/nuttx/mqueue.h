@@ -60,6 +60,15 @@
  * Global Type Declarations
  ****************************************************************************/
 
+#ifdef CONFIG_MQ_SENDREF
+/* The type of the function that is called when a message sent with
+ * mq_sendref() has been received (or discarded) and the sender's buffer
+ * may be reused.
+ */
+
+typedef CODE void (*mq_release_t)(FAR const void *buffer, FAR void *arg);
+#endif
+
 /* This structure defines a message queue */
 
 struct mq_des; /* forward reference */
@@ -68,6 +77,9 @@ struct msgq_s
 {
   FAR struct msgq_s *flink;   /* Forward link to next message queue */
   sq_queue_t   msglist;       /* Prioritized message list */
+#ifdef CONFIG_MQ_MSGPOOL
+  sq_queue_t   msgfree;       /* Free messages in this queue's own pool */
+#endif
   int16_t      maxmsgs;       /* Maximum number of messages in the queue */
   int16_t      nmsgs;         /* Number of message in the queue */
   int16_t      nconnect;      /* Number of connections to message queue */
@@ -114,6 +126,42 @@ extern "C" {
 #define EXTERN extern
 #endif
 
+/****************************************************************************
+ * Name: mq_sendref
+ *
+ * Description:
+ *   Send a message "by reference":  The message data is not copied into
+ *   the message queue.  Rather, a reference to the caller's buffer is
+ *   queued and the data is copied directly from that buffer into the
+ *   receiver's buffer by mq_receive() or mq_timedreceive().  This saves
+ *   one copy of the message data.
+ *
+ *   The buffer must remain valid and unmodified until 'release' is called.
+ *   'release' is called (with the scheduler locked; it must not block)
+ *   after the message is received or, if the message queue is destroyed
+ *   before the message is received, when the message is discarded.
+ *
+ *   Otherwise, this function behaves like mq_send().  It is available only
+ *   to logic within the OS; receivers use the standard interfaces.
+ *
+ * Parameters:
+ *   mqdes   - Message queue descriptor
+ *   buffer  - The message data.  Must remain valid until released.
+ *   buflen  - The length of the message in bytes
+ *   prio    - The priority of the message
+ *   release - Called when the buffer is no longer needed (may be NULL)
+ *   arg     - The argument passed to 'release'
+ *
+ * Return Value:
+ *   Same as mq_send().  'release' is not called if the send fails.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_SENDREF
+int mq_sendref(mqd_t mqdes, FAR const void *buffer, size_t buflen, int prio,
+               mq_release_t release, FAR void *arg);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -0,0 +1,207 @@
+/****************************************************************************
+ * include/nuttx/net/iob.h
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_NET_IOB_H
+#define __INCLUDE_NUTTX_NET_IOB_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#ifdef CONFIG_NET_IOB
+
+#include <stdint.h>
+#include <queue.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_IOB_NBUFFERS
+#  define CONFIG_IOB_NBUFFERS 24
+#endif
+
+#ifndef CONFIG_IOB_BUFSIZE
+#  define CONFIG_IOB_BUFSIZE 196
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Represents one I/O buffer.  A packet is contained in one or more I/O
+ * buffers linked through io_flink (an I/O buffer chain).  The fields
+ * io_node and io_pktlen are meaningful only in the first buffer of a
+ * chain.  Chains may be kept in an sq_queue_t through io_node.
+ */
+
+struct iob_s
+{
+  sq_entry_t io_node;          /* Supports a singly linked list of chains */
+  FAR struct iob_s *io_flink;  /* Next I/O buffer in the chain */
+  uint8_t  io_crefs;           /* Reference count */
+  uint16_t io_len;             /* Length of the data in this buffer */
+  uint16_t io_offset;          /* Offset to the beginning of the data */
+  uint16_t io_pktlen;          /* Total length of the data in the chain */
+  uint8_t  io_data[CONFIG_IOB_BUFSIZE];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: iob_initialize
+ *
+ * Description:
+ *   Set up the I/O buffers for normal operations.
+ *
+ ****************************************************************************/
+
+EXTERN void iob_initialize(void);
+
+/****************************************************************************
+ * Name: iob_alloc
+ *
+ * Description:
+ *   Allocate an I/O buffer, waiting for one to be freed if necessary.  This
+ *   function may not be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+EXTERN FAR struct iob_s *iob_alloc(void);
+
+/****************************************************************************
+ * Name: iob_tryalloc
+ *
+ * Description:
+ *   Allocate an I/O buffer without waiting.  NULL is returned if no buffer
+ *   is available.  This function may be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+EXTERN FAR struct iob_s *iob_tryalloc(void);
+
+/****************************************************************************
+ * Name: iob_addref
+ *
+ * Description:
+ *   Add a reference to each I/O buffer in a chain.  Each reference must be
+ *   released with iob_free() or iob_free_chain() before the buffers are
+ *   returned to the free pool.  Buffers with more than one reference should
+ *   be treated as read-only.
+ *
+ ****************************************************************************/
+
+EXTERN void iob_addref(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_free
+ *
+ * Description:
+ *   Release a reference to one I/O buffer and return the buffer to the free
+ *   pool when no references remain.  Returns the next buffer in the chain.
+ *
+ ****************************************************************************/
+
+EXTERN FAR struct iob_s *iob_free(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_free_chain
+ *
+ * Description:
+ *   Release a reference to every I/O buffer in a chain.
+ *
+ ****************************************************************************/
+
+EXTERN void iob_free_chain(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_copyin
+ *
+ * Description:
+ *   Copy data from a user buffer into an I/O buffer chain at the given
+ *   offset into the packet, extending the chain with iob_tryalloc() as
+ *   necessary.  Returns the number of bytes copied or -ENOMEM if the chain
+ *   could not be extended (the chain is left unchanged in length).
+ *
+ ****************************************************************************/
+
+EXTERN int iob_copyin(FAR struct iob_s *iob, FAR const uint8_t *src,
+                      unsigned int len, unsigned int offset);
+
+/****************************************************************************
+ * Name: iob_copyout
+ *
+ * Description:
+ *   Copy data from an I/O buffer chain, starting at the given offset into
+ *   the packet, into a user buffer.  Returns the number of bytes copied.
+ *
+ ****************************************************************************/
+
+EXTERN int iob_copyout(FAR uint8_t *dest, FAR const struct iob_s *iob,
+                       unsigned int len, unsigned int offset);
+
+/****************************************************************************
+ * Name: iob_trimhead
+ *
+ * Description:
+ *   Remove bytes from the beginning of an I/O buffer chain, freeing the
+ *   buffers that become empty.  Returns the new head of the chain which
+ *   is NULL if all of the data was removed.
+ *
+ ****************************************************************************/
+
+EXTERN FAR struct iob_s *iob_trimhead(FAR struct iob_s *iob,
+                                      unsigned int trimlen);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_NET_IOB */
+#endif /* __INCLUDE_NUTTX_NET_IOB_H */
@@ -68,6 +68,8 @@
  * Public Types
  ****************************************************************************/
 
+struct iob_s;  /* Forward reference */
+
 /* This structure collects information that is specific to a specific network
  * interface driver.  If the hardware platform supports only a single instance
  * of this structure.
@@ -124,6 +126,19 @@ struct uip_driver_s
   uint8_t d_buf[CONFIG_NET_BUFSIZE + CONFIG_NET_GUARDSIZE];
 #endif
 
+#ifdef CONFIG_NET_IOB
+  /* If CONFIG_NET_MULTIBUFFER is defined and an I/O buffer can hold a whole
+   * packet, the driver may receive packets directly into an I/O buffer:  It
+   * sets d_iob to the I/O buffer and d_buf to its io_data[].  If the packet
+   * carries TCP data that must be buffered, TCP then keeps the I/O buffer
+   * instead of copying the data, and sets d_iob to NULL.  The driver must
+   * then provide a new d_buf before the next packet is received or polled
+   * for.  d_iob is NULL if the driver does not receive into I/O buffers.
+   */
+
+  FAR struct iob_s *d_iob;
+#endif
+
   /* d_appdata points to the location where application data can be read from
    * or written into a packet.
    */
@@ -87,6 +87,11 @@ struct arp_entry
   in_addr_t         at_ipaddr;   /* IP address */
   struct ether_addr at_ethaddr;  /* Hardware address */
   uint8_t           at_time;
+#ifdef CONFIG_NET_ARPTAB_HASH
+  uint16_t          at_hnext;    /* Next entry in the hash chain */
+  uint16_t          at_lprev;    /* Next more recently used entry */
+  uint16_t          at_lnext;    /* Next less recently used entry */
+#endif
 };
 
 /****************************************************************************
@@ -230,6 +235,9 @@ EXTERN struct arp_entry *uip_arp_find(in_addr_t ipaddr);
  *
  ****************************************************************************/
 
+#ifdef CONFIG_NET_ARPTAB_HASH
+EXTERN void uip_arp_delete(in_addr_t ipaddr);
+#else
 #define uip_arp_delete(ipaddr) \
 { \
   struct arp_entry *tabptr = uip_arp_find(ipaddr); \
@@ -238,6 +246,7 @@ EXTERN struct arp_entry *uip_arp_find(in_addr_t ipaddr);
       tabptr->at_ipaddr = 0; \
     } \
 }
+#endif
 
 #else /* CONFIG_NET_ARP */
 
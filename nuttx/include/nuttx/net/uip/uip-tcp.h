@@ -164,16 +164,53 @@ struct uip_conn
   uint8_t  nrtx;          /* The number of retransmissions for the last
                            * segment sent */
 
+  /* Hashed connection lookup
+   *
+   *   hnext - The next connection in the same hash chain of active
+   *     connections (hashed on ripaddr, rport and lport).
+   *   pnext - The next connection in the same hash chain of bound
+   *     connections (hashed on lport).
+   */
+
+#ifdef CONFIG_NET_TCP_CONNHASH
+  FAR struct uip_conn *hnext;
+  FAR struct uip_conn *pnext;
+#endif
+
   /* Read-ahead buffering.
    *
    * readahead - A singly linked list of type struct uip_readahead_s
-   *   where the TCP/IP read-ahead data is retained.
+   *   where the TCP/IP read-ahead data is retained.  If CONFIG_NET_IOB
+   *   is selected, this is instead a list of I/O buffer chains (struct
+   *   iob_s).
    */
 
 #if CONFIG_NET_NTCP_READAHEAD_BUFFERS > 0
   sq_queue_t readahead;   /* Read-ahead buffering */
 #endif
 
+  /* Write buffering
+   *
+   *   write_q   - The queue of write buffers (struct uip_wrbuffer_s)
+   *     holding data that has not yet been sent.
+   *   unacked_q - The queue of write buffers holding data that has been
+   *     sent but not yet acknowledged.
+   *   wrseq     - The sequence number of the next byte to be queued.
+   *   sentseq   - The sequence number of the next byte to be sent.
+   *   ackseq    - The highest acknowledgement number received.  The data
+   *     in flight is sentseq - ackseq.
+   *   sndcb     - The callback that drains the write buffer queues.
+   */
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+  sq_queue_t write_q;
+  sq_queue_t unacked_q;
+  uint32_t   wrseq;
+  uint32_t   sentseq;
+  uint32_t   ackseq;
+  FAR struct uip_callback_s *sndcb;
+#endif
+
   /* Listen backlog support
    *
    *   blparent - The backlog parent.  If this connection is backlogged,
@@ -234,7 +271,7 @@ struct uip_conn
  * buffers so that no data is lost.
  */
 
-#if CONFIG_NET_NTCP_READAHEAD_BUFFERS > 0
+#if CONFIG_NET_NTCP_READAHEAD_BUFFERS > 0 && !defined(CONFIG_NET_IOB)
 struct uip_readahead_s
 {
   sq_entry_t rh_node;      /* Supports a singly linked list */
@@ -243,6 +280,22 @@ struct uip_readahead_s
 };
 #endif
 
+/* The following structure is used to handle write buffering for TCP
+ * connections.  Each buffer holds the data of one TCP segment that has
+ * been accepted by send() but not yet acknowledged by the peer.
+ */
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+struct uip_wrbuffer_s
+{
+  sq_entry_t wb_node;      /* Supports a singly linked list */
+  uint32_t wb_seqno;       /* Sequence number of the first byte */
+  uint16_t wb_nbytes;      /* Number of bytes in this buffer */
+  uint16_t wb_sent;        /* Number of bytes sent from this buffer */
+  uint8_t  wb_buffer[CONFIG_NET_TCP_WRITE_BUFSIZE];
+};
+#endif
+
 /* Support for listen backlog:
  *
  *   struct uip_blcontainer_s describes one backlogged connection
@@ -401,10 +454,10 @@ extern int uip_unlisten(struct uip_conn *conn);
 
 /* Access to TCP read-ahead buffers */
 
-#if CONFIG_NET_NTCP_READAHEAD_BUFFERS > 0
+#if CONFIG_NET_NTCP_READAHEAD_BUFFERS > 0 && !defined(CONFIG_NET_IOB)
 extern struct uip_readahead_s *uip_tcpreadaheadalloc(void);
 extern void uip_tcpreadaheadrelease(struct uip_readahead_s *buf);
-#endif /* CONFIG_NET_NTCP_READAHEAD_BUFFERS */
+#endif /* CONFIG_NET_NTCP_READAHEAD_BUFFERS && !CONFIG_NET_IOB */
 
 /* Backlog support */
 
@@ -55,6 +55,7 @@
 #include <queue.h>
 
 #ifdef CONFIG_NET_NOINTS
+#  include <time.h>
 #  include <semaphore.h>
 #endif
 
@@ -264,6 +265,15 @@ struct uip_ip_stats_s
                              were neither ICMP, UDP nor TCP */
 };
 
+#ifdef CONFIG_NET_ARP
+struct uip_arp_stats_s
+{
+  uip_stats_t hit;        /* Number of ARP table lookups that succeeded */
+  uip_stats_t miss;       /* Number of ARP table lookups that failed */
+  uip_stats_t evict;      /* Number of entries replaced while still valid */
+};
+#endif
+
 struct uip_stats
 {
   struct uip_ip_stats_s   ip;   /* IP statistics */
@@ -283,6 +293,10 @@ struct uip_stats
 #ifdef CONFIG_NET_UDP
   struct uip_udp_stats_s  udp;  /* UDP statistics */
 #endif
+
+#ifdef CONFIG_NET_ARP
+  struct uip_arp_stats_s  arp;  /* ARP table statistics */
+#endif
 };
 #endif /* CONFIG_NET_STATISTICS */
 
@@ -331,6 +345,7 @@ extern void uip_setipid(uint16_t id);
  * uip_unlock()     -- Gives the semaphore().
  * uip_lockedwait() -- Like pthread_cond_wait(); releases the semaphore
  *                     momemtarily to wait on another semaphore()
+ * uip_lockedtimedwait() -- Like uip_lockedwait() but with a timeout
  */
 
 typedef uint8_t uip_lock_t; /* Not really used */
@@ -339,6 +354,7 @@ extern void uip_lockinit(void);
 extern uip_lock_t uip_lock(void);
 extern void uip_unlock(uip_lock_t flags);
 extern int uip_lockedwait(sem_t *sem);
+extern int uip_lockedtimedwait(sem_t *sem, const struct timespec *abstime);
 
 #else
 
@@ -349,6 +365,7 @@ extern int uip_lockedwait(sem_t *sem);
  * uip_lock()       -- Disables interrupts.
  * uip_unlock()     -- Conditionally restores interrupts.
  * uip_lockedwait() -- Just wait for the semaphore.
+ * uip_lockedtimedwait() -- Just wait for the semaphore with a timeout.
  */
 
 #  define uip_lock_t        irqstate_t
@@ -356,6 +373,7 @@ extern int uip_lockedwait(sem_t *sem);
 #  define uip_lock()        irqsave()
 #  define uip_unlock(f)     irqrestore(f)
 #  define uip_lockedwait(s) sem_wait(s)
+#  define uip_lockedtimedwait(s,t) sem_timedwait(s,t)
 
 #endif
 
@@ -48,6 +48,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <semaphore.h>
 #include <nuttx/wqueue.h>
 
@@ -57,6 +58,23 @@
  * Pre-processor Definitions
  **********************************************************************/
 
+/* Configuration ******************************************************/
+/* CONFIG_FS_NWRSEGS - The number of independent write-behind segments.
+ *   Each segment buffers one sequential stream of up to wrmaxblocks
+ *   blocks.
+ * CONFIG_FS_NRHSEGS - The number of independent read-ahead segments.
+ *   Each segment holds up to rhmaxblocks blocks for one sequential
+ *   (or strided) stream of reads.
+ */
+
+#ifndef CONFIG_FS_NWRSEGS
+#  define CONFIG_FS_NWRSEGS 1
+#endif
+
+#ifndef CONFIG_FS_NRHSEGS
+#  define CONFIG_FS_NRHSEGS 1
+#endif
+
 /**********************************************************************
  * Public Types
  **********************************************************************/
@@ -71,6 +89,27 @@ typedef ssize_t (*rwbreload_t)(FAR void *dev, FAR uint8_t *buffer,
 typedef ssize_t (*rwbflush_t)(FAR void *dev, FAR const uint8_t *buffer,
                               off_t startblock, size_t nblocks);
 
+/* This structure describes one buffer segment:  A run of consecutive
+ * blocks held in memory.  The stream fields are only used by read-ahead
+ * segments to detect sequential and strided access.
+ */
+
+struct rwbseg_s
+{
+  off_t         blockstart;      /* First block in the segment (-1 if unused) */
+  uint16_t      nblocks;         /* Number of blocks in the segment */
+  uint32_t      lastuse;         /* Value of the use counter at the last access */
+  FAR uint8_t  *buffer;          /* Buffer memory for this segment */
+#ifdef CONFIG_FS_WRITEBUFFER
+  bool          flushing;        /* Write segment is being written by the worker */
+#endif
+#ifdef CONFIG_FS_READAHEAD
+  off_t         laststart;       /* First block of the last read in this stream */
+  off_t         stride;          /* Distance between the last two reads */
+  off_t         nextblock;       /* Block following the last read */
+#endif
+};
+
 /* This structure holds the state of the buffers.  In typical usage,
  * an instance of this structure is declared within each block driver
  * status structure like:
@@ -109,24 +148,30 @@ struct rwbuffer_s
   size_t        nblocks;         /* The total number blocks supported */
   FAR void     *dev;             /* Device state passed to callout functions */
 
+  /* Data transfer callouts.  Transfers that are not buffered are passed
+   * directly to the callouts.  rhreload is always required.  wrflush is
+   * required unless rwb_write() is never called (read-only media).  Full
+   * write segments are written on the worker thread, but the callouts are
+   * never called concurrently for the same rwbuffer instance.
+   */
+
+  rwbflush_t    wrflush;         /* Callout to write blocks to the media */
+  rwbreload_t   rhreload;        /* Callout to read blocks from the media */
+
   /* Write buffer setup.  If CONFIG_FS_WRITEBUFFER is defined, but you
-   * want read-ahead-only operation, (1) set wrmaxblocks to zero and do
-   * not use rwb_write().
+   * want read-ahead-only operation, set wrmaxblocks to zero.
    */
 
 #ifdef CONFIG_FS_WRITEBUFFER
-  uint16_t      wrmaxblocks;     /* The number of blocks to buffer in memory */
-  rwbflush_t    wrflush;         /* Callout to flush the write buffer */
+  uint16_t      wrmaxblocks;     /* The number of blocks to buffer per segment */
 #endif
 
   /* Read-ahead buffer setup.  If CONFIG_FS_READAHEAD is defined but you
-   * want write-buffer-only operation, then (1) set rhmaxblocks to zero and
-   * do not use rwb_read().
+   * want write-buffer-only operation, then set rhmaxblocks to zero.
    */
 
 #ifdef CONFIG_FS_READAHEAD
-  uint16_t      rhmaxblocks;     /* The number of blocks to buffer in memory */
-  rwbreload_t   rhreload;        /* Callout to reload the read-ahead buffer */
+  uint16_t      rhmaxblocks;     /* The number of blocks to buffer per segment */
 #endif
 
   /********************************************************************/
@@ -136,20 +181,24 @@ struct rwbuffer_s
 
 #ifdef CONFIG_FS_WRITEBUFFER
   sem_t         wrsem;           /* Enforces exclusive access to the write buffer */
+  sem_t         wrdone;          /* Posted when the worker finishes writing a segment */
+  sem_t         mdsem;           /* Serializes the data transfer callouts */
   struct work_s work;            /* Delayed work to flush buffer after adelay with no activity */
-  uint8_t      *wrbuffer;        /* Allocated write buffer */
-  uint16_t      wrnblocks;       /* Number of blocks in write buffer */
-  off_t         wrblockstart;    /* First block in write buffer */
-  off_t         wrexpectedblock; /* Next block expected */
+  struct work_s flwork;          /* Work to flush full write segments */
+  uint8_t       wrpending;       /* Number of work items queued or running */
+  uint8_t       wrnwaiters;      /* Number of threads waiting on wrdone */
+  uint8_t      *wrbuffer;        /* Allocated memory for all write segments */
+  uint32_t      wrusecount;      /* Incremented on each write segment access */
+  struct rwbseg_s wrseg[CONFIG_FS_NWRSEGS];
 #endif
 
   /* This is the state of the read-ahead buffer */
 
 #ifdef CONFIG_FS_READAHEAD
-  sem_t         rhsem;           /* Enforces exclusive access to the write buffer */
-  uint8_t      *rhbuffer;        /* Allocated read-ahead buffer */
-  uint16_t      rhnblocks;       /* Number of blocks in read-ahead buffer */
-  off_t         rhblockstart;    /* First block in read-ahead buffer */
+  sem_t         rhsem;           /* Enforces exclusive access to the read-ahead buffer */
+  uint8_t      *rhbuffer;        /* Allocated memory for all read-ahead segments */
+  uint32_t      rhusecount;      /* Incremented on each read-ahead segment access */
+  struct rwbseg_s rhseg[CONFIG_FS_NRHSEGS];
 #endif
 };
 
@@ -182,6 +231,7 @@ EXTERN ssize_t rwb_write(FAR struct rwbuffer_s *rwb,
                          off_t startblock, size_t blockcount,
                          FAR const uint8_t *wrbuffer);
 EXTERN int rwb_mediaremoved(FAR struct rwbuffer_s *rwb);
+EXTERN int rwb_flush(FAR struct rwbuffer_s *rwb);
 
 #undef EXTERN
 #if defined(__cplusplus)
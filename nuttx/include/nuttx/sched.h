@@ -55,6 +55,10 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
+#ifdef CONFIG_MM_TASKCACHE
+#  include <nuttx/mm.h>
+#endif
+
 /********************************************************************************
  * Pre-processor Definitions
  ********************************************************************************/
@@ -507,6 +511,10 @@ struct tcb_s
 
   int pterrno;                           /* Current per-thread errno            */
 
+#ifdef CONFIG_MM_TASKCACHE
+  struct mm_taskcache_s mmcache;         /* Per-task allocation cache           */
+#endif
+
   /* State save areas ***********************************************************/
   /* The form and content of these fields are processor-specific.               */
 
@@ -45,7 +45,9 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <signal.h>
+#include <semaphore.h>
 #include <queue.h>
+#include <wdog.h>
 
 /****************************************************************************
  * Pre-Processor Definitions
@@ -67,8 +69,8 @@
  *   in order to build the high priority work queue.
  * CONFIG_SCHED_WORKPRIORITY - The execution priority of the worker
  *   thread.  Default: 192
- * CONFIG_SCHED_WORKPERIOD - How often the worker thread checks for
- *   work in units of microseconds.  Default: 50*1000 (50 MS).
+ * CONFIG_SCHED_WORKNTHREADS - The number of worker threads that service
+ *   the high priority work queue.  Default: 1
  * CONFIG_SCHED_WORKSTACKSIZE - The stack size allocated for the worker
  *   thread.  Default: CONFIG_IDLETHREAD_STACKSIZE.
  * CONFIG_SIG_SIGWORK - The signal number that will be used to wake-up
@@ -81,10 +83,26 @@
  *   (such as file system clean-up operations)
  * CONFIG_SCHED_LPWORKPRIORITY - The execution priority of the lower priority
  *   worker thread.  Default: 50
- * CONFIG_SCHED_LPWORKPERIOD - How often the lower priority worker thread
- *  checks for work in units of microseconds.  Default: 50*1000 (50 MS).
+ * CONFIG_SCHED_LPWORKNTHREADS - The number of worker threads that service
+ *   the lower priority work queue.  Default: 1
  * CONFIG_SCHED_LPWORKSTACKSIZE - The stack size allocated for the lower
  *   priority worker thread.  Default: CONFIG_IDLETHREAD_STACKSIZE.
+ *
+ * CONFIG_SCHED_WORKSTATS - Collect per-queue statistics (number of work
+ *   items queued and executed, dispatch latency, and backlog).  The
+ *   statistics may be sampled with work_stats().  Default: n
+ *
+ * Work that is ready to run is held in a FIFO and the worker threads
+ * block on a counting semaphore until there is something to do.  Delayed
+ * work is held in a separate list sorted by expiration time and is moved
+ * to the FIFO by a watchdog timer when it expires, so there is no periodic
+ * polling of the work queue.
+ *
+ * With more than one worker thread, a work item that is queued again while
+ * it is still being performed is not started on a second thread until the
+ * first has finished with it.  But different work items do run
+ * concurrently, so work that shares data with other work on the same queue
+ * must protect that data itself.
  */
 
 /* Is this a kernel build (CONFIG_NUTTX_KERNEL=y) */
@@ -158,8 +176,8 @@
 #    define CONFIG_SCHED_WORKPRIORITY 192
 #  endif
 
-#  ifndef CONFIG_SCHED_WORKPERIOD
-#    define CONFIG_SCHED_WORKPERIOD (50*1000) /* 50 milliseconds */
+#  ifndef CONFIG_SCHED_WORKNTHREADS
+#    define CONFIG_SCHED_WORKNTHREADS 1
 #  endif
 
 #  ifndef CONFIG_SCHED_WORKSTACKSIZE
@@ -174,8 +192,8 @@
 #    define CONFIG_SCHED_LPWORKPRIORITY 50
 #  endif
 
-#  ifndef CONFIG_SCHED_LPWORKPERIOD
-#    define CONFIG_SCHED_LPWORKPERIOD (50*1000) /* 50 milliseconds */
+#  ifndef CONFIG_SCHED_LPWORKNTHREADS
+#    define CONFIG_SCHED_LPWORKNTHREADS 1
 #  endif
 
 #  ifndef CONFIG_SCHED_LPWORKSTACKSIZE
@@ -201,8 +219,8 @@
 #    define CONFIG_SCHED_USRWORKPRIORITY 50
 #  endif
 
-#  ifndef CONFIG_SCHED_USRWORKPERIOD
-#    define CONFIG_SCHED_USRWORKPERIOD (50*1000) /* 50 milliseconds */
+#  ifndef CONFIG_SCHED_USRWORKNTHREADS
+#    define CONFIG_SCHED_USRWORKNTHREADS 1
 #  endif
 
 #  ifndef CONFIG_SCHED_USRWORKSTACKSIZE
@@ -264,6 +282,26 @@
 
 #endif /* CONFIG_NUTTX_KERNEL && !__KERNEL__ */
 
+/* The maximum number of worker threads that service any one work queue */
+
+#if defined(CONFIG_NUTTX_KERNEL) && !defined(__KERNEL__)
+#  define WORK_MAXTHREADS CONFIG_SCHED_USRWORKNTHREADS
+#elif defined(CONFIG_SCHED_LPWORK) && \
+      CONFIG_SCHED_LPWORKNTHREADS > CONFIG_SCHED_WORKNTHREADS
+#  define WORK_MAXTHREADS CONFIG_SCHED_LPWORKNTHREADS
+#else
+#  define WORK_MAXTHREADS CONFIG_SCHED_WORKNTHREADS
+#endif
+
+/* Delayed work is released by a watchdog timer.  Watchdog timers are not
+ * available to user-space code in the kernel build.  In that case, the
+ * first worker thread sleeps until the next delayed work expires instead.
+ */
+
+#if !defined(CONFIG_NUTTX_KERNEL) || defined(__KERNEL__)
+#  define WORK_HAVE_WDOG 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -275,10 +313,37 @@
  * accessed by application logic.
  */
 
+#ifdef CONFIG_SCHED_WORKSTATS
+struct work_stats_s
+{
+  uint32_t nqueued;       /* Total number of work items queued */
+  uint32_t nexecuted;     /* Total number of work items executed */
+  uint32_t totlatency;    /* Sum of all dispatch latencies (ticks) */
+  uint32_t maxlatency;    /* Largest dispatch latency (ticks) */
+  uint16_t nready;        /* Work ready to run but not yet dispatched */
+  uint16_t maxready;      /* Largest value of nready seen */
+  uint16_t ndelayed;      /* Work waiting for its delay to expire */
+};
+#endif
+
+struct work_s;  /* Forward reference */
+
 struct wqueue_s
 {
-  pid_t             pid; /* The task ID of the worker thread */
-  struct dq_queue_s q;   /* The queue of pending work */
+  pid_t             pid[WORK_MAXTHREADS]; /* Task IDs of the worker threads */
+  struct dq_queue_s q;       /* The queue of work that is ready to run */
+  struct dq_queue_s delayed; /* Delayed work, sorted by expiration time */
+  sem_t             sem;     /* Counts ready work; worker threads wait here */
+#if WORK_MAXTHREADS > 1
+  FAR struct work_s *running[WORK_MAXTHREADS]; /* Work being performed */
+  uint16_t          ndeferred; /* Wakeups skipped because work was running */
+#endif
+#ifdef WORK_HAVE_WDOG
+  WDOG_ID           wdog;    /* Releases delayed work when it expires */
+#endif
+#ifdef CONFIG_SCHED_WORKSTATS
+  struct work_stats_s stats; /* Queue statistics */
+#endif
 };
 
 /* Defines the work callback */
@@ -295,8 +360,8 @@ struct work_s
   struct dq_entry_s dq;  /* Implements a doubly linked list */
   worker_t  worker;      /* Work callback */
   FAR void *arg;         /* Callback argument */
-  uint32_t  qtime;       /* Time work queued */
-  uint32_t  delay;       /* Delay until work performed */
+  uint32_t  qtime;       /* Time work queued (or became ready to run) */
+  uint32_t  delay;       /* Delay until work performed (zero if ready) */
 };
 
 /****************************************************************************
@@ -385,13 +450,13 @@ int work_usrthread(int argc, char *argv[]);
  * Name: work_usrstart
  *
  * Description:
- *   Start the user mode work queue.
+ *   Start the user mode work queue worker threads.
  *
  * Input parameters:
  *   None
  *
  * Returned Value:
- *   The task ID of the worker thread is returned on success.  A negated
+ *   The task ID of the first worker thread is returned on success.  A negated
  *   errno value is returned on failure.
  *
  ****************************************************************************/
@@ -469,6 +534,46 @@ int work_cancel(int qid, FAR struct work_s *work);
 
 int work_signal(int qid);
 
+/****************************************************************************
+ * Name: work_stats
+ *
+ * Description:
+ *   Return a snapshot of the statistics collected for a work queue.
+ *
+ * Input parameters:
+ *   qid   - The work queue ID
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKSTATS
+int work_stats(int qid, FAR struct work_stats_s *stats);
+#endif
+
+/****************************************************************************
+ * Name: work_expire
+ *
+ * Description:
+ *   Move all delayed work whose delay has elapsed to the ready-to-run
+ *   queue and, if there is a watchdog timer, restart it for the next
+ *   delayed work.  This is used internally by the work logic and should
+ *   not be called by application logic.  It must be called with
+ *   interrupts disabled.
+ *
+ * Input parameters:
+ *   wqueue - The work queue to be updated
+ *
+ * Returned Value:
+ *   The number of clock ticks until the next delayed work expires or zero
+ *   if there is no delayed work.
+ *
+ ****************************************************************************/
+
+uint32_t work_expire(FAR struct wqueue_s *wqueue);
+
 /****************************************************************************
  * Name: work_available
  *
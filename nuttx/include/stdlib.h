@@ -94,6 +94,12 @@ struct mallinfo
                  * chunks handed out by malloc. */
   int fordblks; /* This is the total size of memory occupied
                  * by free (not in use) chunks.*/
+#ifdef CONFIG_MM_SMALLOBJ
+  int smcached; /* Size of the chunks held in the small-object free
+                 * lists (included in uordblks) */
+  int smhits;   /* Small allocations satisfied from the free lists */
+  int smmisses; /* Small allocations passed to the main allocator */
+#endif
 };
 
 /****************************************************************************
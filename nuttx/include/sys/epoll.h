@@ -0,0 +1,133 @@
+/****************************************************************************
+ * include/sys/epoll.h
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_EPOLL_H
+#define __INCLUDE_SYS_EPOLL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <poll.h>
+
+#if !defined(CONFIG_DISABLE_POLL) && CONFIG_NFILE_DESCRIPTORS > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* epoll_ctl() operations */
+
+#define EPOLL_CTL_ADD  1  /* Register interest in a descriptor */
+#define EPOLL_CTL_DEL  2  /* Remove a descriptor from the interest list */
+#define EPOLL_CTL_MOD  3  /* Change the events of a registered descriptor */
+
+/* epoll events.  The low order bits are the same as the poll() events;
+ * the high order bits select how events are reported.
+ *
+ *   EPOLLET
+ *     Edge-triggered.  The descriptor is reported once each time the
+ *     driver posts a new event rather than on every epoll_wait() for as
+ *     long as it remains ready.
+ *   EPOLLONESHOT
+ *     Report the descriptor once, then disable it until it is re-armed
+ *     with EPOLL_CTL_MOD.
+ */
+
+#define EPOLLIN        POLLIN
+#define EPOLLRDNORM    POLLRDNORM
+#define EPOLLRDBAND    POLLRDBAND
+#define EPOLLPRI       POLLPRI
+#define EPOLLOUT       POLLOUT
+#define EPOLLWRNORM    POLLWRNORM
+#define EPOLLWRBAND    POLLWRBAND
+#define EPOLLERR       POLLERR
+#define EPOLLHUP       POLLHUP
+
+#define EPOLLONESHOT   (1u << 30)
+#define EPOLLET        (1u << 31)
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* Caller data returned with each event */
+
+typedef union epoll_data
+{
+  FAR void *ptr;
+  int       fd;
+  uint32_t  u32;
+} epoll_data_t;
+
+struct epoll_event
+{
+  uint32_t     events;  /* Requested events (ctl) or returned events (wait) */
+  epoll_data_t data;    /* Returned unmodified by epoll_wait() */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+EXTERN int  epoll_create(int size);
+EXTERN int  epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev);
+EXTERN int  epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents,
+                       int timeout);
+
+/* The epoll descriptor is an ordinary file descriptor and is released with
+ * close().  epoll_close(epfd) is equivalent to close(epfd).
+ */
+
+EXTERN void epoll_close(int epfd);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* !CONFIG_DISABLE_POLL && CONFIG_NFILE_DESCRIPTORS > 0 */
+#endif /* __INCLUDE_SYS_EPOLL_H */
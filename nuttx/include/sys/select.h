@@ -76,7 +76,7 @@
 #elif __SELECT_NDESCRIPTORS <= 256
 #  define __SELECT_NUINT32 8
 #else
-#  warning "Large fd_set needed"
+#  define __SELECT_NUINT32 ((__SELECT_NDESCRIPTORS + 31) >> 5)
 #endif
 
 /* These macros map a file descripto to an index and bit number */
@@ -213,7 +213,15 @@
 #  ifndef CONFIG_DISABLE_POLL
 #    define SYS_poll                   (__SYS_descriptors+4)
 #    define SYS_select                 (__SYS_descriptors+5)
-#    define __SYS_filedesc             (__SYS_descriptors+6)
+#    if CONFIG_NFILE_DESCRIPTORS > 0
+#      define SYS_epoll_close          (__SYS_descriptors+6)
+#      define SYS_epoll_create         (__SYS_descriptors+7)
+#      define SYS_epoll_ctl            (__SYS_descriptors+8)
+#      define SYS_epoll_wait           (__SYS_descriptors+9)
+#      define __SYS_filedesc           (__SYS_descriptors+10)
+#    else
+#      define __SYS_filedesc           (__SYS_descriptors+6)
+#    endif
 #  else
 #    define __SYS_filedesc             (__SYS_descriptors+4)
 #  endif
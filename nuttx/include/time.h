@@ -90,6 +90,14 @@
 #  define CLOCK_ACTIVETIME CLOCK_REALTIME
 #endif
 
+/* CLOCK_MONOTONIC is the time since start-up.  It cannot be set and is not
+ * affected by changes to CLOCK_REALTIME.  If CONFIG_CLOCK_HIRES is selected,
+ * it is provided by the architecture's high-resolution clock; otherwise it
+ * has the resolution of the system timer.
+ */
+
+#define CLOCK_MONOTONIC    2
+
 /* This is a flag that may be passed to the timer_settime() function */
 
 #define TIMER_ABSTIME      1
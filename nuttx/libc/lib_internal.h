@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <limits.h>
@@ -119,10 +120,60 @@
 
 #define LIB_BUFLEN_UNKNOWN INT_MAX
 
+/* Word-at-a-time support for the mem*() and str*() functions.  When
+ * CONFIG_STRING_OPTSPEED is selected, these functions operate on naturally
+ * aligned lib_word_t quantities wherever the alignment of their arguments
+ * permits.  Aligned word reads never cross a page or memory region
+ * boundary, so the string functions may safely read a few bytes beyond
+ * the terminating NUL as long as they stay within the same aligned word.
+ */
+
+#ifndef CONFIG_HAVE_LONG_LONG
+#  undef CONFIG_STRING_64BIT
+#endif
+
+#ifdef CONFIG_STRING_OPTSPEED
+#  ifdef CONFIG_STRING_64BIT
+#    define LIB_WORD_ONES     0x0101010101010101ull
+#    define LIB_WORD_HIGHS    0x8080808080808080ull
+#  else
+#    define LIB_WORD_ONES     0x01010101ul
+#    define LIB_WORD_HIGHS    0x80808080ul
+#  endif
+
+#  define LIB_WORD_SIZE       sizeof(lib_word_t)
+#  define LIB_WORD_MASK       (LIB_WORD_SIZE - 1)
+
+   /* True if the address is aligned to a word boundary */
+
+#  define LIB_WORD_ALIGNED(p) (((uintptr_t)(p) & LIB_WORD_MASK) == 0)
+
+   /* True if two addresses have the same alignment within a word */
+
+#  define LIB_WORD_COALIGNED(p1,p2) \
+     ((((uintptr_t)(p1) ^ (uintptr_t)(p2)) & LIB_WORD_MASK) == 0)
+
+   /* Replicate a byte value into every byte of a word */
+
+#  define LIB_WORD_REPEAT(c)  ((lib_word_t)(unsigned char)(c) * LIB_WORD_ONES)
+
+   /* Non-zero if any byte in the word is zero */
+
+#  define LIB_WORD_HASZERO(w) (((w) - LIB_WORD_ONES) & ~(w) & LIB_WORD_HIGHS)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_STRING_OPTSPEED
+#  ifdef CONFIG_STRING_64BIT
+typedef uint64_t lib_word_t;
+#  else
+typedef uint32_t lib_word_t;
+#  endif
+#endif
+
 /****************************************************************************
  * Public Variables
  ****************************************************************************/
@@ -41,6 +41,8 @@
 
 #include <string.h>
 
+#include "lib_internal.h"
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -59,12 +61,48 @@
  *
  ****************************************************************************/
 
+#ifndef CONFIG_ARCH_MEMCHR
 FAR void *memchr(FAR const void *s, int c, size_t n)
 {
   FAR const unsigned char *p = (FAR const unsigned char *)s;
+#ifdef CONFIG_STRING_OPTSPEED
+  FAR const lib_word_t *wp;
+  lib_word_t mask;
+#endif
 
   if (s)
     {
+#ifdef CONFIG_STRING_OPTSPEED
+      /* Search a word at a time once p is word aligned.  A word contains
+       * 'c' if the word XOR'ed with 'c' in every byte contains a zero byte.
+       * The matching byte is then located one byte at a time below.
+       */
+
+      if (n >= 2 * LIB_WORD_SIZE)
+        {
+          while (!LIB_WORD_ALIGNED(p))
+            {
+              if (*p == (unsigned char)c)
+                {
+                  return (FAR void *)p;
+                }
+
+              p++;
+              n--;
+            }
+
+          mask = LIB_WORD_REPEAT(c);
+          wp   = (FAR const lib_word_t *)p;
+          while (n >= LIB_WORD_SIZE && !LIB_WORD_HASZERO(*wp ^ mask))
+            {
+              wp++;
+              n -= LIB_WORD_SIZE;
+            }
+
+          p = (FAR const unsigned char *)wp;
+        }
+#endif
+
       while (n--)
         {
           if (*p == (unsigned char)c)
@@ -78,3 +116,4 @@ FAR void *memchr(FAR const void *s, int c, size_t n)
 
   return NULL;
 }
+#endif
@@ -45,6 +45,8 @@
 #include <sys/types.h>
 #include <string.h>
 
+#include "lib_internal.h"
+
 /************************************************************
  * Global Functions
  ************************************************************/
@@ -55,6 +57,43 @@ int memcmp(FAR const void *s1, FAR const void *s2, size_t n)
   unsigned char *p1 = (unsigned char *)s1;
   unsigned char *p2 = (unsigned char *)s2;
 
+#ifdef CONFIG_STRING_OPTSPEED
+  FAR const lib_word_t *w1;
+  FAR const lib_word_t *w2;
+
+  /* If both buffers have the same alignment, skip over the leading equal
+   * words a word at a time.  The bytes of the first differing word (if
+   * any) are then compared one at a time below.
+   */
+
+  if (n >= 2 * LIB_WORD_SIZE && LIB_WORD_COALIGNED(p1, p2))
+    {
+      while (!LIB_WORD_ALIGNED(p1))
+        {
+          if (*p1 != *p2)
+            {
+              return *p1 < *p2 ? -1 : 1;
+            }
+
+          p1++;
+          p2++;
+          n--;
+        }
+
+      w1 = (FAR const lib_word_t *)p1;
+      w2 = (FAR const lib_word_t *)p2;
+      while (n >= LIB_WORD_SIZE && *w1 == *w2)
+        {
+          w1++;
+          w2++;
+          n -= LIB_WORD_SIZE;
+        }
+
+      p1 = (unsigned char *)w1;
+      p2 = (unsigned char *)w2;
+    }
+#endif
+
   while (n-- > 0)
     {
       if (*p1 < *p2)
@@ -45,6 +45,8 @@
 #include <sys/types.h>
 #include <string.h>
 
+#include "lib_internal.h"
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -58,6 +60,91 @@ FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
 {
   FAR unsigned char *pout = (FAR unsigned char*)dest;
   FAR unsigned char *pin  = (FAR unsigned char*)src;
+#ifdef CONFIG_STRING_OPTSPEED
+  FAR lib_word_t *wout;
+  FAR const lib_word_t *win;
+  lib_word_t prev;
+  lib_word_t next;
+  unsigned int offset;
+  unsigned int lshift;
+  unsigned int rshift;
+
+  /* Copying a word at a time only pays off if there are a few words to
+   * copy.
+   */
+
+  if (n >= 4 * LIB_WORD_SIZE)
+    {
+      /* Copy bytes until the destination is word aligned */
+
+      while (!LIB_WORD_ALIGNED(pout))
+        {
+          *pout++ = *pin++;
+          n--;
+        }
+
+      wout = (FAR lib_word_t *)pout;
+      if (LIB_WORD_ALIGNED(pin))
+        {
+          /* The source is now aligned too.  Copy four words at a time, then
+           * any remaining whole words.
+           */
+
+          win = (FAR const lib_word_t *)pin;
+          while (n >= 4 * LIB_WORD_SIZE)
+            {
+              wout[0] = win[0];
+              wout[1] = win[1];
+              wout[2] = win[2];
+              wout[3] = win[3];
+              wout   += 4;
+              win    += 4;
+              n      -= 4 * LIB_WORD_SIZE;
+            }
+
+          while (n >= LIB_WORD_SIZE)
+            {
+              *wout++ = *win++;
+              n      -= LIB_WORD_SIZE;
+            }
+
+          pin = (FAR unsigned char *)win;
+        }
+      else
+        {
+          /* The source is not aligned the same as the destination.  Read
+           * aligned words from the source and shift them into place.  Each
+           * source word read contains at least one byte that is copied, so
+           * we never read outside of the source buffer's aligned words.
+           */
+
+          offset = (uintptr_t)pin & LIB_WORD_MASK;
+          win    = (FAR const lib_word_t *)(pin - offset);
+          rshift = 8 * offset;
+          lshift = 8 * (LIB_WORD_SIZE - offset);
+          prev   = *win++;
+
+          while (n >= LIB_WORD_SIZE)
+            {
+              next    = *win++;
+#ifdef CONFIG_ENDIAN_BIG
+              *wout++ = (prev << rshift) | (next >> lshift);
+#else
+              *wout++ = (prev >> rshift) | (next << lshift);
+#endif
+              prev    = next;
+              n      -= LIB_WORD_SIZE;
+            }
+
+          pin = (FAR unsigned char *)win - LIB_WORD_SIZE + offset;
+        }
+
+      pout = (FAR unsigned char *)wout;
+    }
+#endif
+
+  /* Copy any remaining bytes */
+
   while (n-- > 0) *pout++ = *pin++;
   return dest;
 }
@@ -45,6 +45,8 @@
 #include <sys/types.h>
 #include <string.h>
 
+#include "lib_internal.h"
+
 /************************************************************
  * Global Functions
  ************************************************************/
@@ -53,22 +55,82 @@
 FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
 {
   char *tmp, *s;
+#ifdef CONFIG_STRING_OPTSPEED
+  FAR lib_word_t *wtmp;
+  FAR const lib_word_t *ws;
+#endif
+
   if (dest <= src)
     {
       tmp = (char*) dest;
       s   = (char*) src;
+
+#ifdef CONFIG_STRING_OPTSPEED
+      /* Copy forward a word at a time if the source and destination have
+       * the same alignment.  Each word is read before the destination
+       * word that may overlap it is written.
+       */
+
+      if (count >= 2 * LIB_WORD_SIZE && LIB_WORD_COALIGNED(tmp, s))
+        {
+          while (!LIB_WORD_ALIGNED(s))
+            {
+              *tmp++ = *s++;
+              count--;
+            }
+
+          wtmp = (FAR lib_word_t *)tmp;
+          ws   = (FAR const lib_word_t *)s;
+          while (count >= LIB_WORD_SIZE)
+            {
+              *wtmp++ = *ws++;
+              count  -= LIB_WORD_SIZE;
+            }
+
+          tmp = (char*)wtmp;
+          s   = (char*)ws;
+        }
+#endif
+
       while (count--)
         {
-	  *tmp++ = *s++;
+          *tmp++ = *s++;
         }
     }
   else
     {
       tmp = (char*) dest + count;
       s   = (char*) src + count;
+
+#ifdef CONFIG_STRING_OPTSPEED
+      /* Copy backward a word at a time if the source and destination have
+       * the same alignment.
+       */
+
+      if (count >= 2 * LIB_WORD_SIZE && LIB_WORD_COALIGNED(tmp, s))
+        {
+          while (!LIB_WORD_ALIGNED(s))
+            {
+              *--tmp = *--s;
+              count--;
+            }
+
+          wtmp = (FAR lib_word_t *)tmp;
+          ws   = (FAR const lib_word_t *)s;
+          while (count >= LIB_WORD_SIZE)
+            {
+              *--wtmp = *--ws;
+              count  -= LIB_WORD_SIZE;
+            }
+
+          tmp = (char*)wtmp;
+          s   = (char*)ws;
+        }
+#endif
+
       while (count--)
         {
-	  *--tmp = *--s;
+          *--tmp = *--s;
         }
     }
 
@@ -51,6 +51,19 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* CONFIG_STRING_OPTSPEED selects the speed-optimized versions of all of
+ * the mem*() and str*() functions, including this one.
+ */
+
+#ifdef CONFIG_STRING_OPTSPEED
+#  undef CONFIG_MEMSET_OPTSPEED
+#  define CONFIG_MEMSET_OPTSPEED 1
+#  ifdef CONFIG_STRING_64BIT
+#    undef CONFIG_MEMSET_64BIT
+#    define CONFIG_MEMSET_64BIT 1
+#  endif
+#endif
+
 /* Can't support CONFIG_MEMSET_64BIT if the platform does not have 64-bit
  * integer types.
  */
@@ -41,6 +41,8 @@
 
 #include <string.h>
 
+#include "lib_internal.h"
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -62,11 +64,48 @@
 #ifndef CONFIG_ARCH_STRCHR
 FAR char *strchr(FAR const char *s, int c)
 {
+#ifdef CONFIG_STRING_OPTSPEED
+  FAR const lib_word_t *wp;
+  lib_word_t mask;
+  lib_word_t w;
+#endif
+
   if (s)
     {
+#ifdef CONFIG_STRING_OPTSPEED
+      /* Check bytes until s is word aligned, then skip whole words that
+       * contain neither 'c' nor the NUL terminator.
+       */
+
+      for (; !LIB_WORD_ALIGNED(s); s++)
+        {
+          if (*s == (char)c)
+            {
+              return (FAR char *)s;
+            }
+
+          if (!*s)
+            {
+              return NULL;
+            }
+        }
+
+      mask = LIB_WORD_REPEAT(c);
+      for (wp = (FAR const lib_word_t *)s; ; wp++)
+        {
+          w = *wp;
+          if (LIB_WORD_HASZERO(w) || LIB_WORD_HASZERO(w ^ mask))
+            {
+              break;
+            }
+        }
+
+      s = (FAR const char *)wp;
+#endif
+
       for (; ; s++)
         {
-          if (*s == c)
+          if (*s == (char)c)
             {
               return (FAR char *)s;
             }
@@ -41,6 +41,8 @@
 
 #include <string.h>
 
+#include "lib_internal.h"
+
 /****************************************************************************
  * Public Functions
  *****************************************************************************/
@@ -49,6 +51,37 @@
 int strcmp(const char *cs, const char *ct)
 {
   register signed char result;
+#ifdef CONFIG_STRING_OPTSPEED
+  FAR const lib_word_t *ws;
+  FAR const lib_word_t *wt;
+
+  /* If both strings have the same alignment, skip over the leading equal
+   * words that do not contain the NUL terminator.
+   */
+
+  if (LIB_WORD_COALIGNED(cs, ct))
+    {
+      for (; !LIB_WORD_ALIGNED(cs); cs++, ct++)
+        {
+          if ((result = *cs - *ct) != 0 || !*cs)
+            {
+              return result;
+            }
+        }
+
+      ws = (FAR const lib_word_t *)cs;
+      wt = (FAR const lib_word_t *)ct;
+      while (*ws == *wt && !LIB_WORD_HASZERO(*ws))
+        {
+          ws++;
+          wt++;
+        }
+
+      cs = (const char *)ws;
+      ct = (const char *)wt;
+    }
+#endif
+
   for (;;)
     {
       if ((result = *cs - *ct++) != 0 || !*cs++)
@@ -41,6 +41,8 @@
 
 #include <string.h>
 
+#include "lib_internal.h"
+
 /************************************************************************
  * Global Functions
  ************************************************************************/
@@ -49,6 +51,36 @@
 char *strcpy(char *dest, const char *src)
 {
   char *tmp = dest;
+#ifdef CONFIG_STRING_OPTSPEED
+  FAR lib_word_t *wdest;
+  FAR const lib_word_t *wsrc;
+
+  /* If the source and destination have the same alignment, copy whole
+   * words until reaching the word that contains the NUL terminator.
+   */
+
+  if (LIB_WORD_COALIGNED(dest, src))
+    {
+      for (; !LIB_WORD_ALIGNED(src); dest++, src++)
+        {
+          if ((*dest = *src) == '\0')
+            {
+              return tmp;
+            }
+        }
+
+      wdest = (FAR lib_word_t *)dest;
+      wsrc  = (FAR const lib_word_t *)src;
+      while (!LIB_WORD_HASZERO(*wsrc))
+        {
+          *wdest++ = *wsrc++;
+        }
+
+      dest = (char *)wdest;
+      src  = (const char *)wsrc;
+    }
+#endif
+
   while ((*dest++ = *src++) != '\0');
   return tmp;
 }
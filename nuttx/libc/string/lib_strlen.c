@@ -41,6 +41,8 @@
 #include <sys/types.h>
 #include <string.h>
 
+#include "lib_internal.h"
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -48,8 +50,27 @@
 #ifndef CONFIG_ARCH_STRLEN
 size_t strlen(const char *s)
 {
-  const char *sc;
-  for (sc = s; *sc != '\0'; ++sc);
+  const char *sc = s;
+#ifdef CONFIG_STRING_OPTSPEED
+  FAR const lib_word_t *wp;
+
+  /* Check bytes until sc is word aligned, then whole words until one
+   * contains the NUL terminator.
+   */
+
+  for (; !LIB_WORD_ALIGNED(sc); ++sc)
+    {
+      if (*sc == '\0')
+        {
+          return sc - s;
+        }
+    }
+
+  for (wp = (FAR const lib_word_t *)sc; !LIB_WORD_HASZERO(*wp); wp++);
+  sc = (const char *)wp;
+#endif
+
+  for (; *sc != '\0'; ++sc);
   return sc - s;
 }
 #endif
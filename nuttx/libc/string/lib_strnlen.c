@@ -48,6 +48,8 @@
 #include <sys/types.h>
 #include <string.h>
 
+#include "lib_internal.h"
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -55,8 +57,30 @@
 #ifndef CONFIG_ARCH_STRNLEN
 size_t strnlen(const char *s, size_t maxlen)
 {
-  const char *sc;
-  for (sc = s; maxlen != 0 && *sc != '\0'; maxlen--, ++sc);
+  const char *sc = s;
+#ifdef CONFIG_STRING_OPTSPEED
+  FAR const lib_word_t *wp;
+
+  /* Check bytes until sc is word aligned, then whole words until one
+   * contains the NUL terminator or fewer than a word remains.
+   */
+
+  for (; maxlen != 0 && !LIB_WORD_ALIGNED(sc); maxlen--, ++sc)
+    {
+      if (*sc == '\0')
+        {
+          return sc - s;
+        }
+    }
+
+  for (wp = (FAR const lib_word_t *)sc;
+       maxlen >= LIB_WORD_SIZE && !LIB_WORD_HASZERO(*wp);
+       maxlen -= LIB_WORD_SIZE, wp++);
+
+  sc = (const char *)wp;
+#endif
+
+  for (; maxlen != 0 && *sc != '\0'; maxlen--, ++sc);
   return sc - s;
 }
 #endif
@@ -93,6 +93,7 @@
 int work_cancel(int qid, FAR struct work_s *work)
 {
   FAR struct wqueue_s *wqueue = &g_work[qid];
+  FAR dq_queue_t *q;
   irqstate_t flags;
 
   DEBUGASSERT(work != NULL && (unsigned)qid < NWORKERS);
@@ -105,17 +106,36 @@ int work_cancel(int qid, FAR struct work_s *work)
   flags = irqsave();
   if (work->worker != NULL)
     {
+      /* Work that is ready to run has a delay of zero and is in the ready-
+       * to-run queue; otherwise, it is still in the delayed work list.  If
+       * it is at the head of the delayed work list, the watchdog timer is
+       * left running.  It will simply find nothing to do when it expires.
+       */
+
+      q = work->delay == 0 ? &wqueue->q : &wqueue->delayed;
+
       /* A little test of the integrity of the work queue */
 
-      DEBUGASSERT(work->dq.flink ||(FAR dq_entry_t *)work == wqueue->q.tail);
-      DEBUGASSERT(work->dq.blink ||(FAR dq_entry_t *)work == wqueue->q.head);
+      DEBUGASSERT(work->dq.flink ||(FAR dq_entry_t *)work == q->tail);
+      DEBUGASSERT(work->dq.blink ||(FAR dq_entry_t *)work == q->head);
 
       /* Remove the entry from the work queue and make sure that it is
        * mark as availalbe (i.e., the worker field is nullified).
        */
 
-      dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+      dq_rem((FAR dq_entry_t *)work, q);
       work->worker = NULL;
+
+#ifdef CONFIG_SCHED_WORKSTATS
+      if (work->delay == 0)
+        {
+          wqueue->stats.nready--;
+        }
+      else
+        {
+          wqueue->stats.ndelayed--;
+        }
+#endif
     }
 
   irqrestore(flags);
@@ -40,7 +40,10 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <signal.h>
+#include <semaphore.h>
 #include <queue.h>
+#include <wdog.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
@@ -71,10 +74,111 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_ready
+ *
+ * Description:
+ *   Add work to the tail of the ready-to-run queue and wake up one worker
+ *   thread.  Must be called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void work_ready(FAR struct wqueue_s *wqueue, FAR struct work_s *work)
+{
+  dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+
+#ifdef CONFIG_SCHED_WORKSTATS
+  if (++wqueue->stats.nready > wqueue->stats.maxready)
+    {
+      wqueue->stats.maxready = wqueue->stats.nready;
+    }
+#endif
+
+  sem_post(&wqueue->sem);
+}
+
+/****************************************************************************
+ * Name: work_timeout
+ *
+ * Description:
+ *   Watchdog timer handler.  Release the delayed work that has expired.
+ *   This runs in the context of the timer interrupt.
+ *
+ ****************************************************************************/
+
+#ifdef WORK_HAVE_WDOG
+static void work_timeout(int argc, uint32_t arg, ...)
+{
+  (void)work_expire((FAR struct wqueue_s *)arg);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_expire
+ *
+ * Description:
+ *   Move all delayed work whose delay has elapsed to the ready-to-run
+ *   queue and, if there is a watchdog timer, restart it for the next
+ *   delayed work.  This is used internally by the work logic and should
+ *   not be called by application logic.  It must be called with
+ *   interrupts disabled.
+ *
+ * Input parameters:
+ *   wqueue - The work queue to be updated
+ *
+ * Returned Value:
+ *   The number of clock ticks until the next delayed work expires or zero
+ *   if there is no delayed work.
+ *
+ ****************************************************************************/
+
+uint32_t work_expire(FAR struct wqueue_s *wqueue)
+{
+  FAR struct work_s *work;
+  uint32_t now = clock_systimer();
+  int32_t remaining;
+
+  /* The delayed work is sorted by expiration time so we only have to look
+   * at the head of the list.
+   */
+
+  while ((work = (FAR struct work_s *)wqueue->delayed.head) != NULL)
+    {
+      remaining = (int32_t)(work->qtime + work->delay - now);
+      if (remaining > 0)
+        {
+          /* This one and all of those that follow it have not yet expired.
+           * Restart the watchdog to release it when it does.
+           */
+
+#ifdef WORK_HAVE_WDOG
+          (void)wd_start(wqueue->wdog, remaining, (wdentry_t)work_timeout,
+                         1, (uint32_t)wqueue);
+#endif
+          return (uint32_t)remaining;
+        }
+
+      /* Move the expired work to the ready-to-run queue.  From here on,
+       * qtime is the time that the work became ready.
+       */
+
+      (void)dq_rem((FAR dq_entry_t *)work, &wqueue->delayed);
+      work->qtime += work->delay;
+      work->delay  = 0;
+
+#ifdef CONFIG_SCHED_WORKSTATS
+      wqueue->stats.ndelayed--;
+#endif
+      work_ready(wqueue, work);
+    }
+
+  return 0;
+}
+
 /****************************************************************************
  * Name: work_queue
  *
@@ -108,7 +212,9 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, uint32_t delay)
 {
   FAR struct wqueue_s *wqueue = &g_work[qid];
+  FAR struct work_s *prev;
   irqstate_t flags;
+  uint32_t expiry;
 
   DEBUGASSERT(work != NULL && (unsigned)qid < NWORKERS);
 
@@ -126,8 +232,76 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
   flags        = irqsave();
   work->qtime  = clock_systimer(); /* Time work queued */
 
-  dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
-  kill(wqueue->pid, SIGWORK);      /* Wake up the worker thread */
+#ifdef CONFIG_SCHED_WORKSTATS
+  wqueue->stats.nqueued++;
+#endif
+
+  if (delay == 0)
+    {
+      /* The work is ready to run now */
+
+      work_ready(wqueue, work);
+    }
+  else
+    {
+#ifdef WORK_HAVE_WDOG
+      /* The watchdog timer is allocated when the first delayed work is
+       * queued.
+       */
+
+      if (wqueue->wdog == NULL)
+        {
+          wqueue->wdog = wd_create();
+          if (wqueue->wdog == NULL)
+            {
+              work->worker = NULL;
+              irqrestore(flags);
+              return -ENOMEM;
+            }
+        }
+#endif
+
+      /* Find the position in the delayed work list.  The list is sorted
+       * by expiration time and work with the same expiration time is kept
+       * in FIFO order.  Search backward from the tail since most new work
+       * will expire after the work that is already queued.
+       */
+
+      expiry = work->qtime + delay;
+      for (prev = (FAR struct work_s *)wqueue->delayed.tail;
+           prev && (int32_t)(prev->qtime + prev->delay - expiry) > 0;
+           prev = (FAR struct work_s *)prev->dq.blink);
+
+      if (prev)
+        {
+          dq_addafter((FAR dq_entry_t *)prev, (FAR dq_entry_t *)work,
+                      &wqueue->delayed);
+        }
+      else
+        {
+          /* The new work expires before any other delayed work.  The
+           * watchdog must be restarted for the new expiration time.
+           */
+
+          dq_addfirst((FAR dq_entry_t *)work, &wqueue->delayed);
+#ifdef WORK_HAVE_WDOG
+          (void)wd_start(wqueue->wdog, delay, (wdentry_t)work_timeout,
+                         1, (uint32_t)wqueue);
+#endif
+        }
+
+#ifdef CONFIG_SCHED_WORKSTATS
+      wqueue->stats.ndelayed++;
+#endif
+    }
+
+#ifndef WORK_HAVE_WDOG
+  /* Without a watchdog timer, the first worker thread keeps the time.
+   * Wake it up so that it can re-evaluate its delay.
+   */
+
+  kill(wqueue->pid[0], SIGWORK);
+#endif
 
   irqrestore(flags);
   return OK;
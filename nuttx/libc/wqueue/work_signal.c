@@ -40,8 +40,10 @@
 #include <nuttx/config.h>
 
 #include <signal.h>
+#include <semaphore.h>
 #include <assert.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/wqueue.h>
 
 #ifdef CONFIG_SCHED_WORKQUEUE
@@ -87,8 +89,35 @@
 
 int work_signal(int qid)
 {
+  FAR struct wqueue_s *wqueue = &g_work[qid];
+  irqstate_t flags;
+  int semcount;
+  int ret = OK;
+
   DEBUGASSERT((unsigned)qid < NWORKERS);
-  return kill(g_work[qid].pid, SIGWORK);
+
+  /* Wake up one worker thread unless one is already due to run.  The
+   * semaphore count is not allowed to grow here since nothing was added
+   * to the queue.
+   */
+
+  flags = irqsave();
+  if (sem_getvalue(&wqueue->sem, &semcount) == OK && semcount <= 0)
+    {
+      ret = sem_post(&wqueue->sem);
+    }
+
+#ifndef WORK_HAVE_WDOG
+  /* The first worker thread may be sleeping until delayed work expires */
+
+  if (ret == OK)
+    {
+      ret = kill(wqueue->pid[0], SIGWORK);
+    }
+#endif
+
+  irqrestore(flags);
+  return ret;
 }
 
 #endif /* CONFIG_SCHED_WORKQUEUE */
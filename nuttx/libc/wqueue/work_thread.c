@@ -41,6 +41,7 @@
 
 #include <stdint.h>
 #include <unistd.h>
+#include <semaphore.h>
 #include <queue.h>
 #include <assert.h>
 #include <errno.h>
@@ -97,6 +98,58 @@ struct wqueue_s g_work[NWORKERS];
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_next
+ *
+ * Description:
+ *   Remove and return the oldest ready work that is not already being
+ *   performed by another worker thread.  A work item may be queued again
+ *   by its own worker function (or by an interrupt handler) while it is
+ *   still running; it must not be started on a second thread until the
+ *   first has finished with it.  Must be called with interrupts disabled.
+ *
+ * Input parameters:
+ *   wqueue - Describes the work queue to be processed
+ *
+ * Returned Value:
+ *   The work to perform or NULL if there is none that can be performed
+ *   now.
+ *
+ ****************************************************************************/
+
+#if WORK_MAXTHREADS > 1
+static FAR struct work_s *work_next(FAR struct wqueue_s *wqueue)
+{
+  FAR struct work_s *work;
+  int i;
+
+  for (work = (FAR struct work_s *)wqueue->q.head;
+       work;
+       work = (FAR struct work_s *)work->dq.flink)
+    {
+      for (i = 0; i < WORK_MAXTHREADS && wqueue->running[i] != work; i++);
+
+      if (i >= WORK_MAXTHREADS)
+        {
+          dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+          return work;
+        }
+    }
+
+  /* All of the ready work (if any) is still being performed by other
+   * worker threads.  The semaphore count that woke us up is given back
+   * when one of them finishes.
+   */
+
+  if (wqueue->q.head)
+    {
+      wqueue->ndeferred++;
+    }
+
+  return NULL;
+}
+#endif
+
 /****************************************************************************
  * Name: work_process
  *
@@ -113,87 +166,126 @@ struct wqueue_s g_work[NWORKERS];
 
 static void work_process(FAR struct wqueue_s *wqueue)
 {
-  volatile FAR struct work_s *work;
+  FAR struct work_s *work;
   worker_t  worker;
   irqstate_t flags;
   FAR void *arg;
-  uint32_t elapsed;
-  uint32_t remaining;
+#if WORK_MAXTHREADS > 1
+  int slot;
+#endif
+#ifdef CONFIG_SCHED_WORKSTATS
+  uint32_t latency;
+#endif
+#ifndef WORK_HAVE_WDOG
   uint32_t next;
+#endif
 
-  /* Then process queued work.  We need to keep interrupts disabled while
-   * we process items in the work list.
+  flags = irqsave();
+
+#ifndef WORK_HAVE_WDOG
+  /* There is no watchdog timer to release the delayed work.  The first
+   * worker thread does that instead:  If there is delayed work but nothing
+   * that is ready to run, then it sleeps until the next delayed work
+   * expires.  It will be awakened early by a signal if new work is queued.
    */
 
-  next  = CONFIG_SCHED_WORKPERIOD / USEC_PER_TICK;
-  flags = irqsave();
-  work  = (FAR struct work_s *)wqueue->q.head;
-  while (work)
+  if (wqueue->pid[0] == getpid())
     {
-      /* Is this work ready?  It is ready if there is no delay or if
-       * the delay has elapsed. qtime is the time that the work was added
-       * to the work queue.  It will always be greater than or equal to
-       * zero.  Therefore a delay of zero will always execute immediately.
-       */
-
-      elapsed = clock_systimer() - work->qtime;
-      if (elapsed >= work->delay)
+      next = work_expire(wqueue);
+      if (next > 0 && wqueue->q.head == NULL)
         {
-          /* Remove the ready-to-execute work from the list */
+          usleep(next * USEC_PER_TICK);
+          irqrestore(flags);
+          return;
+        }
+    }
+#endif
 
-          (void)dq_rem((struct dq_entry_s *)work, &wqueue->q);
+  /* Wait until there is work that is ready to run.  The semaphore is
+   * posted once for each work item that becomes ready.  It may also be
+   * posted by work_signal() or may be left with a surplus count when
+   * ready work is cancelled, so it is not an error if the queue is empty
+   * when we wake up.  The wait may also be interrupted by a signal.
+   */
 
-          /* Extract the work description from the entry (in case the work
-           * instance by the re-used after it has been de-queued).
-           */
+  if (sem_wait(&wqueue->sem) < 0)
+    {
+      DEBUGASSERT(errno == EINTR);
+      irqrestore(flags);
+      return;
+    }
 
-          worker = work->worker;
-          arg    = work->arg;
+  /* Take the oldest ready work from the queue.  Other worker threads
+   * servicing the same queue will take the work that follows it.
+   */
 
-          /* Mark the work as no longer being queued */
+#if WORK_MAXTHREADS > 1
+  work = work_next(wqueue);
+#else
+  work = (FAR struct work_s *)dq_remfirst(&wqueue->q);
+#endif
+  if (work)
+    {
+      /* Extract the work description from the entry (in case the work
+       * instance by the re-used after it has been de-queued).
+       */
 
-          work->worker = NULL;
+      worker = work->worker;
+      arg    = work->arg;
 
-          /* Do the work.  Re-enable interrupts while the work is being
-           * performed... we don't have any idea how long that will take!
-           */
+#ifdef CONFIG_SCHED_WORKSTATS
+      /* qtime is the time that the work became ready to run */
 
-          irqrestore(flags);
-          worker(arg);
+      latency = clock_systimer() - work->qtime;
+      wqueue->stats.nready--;
+      wqueue->stats.nexecuted++;
+      wqueue->stats.totlatency += latency;
+      if (latency > wqueue->stats.maxlatency)
+        {
+          wqueue->stats.maxlatency = latency;
+        }
+#endif
 
-          /* Now, unfortunately, since we re-enabled interrupts we don't
-           * know the state of the work list and we will have to start
-           * back at the head of the list.
-           */
+      /* Mark the work as no longer being queued */
 
-          flags = irqsave();
-          work  = (FAR struct work_s *)wqueue->q.head;
-        }
-      else
-        {
-          /* This one is not ready.. will it be ready before the next
-           * scheduled wakeup interval?
-           */
+      work->worker = NULL;
+
+#if WORK_MAXTHREADS > 1
+      /* Remember that this thread is performing the work.  There is one
+       * slot for each worker thread so a free slot will always be found.
+       */
+
+      for (slot = 0; wqueue->running[slot] != NULL; slot++);
+      wqueue->running[slot] = work;
+#endif
+
+      /* Do the work.  Re-enable interrupts while the work is being
+       * performed... we don't have any idea how long that will take!
+       */
 
-          remaining = elapsed - work->delay;
-          if (remaining < next)
-            {
-              /* Yes.. Then schedule to wake up when the work is ready */
+      irqrestore(flags);
+      worker(arg);
 
-              next = remaining;
-            }
-              
-          /* Then try the next in the list. */
+#if WORK_MAXTHREADS > 1
+      /* The work may now be performed by any thread.  If another thread
+       * found nothing else to do while this work was running, wake one up.
+       * The work structure may have been freed by the worker, so it is not
+       * accessed again.
+       */
 
-          work = (FAR struct work_s *)work->dq.flink;
+      flags = irqsave();
+      wqueue->running[slot] = NULL;
+      if (wqueue->ndeferred > 0)
+        {
+          wqueue->ndeferred--;
+          sem_post(&wqueue->sem);
         }
-    }
 
-  /* Wait awhile to check the work list.  We will wait here until either
-   * the time elapses or until we are awakened by a signal.
-   */
+      irqrestore(flags);
+#endif
+      return;
+    }
 
-  usleep(next * USEC_PER_TICK);
   irqrestore(flags);
 }
 
@@ -250,9 +342,7 @@ int work_hpthread(int argc, char *argv[])
       sched_garbagecollection();
 #endif
 
-      /* Then process queued work.  We need to keep interrupts disabled while
-       * we process items in the work list.
-       */
+      /* Then wait for and process the next queued work */
 
       work_process(&g_work[HPWORK]);
     }
@@ -277,9 +367,7 @@ int work_lpthread(int argc, char *argv[])
 
       sched_garbagecollection();
 
-      /* Then process queued work.  We need to keep interrupts disabled while
-       * we process items in the work list.
-       */
+      /* Then wait for and process the next queued work */
 
       work_process(&g_work[LPWORK]);
     }
@@ -298,9 +386,7 @@ int work_usrthread(int argc, char *argv[])
 
   for (;;)
     {
-      /* Then process queued work.  We need to keep interrupts disabled while
-       * we process items in the work list.
-       */
+      /* Then wait for and process the next queued work */
 
       work_process(&g_work[USRWORK]);
     }
@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <sched.h>
+#include <semaphore.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -75,13 +76,13 @@
  * Name: work_usrstart
  *
  * Description:
- *   Start the user mode work queue.
+ *   Start the user mode work queue worker threads.
  *
  * Input parameters:
  *   None
  *
  * Returned Value:
- *   The task ID of the worker thread is returned on success.  A negated
+ *   The task ID of the first worker thread is returned on success.  A negated
  *   errno value is returned on failure.
  *
  ****************************************************************************/
@@ -89,28 +90,38 @@
 int work_usrstart(void)
 {
   int errcode;
+  int i;
 
-  DEBUGASSERT(g_usrwork[USRWORK] == NULL);
+  DEBUGASSERT(g_usrwork[USRWORK].pid[0] == 0);
 
-  /* Start a user-mode worker thread for use by applications. */
+  /* The worker threads wait on this semaphore for work that is ready to
+   * run.  It must be initialized before the first worker thread starts.
+   */
 
-  svdbg("Starting user-mode worker thread\n");
+  (void)sem_init(&g_usrwork[USRWORK].sem, 0, 0);
+
+  /* Start the user-mode worker threads for use by applications. */
 
-  g_usrwork[USRWORK].pid = TASK_CREATE("usrwork",
-                                       CONFIG_SCHED_USRWORKPRIORITY,
-                                       CONFIG_SCHED_USRWORKSTACKSIZE,
-                                       (main_t)work_usrthread,
-                                       (FAR char * const *)NULL);
+  svdbg("Starting user-mode worker thread\n");
 
-  errcode = errno;
-  ASSERT(g_usrwork[USRWORK].pid > 0);
-  if (g_usrwork[USRWORK].pid < 0)
+  for (i = 0; i < CONFIG_SCHED_USRWORKNTHREADS; i++)
     {
-      sdbg("task_create failed: %d\n", errcode);
-      return -errcode;
+      g_usrwork[USRWORK].pid[i] = TASK_CREATE("usrwork",
+                                              CONFIG_SCHED_USRWORKPRIORITY,
+                                              CONFIG_SCHED_USRWORKSTACKSIZE,
+                                              (main_t)work_usrthread,
+                                              (FAR char * const *)NULL);
+
+      errcode = errno;
+      ASSERT(g_usrwork[USRWORK].pid[i] > 0);
+      if (g_usrwork[USRWORK].pid[i] < 0)
+        {
+          sdbg("task_create failed: %d\n", errcode);
+          return -errcode;
+        }
     }
 
-  return g_usrwork[USRWORK].pid;
+  return g_usrwork[USRWORK].pid[0];
 }
 
 #endif /* CONFIG_SCHED_WORKQUEUE && CONFIG_SCHED_USRWORK */
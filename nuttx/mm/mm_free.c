@@ -68,8 +68,6 @@ static inline
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 {
   FAR struct mm_freenode_s *node;
-  FAR struct mm_freenode_s *prev;
-  FAR struct mm_freenode_s *next;
 
   mvdbg("Freeing %p\n", mem);
 
@@ -80,77 +78,27 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
       return;
     }
 
-  /* We need to hold the MM semaphore while we muck with the
-   * nodelist.
-   */
-
-  mm_takesemaphore(heap);
-
   /* Map the memory chunk into a free node */
 
   node = (FAR struct mm_freenode_s *)((char*)mem - SIZEOF_MM_ALLOCNODE);
-  node->preceding &= ~MM_ALLOC_BIT;
-
-  /* Check if the following node is free and, if so, merge it */
-
-  next = (FAR struct mm_freenode_s *)((char*)node + node->size);
-  if ((next->preceding & MM_ALLOC_BIT) == 0)
-    {
-      FAR struct mm_allocnode_s *andbeyond;
-
-      /* Get the node following the next node (which will
-       * become the new next node). We know that we can never
-       * index past the tail chunk because it is always allocated.
-       */
-
-      andbeyond = (FAR struct mm_allocnode_s*)((char*)next + next->size);
-
-      /* Remove the next node.  There must be a predecessor,
-       * but there may not be a successor node.
-       */
-
-      DEBUGASSERT(next->blink);
-      next->blink->flink = next->flink;
-      if (next->flink)
-        {
-          next->flink->blink = next->blink;
-        }
-
-      /* Then merge the two chunks */
 
-      node->size          += next->size;
-      andbeyond->preceding =  node->size | (andbeyond->preceding & MM_ALLOC_BIT);
-      next                 = (FAR struct mm_freenode_s *)andbeyond;
-    }
-
-  /* Check if the preceding node is also free and, if so, merge
-   * it with this node
+#ifdef CONFIG_MM_SMALLOBJ
+  /* Small chunks are parked in the small-object free lists (if there is
+   * room) without touching the nodelist.
    */
 
-  prev = (FAR struct mm_freenode_s *)((char*)node - node->preceding);
-  if ((prev->preceding & MM_ALLOC_BIT) == 0)
+  if (mm_smallobj_free(heap, (FAR struct mm_allocnode_s *)node))
     {
-      /* Remove the node.  There must be a predecessor, but there may
-       * not be a successor node.
-       */
-
-      DEBUGASSERT(prev->blink);
-      prev->blink->flink = prev->flink;
-      if (prev->flink)
-        {
-          prev->flink->blink = prev->blink;
-        }
-
-      /* Then merge the two chunks */
-
-      prev->size     += node->size;
-      next->preceding = prev->size | (next->preceding & MM_ALLOC_BIT);
-      node            = prev;
+      return;
     }
+#endif
 
-  /* Add the merged node to the nodelist */
+  /* We need to hold the MM semaphore while we muck with the
+   * nodelist.
+   */
 
-  mm_addfreechunk(heap, node);
+  mm_takesemaphore(heap);
+  mm_freechunk(heap, node);
   mm_givesemaphore(heap);
 }
 
@@ -170,6 +118,15 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 #if !defined(CONFIG_NUTTX_KERNEL) || !defined(__KERNEL__)
 void free(FAR void *mem)
 {
+#ifdef CONFIG_MM_TASKCACHE
+  /* Keep the chunk in the running task's allocation cache if possible */
+
+  if (mem && mm_taskcache_free(mem))
+    {
+      return;
+    }
+#endif
+
   mm_free(&g_mmheap, mem);
 }
 #endif
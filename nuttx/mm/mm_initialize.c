@@ -189,6 +189,12 @@ void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart,
   heap->mm_nregions = 0;
 #endif
 
+#ifdef CONFIG_MM_SMALLOBJ
+  /* Initialize the small-object free lists */
+
+  mm_smallobj_initialize(heap);
+#endif
+
   /* Initialize the node array */
 
   memset(heap->mm_nodelist, 0, sizeof(struct mm_freenode_s) * MM_NNODES);
@@ -130,6 +130,11 @@ int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
   info->mxordblk = mxordblk;
   info->uordblks = uordblks;
   info->fordblks = fordblks;
+#ifdef CONFIG_MM_SMALLOBJ
+  info->smcached = heap->mm_smcached;
+  info->smhits   = heap->mm_smhits;
+  info->smmisses = heap->mm_smmisses;
+#endif
   return OK;
 }
 
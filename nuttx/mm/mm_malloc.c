@@ -102,6 +102,21 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   size = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
 
+#ifdef CONFIG_MM_SMALLOBJ
+  /* Small requests are first tried against the small-object free list for
+   * their size class.  This does not require the MM semaphore.
+   */
+
+  if (size <= MM_SMALLOBJ_MAXCHUNK)
+    {
+      ret = mm_smallobj_alloc(heap, size);
+      if (ret)
+        {
+          return ret;
+        }
+    }
+#endif
+
   /* We need to hold the MM semaphore while we muck with the nodelist. */
 
   mm_takesemaphore(heap);
@@ -130,6 +145,19 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
        node && node->size < size;
        node = node->flink);
 
+#ifdef CONFIG_MM_SMALLOBJ
+  /* If nothing was found, then return the chunks parked in the small-object
+   * free lists to the heap (where they may coalesce) and search again.
+   */
+
+  if (!node && mm_smallobj_release(heap) > 0)
+    {
+      for (node = heap->mm_nodelist[ndx].flink;
+           node && node->size < size;
+           node = node->flink);
+    }
+#endif
+
   /* If we found a node with non-zero size, then this is one to use. Since
    * the list is ordered, we know that is must be best fitting chunk
    * available.
@@ -231,6 +259,16 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 #if !defined(CONFIG_NUTTX_KERNEL) || !defined(__KERNEL__)
 FAR void *malloc(size_t size)
 {
+#ifdef CONFIG_MM_TASKCACHE
+  /* Try the running task's allocation cache first */
+
+  FAR void *mem = mm_taskcache_alloc(size);
+  if (mem)
+    {
+      return mem;
+    }
+#endif
+
   return mm_malloc(&g_mmheap, size);
 }
 #endif
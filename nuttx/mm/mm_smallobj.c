@@ -0,0 +1,222 @@
+/****************************************************************************
+ * mm/mm_smallobj.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <arch/irq.h>
+#include <nuttx/mm.h>
+
+#ifdef CONFIG_MM_SMALLOBJ
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Global Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_smallobj_initialize
+ *
+ * Description:
+ *   Initialize the small-object free lists of the selected heap.
+ *
+ ****************************************************************************/
+
+void mm_smallobj_initialize(FAR struct mm_heap_s *heap)
+{
+  memset(heap->mm_smfree, 0, sizeof(heap->mm_smfree));
+  memset(heap->mm_smcount, 0, sizeof(heap->mm_smcount));
+
+  heap->mm_smcached = 0;
+  heap->mm_smhits   = 0;
+  heap->mm_smmisses = 0;
+}
+
+/****************************************************************************
+ * Name: mm_smallobj_alloc
+ *
+ * Description:
+ *   Try to satisfy an allocation from the small-object free list for its
+ *   size class.  'size' is the aligned chunk size (including the chunk
+ *   header) and must not exceed MM_SMALLOBJ_MAXCHUNK.
+ *
+ * Returned Value:
+ *   A pointer to the allocated memory on success; NULL if the size class
+ *   is empty.  In that case, the caller must fall back to the main heap.
+ *
+ ****************************************************************************/
+
+FAR void *mm_smallobj_alloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct mm_smallnode_s *node;
+  irqstate_t flags;
+  int ndx;
+
+  DEBUGASSERT(size >= MM_MIN_CHUNK && size <= MM_SMALLOBJ_MAXCHUNK);
+  ndx = MM_SMALLOBJ_NDX(size);
+
+  flags = irqsave();
+  node  = heap->mm_smfree[ndx];
+  if (node)
+    {
+      heap->mm_smfree[ndx] = node->flink;
+      heap->mm_smcount[ndx]--;
+      heap->mm_smcached -= size;
+      heap->mm_smhits++;
+    }
+  else
+    {
+      heap->mm_smmisses++;
+    }
+
+  irqrestore(flags);
+
+  if (!node)
+    {
+      return NULL;
+    }
+
+  mvdbg("Allocated %p, size %d\n",
+        (FAR char *)node + SIZEOF_MM_ALLOCNODE, size);
+  return (FAR void *)((FAR char *)node + SIZEOF_MM_ALLOCNODE);
+}
+
+/****************************************************************************
+ * Name: mm_smallobj_free
+ *
+ * Description:
+ *   Park a chunk in the small-object free list for its size class.  The
+ *   chunk remains marked as allocated in the main heap.
+ *
+ * Returned Value:
+ *   true if the chunk was taken; false if the chunk is too large or the
+ *   size class is already full.  In that case, the caller must return the
+ *   chunk to the main heap.
+ *
+ ****************************************************************************/
+
+bool mm_smallobj_free(FAR struct mm_heap_s *heap,
+                      FAR struct mm_allocnode_s *node)
+{
+  FAR struct mm_smallnode_s *small = (FAR struct mm_smallnode_s *)node;
+  irqstate_t flags;
+  bool ret = false;
+  int ndx;
+
+  if (node->size > MM_SMALLOBJ_MAXCHUNK)
+    {
+      return false;
+    }
+
+  ndx = MM_SMALLOBJ_NDX(node->size);
+
+  flags = irqsave();
+  if (heap->mm_smcount[ndx] < CONFIG_MM_SMALLOBJ_DEPTH)
+    {
+      small->flink         = heap->mm_smfree[ndx];
+      heap->mm_smfree[ndx] = small;
+      heap->mm_smcount[ndx]++;
+      heap->mm_smcached   += node->size;
+      ret                  = true;
+    }
+
+  irqrestore(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_smallobj_release
+ *
+ * Description:
+ *   Return every chunk held in the small-object free lists to the main
+ *   heap.  This is done when the main heap cannot satisfy a request so that
+ *   the parked chunks can be coalesced with their neighbors.  It is assumed
+ *   that the caller holds the mm semaphore.
+ *
+ * Returned Value:
+ *   The number of chunks that were returned to the main heap.
+ *
+ ****************************************************************************/
+
+int mm_smallobj_release(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_smallnode_s *node;
+  FAR struct mm_smallnode_s *next;
+  irqstate_t flags;
+  int nreleased = 0;
+  int ndx;
+
+  for (ndx = 0; ndx < MM_SMALLOBJ_NCLASSES; ndx++)
+    {
+      /* Detach the whole list with interrupts disabled ... */
+
+      flags = irqsave();
+      node  = heap->mm_smfree[ndx];
+      heap->mm_smfree[ndx]  = NULL;
+      heap->mm_smcached    -= (size_t)heap->mm_smcount[ndx] *
+                              ((ndx + 1) << MM_MIN_SHIFT);
+      heap->mm_smcount[ndx] = 0;
+      irqrestore(flags);
+
+      /* ... then free each chunk back into the nodelist */
+
+      for (; node; node = next)
+        {
+          next = node->flink;
+          mm_freechunk(heap, (FAR struct mm_freenode_s *)node);
+          nreleased++;
+        }
+    }
+
+  mvdbg("Released %d small chunks\n", nreleased);
+  return nreleased;
+}
+
+#endif /* CONFIG_MM_SMALLOBJ */
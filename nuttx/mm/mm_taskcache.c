@@ -0,0 +1,220 @@
+/****************************************************************************
+ * mm/mm_taskcache.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/mm.h>
+
+#ifdef CONFIG_MM_TASKCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_taskcache
+ *
+ * Description:
+ *   Return the allocation cache of the running task or NULL if the cache
+ *   cannot be used in this context (interrupt handlers, exiting tasks).
+ *
+ ****************************************************************************/
+
+static inline FAR struct mm_taskcache_s *mm_taskcache(void)
+{
+  FAR struct tcb_s *tcb;
+
+  if (up_interrupt_context())
+    {
+      return NULL;
+    }
+
+  tcb = sched_self();
+  if (!tcb || tcb->mmcache.mc_closed)
+    {
+      return NULL;
+    }
+
+  return &tcb->mmcache;
+}
+
+/****************************************************************************
+ * Global Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_taskcache_alloc
+ *
+ * Description:
+ *   Try to satisfy a user heap allocation from the running task's cache.
+ *
+ * Returned Value:
+ *   A pointer to the allocated memory on success; NULL if the request is
+ *   too large or the cache holds no chunk of that size.  In that case, the
+ *   caller must fall back to the heap.
+ *
+ ****************************************************************************/
+
+FAR void *mm_taskcache_alloc(size_t size)
+{
+  FAR struct mm_taskcache_s *cache;
+  FAR struct mm_smallnode_s *node;
+  int ndx;
+
+  if (size == 0 || size > CONFIG_MM_TASKCACHE_MAXSIZE)
+    {
+      return NULL;
+    }
+
+  cache = mm_taskcache();
+  if (!cache)
+    {
+      return NULL;
+    }
+
+  size = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
+  ndx  = MM_TASKCACHE_NDX(size);
+
+  node = cache->mc_free[ndx];
+  if (!node)
+    {
+      cache->mc_misses++;
+      return NULL;
+    }
+
+  cache->mc_free[ndx] = node->flink;
+  cache->mc_count[ndx]--;
+  cache->mc_cached   -= size;
+  cache->mc_hits++;
+
+  return (FAR void *)((FAR char *)node + SIZEOF_MM_ALLOCNODE);
+}
+
+/****************************************************************************
+ * Name: mm_taskcache_free
+ *
+ * Description:
+ *   Try to keep a freed user heap chunk in the running task's cache.  The
+ *   chunk remains marked as allocated in the heap.
+ *
+ * Returned Value:
+ *   true if the chunk was taken; false if the chunk is too large or its
+ *   size class is full.  In that case, the caller must return the chunk to
+ *   the heap.
+ *
+ ****************************************************************************/
+
+bool mm_taskcache_free(FAR void *mem)
+{
+  FAR struct mm_taskcache_s *cache;
+  FAR struct mm_smallnode_s *node;
+  int ndx;
+
+  node = (FAR struct mm_smallnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+  if (node->size > MM_TASKCACHE_MAXCHUNK)
+    {
+      return false;
+    }
+
+  cache = mm_taskcache();
+  if (!cache)
+    {
+      return false;
+    }
+
+  ndx = MM_TASKCACHE_NDX(node->size);
+  if (cache->mc_count[ndx] >= CONFIG_MM_TASKCACHE_DEPTH)
+    {
+      return false;
+    }
+
+  node->flink         = cache->mc_free[ndx];
+  cache->mc_free[ndx] = node;
+  cache->mc_count[ndx]++;
+  cache->mc_cached   += node->size;
+  cache->mc_frees++;
+  return true;
+}
+
+/****************************************************************************
+ * Name: mm_taskcache_remove
+ *
+ * Description:
+ *   Close the cache of an exiting task and remove one chunk from it.  This
+ *   is called repeatedly from task_exithook() until it returns NULL; the
+ *   caller is responsible for returning each chunk to the heap.  Since the
+ *   cache is closed, chunks freed by the exiting task are no longer cached.
+ *
+ ****************************************************************************/
+
+FAR void *mm_taskcache_remove(FAR struct tcb_s *tcb)
+{
+  FAR struct mm_taskcache_s *cache = &tcb->mmcache;
+  FAR struct mm_smallnode_s *node;
+  int ndx;
+
+  cache->mc_closed = true;
+
+  for (ndx = 0; ndx < MM_TASKCACHE_NCLASSES; ndx++)
+    {
+      node = cache->mc_free[ndx];
+      if (node)
+        {
+          cache->mc_free[ndx] = node->flink;
+          cache->mc_count[ndx]--;
+          cache->mc_cached   -= node->size;
+          return (FAR void *)((FAR char *)node + SIZEOF_MM_ALLOCNODE);
+        }
+    }
+
+  return NULL;
+}
+
+#endif /* CONFIG_MM_TASKCACHE */
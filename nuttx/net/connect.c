@@ -235,9 +235,14 @@ static uint16_t tcp_connect_interrupt(struct uip_driver_s *dev, void *pvconn,
 
       nllvdbg("Resuming: %d\n", pstate->tc_result);
 
-      /* Stop further callbacks */
+      /* Stop further callbacks.  The callback structure is freed by
+       * tcp_connect() when the waiting thread resumes; freeing it here too
+       * would put it on the free list twice.
+       */
 
-      tcp_teardown_callbacks(pstate, pstate->tc_result);
+      pstate->tc_cb->flags   = 0;
+      pstate->tc_cb->priv    = NULL;
+      pstate->tc_cb->event   = NULL;
 
       /* Wake up the waiting thread */
 
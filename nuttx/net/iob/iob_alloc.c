@@ -0,0 +1,139 @@
+/****************************************************************************
+ * net/iob/iob_alloc.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#ifdef CONFIG_NET_IOB
+
+#include <semaphore.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <arch/irq.h>
+#include <nuttx/net/iob.h>
+
+#include "iob.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_takefree
+ *
+ * Description:
+ *   Remove a buffer from the free list and initialize it.  The caller has
+ *   already taken a count from g_iob_sem.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_takefree(void)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  flags          = irqsave();
+  iob            = g_iob_freelist;
+  DEBUGASSERT(iob != NULL);
+  g_iob_freelist = iob->io_flink;
+  irqrestore(flags);
+
+  iob->io_node.flink = NULL;
+  iob->io_flink      = NULL;
+  iob->io_crefs      = 1;
+  iob->io_len        = 0;
+  iob->io_offset     = 0;
+  iob->io_pktlen     = 0;
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_alloc
+ *
+ * Description:
+ *   Allocate an I/O buffer, waiting for one to be freed if necessary.  This
+ *   function may not be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc(void)
+{
+  /* Take a count on the semaphore, waiting if no buffer is free.  The wait
+   * is restarted if it is interrupted by a signal.
+   */
+
+  while (sem_wait(&g_iob_sem) < 0)
+    {
+      DEBUGASSERT(errno == EINTR);
+    }
+
+  return iob_takefree();
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc
+ *
+ * Description:
+ *   Allocate an I/O buffer without waiting.  NULL is returned if no buffer
+ *   is available.  This function may be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc(void)
+{
+  irqstate_t flags;
+
+  /* sem_trywait() may not be called from interrupt handlers so the count
+   * is taken directly with interrupts disabled.
+   */
+
+  flags = irqsave();
+  if (g_iob_sem.semcount <= 0)
+    {
+      irqrestore(flags);
+      return NULL;
+    }
+
+  g_iob_sem.semcount--;
+  irqrestore(flags);
+
+  return iob_takefree();
+}
+
+#endif /* CONFIG_NET_IOB */
@@ -0,0 +1,177 @@
+/****************************************************************************
+ * net/iob/iob_copyin.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#ifdef CONFIG_NET_IOB
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/net/iob.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_copyin
+ *
+ * Description:
+ *   Copy data from a user buffer into an I/O buffer chain at the given
+ *   offset into the packet, extending the chain with iob_tryalloc() as
+ *   necessary.  Returns the number of bytes copied or -ENOMEM if the chain
+ *   could not be extended (the chain is left unchanged in length).
+ *
+ ****************************************************************************/
+
+int iob_copyin(FAR struct iob_s *iob, FAR const uint8_t *src,
+               unsigned int len, unsigned int offset)
+{
+  FAR struct iob_s *head = iob;
+  FAR struct iob_s *tail;
+  FAR struct iob_s *next;
+  unsigned int remaining;
+  unsigned int tailroom;
+  unsigned int extra;
+  unsigned int span;
+  unsigned int ncopy;
+  int nalloc;
+
+  DEBUGASSERT(iob != NULL && src != NULL);
+
+  /* Data may overwrite or extend the packet, but there may be no holes */
+
+  if (offset > iob->io_pktlen)
+    {
+      return -EINVAL;
+    }
+
+  /* Find the last buffer in the chain and the free space that follows its
+   * data.
+   */
+
+  for (tail = iob; tail->io_flink; tail = tail->io_flink);
+  tailroom = CONFIG_IOB_BUFSIZE - (tail->io_offset + tail->io_len);
+
+  /* Allocate all of the buffers needed to extend the packet before copying
+   * anything so that a failure leaves the chain unchanged.
+   */
+
+  extra = 0;
+  if (offset + len > iob->io_pktlen)
+    {
+      extra = offset + len - iob->io_pktlen;
+    }
+
+  if (extra > tailroom)
+    {
+      nalloc = (extra - tailroom + CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE;
+      next   = tail;
+
+      while (nalloc-- > 0)
+        {
+          next->io_flink = iob_tryalloc();
+          if (!next->io_flink)
+            {
+              iob_free_chain(tail->io_flink);
+              tail->io_flink = NULL;
+              return -ENOMEM;
+            }
+
+          next = next->io_flink;
+        }
+    }
+
+  /* Now copy the data.  A buffer followed by buffers containing data can
+   * only be overwritten;  the last buffer with data (and the empty buffers
+   * just added) can also be extended up to the end of io_data[].
+   */
+
+  remaining = len;
+  while (remaining > 0)
+    {
+      DEBUGASSERT(iob != NULL);
+
+      next = iob->io_flink;
+      if (next && next->io_len > 0)
+        {
+          span = iob->io_len;
+        }
+      else
+        {
+          span = CONFIG_IOB_BUFSIZE - iob->io_offset;
+        }
+
+      if (offset < span)
+        {
+          ncopy = MIN(span - offset, remaining);
+          memcpy(&iob->io_data[iob->io_offset + offset], src, ncopy);
+
+          if (offset + ncopy > iob->io_len)
+            {
+              head->io_pktlen += offset + ncopy - iob->io_len;
+              iob->io_len      = offset + ncopy;
+            }
+
+          src       += ncopy;
+          remaining -= ncopy;
+          offset     = 0;
+        }
+      else
+        {
+          offset -= iob->io_len;
+        }
+
+      iob = next;
+    }
+
+  return len;
+}
+
+#endif /* CONFIG_NET_IOB */
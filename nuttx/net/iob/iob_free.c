@@ -0,0 +1,130 @@
+/****************************************************************************
+ * net/iob/iob_free.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#ifdef CONFIG_NET_IOB
+
+#include <semaphore.h>
+#include <assert.h>
+
+#include <arch/irq.h>
+#include <nuttx/net/iob.h>
+
+#include "iob.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_addref
+ *
+ * Description:
+ *   Add a reference to each I/O buffer in a chain.  Each reference must be
+ *   released with iob_free() or iob_free_chain() before the buffers are
+ *   returned to the free pool.  Buffers with more than one reference should
+ *   be treated as read-only.
+ *
+ ****************************************************************************/
+
+void iob_addref(FAR struct iob_s *iob)
+{
+  irqstate_t flags;
+
+  flags = irqsave();
+  for (; iob; iob = iob->io_flink)
+    {
+      DEBUGASSERT(iob->io_crefs < UINT8_MAX);
+      iob->io_crefs++;
+    }
+
+  irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: iob_free
+ *
+ * Description:
+ *   Release a reference to one I/O buffer and return the buffer to the free
+ *   pool when no references remain.  Returns the next buffer in the chain.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next = iob->io_flink;
+  irqstate_t flags;
+
+  flags = irqsave();
+  DEBUGASSERT(iob->io_crefs > 0);
+  if (--iob->io_crefs == 0)
+    {
+      iob->io_flink  = g_iob_freelist;
+      g_iob_freelist = iob;
+      irqrestore(flags);
+
+      /* Wake up any thread waiting for a free buffer */
+
+      sem_post(&g_iob_sem);
+    }
+  else
+    {
+      irqrestore(flags);
+    }
+
+  return next;
+}
+
+/****************************************************************************
+ * Name: iob_free_chain
+ *
+ * Description:
+ *   Release a reference to every I/O buffer in a chain.
+ *
+ ****************************************************************************/
+
+void iob_free_chain(FAR struct iob_s *iob)
+{
+  while (iob)
+    {
+      iob = iob_free(iob);
+    }
+}
+
+#endif /* CONFIG_NET_IOB */
@@ -0,0 +1,95 @@
+/****************************************************************************
+ * net/iob/iob_initialize.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#ifdef CONFIG_NET_IOB
+
+#include <semaphore.h>
+
+#include <nuttx/net/iob.h>
+
+#include "iob.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* This is a pool of pre-allocated I/O buffers */
+
+static struct iob_s g_iob_pool[CONFIG_IOB_NBUFFERS];
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* A list of all free, unallocated I/O buffers */
+
+FAR struct iob_s *g_iob_freelist;
+
+/* Counts the number of free I/O buffers */
+
+sem_t g_iob_sem;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_initialize
+ *
+ * Description:
+ *   Set up the I/O buffers for normal operations.
+ *
+ ****************************************************************************/
+
+void iob_initialize(void)
+{
+  int i;
+
+  g_iob_freelist = NULL;
+  for (i = 0; i < CONFIG_IOB_NBUFFERS; i++)
+    {
+      g_iob_pool[i].io_flink = g_iob_freelist;
+      g_iob_freelist         = &g_iob_pool[i];
+    }
+
+  sem_init(&g_iob_sem, 0, CONFIG_IOB_NBUFFERS);
+}
+
+#endif /* CONFIG_NET_IOB */
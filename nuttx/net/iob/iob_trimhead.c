@@ -0,0 +1,100 @@
+/****************************************************************************
+ * net/iob/iob_trimhead.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#ifdef CONFIG_NET_IOB
+
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/net/iob.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_trimhead
+ *
+ * Description:
+ *   Remove bytes from the beginning of an I/O buffer chain, freeing the
+ *   buffers that become empty.  Returns the new head of the chain which
+ *   is NULL if all of the data was removed.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_trimhead(FAR struct iob_s *iob, unsigned int trimlen)
+{
+  unsigned int pktlen;
+
+  DEBUGASSERT(iob != NULL);
+  pktlen = iob->io_pktlen;
+
+  while (iob && trimlen > 0)
+    {
+      if (trimlen >= iob->io_len)
+        {
+          /* Remove the entire buffer from the head of the chain */
+
+          trimlen -= iob->io_len;
+          pktlen  -= iob->io_len;
+          iob      = iob_free(iob);
+        }
+      else
+        {
+          /* Remove only the leading part of the data in this buffer */
+
+          iob->io_offset += trimlen;
+          iob->io_len    -= trimlen;
+          pktlen         -= trimlen;
+          trimlen         = 0;
+        }
+    }
+
+  /* The packet length is kept only in the new head of the chain */
+
+  if (iob)
+    {
+      iob->io_pktlen = pktlen;
+    }
+
+  return iob;
+}
+
+#endif /* CONFIG_NET_IOB */
@@ -44,9 +44,11 @@
 #include <sys/socket.h>
 #include <stdint.h>
 #include <errno.h>
+#include <assert.h>
 #include <debug.h>
 
 #include <arch/irq.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/uip/uip-arch.h>
 
 #include "net_internal.h"
@@ -103,6 +105,17 @@ static uint16_t netclose_interrupt(FAR struct uip_driver_s *dev,
 
       flags = 0;
     }
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+  else if (!sq_empty(&conn->write_q) || !sq_empty(&conn->unacked_q))
+    {
+      /* Do not send the FIN until all of the buffered data has been sent
+       * and acknowledged.  Drop data received in this state.
+       */
+
+      dev->d_len = 0;
+      flags &= ~UIP_NEWDATA;
+    }
+#endif
   else
     {
       /* Drop data received in this state and make sure that UIP_CLOSE
@@ -146,9 +159,16 @@ static inline void netclose_disconnect(FAR struct socket *psock)
   flags = uip_lock();
   conn = (struct uip_conn*)psock->s_conn;
 
-  /* There shouldn't be any callbacks registered */
+  /* There shouldn't be any callbacks registered other than the one that
+   * drains the write buffers.
+   */
 
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+  DEBUGASSERT(conn->list == NULL ||
+              (conn->list == conn->sndcb && conn->sndcb->flink == NULL));
+#else
   DEBUGASSERT(conn->list == NULL);
+#endif
 
   /* Check for the case where the host beat us and disconnected first */
 
@@ -205,6 +225,10 @@ int psock_close(FAR struct socket *psock)
       goto errout;
     }
 
+  /* Drop any epoll registrations of the socket before it goes away */
+
+  epoll_release(psock);
+
   /* We perform the uIP close operation only if this is the last count on the socket.
    * (actually, I think the socket crefs only takes the values 0 and 1 right now).
    */
@@ -385,7 +385,7 @@ static inline int net_pollteardown(FAR struct socket *psock,
  ****************************************************************************/
 
 /****************************************************************************
- * Function: net_poll
+ * Function: psock_poll
  *
  * Description:
  *   The standard poll() operation redirects operations on socket descriptors
@@ -402,9 +402,12 @@ static inline int net_pollteardown(FAR struct socket *psock,
  *
  ****************************************************************************/
 
-#if !defined(CONFIG_DISABLE_POLL) && defined(HAVE_NETPOLL)
+#ifndef CONFIG_DISABLE_POLL
 int psock_poll(FAR struct socket *psock, FAR struct pollfd *fds, bool setup)
 {
+#ifndef HAVE_NETPOLL
+  return -ENOSYS;
+#else
   int ret;
 
 #ifdef CONFIG_NET_UDP
@@ -432,8 +435,9 @@ int psock_poll(FAR struct socket *psock, FAR struct pollfd *fds, bool setup)
     }
 
   return ret;
+#endif /* HAVE_NETPOLL */
 }
-#endif
+#endif /* !CONFIG_DISABLE_POLL */
 
 /****************************************************************************
  * Function: net_poll
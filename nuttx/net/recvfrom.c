@@ -51,6 +51,7 @@
 #include <arch/irq.h>
 #include <nuttx/clock.h>
 #include <nuttx/net/uip/uip-arch.h>
+#include <nuttx/net/iob.h>
 
 #include "net_internal.h"
 #include "uip/uip_internal.h"
@@ -264,6 +265,52 @@ static inline void recvfrom_newudpdata(FAR struct uip_driver_s *dev,
  ****************************************************************************/
 
 #if defined(CONFIG_NET_TCP) && CONFIG_NET_NTCP_READAHEAD_BUFFERS > 0
+#ifdef CONFIG_NET_IOB
+static inline void recvfrom_readahead(struct recvfrom_s *pstate)
+{
+  FAR struct uip_conn *conn = (FAR struct uip_conn *)pstate->rf_sock->s_conn;
+  FAR struct iob_s    *iob;
+  int                  recvlen;
+
+  /* Check there is any TCP data already buffered in a read-ahead
+   * I/O buffer chain.
+   */
+
+  while (pstate->rf_buflen > 0 &&
+         (iob = (FAR struct iob_s *)sq_remfirst(&conn->readahead)) != NULL)
+    {
+      /* Copy as much of the buffered data as will fit into the user
+       * buffer.
+       */
+
+      recvlen = iob_copyout((FAR uint8_t *)pstate->rf_buffer, iob,
+                            pstate->rf_buflen, 0);
+      nllvdbg("Received %d bytes (of %d)\n", recvlen, iob->io_pktlen);
+
+      /* Update the accumulated size of the data read */
+
+      pstate->rf_recvlen += recvlen;
+      pstate->rf_buffer  += recvlen;
+      pstate->rf_buflen  -= recvlen;
+
+      /* If the chain was only partially consumed, then free only the I/O
+       * buffers that were emptied and return the remainder of the chain to
+       * the front of the list.  No data is moved.
+       */
+
+      if (recvlen < iob->io_pktlen)
+        {
+          iob = iob_trimhead(iob, recvlen);
+          sq_addfirst(&iob->io_node, &conn->readahead);
+        }
+      else
+        {
+          iob_free_chain(iob);
+        }
+    }
+}
+
+#else
 static inline void recvfrom_readahead(struct recvfrom_s *pstate)
 {
   FAR struct uip_conn        *conn = (FAR struct uip_conn *)pstate->rf_sock->s_conn;
@@ -330,6 +377,7 @@ static inline void recvfrom_readahead(struct recvfrom_s *pstate)
     }
   while (readahead && pstate->rf_buflen > 0);
 }
+#endif /* CONFIG_NET_IOB */
 #endif /* CONFIG_NET_UDP || CONFIG_NET_TCP */
 
 /****************************************************************************
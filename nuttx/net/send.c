@@ -46,9 +46,12 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include <time.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <queue.h>
+
 #include <arch/irq.h>
 #include <nuttx/clock.h>
 #include <nuttx/net/uip/uip-arp.h>
@@ -75,6 +78,7 @@
  * Private Types
  ****************************************************************************/
 
+#ifndef CONFIG_NET_TCP_WRITE_BUFFERS
 /* This structure holds the state of the send operation until it can be
  * operated upon from the interrupt level.
  */
@@ -96,6 +100,7 @@ struct send_s
   bool                       snd_odd;     /* True: Odd packet in pair transaction */
 #endif
 };
+#endif /* !CONFIG_NET_TCP_WRITE_BUFFERS */
 
 /****************************************************************************
  * Private Functions
@@ -118,7 +123,8 @@ struct send_s
  *
  ****************************************************************************/
 
-#if defined(CONFIG_NET_SOCKOPTS) && !defined(CONFIG_DISABLE_CLOCK)
+#if defined(CONFIG_NET_SOCKOPTS) && !defined(CONFIG_DISABLE_CLOCK) && \
+   !defined(CONFIG_NET_TCP_WRITE_BUFFERS)
 static inline int send_timeout(FAR struct send_s *pstate)
 {
   FAR struct socket *psock = 0;
@@ -141,6 +147,244 @@ static inline int send_timeout(FAR struct send_s *pstate)
 }
 #endif /* CONFIG_NET_SOCKOPTS && !CONFIG_DISABLE_CLOCK */
 
+/****************************************************************************
+ * Function: send_wrrelease
+ *
+ * Description:
+ *   Release the write buffers at the head of a queue whose data has been
+ *   acknowledged.
+ *
+ * Parameters:
+ *   queue    The queue of write buffers
+ *   ackno    The acknowledgement number received from the peer
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Running at the interrupt level
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+static void send_wrrelease(FAR sq_queue_t *queue, uint32_t ackno)
+{
+  FAR struct uip_wrbuffer_s *wrb;
+
+  while ((wrb = (FAR struct uip_wrbuffer_s *)sq_peek(queue)) != NULL &&
+         (int32_t)(ackno - (wrb->wb_seqno + wrb->wb_nbytes)) >= 0)
+    {
+      (void)sq_remfirst(queue);
+      uip_tcpwrbufferrelease(wrb);
+    }
+}
+
+/****************************************************************************
+ * Function: send_wrinterrupt
+ *
+ * Description:
+ *   This function is called from the interrupt level to send the data in
+ *   the connection's write buffers when polled by the uIP layer.  One
+ *   segment is sent per poll.  Sent buffers are retained until the data is
+ *   acknowledged.  On a retransmission timeout, all unacknowledged buffers
+ *   are sent again starting with the oldest.
+ *
+ *   A buffer is normally sent as one segment.  If nothing is in flight and
+ *   the peer's window is too small for the buffer, then only the part that
+ *   fits is sent.  If the window is closed, one byte is sent as a window
+ *   probe.  Either way, the peer must answer with an ACK that carries its
+ *   current window, so the connection cannot stall on a lost window
+ *   update.  An unanswered probe is retransmitted with the normal backoff.
+ *
+ * Parameters:
+ *   dev      The sructure of the network driver that caused the interrupt
+ *   conn     The connection structure associated with the socket
+ *   flags    Set of events describing why the callback was invoked
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Running at the interrupt level
+ *
+ ****************************************************************************/
+
+static uint16_t send_wrinterrupt(FAR struct uip_driver_s *dev,
+                                 FAR void *pvconn, FAR void *pvpriv,
+                                 uint16_t flags)
+{
+  FAR struct uip_conn *conn = (FAR struct uip_conn*)pvconn;
+  FAR struct uip_wrbuffer_s *wrb;
+  uint32_t inflight;
+  uint32_t win;
+  uint32_t sndlen;
+
+  nllvdbg("flags: %04x sentseq: %08x wrseq: %08x\n",
+          flags, conn->sentseq, conn->wrseq);
+
+  /* If this packet contains an acknowledgement, then release the buffers
+   * holding the acknowledged data.  After a retransmission, acknowledged
+   * data may also be at the head of the write queue.
+   */
+
+  if ((flags & UIP_ACKDATA) != 0)
+    {
+      uint32_t ackno = uip_tcpgetsequence(TCPBUF->ackno);
+
+      if ((int32_t)(ackno - conn->ackseq) > 0)
+        {
+          conn->ackseq = ackno;
+        }
+
+      send_wrrelease(&conn->unacked_q, ackno);
+      send_wrrelease(&conn->write_q, ackno);
+    }
+
+  /* Check if we are being asked to retransmit data */
+
+  else if ((flags & UIP_REXMIT) != 0)
+    {
+      /* Yes.. move all of the unacknowledged buffers back to the head of
+       * the write queue so that they will be sent again in order.
+       */
+
+      wrb = (FAR struct uip_wrbuffer_s *)sq_peek(&conn->write_q);
+      if (wrb != NULL)
+        {
+          wrb->wb_sent = 0;
+        }
+
+      while ((wrb = (FAR struct uip_wrbuffer_s *)sq_remlast(&conn->unacked_q)) != NULL)
+        {
+          wrb->wb_sent = 0;
+          sq_addfirst(&wrb->wb_node, &conn->write_q);
+        }
+
+      /* Resume sending at the first unacknowledged byte.  The buffers that
+       * were fully acknowledged have already been released.
+       */
+
+      wrb = (FAR struct uip_wrbuffer_s *)sq_peek(&conn->write_q);
+      if (wrb != NULL)
+        {
+          if ((int32_t)(conn->ackseq - wrb->wb_seqno) > 0)
+            {
+              wrb->wb_sent = conn->ackseq - wrb->wb_seqno;
+            }
+
+          conn->sentseq = wrb->wb_seqno + wrb->wb_sent;
+        }
+    }
+
+  /* Check for a loss of connection */
+
+  else if ((flags & (UIP_CLOSE|UIP_ABORT|UIP_TIMEDOUT)) != 0)
+    {
+      nllvdbg("Lost connection\n");
+
+      /* Discard all queued data and do not allow any further callbacks */
+
+      while ((wrb = (FAR struct uip_wrbuffer_s *)sq_remfirst(&conn->write_q)) != NULL)
+        {
+          uip_tcpwrbufferrelease(wrb);
+        }
+
+      while ((wrb = (FAR struct uip_wrbuffer_s *)sq_remfirst(&conn->unacked_q)) != NULL)
+        {
+          uip_tcpwrbufferrelease(wrb);
+        }
+
+      conn->sndcb->flags = 0;
+      conn->sndcb->event = NULL;
+      return flags;
+    }
+
+  /* Send the next queued segment if the outgoing packet is available (it
+   * is not if the buffer contains unprocessed incoming data) and if there
+   * is space in the window.
+   */
+
+  wrb = (FAR struct uip_wrbuffer_s *)sq_peek(&conn->write_q);
+  if ((flags & UIP_NEWDATA) == 0 && dev->d_sndlen == 0 && wrb != NULL)
+    {
+      inflight = 0;
+      if ((int32_t)(conn->sentseq - conn->ackseq) > 0)
+        {
+          inflight = conn->sentseq - conn->ackseq;
+        }
+
+      win    = conn->winsize > inflight ? conn->winsize - inflight : 0;
+      sndlen = wrb->wb_nbytes - wrb->wb_sent;
+
+      if (sndlen > win)
+        {
+          /* The rest of the buffer does not fit in the window.  If data is
+           * in flight, its ACK will update the window.  Otherwise, no ACK
+           * is coming:  Send what fits or, if the window is closed, a one
+           * byte probe.
+           */
+
+          if (inflight > 0)
+            {
+              sndlen = 0;
+            }
+          else if (win > 0)
+            {
+              sndlen = win;
+            }
+          else
+            {
+              sndlen = 1;
+            }
+        }
+
+      if (sndlen > 0)
+        {
+          /* Set the sequence number for this packet.  conn->unacked is set
+           * so that sndseq + unacked is the end of this segment once the
+           * segment is sent:  uip_tcpappsend() adds the length of new data
+           * but retransmissions are sent by uip_tcprexmit() directly.
+           */
+
+          uip_tcpsetsequence(conn->sndseq, wrb->wb_seqno + wrb->wb_sent);
+          conn->unacked = (flags & UIP_REXMIT) != 0 ? sndlen : 0;
+
+          /* Then set-up to send the segment.  (this won't actually happen
+           * until the polling cycle completes).
+           */
+
+          uip_send(dev, &wrb->wb_buffer[wrb->wb_sent], sndlen);
+
+          /* If the destination IP address is not in the ARP table, then the
+           * packet will be replaced with an ARP request.  Leave the buffer
+           * unsent in that case.  As in the unbuffered case, the check is
+           * made only for the first segment in flight.
+           */
+
+#if defined(CONFIG_NET_ETHERNET) && !defined(CONFIG_NET_ARP_IPIN)
+          if (inflight > 0 || uip_arp_find(conn->ripaddr) != NULL)
+#endif
+            {
+              wrb->wb_sent += sndlen;
+              conn->sentseq = wrb->wb_seqno + wrb->wb_sent;
+
+              /* The buffer is retained in the unacked queue once all of
+               * its data has been sent.
+               */
+
+              if (wrb->wb_sent >= wrb->wb_nbytes)
+                {
+                  (void)sq_remfirst(&conn->write_q);
+                  sq_addlast(&wrb->wb_node, &conn->unacked_q);
+                }
+            }
+        }
+    }
+
+  return flags;
+}
+#endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
+
 /****************************************************************************
  * Function: send_interrupt
  *
@@ -161,6 +405,7 @@ static inline int send_timeout(FAR struct send_s *pstate)
  *
  ****************************************************************************/
 
+#ifndef CONFIG_NET_TCP_WRITE_BUFFERS
 static uint16_t send_interrupt(FAR struct uip_driver_s *dev, FAR void *pvconn,
                                FAR void *pvpriv, uint16_t flags)
 {
@@ -440,6 +685,7 @@ end_wait:
   sem_post(&pstate->snd_sem);
   return flags;
 }
+#endif /* !CONFIG_NET_TCP_WRITE_BUFFERS */
 
 /****************************************************************************
  * Public Functions
@@ -506,16 +752,31 @@ end_wait:
  *     MSG_NOSIGNAL is set.
  *
  * Assumptions:
+ *   If CONFIG_NET_TCP_WRITE_BUFFERS is selected, the data is copied into
+ *   write buffers and send() returns as soon as all of it has been queued.
+ *   It blocks only while waiting for free write buffers.  That wait is
+ *   limited by SO_SNDTIMEO.
  *
  ****************************************************************************/
 
 ssize_t psock_send(FAR struct socket *psock, FAR const void *buf, size_t len,
                    int flags)
 {
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+  FAR struct uip_conn *conn;
+  FAR struct uip_wrbuffer_s *wrb;
+  FAR struct timespec *timeout = NULL;
+#if defined(CONFIG_NET_SOCKOPTS) && !defined(CONFIG_DISABLE_CLOCK)
+  struct timespec abstime;
+#endif
+  ssize_t result = 0;
+  size_t nbytes;
+#else
   struct send_s state;
+  int ret = OK;
+#endif
   uip_lock_t save;
   int err;
-  int ret = OK;
 
   /* Verify that the sockfd corresponds to valid, allocated socket */
 
@@ -537,6 +798,136 @@ ssize_t psock_send(FAR struct socket *psock, FAR const void *buf, size_t len,
 
   psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_SEND);
 
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+  /* Copy the data into write buffers queued on the connection.  The data
+   * is sent by send_wrinterrupt() when the connection is polled.
+   */
+
+#if defined(CONFIG_NET_SOCKOPTS) && !defined(CONFIG_DISABLE_CLOCK)
+  /* A timeout configured via setsockopts(SO_SNDTIMEO) limits the time
+   * spent waiting for free write buffers.  If none... we will let the send
+   * wait forever.
+   */
+
+  if (psock->s_sndtimeo != 0)
+    {
+      (void)clock_gettime(CLOCK_REALTIME, &abstime);
+      abstime.tv_sec  += psock->s_sndtimeo / DSEC_PER_SEC;
+      abstime.tv_nsec += (psock->s_sndtimeo % DSEC_PER_SEC) * NSEC_PER_DSEC;
+      if (abstime.tv_nsec >= NSEC_PER_SEC)
+        {
+          abstime.tv_sec++;
+          abstime.tv_nsec -= NSEC_PER_SEC;
+        }
+
+      timeout = &abstime;
+    }
+#endif
+
+  save = uip_lock();
+  conn = (FAR struct uip_conn *)psock->s_conn;
+
+  if (len > 0 && conn->sndcb == NULL)
+    {
+      /* This is the first buffered send on this connection.  Set up the
+       * callback that drains the write buffer queues.  It remains in place
+       * until the connection is freed.
+       */
+
+      conn->sndcb = uip_tcpcallbackalloc(conn);
+      if (conn->sndcb == NULL)
+        {
+          result = -ENOMEM;
+        }
+      else
+        {
+          conn->wrseq        = uip_tcpgetsequence(conn->sndseq);
+          conn->sentseq      = conn->wrseq;
+          conn->ackseq       = conn->wrseq;
+
+          conn->sndcb->flags = UIP_ACKDATA|UIP_REXMIT|UIP_POLL|UIP_CLOSE|UIP_ABORT|UIP_TIMEDOUT;
+          conn->sndcb->event = send_wrinterrupt;
+        }
+    }
+
+  while (result >= 0 && (size_t)result < len)
+    {
+      /* Get a free write buffer.  This may wait for queued data to be
+       * acknowledged.
+       */
+
+      wrb = uip_tcpwrbufferalloc(timeout);
+      if (wrb == NULL)
+        {
+          /* Interrupted by a signal or timed out.  Report the error only if
+           * nothing was queued.
+           */
+
+          if (result == 0)
+            {
+              result = -errno;
+            }
+
+          break;
+        }
+
+      /* The connection may have been lost while we waited */
+
+      if ((conn->tcpstateflags & UIP_TS_MASK) != UIP_ESTABLISHED)
+        {
+          uip_tcpwrbufferrelease(wrb);
+          if (result == 0)
+            {
+              result = -ENOTCONN;
+            }
+
+          break;
+        }
+
+      /* Each write buffer is sent as one segment */
+
+      nbytes = len - result;
+      if (nbytes > CONFIG_NET_TCP_WRITE_BUFSIZE)
+        {
+          nbytes = CONFIG_NET_TCP_WRITE_BUFSIZE;
+        }
+
+      if (nbytes > uip_mss(conn))
+        {
+          nbytes = uip_mss(conn);
+        }
+
+      memcpy(wrb->wb_buffer, (FAR const uint8_t *)buf + result, nbytes);
+      wrb->wb_nbytes = nbytes;
+      wrb->wb_sent   = 0;
+      wrb->wb_seqno  = conn->wrseq;
+      conn->wrseq   += nbytes;
+
+      sq_addlast(&wrb->wb_node, &conn->write_q);
+      result += nbytes;
+    }
+
+  /* Notify the device driver of the availaibilty of TX data */
+
+  if (result > 0)
+    {
+      netdev_txnotify(conn->ripaddr);
+    }
+
+  uip_unlock(save);
+
+  /* Set the socket state to idle */
+
+  psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
+
+  if (result < 0)
+    {
+      err = -result;
+      goto errout;
+    }
+
+  return result;
+#else
   /* Perform the TCP send operation */
 
   /* Initialize the state structure.  This is done with interrupts
@@ -629,6 +1020,7 @@ ssize_t psock_send(FAR struct socket *psock, FAR const void *buf, size_t len,
   /* Return the number of bytes actually sent */
 
   return state.snd_sent;
+#endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
 
 errout:
   set_errno(err);
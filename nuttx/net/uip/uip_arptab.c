@@ -54,6 +54,7 @@
 
 #include <net/ethernet.h>
 #include <nuttx/net/uip/uipopt.h>
+#include <nuttx/net/uip/uip.h>
 #include <nuttx/net/uip/uip-arch.h>
 #include <nuttx/net/uip/uip-arp.h>
 
@@ -63,6 +64,34 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_ARPTAB_HASH
+/* Marks the end of a hash chain or LRU list */
+
+#  define ARP_NOENTRY      0xffff
+
+/* The number of hash buckets must be a power of two */
+
+#  ifndef CONFIG_NET_ARPTAB_NBUCKETS
+#    define CONFIG_NET_ARPTAB_NBUCKETS 16
+#  endif
+
+#  if (CONFIG_NET_ARPTAB_NBUCKETS & (CONFIG_NET_ARPTAB_NBUCKETS - 1)) != 0
+#    error "CONFIG_NET_ARPTAB_NBUCKETS must be a power of two"
+#  endif
+
+#  if CONFIG_NET_ARPTAB_SIZE >= ARP_NOENTRY
+#    error "CONFIG_NET_ARPTAB_SIZE is too large"
+#  endif
+#endif
+
+/* ARP table statistics */
+
+#ifdef CONFIG_NET_STATISTICS
+#  define ARP_STATINCR(p) ((p)++)
+#else
+#  define ARP_STATINCR(p)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -76,10 +105,178 @@
 static struct arp_entry g_arptable[CONFIG_NET_ARPTAB_SIZE];
 static uint8_t g_arptime;
 
+#ifdef CONFIG_NET_ARPTAB_HASH
+/* The head of each hash chain */
+
+static uint16_t g_arphash[CONFIG_NET_ARPTAB_NBUCKETS];
+
+/* The list of unused entries (linked through at_hnext) */
+
+static uint16_t g_arpfree;
+
+/* The ends of the list of entries in use, from most to least recently
+ * used.
+ */
+
+static uint16_t g_arpmru;
+static uint16_t g_arplru;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_ARPTAB_HASH
+/****************************************************************************
+ * Name: arp_hash
+ *
+ * Description:
+ *   Return the hash bucket of an IP address.  All octets are folded into
+ *   the result so that hosts on the same segment are spread evenly.
+ *
+ ****************************************************************************/
+
+static inline unsigned int arp_hash(in_addr_t ipaddr)
+{
+  uint32_t hash = (uint32_t)ipaddr;
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return (unsigned int)hash & (CONFIG_NET_ARPTAB_NBUCKETS - 1);
+}
+
+/****************************************************************************
+ * Name: arp_lru_remove
+ *
+ * Description:
+ *   Remove an entry from the LRU list.
+ *
+ ****************************************************************************/
+
+static void arp_lru_remove(uint16_t ndx)
+{
+  struct arp_entry *tabptr = &g_arptable[ndx];
+
+  if (tabptr->at_lprev != ARP_NOENTRY)
+    {
+      g_arptable[tabptr->at_lprev].at_lnext = tabptr->at_lnext;
+    }
+  else
+    {
+      g_arpmru = tabptr->at_lnext;
+    }
+
+  if (tabptr->at_lnext != ARP_NOENTRY)
+    {
+      g_arptable[tabptr->at_lnext].at_lprev = tabptr->at_lprev;
+    }
+  else
+    {
+      g_arplru = tabptr->at_lprev;
+    }
+}
+
+/****************************************************************************
+ * Name: arp_lru_addfirst
+ *
+ * Description:
+ *   Make an entry the most recently used one.
+ *
+ ****************************************************************************/
+
+static void arp_lru_addfirst(uint16_t ndx)
+{
+  struct arp_entry *tabptr = &g_arptable[ndx];
+
+  tabptr->at_lprev = ARP_NOENTRY;
+  tabptr->at_lnext = g_arpmru;
+
+  if (g_arpmru != ARP_NOENTRY)
+    {
+      g_arptable[g_arpmru].at_lprev = ndx;
+    }
+  else
+    {
+      g_arplru = ndx;
+    }
+
+  g_arpmru = ndx;
+}
+
+/****************************************************************************
+ * Name: arp_touch
+ *
+ * Description:
+ *   Move an entry to the most recently used end of the LRU list.
+ *
+ ****************************************************************************/
+
+static inline void arp_touch(uint16_t ndx)
+{
+  if (g_arpmru != ndx)
+    {
+      arp_lru_remove(ndx);
+      arp_lru_addfirst(ndx);
+    }
+}
+
+/****************************************************************************
+ * Name: arp_lookup
+ *
+ * Description:
+ *   Return the index of the entry that maps ipaddr or ARP_NOENTRY.
+ *
+ ****************************************************************************/
+
+static uint16_t arp_lookup(in_addr_t ipaddr)
+{
+  uint16_t ndx;
+
+  for (ndx = g_arphash[arp_hash(ipaddr)];
+       ndx != ARP_NOENTRY;
+       ndx = g_arptable[ndx].at_hnext)
+    {
+      if (uip_ipaddr_cmp(ipaddr, g_arptable[ndx].at_ipaddr))
+        {
+          break;
+        }
+    }
+
+  return ndx;
+}
+
+/****************************************************************************
+ * Name: arp_release
+ *
+ * Description:
+ *   Remove an entry from its hash chain and from the LRU list and return
+ *   it to the list of unused entries.
+ *
+ ****************************************************************************/
+
+static void arp_release(uint16_t ndx)
+{
+  struct arp_entry *tabptr = &g_arptable[ndx];
+  uint16_t *link;
+
+  /* Unlink the entry from its hash chain */
+
+  for (link = &g_arphash[arp_hash(tabptr->at_ipaddr)];
+       *link != ndx;
+       link = &g_arptable[*link].at_hnext);
+
+  *link = tabptr->at_hnext;
+
+  /* Remove the entry from the LRU list and put it in the free list */
+
+  arp_lru_remove(ndx);
+
+  tabptr->at_ipaddr = 0;
+  tabptr->at_hnext  = g_arpfree;
+  g_arpfree         = ndx;
+}
+#endif /* CONFIG_NET_ARPTAB_HASH */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -99,7 +296,21 @@ void uip_arp_init(void)
   for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
     {
       memset(&g_arptable[i].at_ipaddr, 0, sizeof(in_addr_t));
+#ifdef CONFIG_NET_ARPTAB_HASH
+      g_arptable[i].at_hnext = i + 1 < CONFIG_NET_ARPTAB_SIZE ? i + 1 : ARP_NOENTRY;
+#endif
+    }
+
+#ifdef CONFIG_NET_ARPTAB_HASH
+  for (i = 0; i < CONFIG_NET_ARPTAB_NBUCKETS; ++i)
+    {
+      g_arphash[i] = ARP_NOENTRY;
     }
+
+  g_arpfree = 0;
+  g_arpmru  = ARP_NOENTRY;
+  g_arplru  = ARP_NOENTRY;
+#endif
 }
 
 /****************************************************************************
@@ -124,7 +335,11 @@ void uip_arp_timer(void)
       tabptr = &g_arptable[i];
       if (tabptr->at_ipaddr != 0 && g_arptime - tabptr->at_time >= UIP_ARP_MAXAGE)
         {
+#ifdef CONFIG_NET_ARPTAB_HASH
+          arp_release(i);
+#else
           tabptr->at_ipaddr = 0;
+#endif
         }
     }
 }
@@ -145,6 +360,54 @@ void uip_arp_timer(void)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_NET_ARPTAB_HASH
+void uip_arp_update(uint16_t *pipaddr, uint8_t *ethaddr)
+{
+  struct arp_entry *tabptr;
+  in_addr_t         ipaddr = uip_ip4addr_conv(pipaddr);
+  unsigned int      hash;
+  uint16_t          ndx;
+
+  /* Check if there is already an entry for this IP address */
+
+  ndx = arp_lookup(ipaddr);
+  if (ndx == ARP_NOENTRY)
+    {
+      /* No.. Take an unused entry or, if there is none, reclaim the least
+       * recently used one.
+       */
+
+      ndx = g_arpfree;
+      if (ndx == ARP_NOENTRY)
+        {
+          ARP_STATINCR(uip_stat.arp.evict);
+          arp_release(g_arplru);
+          ndx = g_arpfree;
+        }
+
+      g_arpfree = g_arptable[ndx].at_hnext;
+
+      /* Add the entry to its hash chain and to the LRU list */
+
+      tabptr            = &g_arptable[ndx];
+      tabptr->at_ipaddr = ipaddr;
+
+      hash              = arp_hash(ipaddr);
+      tabptr->at_hnext  = g_arphash[hash];
+      g_arphash[hash]   = ndx;
+
+      arp_lru_addfirst(ndx);
+    }
+  else
+    {
+      tabptr = &g_arptable[ndx];
+      arp_touch(ndx);
+    }
+
+  memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
+  tabptr->at_time = g_arptime;
+}
+#else
 void uip_arp_update(uint16_t *pipaddr, uint8_t *ethaddr)
 {
   struct arp_entry *tabptr = NULL;
@@ -211,6 +474,7 @@ void uip_arp_update(uint16_t *pipaddr, uint8_t *ethaddr)
         }
       i = j;
       tabptr = &g_arptable[i];
+      ARP_STATINCR(uip_stat.arp.evict);
     }
 
   /* Now, i is the ARP table entry which we will fill with the new
@@ -221,6 +485,7 @@ void uip_arp_update(uint16_t *pipaddr, uint8_t *ethaddr)
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
   tabptr->at_time = g_arptime;
 }
+#endif /* CONFIG_NET_ARPTAB_HASH */
 
 /****************************************************************************
  * Name: uip_arp_find
@@ -239,6 +504,17 @@ void uip_arp_update(uint16_t *pipaddr, uint8_t *ethaddr)
 
 struct arp_entry *uip_arp_find(in_addr_t ipaddr)
 {
+#ifdef CONFIG_NET_ARPTAB_HASH
+  uint16_t ndx;
+
+  ndx = arp_lookup(ipaddr);
+  if (ndx != ARP_NOENTRY)
+    {
+      ARP_STATINCR(uip_stat.arp.hit);
+      arp_touch(ndx);
+      return &g_arptable[ndx];
+    }
+#else
   struct arp_entry *tabptr;
   int i;
 
@@ -247,11 +523,41 @@ struct arp_entry *uip_arp_find(in_addr_t ipaddr)
       tabptr = &g_arptable[i];
       if (uip_ipaddr_cmp(ipaddr, tabptr->at_ipaddr))
         {
+          ARP_STATINCR(uip_stat.arp.hit);
           return tabptr;
         }
     }
+#endif
+
+  ARP_STATINCR(uip_stat.arp.miss);
   return NULL;
 }
 
+/****************************************************************************
+ * Name: uip_arp_delete
+ *
+ * Description:
+ *   Remove an IP association from the ARP table
+ *
+ * Input parameters:
+ *   ipaddr - Refers to an IP address in network order
+ *
+ * Assumptions
+ *   Interrupts are disabled
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARPTAB_HASH
+void uip_arp_delete(in_addr_t ipaddr)
+{
+  uint16_t ndx = arp_lookup(ipaddr);
+
+  if (ndx != ARP_NOENTRY)
+    {
+      arp_release(ndx);
+    }
+}
+#endif
+
 #endif /* CONFIG_NET_ARP */
 #endif /* CONFIG_NET */
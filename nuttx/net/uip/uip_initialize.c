@@ -46,6 +46,7 @@
 
 #include <stdint.h>
 #include <nuttx/net/uip/uip.h>
+#include <nuttx/net/iob.h>
 
 #include "uip_internal.h"
 
@@ -119,6 +120,12 @@ void uip_initialize(void)
 
   uip_lockinit();
 
+  /* Initialize I/O buffering */
+
+#ifdef CONFIG_NET_IOB
+  iob_initialize();
+#endif
+
   /* Initialize callback support */
 
   uip_callbackinit();
@@ -134,9 +141,15 @@ void uip_initialize(void)
 
   /* Initialize the TCP/IP read-ahead buffering */
 
-#if CONFIG_NET_NTCP_READAHEAD_BUFFERS > 0
+#if CONFIG_NET_NTCP_READAHEAD_BUFFERS > 0 && !defined(CONFIG_NET_IOB)
   uip_tcpreadaheadinit();
 #endif
+
+  /* Initialize the TCP/IP write buffering */
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+  uip_tcpwrbufferinit();
+#endif
 #endif /* CONFIG_NET_TCP */
 
   /* Initialize the UDP connection structures */
@@ -49,6 +49,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <errno.h>
+#include <time.h>
 #include <arch/irq.h>
 #include <nuttx/net/uip/uip.h>
 
@@ -163,11 +164,20 @@ uint16_t uip_datahandler(FAR struct uip_conn *conn,
 
 /* Defined in uip_tcpreadahead.c ********************************************/
 
-#if CONFIG_NET_NTCP_READAHEAD_BUFFERS > 0
+#if CONFIG_NET_NTCP_READAHEAD_BUFFERS > 0 && !defined(CONFIG_NET_IOB)
 void uip_tcpreadaheadinit(void);
 struct uip_readahead_s *uip_tcpreadaheadalloc(void);
 void uip_tcpreadaheadrelease(struct uip_readahead_s *buf);
-#endif /* CONFIG_NET_NTCP_READAHEAD_BUFFERS */
+#endif /* CONFIG_NET_NTCP_READAHEAD_BUFFERS && !CONFIG_NET_IOB */
+
+/* Defined in uip_tcpwrbuffer.c *********************************************/
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+void uip_tcpwrbufferinit(void);
+FAR struct uip_wrbuffer_s *
+uip_tcpwrbufferalloc(FAR const struct timespec *abstime);
+void uip_tcpwrbufferrelease(FAR struct uip_wrbuffer_s *wrb);
+#endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
 
 #endif /* CONFIG_NET_TCP */
 
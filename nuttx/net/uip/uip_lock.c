@@ -171,14 +171,15 @@ void uip_unlock(uip_lock_t flags)
 }
 
 /****************************************************************************
- * Function: uip_lockedwait
+ * Function: uip_semwait
  *
  * Description:
- *   Atomically wait for sem while temporarily releasing g_uipsem.
+ *   Wait for sem, with a timeout if abstime is non-NULL, while temporarily
+ *   releasing g_uipsem.
  *
  ****************************************************************************/
 
-int uip_lockedwait(sem_t *sem)
+static int uip_semwait(sem_t *sem, const struct timespec *abstime)
 {
   pid_t        me = getpid();
   unsigned int count;
@@ -198,7 +199,7 @@ int uip_lockedwait(sem_t *sem)
 
       /* Now take the semaphore */
 
-      ret = sem_wait(sem);
+      ret = abstime ? sem_timedwait(sem, abstime) : sem_wait(sem);
 
       /* Recover the uIP semaphore at the proper count */
 
@@ -208,7 +209,7 @@ int uip_lockedwait(sem_t *sem)
     }
   else
     {
-      ret = sem_wait(sem);
+      ret = abstime ? sem_timedwait(sem, abstime) : sem_wait(sem);
     }
 
   sched_unlock();
@@ -216,4 +217,31 @@ int uip_lockedwait(sem_t *sem)
   return ret;
  }
 
+/****************************************************************************
+ * Function: uip_lockedwait
+ *
+ * Description:
+ *   Atomically wait for sem while temporarily releasing g_uipsem.
+ *
+ ****************************************************************************/
+
+int uip_lockedwait(sem_t *sem)
+{
+  return uip_semwait(sem, NULL);
+}
+
+/****************************************************************************
+ * Function: uip_lockedtimedwait
+ *
+ * Description:
+ *   Like uip_lockedwait() but fails with ETIMEDOUT if sem is not available
+ *   by the absolute time abstime (see sem_timedwait()).
+ *
+ ****************************************************************************/
+
+int uip_lockedtimedwait(sem_t *sem, const struct timespec *abstime)
+{
+  return uip_semwait(sem, abstime);
+}
+
 #endif /* CONFIG_NET */
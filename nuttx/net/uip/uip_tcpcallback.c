@@ -48,6 +48,7 @@
 #include <nuttx/net/uip/uipopt.h>
 #include <nuttx/net/uip/uip.h>
 #include <nuttx/net/uip/uip-arch.h>
+#include <nuttx/net/iob.h>
 
 #include "uip_internal.h"
 
@@ -70,7 +71,7 @@
  *
  ****************************************************************************/
 
-#if CONFIG_NET_NTCP_READAHEAD_BUFFERS > 0
+#if CONFIG_NET_NTCP_READAHEAD_BUFFERS > 0 && !defined(CONFIG_NET_IOB)
 static int uip_readahead(struct uip_readahead_s *readahead, uint8_t *buf,
                          int len)
 {
@@ -99,6 +100,75 @@ static int uip_readahead(struct uip_readahead_s *readahead, uint8_t *buf,
 }
 #endif
 
+/****************************************************************************
+ * Function: uip_iobhandler
+ *
+ * Description:
+ *   Buffer new TCP data from a packet that the driver may have received
+ *   directly into an I/O buffer (see d_iob in struct uip_driver_s).  If so,
+ *   the I/O buffer itself is queued in the read-ahead list with io_offset
+ *   skipping the headers, and d_iob is set to NULL to tell the driver that
+ *   it no longer owns the buffer.  Otherwise the data is copied by
+ *   uip_datahandler().
+ *
+ *   Data that fits in the space left at the end of the last buffered chain
+ *   is still copied so that small segments do not each hold a whole
+ *   packet-sized buffer.
+ *
+ * Assumptions:
+ * - Called from uip_dataevent() after all connection callbacks have run.
+ *   Callbacks do not send while UIP_NEWDATA is set, so the only response
+ *   built in d_buf is made of headers and does not overlap the data.
+ * - This function is called at the interrupt level with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_NTCP_READAHEAD_BUFFERS > 0 && defined(CONFIG_NET_IOB)
+static uint16_t uip_iobhandler(FAR struct uip_driver_s *dev,
+                               FAR struct uip_conn *conn,
+                               FAR uint8_t *buffer, uint16_t buflen)
+{
+  FAR struct iob_s *iob = dev->d_iob;
+  FAR struct iob_s *tail;
+  unsigned int tailroom;
+
+  /* Was the data received into the driver's I/O buffer? */
+
+  if (!iob || buffer < iob->io_data ||
+      buffer + buflen > &iob->io_data[CONFIG_IOB_BUFSIZE])
+    {
+      return uip_datahandler(conn, buffer, buflen);
+    }
+
+  /* Copy small segments into the last buffer already queued */
+
+  tail = (FAR struct iob_s *)conn->readahead.tail;
+  if (tail)
+    {
+      for (; tail->io_flink; tail = tail->io_flink);
+      tailroom = CONFIG_IOB_BUFSIZE - (tail->io_offset + tail->io_len);
+
+      if (buflen <= tailroom)
+        {
+          return uip_datahandler(conn, buffer, buflen);
+        }
+    }
+
+  /* Take the driver's I/O buffer and queue it as a new chain */
+
+  dev->d_iob     = NULL;
+  iob->io_flink  = NULL;
+  iob->io_offset = buffer - iob->io_data;
+  iob->io_len    = buflen;
+  iob->io_pktlen = buflen;
+
+  sq_addlast(&iob->io_node, &conn->readahead);
+
+  nllvdbg("Queued %d bytes without copying\n", buflen);
+  return buflen;
+}
+#endif
+
 /****************************************************************************
  * Function: uip_dataevent
  *
@@ -142,7 +212,11 @@ uip_dataevent(FAR struct uip_driver_s *dev, FAR struct uip_conn *conn,
 #if CONFIG_NET_NTCP_READAHEAD_BUFFERS > 0
       /* Save as much data as possible in the read-ahead buffers */
 
+#ifdef CONFIG_NET_IOB
+      recvlen = uip_iobhandler(dev, conn, buffer, buflen);
+#else
       recvlen = uip_datahandler(conn, buffer, buflen);
+#endif
 
       /* There are several complicated buffering issues that are not addressed
        * properly here.  For example, what if we cannot buffer the entire
@@ -277,6 +351,61 @@ uint16_t uip_tcpcallback(struct uip_driver_s *dev, struct uip_conn *conn,
  ****************************************************************************/
 
 #if CONFIG_NET_NTCP_READAHEAD_BUFFERS > 0
+#ifdef CONFIG_NET_IOB
+uint16_t uip_datahandler(FAR struct uip_conn *conn, FAR uint8_t *buffer,
+                         uint16_t buflen)
+{
+  FAR struct iob_s *iob;
+  int ret;
+
+  /* Append the data to the last I/O buffer chain queued on the connection,
+   * filling any space that remains in its last I/O buffer.  iob_copyin()
+   * either buffers all of the data or leaves the chain unchanged.
+   */
+
+  iob = (FAR struct iob_s *)conn->readahead.tail;
+  if (iob && (uint32_t)iob->io_pktlen + buflen <= UINT16_MAX)
+    {
+      ret = iob_copyin(iob, buffer, buflen, iob->io_pktlen);
+    }
+
+  /* Otherwise, start a new I/O buffer chain */
+
+  else
+    {
+      iob = iob_tryalloc();
+      if (!iob)
+        {
+          nllvdbg("No I/O buffers, dropped %d bytes\n", buflen);
+          return 0;
+        }
+
+      ret = iob_copyin(iob, buffer, buflen, 0);
+      if (ret < 0)
+        {
+          iob_free(iob);
+        }
+      else
+        {
+          /* Save the I/O buffer chain in the connection structure where
+           * it can be found with recv() is called.
+           */
+
+          sq_addlast(&iob->io_node, &conn->readahead);
+        }
+    }
+
+  if (ret < 0)
+    {
+      nllvdbg("Insufficient I/O buffers, dropped %d bytes\n", buflen);
+      return 0;
+    }
+
+  nllvdbg("Buffered %d bytes\n", buflen);
+  return buflen;
+}
+
+#else
 uint16_t uip_datahandler(FAR struct uip_conn *conn, FAR uint8_t *buffer,
                          uint16_t buflen)
 {
@@ -332,6 +461,7 @@ uint16_t uip_datahandler(FAR struct uip_conn *conn, FAR uint8_t *buffer,
   nllvdbg("Buffered %d bytes (of %d)\n", recvlen, buflen);
   return recvlen;
 }
+#endif /* CONFIG_NET_IOB */
 #endif /* CONFIG_NET_NTCP_READAHEAD_BUFFERS > 0 */
 
 #endif /* CONFIG_NET && CONFIG_NET_TCP */
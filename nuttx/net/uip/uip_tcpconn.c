@@ -54,9 +54,26 @@
 #include <nuttx/net/uip/uipopt.h>
 #include <nuttx/net/uip/uip.h>
 #include <nuttx/net/uip/uip-arch.h>
+#include <nuttx/net/iob.h>
 
 #include "uip_internal.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONNHASH
+#  ifndef CONFIG_NET_TCP_CONNHASH_NBUCKETS
+#    define CONFIG_NET_TCP_CONNHASH_NBUCKETS 16
+#  endif
+
+#  if (CONFIG_NET_TCP_CONNHASH_NBUCKETS & (CONFIG_NET_TCP_CONNHASH_NBUCKETS - 1)) != 0
+#    error "CONFIG_NET_TCP_CONNHASH_NBUCKETS must be a power of two"
+#  endif
+
+#  define TCP_HASHMASK (CONFIG_NET_TCP_CONNHASH_NBUCKETS - 1)
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -81,10 +98,118 @@ static dq_queue_t g_active_tcp_connections;
 
 static uint16_t g_last_tcp_port;
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+/* Active connections hashed on the remote address, remote port and local
+ * port.
+ */
+
+static FAR struct uip_conn *g_tcp_connhash[CONFIG_NET_TCP_CONNHASH_NBUCKETS];
+
+/* Bound connections hashed on the local port */
+
+static FAR struct uip_conn *g_tcp_porthash[CONFIG_NET_TCP_CONNHASH_NBUCKETS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+/****************************************************************************
+ * Name: uip_tcphash() and uip_porthash()
+ *
+ * Description:
+ *   Return the hash bucket of a connection 4-tuple (the local address is
+ *   not used) or of a local port number.  All values are in network byte
+ *   order.
+ *
+ ****************************************************************************/
+
+static inline unsigned int uip_tcphash(in_addr_t ripaddr, uint16_t rport,
+                                       uint16_t lport)
+{
+  uint32_t hash = (uint32_t)ripaddr ^ ((uint32_t)rport << 16) ^ lport;
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return (unsigned int)hash & TCP_HASHMASK;
+}
+
+static inline unsigned int uip_porthash(uint16_t portno)
+{
+  return (unsigned int)(portno ^ (portno >> 8)) & TCP_HASHMASK;
+}
+
+/****************************************************************************
+ * Name: uip_hashconn() and uip_unhashconn()
+ *
+ * Description:
+ *   Add a connection to or remove it from the hash of active connections.
+ *
+ * Assumptions:
+ *   Interrupts are disabled
+ *
+ ****************************************************************************/
+
+static void uip_hashconn(FAR struct uip_conn *conn)
+{
+  unsigned int hash = uip_tcphash(conn->ripaddr, conn->rport, conn->lport);
+
+  conn->hnext          = g_tcp_connhash[hash];
+  g_tcp_connhash[hash] = conn;
+}
+
+static void uip_unhashconn(FAR struct uip_conn *conn)
+{
+  FAR struct uip_conn **link;
+
+  link = &g_tcp_connhash[uip_tcphash(conn->ripaddr, conn->rport, conn->lport)];
+  for (; *link; link = &(*link)->hnext)
+    {
+      if (*link == conn)
+        {
+          *link = conn->hnext;
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: uip_hashport() and uip_unhashport()
+ *
+ * Description:
+ *   Add a connection to or remove it from the hash of bound connections.
+ *
+ * Assumptions:
+ *   Interrupts are disabled
+ *
+ ****************************************************************************/
+
+static void uip_hashport(FAR struct uip_conn *conn)
+{
+  unsigned int hash = uip_porthash(conn->lport);
+
+  conn->pnext          = g_tcp_porthash[hash];
+  g_tcp_porthash[hash] = conn;
+}
+
+static void uip_unhashport(FAR struct uip_conn *conn)
+{
+  FAR struct uip_conn **link;
+
+  for (link = &g_tcp_porthash[uip_porthash(conn->lport)];
+       *link;
+       link = &(*link)->pnext)
+    {
+      if (*link == conn)
+        {
+          *link = conn->pnext;
+          break;
+        }
+    }
+}
+#endif /* CONFIG_NET_TCP_CONNHASH */
+
 /****************************************************************************
  * Name: uip_selectport()
  *
@@ -187,6 +312,14 @@ void uip_tcpinit(void)
       dq_addlast(&g_tcp_connections[i].node, &g_free_tcp_connections);
     }
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+  for (i = 0; i < CONFIG_NET_TCP_CONNHASH_NBUCKETS; i++)
+    {
+      g_tcp_connhash[i] = NULL;
+      g_tcp_porthash[i] = NULL;
+    }
+#endif
+
   g_last_tcp_port = 1024;
 }
 
@@ -307,7 +440,14 @@ void uip_tcpfree(struct uip_conn *conn)
   FAR struct uip_callback_s *next;
 
 #if CONFIG_NET_NTCP_READAHEAD_BUFFERS > 0
+#ifdef CONFIG_NET_IOB
+  FAR struct iob_s *iob;
+#else
   struct uip_readahead_s *readahead;
+#endif
+#endif
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+  FAR struct uip_wrbuffer_s *wrb;
 #endif
   uip_lock_t flags;
 
@@ -338,16 +478,49 @@ void uip_tcpfree(struct uip_conn *conn)
       /* Remove the connection from the active list */
 
       dq_rem(&conn->node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONNHASH
+      uip_unhashconn(conn);
+#endif
+    }
+
+#ifdef CONFIG_NET_TCP_CONNHASH
+  /* Release the local port */
+
+  if (conn->lport != 0)
+    {
+      uip_unhashport(conn);
     }
+#endif
 
   /* Release any read-ahead buffers attached to the connection */
 
 #if CONFIG_NET_NTCP_READAHEAD_BUFFERS > 0
+#ifdef CONFIG_NET_IOB
+  while ((iob = (FAR struct iob_s *)sq_remfirst(&conn->readahead)) != NULL)
+    {
+      iob_free_chain(iob);
+    }
+#else
   while ((readahead = (struct uip_readahead_s *)sq_remfirst(&conn->readahead)) != NULL)
     {
       uip_tcpreadaheadrelease(readahead);
     }
 #endif
+#endif
+
+  /* Release any write buffers attached to the connection */
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+  while ((wrb = (FAR struct uip_wrbuffer_s *)sq_remfirst(&conn->write_q)) != NULL)
+    {
+      uip_tcpwrbufferrelease(wrb);
+    }
+
+  while ((wrb = (FAR struct uip_wrbuffer_s *)sq_remfirst(&conn->unacked_q)) != NULL)
+    {
+      uip_tcpwrbufferrelease(wrb);
+    }
+#endif
 
   /* Remove any backlog attached to this connection */
 
@@ -388,6 +561,23 @@ void uip_tcpfree(struct uip_conn *conn)
 
 struct uip_conn *uip_tcpactive(struct uip_tcpip_hdr *buf)
 {
+#ifdef CONFIG_NET_TCP_CONNHASH
+  struct uip_conn *conn;
+  in_addr_t        srcipaddr = uip_ip4addr_conv(buf->srcipaddr);
+
+  /* Search only the hash chain that the connection would be in */
+
+  conn = g_tcp_connhash[uip_tcphash(srcipaddr, buf->srcport, buf->destport)];
+  for (; conn; conn = conn->hnext)
+    {
+      if (conn->tcpstateflags != UIP_CLOSED &&
+          buf->destport == conn->lport && buf->srcport == conn->rport &&
+          uip_ipaddr_cmp(srcipaddr, conn->ripaddr))
+        {
+          break;
+        }
+    }
+#else
   struct uip_conn *conn      = (struct uip_conn *)g_active_tcp_connections.head;
   in_addr_t        srcipaddr = uip_ip4addr_conv(buf->srcipaddr);
 
@@ -410,6 +600,7 @@ struct uip_conn *uip_tcpactive(struct uip_tcpip_hdr *buf)
 
       conn = (struct uip_conn *)conn->node.flink;
     }
+#endif
 
   return conn;
 }
@@ -453,8 +644,21 @@ struct uip_conn *uip_nexttcpconn(struct uip_conn *conn)
 struct uip_conn *uip_tcplistener(uint16_t portno)
 {
   struct uip_conn *conn;
+#ifndef CONFIG_NET_TCP_CONNHASH
   int i;
+#endif
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+  /* Check if this port number is in use by any bound UIP TCP connection */
+
+  for (conn = g_tcp_porthash[uip_porthash(portno)]; conn; conn = conn->pnext)
+    {
+      if (conn->tcpstateflags != UIP_CLOSED && conn->lport == portno)
+        {
+          return conn;
+        }
+    }
+#else
   /* Check if this port number is in use by any active UIP TCP connection */
 
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
@@ -467,6 +671,7 @@ struct uip_conn *uip_tcplistener(uint16_t portno)
           return conn;
         }
     }
+#endif
 
   return NULL;
 }
@@ -520,6 +725,10 @@ struct uip_conn *uip_tcpaccept(struct uip_tcpip_hdr *buf)
        */
 
       dq_addlast(&conn->node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONNHASH
+      uip_hashconn(conn);
+      uip_hashport(conn);
+#endif
     }
 
   return conn;
@@ -565,7 +774,23 @@ int uip_tcpbind(struct uip_conn *conn, const struct sockaddr_in *addr)
    * interface is supported, the IP address is not of importance.
    */
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+  flags = uip_lock();
+  if (conn->lport != 0)
+    {
+      uip_unhashport(conn);
+    }
+
   conn->lport = addr->sin_port;
+  if (conn->lport != 0)
+    {
+      uip_hashport(conn);
+    }
+
+  uip_unlock(flags);
+#else
+  conn->lport = addr->sin_port;
+#endif
 
 #if 0 /* Not used */
 #ifdef CONFIG_NET_IPv6
@@ -642,7 +867,22 @@ int uip_tcpconnect(struct uip_conn *conn, const struct sockaddr_in *addr)
   conn->rto        = UIP_RTO;
   conn->sa         = 0;
   conn->sv         = 16;   /* Initial value of the RTT variance. */
+
+#ifdef CONFIG_NET_TCP_CONNHASH
+  /* If the connection was bound, it is already in the hash of bound
+   * connections under the same port number.
+   */
+
+  if (conn->lport == 0)
+    {
+      conn->lport = htons((uint16_t)port);
+      flags = uip_lock();
+      uip_hashport(conn);
+      uip_unlock(flags);
+    }
+#else
   conn->lport      = htons((uint16_t)port);
+#endif
 
   /* The sockaddr port is 16 bits and already in network order */
 
@@ -666,6 +906,9 @@ int uip_tcpconnect(struct uip_conn *conn, const struct sockaddr_in *addr)
 
   flags = uip_lock();
   dq_addlast(&conn->node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONNHASH
+  uip_hashconn(conn);
+#endif
   uip_unlock(flags);
 
   return OK;
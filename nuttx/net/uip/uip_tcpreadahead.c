@@ -38,7 +38,8 @@
  ****************************************************************************/
 
 #include <nuttx/net/uip/uipopt.h>
-#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && (CONFIG_NET_NTCP_READAHEAD_BUFFERS > 0)
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    (CONFIG_NET_NTCP_READAHEAD_BUFFERS > 0) && !defined(CONFIG_NET_IOB)
 
 #include <queue.h>
 #include <debug.h>
@@ -0,0 +1,164 @@
+/****************************************************************************
+ * net/uip/uip_tcpwrbuffer.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/net/uip/uipopt.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && defined(CONFIG_NET_TCP_WRITE_BUFFERS)
+
+#include <queue.h>
+#include <semaphore.h>
+#include <debug.h>
+
+#include <nuttx/net/uip/uip.h>
+
+#include "uip_internal.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* These are the pre-allocated write buffers */
+
+static struct uip_wrbuffer_s g_wrbuffers[CONFIG_NET_NTCP_WRITE_BUFFERS];
+
+/* This is the list of available write buffers */
+
+static sq_queue_t g_freewrbuffers;
+
+/* This counts the number of available write buffers */
+
+static sem_t g_wrbuffersem;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: uip_tcpwrbufferinit
+ *
+ * Description:
+ *   Initialize the list of free write buffers
+ *
+ * Assumptions:
+ *   Called once early initialization.
+ *
+ ****************************************************************************/
+
+void uip_tcpwrbufferinit(void)
+{
+  int i;
+
+  sq_init(&g_freewrbuffers);
+  for (i = 0; i < CONFIG_NET_NTCP_WRITE_BUFFERS; i++)
+    {
+      sq_addfirst(&g_wrbuffers[i].wb_node, &g_freewrbuffers);
+    }
+
+  sem_init(&g_wrbuffersem, 0, CONFIG_NET_NTCP_WRITE_BUFFERS);
+}
+
+/****************************************************************************
+ * Function: uip_tcpwrbufferalloc
+ *
+ * Description:
+ *   Allocate a TCP write buffer by taking a pre-allocated buffer from the
+ *   free list.  This function is called from send() logic when new data is
+ *   queued for transmission.  If no buffer is available, this function
+ *   waits until one is released by the acknowledgement of queued data.
+ *
+ * Input Parameters:
+ *   abstime - The absolute time at which to give up waiting (see
+ *             sem_timedwait()) or NULL to wait indefinitely.
+ *
+ * Returned Value:
+ *   The allocated buffer or NULL if the wait was interrupted by a signal or
+ *   timed out.  In that case, the errno value is set appropriately.
+ *
+ * Assumptions:
+ *   Called from user logic with the network locked (see uip_lock()).  The
+ *   network is unlocked while waiting.
+ *
+ ****************************************************************************/
+
+FAR struct uip_wrbuffer_s *
+uip_tcpwrbufferalloc(FAR const struct timespec *abstime)
+{
+  int ret;
+
+  if (abstime != NULL)
+    {
+      ret = uip_lockedtimedwait(&g_wrbuffersem, abstime);
+    }
+  else
+    {
+      ret = uip_lockedwait(&g_wrbuffersem);
+    }
+
+  if (ret < 0)
+    {
+      return NULL;
+    }
+
+  return (FAR struct uip_wrbuffer_s *)sq_remfirst(&g_freewrbuffers);
+}
+
+/****************************************************************************
+ * Function: uip_tcpwrbufferrelease
+ *
+ * Description:
+ *   Release a TCP write buffer by returning the buffer to the free list.
+ *   This function is called from TCP logic when the data in the buffer has
+ *   been acknowledged or when the connection is lost.
+ *
+ * Assumptions:
+ *   Called from interrupt level or from user logic with interrupts
+ *   disabled.
+ *
+ ****************************************************************************/
+
+void uip_tcpwrbufferrelease(FAR struct uip_wrbuffer_s *wrb)
+{
+  sq_addfirst(&wrb->wb_node, &g_freewrbuffers);
+  sem_post(&g_wrbuffersem);
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_WRITE_BUFFERS */
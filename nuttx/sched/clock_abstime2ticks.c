@@ -122,5 +122,9 @@ int clock_abstime2ticks(clockid_t clockid, FAR const struct timespec *abstime,
 
   /* Convert this relative time into clock ticks. */
 
+#ifdef CONFIG_CLOCK_HIRES
+  return clock_time2delay(&reltime, ticks);
+#else
   return clock_time2ticks(&reltime, ticks);
+#endif
 }
@@ -93,9 +93,9 @@ int clock_getres(clockid_t clock_id, struct timespec *res)
 
   sdbg("clock_id=%d\n", clock_id);
 
-  /* Only CLOCK_REALTIME is supported */
+  /* Only CLOCK_REALTIME and CLOCK_MONOTONIC are supported */
 
-  if (clock_id != CLOCK_REALTIME)
+  if (clock_id != CLOCK_REALTIME && clock_id != CLOCK_MONOTONIC)
     {
       sdbg("Returning ERROR\n");
       set_errno(EINVAL);
@@ -105,7 +105,11 @@ int clock_getres(clockid_t clock_id, struct timespec *res)
     {
       /* Get the clock resolution in nanoseconds */
 
+#ifdef CONFIG_CLOCK_HIRES
+      time_res = CONFIG_CLOCK_HIRES_NSEC;
+#else
       time_res = MSEC_PER_TICK * NSEC_PER_MSEC;
+#endif
 
       /* And return this as a timespec. */
 
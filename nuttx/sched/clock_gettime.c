@@ -47,6 +47,7 @@
 #include <debug.h>
 
 #include <arch/irq.h>
+#include <nuttx/arch.h>
 
 #include "clock_internal.h"
 
@@ -93,27 +94,56 @@
 int clock_gettime(clockid_t clock_id, struct timespec *tp)
 {
 #ifdef CONFIG_SYSTEM_TIME64
+#ifndef CONFIG_CLOCK_HIRES
   uint64_t msecs;
+#endif
   uint64_t secs;
   uint64_t nsecs;
 #else
+#ifndef CONFIG_CLOCK_HIRES
   uint32_t msecs;
+#endif
   uint32_t secs;
   uint32_t nsecs;
+#endif
+#ifdef CONFIG_CLOCK_HIRES
+  struct timespec hrnow;
 #endif
   int ret = OK;
 
   sdbg("clock_id=%d\n", clock_id);
   DEBUGASSERT(tp != NULL);
 
+  /* CLOCK_MONOTONIC is the time since start-up.  It is not affected by
+   * clock_settime().
+   */
+
+  if (clock_id == CLOCK_MONOTONIC)
+    {
+#ifdef CONFIG_CLOCK_HIRES
+      up_hrclock_gettime(tp);
+#else
+#ifdef CONFIG_SCHED_TICKLESS
+      msecs = MSEC_PER_TICK * clock_systimer();
+#else
+      msecs = MSEC_PER_TICK * g_system_timer;
+#endif
+      secs  = msecs / MSEC_PER_SEC;
+      nsecs = (msecs - (secs * MSEC_PER_SEC)) * NSEC_PER_MSEC;
+
+      tp->tv_sec  = (time_t)secs;
+      tp->tv_nsec = (long)nsecs;
+#endif
+    }
+
   /* CLOCK_REALTIME - POSIX demands this to be present. This is the wall
    * time clock.
    */
 
 #ifdef CONFIG_RTC
-  if (clock_id == CLOCK_REALTIME || clock_id == CLOCK_ACTIVETIME)
+  else if (clock_id == CLOCK_REALTIME || clock_id == CLOCK_ACTIVETIME)
 #else
-  if (clock_id == CLOCK_REALTIME)
+  else if (clock_id == CLOCK_REALTIME)
 #endif
     {
       /* Do we have a high-resolution RTC that can provie us with the time? */
@@ -128,11 +158,30 @@ int clock_gettime(clockid_t clock_id, struct timespec *tp)
       else
 #endif
         {
+#ifdef CONFIG_CLOCK_HIRES
+          /* Get the elapsed time since the base time was set from the
+           * high-resolution clock.
+           */
+
+          up_hrclock_gettime(&hrnow);
+          if (hrnow.tv_nsec < g_hrbias.tv_nsec)
+            {
+              hrnow.tv_nsec += NSEC_PER_SEC;
+              hrnow.tv_sec--;
+            }
+
+          secs  = hrnow.tv_sec  - g_hrbias.tv_sec;
+          nsecs = hrnow.tv_nsec - g_hrbias.tv_nsec;
+#else
           /* Get the elapsed time since power up (in milliseconds) biased
            * as appropriate.
            */
 
+#ifdef CONFIG_SCHED_TICKLESS
+          msecs = MSEC_PER_TICK * (clock_systimer() - g_tickbias);
+#else
           msecs = MSEC_PER_TICK * (g_system_timer - g_tickbias);
+#endif
 
           sdbg("msecs = %d g_tickbias=%d\n",
                (int)msecs, (int)g_tickbias);
@@ -141,9 +190,10 @@ int clock_gettime(clockid_t clock_id, struct timespec *tp)
 
           secs  = msecs / MSEC_PER_SEC;
           nsecs = (msecs - (secs * MSEC_PER_SEC)) * NSEC_PER_MSEC;
+#endif
 
           sdbg("secs = %d + %d nsecs = %d + %d\n",
-               (int)msecs, (int)g_basetime.tv_sec,
+               (int)secs, (int)g_basetime.tv_sec,
                (int)nsecs, (int)g_basetime.tv_nsec);
 
           /* Add the base time to this. */
@@ -153,7 +203,7 @@ int clock_gettime(clockid_t clock_id, struct timespec *tp)
 
           /* Handle carry to seconds. */
 
-          if (nsecs > NSEC_PER_SEC)
+          if (nsecs >= NSEC_PER_SEC)
             {
               uint32_t dwCarrySecs = nsecs / NSEC_PER_SEC;
               secs  += dwCarrySecs;
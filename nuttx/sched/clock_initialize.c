@@ -52,6 +52,7 @@
 #include <nuttx/clock.h>
 #include <nuttx/time.h>
 #include <nuttx/rtc.h>
+#include <nuttx/arch.h>
 
 #include "clock_internal.h"
 
@@ -90,6 +91,11 @@ uint32_t          g_tickbias;
 
 struct timespec   g_basetime;
 
+#ifdef CONFIG_CLOCK_HIRES
+struct timespec   g_hrbias;
+struct timespec   g_hrticktime;
+#endif
+
 /**************************************************************************
  * Private Variables
  **************************************************************************/
@@ -184,6 +190,11 @@ static void clock_inittime(void)
   clock_basetime(&g_basetime);
   g_system_timer = 0;
   g_tickbias     = 0;
+
+#ifdef CONFIG_CLOCK_HIRES
+  up_hrclock_gettime(&g_hrbias);
+  g_hrticktime = g_hrbias;
+#endif
 }
 
 /****************************************************************************
@@ -267,4 +278,12 @@ void clock_timer(void)
   /* Increment the per-tick system counter */
 
   g_system_timer++;
+
+  /* Remember when the tick occurred so that delays can be measured from
+   * the tick rather than rounded up to a whole tick.
+   */
+
+#ifdef CONFIG_CLOCK_HIRES
+  up_hrclock_gettime(&g_hrticktime);
+#endif
 }
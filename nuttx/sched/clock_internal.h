@@ -59,6 +59,18 @@
 #  undef CONFIG_SYSTEM_TIME64
 #endif
 
+/* clock_time2delay() returns a delay of zero for a time that occurs before
+ * the next system timer tick, so only a negative delay means that the time
+ * has already passed.  clock_time2ticks() rounds up, so any delay that is
+ * not positive means that the time has passed.
+ */
+
+#ifdef CONFIG_CLOCK_HIRES
+#  define CLOCK_EXPIRED(delay) ((delay) < 0)
+#else
+#  define CLOCK_EXPIRED(delay) ((delay) <= 0)
+#endif
+
 /********************************************************************************
  * Public Type Definitions
  ********************************************************************************/
@@ -75,6 +87,16 @@ extern uint32_t        g_tickbias;
 
 extern struct timespec g_basetime;
 
+#ifdef CONFIG_CLOCK_HIRES
+/* g_hrbias is the high-resolution clock time corresponding to g_basetime.
+ * g_hrticktime is the high-resolution clock time of the last system timer
+ * tick.
+ */
+
+extern struct timespec g_hrbias;
+extern struct timespec g_hrticktime;
+#endif
+
 /********************************************************************************
  * Public Function Prototypes
  ********************************************************************************/
@@ -88,4 +110,8 @@ int    clock_abstime2ticks(clockid_t clockid,
 int    clock_time2ticks(FAR const struct timespec *reltime, FAR int *ticks);
 int    clock_ticks2time(int ticks, FAR struct timespec *reltime);
 
+#ifdef CONFIG_CLOCK_HIRES
+int    clock_time2delay(FAR const struct timespec *reltime, FAR int *delay);
+#endif
+
 #endif /* __SCHED_CLOCK_INTERNAL_H */
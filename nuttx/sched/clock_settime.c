@@ -46,6 +46,8 @@
 #include <debug.h>
 
 #include <arch/irq.h>
+#include <nuttx/arch.h>
+
 #include "clock_internal.h"
 
 /************************************************************************
@@ -122,7 +124,15 @@ int clock_settime(clockid_t clock_id, FAR const struct timespec *tp)
        * as appropriate.
        */
 
+#ifdef CONFIG_SCHED_TICKLESS
+      g_tickbias = clock_systimer();
+#else
       g_tickbias = g_system_timer;
+#endif
+
+#ifdef CONFIG_CLOCK_HIRES
+      up_hrclock_gettime(&g_hrbias);
+#endif
 
       /* Setup the RTC (lo- or high-res) */
 
@@ -42,6 +42,7 @@
 #include <stdint.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/arch.h>
 
 #include "clock_internal.h"
 
@@ -76,7 +77,11 @@
 #if !defined(clock_systimer) /* See nuttx/clock.h */
 uint32_t clock_systimer(void)
 {
-#ifdef CONFIG_SYSTEM_TIME64
+#if defined(CONFIG_SCHED_TICKLESS)
+  /* In tickless mode, the architecture timer provides the current tick */
+
+  return up_timer_gettick();
+#elif defined(CONFIG_SYSTEM_TIME64)
   return (uint32_t)(g_system_timer & 0x00000000ffffffff);
 #else
   return g_system_timer;
@@ -0,0 +1,160 @@
+/****************************************************************************
+ * sched/clock_time2delay.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#include <arch/irq.h>
+#include <nuttx/arch.h>
+
+#include "clock_internal.h"
+
+#ifdef CONFIG_CLOCK_HIRES
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Type Declarations
+ ****************************************************************************/
+
+/****************************************************************************
+ * Global Variables
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_time2delay
+ *
+ * Description:
+ *   Convert a relative time to a wd_start() delay.  clock_time2ticks()
+ *   must assume that the current tick has just begun so, together with the
+ *   extra tick added by wd_start(), a delay may be extended by up to two
+ *   ticks.  This function uses the high-resolution clock to measure how
+ *   much of the current tick has already elapsed and selects the first
+ *   tick that occurs at or after the requested time, so that the delay is
+ *   extended by less than one tick.
+ *
+ * Parameters:
+ *   reltime - Convert this relative time to a watchdog delay.
+ *   delay - Return the delay to pass to wd_start() here.  This is zero if
+ *     the time occurs before the next tick and negative if reltime is zero
+ *     or negative (see CLOCK_EXPIRED()).
+ *
+ * Return Value:
+ *   Always returns OK
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+int clock_time2delay(FAR const struct timespec *reltime, FAR int *delay)
+{
+#if defined(CONFIG_HAVE_LONG_LONG) && !defined(CONFIG_SCHED_TICKLESS)
+  struct timespec now;
+  irqstate_t flags;
+  int64_t relnsec;
+  int64_t phase;
+  int64_t ticks;
+#endif
+
+  /* A delay of zero means the next tick, so report a time that has already
+   * passed with a negative delay.
+   */
+
+  if (reltime->tv_sec < 0 || (reltime->tv_sec == 0 && reltime->tv_nsec <= 0))
+    {
+      *delay = -1;
+      return OK;
+    }
+
+#if defined(CONFIG_HAVE_LONG_LONG) && !defined(CONFIG_SCHED_TICKLESS)
+  relnsec = (int64_t)reltime->tv_sec * NSEC_PER_SEC +
+            (int64_t)reltime->tv_nsec;
+
+  /* Get the time elapsed since the last system timer tick.  The tick may
+   * be late (for example, if interrupts were disabled) so the result is
+   * limited to less than one tick.
+   */
+
+  flags = irqsave();
+  up_hrclock_gettime(&now);
+  phase = (int64_t)(now.tv_sec - g_hrticktime.tv_sec) * NSEC_PER_SEC +
+          (int64_t)(now.tv_nsec - g_hrticktime.tv_nsec);
+  irqrestore(flags);
+
+  if (phase < 0)
+    {
+      phase = 0;
+    }
+  else if (phase >= NSEC_PER_TICK)
+    {
+      phase = NSEC_PER_TICK - 1;
+    }
+
+  /* The n'th tick from now occurs n * NSEC_PER_TICK - phase nanoseconds from
+   * now.  wd_start() waits for delay + 1 ticks, so a time before the next
+   * tick needs a delay of zero.
+   */
+
+  ticks = (relnsec + phase + NSEC_PER_TICK - 1) / NSEC_PER_TICK - 1;
+  *delay = ticks > 0 ? (int)ticks : 0;
+  return OK;
+#else
+  /* The phase of the current tick is not known in tickless mode */
+
+  return clock_time2ticks(reltime, delay);
+#endif
+}
+
+#endif /* CONFIG_CLOCK_HIRES */
@@ -75,6 +75,31 @@
 
 #define NUM_INTERRUPT_MSGS   8
 
+/* Values for the mqmsg flags field */
+
+#define MQ_MSGFLAG_REF       (1 << 0) /* Payload is held by reference (mq_sendref) */
+
+/* The payload storage needed by a message that holds 'n' bytes of data.
+ * A message sent by reference needs room for the reference instead.
+ */
+
+#ifdef CONFIG_MQ_SENDREF
+#  define MQ_PAYLOAD_SIZE(n) \
+     ((n) > sizeof(struct mqref_s) ? (n) : sizeof(struct mqref_s))
+#else
+#  define MQ_PAYLOAD_SIZE(n) (n)
+#endif
+
+/* The size of a message with room for 'n' bytes of data, rounded up so that
+ * the messages in a per-queue pool stay pointer-aligned.
+ */
+
+#define MQ_MSG_ALIGN         sizeof(FAR void *)
+#define MQ_MSG_ALIGNUP(n)    (((n) + MQ_MSG_ALIGN - 1) & ~(MQ_MSG_ALIGN - 1))
+#define SIZEOF_MQ_MSG_HEADER ((size_t)&(((FAR mqmsg_t*)NULL)->u))
+#define MQ_MSG_SIZE(n) \
+  MQ_MSG_ALIGNUP(SIZEOF_MQ_MSG_HEADER + MQ_PAYLOAD_SIZE(n))
+
 /****************************************************************************
  * Global Type Declarations
  ****************************************************************************/
@@ -83,24 +108,48 @@ enum mqalloc_e
 {
   MQ_ALLOC_FIXED = 0,  /* pre-allocated; never freed */
   MQ_ALLOC_DYN,        /* dynamically allocated; free when unused */
-  MQ_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_IRQ,        /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_QUEUE       /* Preallocated in the message queue's own pool */
 };
 
 typedef enum mqalloc_e mqalloc_t;
 
-/* This structure describes one buffered POSIX message. */
+#ifdef CONFIG_MQ_SENDREF
+/* This describes a message payload that was sent by reference */
+
+struct mqref_s
+{
+  FAR const void *buffer;     /* The sender's message data */
+  mq_release_t release;       /* Called when the data is no longer needed */
+  FAR void    *arg;           /* Argument passed to 'release' */
+};
+#endif
+
+/* This structure describes one buffered POSIX message.  Messages in the
+ * global free lists have room for MQ_MAX_BYTES of data; messages in a
+ * per-queue pool have room only for that queue's maximum message size.
+ */
 
 struct mqmsg
 {
   FAR struct mqmsg  *next;    /* Forward link to next message */
   uint8_t      type;          /* (Used to manage allocations) */
   uint8_t      priority;      /* priority of message          */
+#ifdef CONFIG_MQ_SENDREF
+  uint8_t      flags;         /* See MQ_MSGFLAG_* definitions */
+#endif
 #if MQ_MAX_BYTES < 256
   uint8_t      msglen;        /* Message data length          */
 #else
   uint16_t     msglen;        /* Message data length          */
 #endif
-  uint8_t      mail[MQ_MAX_BYTES]; /* Message data            */
+  union
+  {
+#ifdef CONFIG_MQ_SENDREF
+    struct mqref_s ref;       /* Reference to the data (MQ_MSGFLAG_REF) */
+#endif
+    uint8_t    mail[MQ_MAX_BYTES]; /* Message data            */
+  } u;
 };
 
 typedef struct mqmsg mqmsg_t;
@@ -151,7 +200,7 @@ void mq_desblockalloc(void);
 
 mqd_t mq_descreate(FAR struct tcb_s* mtcb, FAR msgq_t* msgq, int oflags);
 FAR msgq_t  *mq_findnamed(const char *mq_name);
-void mq_msgfree(FAR mqmsg_t *mqmsg);
+void mq_msgfree(FAR msgq_t *msgq, FAR mqmsg_t *mqmsg);
 void mq_msgqfree(FAR msgq_t *msgq);
 
 /* mq_waitirq.c ************************************************************/
@@ -167,10 +216,11 @@ ssize_t mq_doreceive(mqd_t mqdes, mqmsg_t *mqmsg, void *ubuffer, int *prio);
 /* mq_sndinternal.c ********************************************************/
 
 int mq_verifysend(mqd_t mqdes, const void *msg, size_t msglen, int prio);
-FAR mqmsg_t *mq_msgalloc(void);
+FAR mqmsg_t *mq_msgalloc(FAR msgq_t *msgq);
 int mq_waitsend(mqd_t mqdes);
 int mq_dosend(mqd_t mqdes, FAR mqmsg_t *mqmsg, const void *msg,
               size_t msglen, int prio);
+int mq_doenqueue(mqd_t mqdes, FAR mqmsg_t *mqmsg);
 
 /* mq_release.c ************************************************************/
 
@@ -74,9 +74,11 @@
  * Description:
  *   The mq_msgfree function will return a message to the free pool of
  *   messages if it was a pre-allocated message. If the message was
- *   allocated dynamically it will be deallocated.
+ *   allocated dynamically it will be deallocated.  If the message was
+ *   sent by reference, the sender's buffer is released first.
  *
  * Inputs:
+ *   msgq  - The message queue that the message was sent to
  *   mqmsg - message to free
  *
  * Return Value:
@@ -84,14 +86,43 @@
  *
  ************************************************************************/
 
-void mq_msgfree(FAR mqmsg_t *mqmsg)
+void mq_msgfree(FAR msgq_t *msgq, FAR mqmsg_t *mqmsg)
 {
   irqstate_t saved_state;
 
+#ifdef CONFIG_MQ_SENDREF
+  /* If the message was sent by reference, then the sender's buffer
+   * is no longer needed.
+   */
+
+  if ((mqmsg->flags & MQ_MSGFLAG_REF) != 0 && mqmsg->u.ref.release)
+    {
+      mqmsg->u.ref.release(mqmsg->u.ref.buffer, mqmsg->u.ref.arg);
+    }
+#endif
+
+#ifdef CONFIG_MQ_MSGPOOL
+  /* If the message came from the message queue's own pool, then
+   * put it back in that pool.
+   */
+
+  if (mqmsg->type == MQ_ALLOC_QUEUE)
+    {
+      /* Make sure we avoid concurrent access to the free
+       * list from interrupt handlers.
+       */
+
+      saved_state = irqsave();
+      sq_addlast((FAR sq_entry_t*)mqmsg, &msgq->msgfree);
+      irqrestore(saved_state);
+    }
+
   /* If this is a generally available pre-allocated message,
    * then just put it back in the free list.
    */
 
+  else
+#endif
   if (mqmsg->type == MQ_ALLOC_FIXED)
     {
       /* Make sure we avoid concurrent access to the free
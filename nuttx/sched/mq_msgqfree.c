@@ -98,11 +98,13 @@ void mq_msgqfree(FAR msgq_t *msgq)
       /* Deallocate the message structure. */
 
       next = curr->next;
-      mq_msgfree(curr);
+      mq_msgfree(msgq, curr);
       curr = next;
     }
 
-  /* Then deallocate the message queue itself */
+  /* Then deallocate the message queue itself (and its message pool, if
+   * CONFIG_MQ_MSGPOOL is selected)
+   */
 
   sched_kfree(msgq);
 }
@@ -100,6 +100,11 @@
  *        created to determine the maximum number of
  *        messages that may be placed in the message queue.
  *
+ *   If CONFIG_MQ_MSGPOOL is selected, then mq_maxmsg messages, each with
+ *   room for mq_msgsize bytes, are allocated along with a new message
+ *   queue.  Messages are then sent without accessing the global free
+ *   message lists or the heap.
+ *
  * Return Value:
  *   A message queue descriptor or -1 (ERROR)
  *
@@ -114,7 +119,16 @@ mqd_t mq_open(const char *mq_name, int oflags, ...)
   mqd_t mqdes = NULL;
   va_list arg;                  /* Points to each un-named argument */
   struct mq_attr *attr;         /* MQ creation attributes */
+  size_t size;                  /* Size of the MQ allocation */
+  int16_t maxmsgs;              /* Maximum number of messages */
+  uint8_t maxmsgsize;           /* Maximum size of one message */
   int namelen;                  /* Length of MQ name */
+#ifdef CONFIG_MQ_MSGPOOL
+  FAR uint8_t *pool;            /* Next message in the MQ pool */
+  size_t poolofs;               /* Offset to the MQ pool */
+  size_t msgsize;               /* Size of each message in the MQ pool */
+  int i;
+#endif
 
   /* Make sure that a non-NULL name is supplied */
 
@@ -151,12 +165,47 @@ mqd_t mq_open(const char *mq_name, int oflags, ...)
 
           else if ((oflags & O_CREAT) != 0)
             {
+              /* Get the optional arguments needed to create a message
+               * queue.
+               */
+
+              va_start(arg, oflags);
+              (void)va_arg(arg, mode_t); /* MQ creation mode parameter (ignored) */
+              attr = va_arg(arg, struct mq_attr*);
+              va_end(arg);
+
+              if (attr)
+                {
+                  maxmsgs = (int16_t)attr->mq_maxmsg;
+                  if (attr->mq_msgsize <= MQ_MAX_BYTES)
+                    {
+                      maxmsgsize = (uint8_t)attr->mq_msgsize;
+                    }
+                  else
+                    {
+                      maxmsgsize = MQ_MAX_BYTES;
+                    }
+                }
+              else
+                {
+                  maxmsgs    = MQ_MAX_MSGS;
+                  maxmsgsize = MQ_MAX_BYTES;
+                }
+
               /* Allocate memory for the new message queue.  The size to
                * allocate is the size of the msgq_t header plus the size
-               * of the message queue name+1.
+               * of the message queue name+1 (plus the message pool).
                */
 
-              msgq = (FAR msgq_t*)kzalloc(SIZEOF_MQ_HEADER + namelen + 1);
+              size = SIZEOF_MQ_HEADER + namelen + 1;
+
+#ifdef CONFIG_MQ_MSGPOOL
+              poolofs = MQ_MSG_ALIGNUP(size);
+              msgsize = MQ_MSG_SIZE(maxmsgsize);
+              size    = poolofs + (maxmsgs > 0 ? maxmsgs : 0) * msgsize;
+#endif
+
+              msgq = (FAR msgq_t*)kzalloc(size);
               if (msgq)
                 {
                   /* Create a message queue descriptor for the TCB */
@@ -164,50 +213,37 @@ mqd_t mq_open(const char *mq_name, int oflags, ...)
                   mqdes = mq_descreate(rtcb, msgq, oflags);
                   if (mqdes)
                     {
-                      /* Set up to get the optional arguments needed to create
-                       * a message queue.
-                       */
-
-                      va_start(arg, oflags);
-                      (void)va_arg(arg, mode_t); /* MQ creation mode parameter (ignored) */
-                      attr = va_arg(arg, struct mq_attr*);
-
                       /* Initialize the new named message queue */
 
                       sq_init(&msgq->msglist);
-                      if (attr)
-                        {
-                          msgq->maxmsgs = (int16_t)attr->mq_maxmsg;
-                          if (attr->mq_msgsize <= MQ_MAX_BYTES)
-                            {
-                              msgq->maxmsgsize = (int16_t)attr->mq_msgsize;
-                            }
-                          else
-                            {
-                              msgq->maxmsgsize = MQ_MAX_BYTES;
-                            }
-                        }
-                      else
-                        {
-                          msgq->maxmsgs = MQ_MAX_MSGS;
-                          msgq->maxmsgsize = MQ_MAX_BYTES;
-                        }
-
-                      msgq->nconnect = 1;
+                      msgq->maxmsgs    = maxmsgs;
+                      msgq->maxmsgsize = maxmsgsize;
+                      msgq->nconnect   = 1;
 #ifndef CONFIG_DISABLE_SIGNALS
-                      msgq->ntpid    = INVALID_PROCESS_ID;
+                      msgq->ntpid      = INVALID_PROCESS_ID;
 #endif
                       strcpy(msgq->name, mq_name);
 
+#ifdef CONFIG_MQ_MSGPOOL
+                      /* Carve the message pool out of the memory that
+                       * follows the message queue name.
+                       */
+
+                      sq_init(&msgq->msgfree);
+                      pool = (FAR uint8_t *)msgq + poolofs;
+
+                      for (i = 0; i < maxmsgs; i++, pool += msgsize)
+                        {
+                          ((FAR mqmsg_t *)pool)->type = MQ_ALLOC_QUEUE;
+                          sq_addlast((FAR sq_entry_t*)pool, &msgq->msgfree);
+                        }
+#endif
+
                       /* Add the new message queue to the list of
                        * message queues
                        */
 
                       sq_addlast((FAR sq_entry_t*)msgq, &g_msgqueues);
-
-                      /* Clean-up variable argument stuff */
-
-                      va_end(arg);
                     }
                   else
                     {
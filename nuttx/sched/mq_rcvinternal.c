@@ -258,7 +258,20 @@ ssize_t mq_doreceive(mqd_t mqdes, mqmsg_t *mqmsg, void *ubuffer, int *prio)
 
   /* Copy the message into the caller's buffer */
 
-  memcpy(ubuffer, (const void*)mqmsg->mail, rcvmsglen);
+#ifdef CONFIG_MQ_SENDREF
+  if ((mqmsg->flags & MQ_MSGFLAG_REF) != 0)
+    {
+      /* The message was sent by reference.  Copy the data directly from
+       * the sender's buffer.
+       */
+
+      memcpy(ubuffer, mqmsg->u.ref.buffer, rcvmsglen);
+    }
+  else
+#endif
+    {
+      memcpy(ubuffer, (const void*)mqmsg->u.mail, rcvmsglen);
+    }
 
   /* Copy the message priority as well (if a buffer is provided) */
 
@@ -269,11 +282,11 @@ ssize_t mq_doreceive(mqd_t mqdes, mqmsg_t *mqmsg, void *ubuffer, int *prio)
 
   /* We are done with the message.  Deallocate it now. */
 
-  mq_msgfree(mqmsg);
+  msgq = mqdes->msgq;
+  mq_msgfree(msgq, mqmsg);
 
   /* Check if any tasks are waiting for the MQ not full event. */
 
-  msgq = mqdes->msgq;
   if (msgq->nwaitnotfull > 0)
     {
       /* Find the highest priority task that is waiting for
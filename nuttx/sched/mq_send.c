@@ -152,7 +152,7 @@ int mq_send(mqd_t mqdes, const void *msg, size_t msglen, int prio)
       /* Allocate the message */
 
       irqrestore(saved_state);
-      mqmsg = mq_msgalloc();
+      mqmsg = mq_msgalloc(msgq);
     }
   else
     {
@@ -0,0 +1,162 @@
+/****************************************************************************
+ * sched/mq_sendref.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include  <nuttx/config.h>
+
+#include  <sys/types.h>
+#include  <mqueue.h>
+#include  <errno.h>
+#include  <debug.h>
+
+#include  <nuttx/arch.h>
+#include  <nuttx/mqueue.h>
+
+#include  "os_internal.h"
+#include  "mq_internal.h"
+
+#ifdef CONFIG_MQ_SENDREF
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Type Declarations
+ ****************************************************************************/
+
+/****************************************************************************
+ * Global Variables
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_sendref
+ *
+ * Description:
+ *   This function adds a reference to the message data in 'buffer' to the
+ *   message queue (mqdes).  The data is not copied until it is received.
+ *   See include/nuttx/mqueue.h for a full description.
+ *
+ * Parameters:
+ *   mqdes   - Message queue descriptor
+ *   buffer  - The message data.  Must remain valid until released.
+ *   buflen  - The length of the message in bytes
+ *   prio    - The priority of the message
+ *   release - Called when the buffer is no longer needed (may be NULL)
+ *   arg     - The argument passed to 'release'
+ *
+ * Return Value:
+ *   On success, mq_sendref() returns 0 (OK); on error, -1 (ERROR)
+ *   is returned, with errno set to indicate the error (see mq_send()).
+ *
+ * Assumptions/restrictions:
+ *
+ ****************************************************************************/
+
+int mq_sendref(mqd_t mqdes, FAR const void *buffer, size_t buflen, int prio,
+               mq_release_t release, FAR void *arg)
+{
+  FAR msgq_t  *msgq;
+  FAR mqmsg_t *mqmsg = NULL;
+  irqstate_t   saved_state;
+  int          ret = ERROR;
+
+  /* Verify the input parameters -- setting errno appropriately
+   * on any failures to verify.
+   */
+
+  if (mq_verifysend(mqdes, buffer, buflen, prio) != OK)
+    {
+      return ERROR;
+    }
+
+  /* Get a pointer to the message queue */
+
+  sched_lock();
+  msgq = mqdes->msgq;
+
+  /* Allocate a message structure exactly as mq_send() does */
+
+  saved_state = irqsave();
+  if (up_interrupt_context()      || /* In an interrupt handler */
+      msgq->nmsgs < msgq->maxmsgs || /* OR Message queue not full */
+      mq_waitsend(mqdes) == OK)      /* OR Successfully waited for mq not full */
+    {
+      /* Allocate the message */
+
+      irqrestore(saved_state);
+      mqmsg = mq_msgalloc(msgq);
+    }
+  else
+    {
+      irqrestore(saved_state);
+    }
+
+  if (mqmsg)
+    {
+      /* Queue the reference in place of the message data.  The storage
+       * of every message is large enough to hold the reference.
+       */
+
+      mqmsg->priority          = prio;
+      mqmsg->msglen            = buflen;
+      mqmsg->flags             = MQ_MSGFLAG_REF;
+      mqmsg->u.ref.buffer      = buffer;
+      mqmsg->u.ref.release     = release;
+      mqmsg->u.ref.arg         = arg;
+
+      ret = mq_doenqueue(mqdes, mqmsg);
+    }
+
+  sched_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_MQ_SENDREF */
@@ -138,8 +138,11 @@ int mq_verifysend(mqd_t mqdes, const void *msg, size_t msglen, int prio)
  *
  * Description:
  *   The mq_msgalloc function will get a free message for use by the
- *   operating system.  The message will be allocated from the g_msgfree
- *   list.
+ *   operating system.  If CONFIG_MQ_MSGPOOL is selected, the message will
+ *   normally be taken from the message queue's own pool.  That pool holds
+ *   one message for each message that the queue can hold so it is empty
+ *   only if an interrupt handler has sent to a full message queue.
+ *   Otherwise, the message will be allocated from the g_msgfree list.
  *
  *   If the list is empty AND the message is NOT being allocated from the
  *   interrupt level, then the message will be allocated.  If a message
@@ -152,7 +155,7 @@ int mq_verifysend(mqd_t mqdes, const void *msg, size_t msglen, int prio)
  *   handler will be notified.
  *
  * Inputs:
- *   None
+ *   msgq - The message queue that the message will be sent to
  *
  * Return Value:
  *   A reference to the allocated msg structure.  On a failure to allocate,
@@ -160,11 +163,27 @@ int mq_verifysend(mqd_t mqdes, const void *msg, size_t msglen, int prio)
  *
  ****************************************************************************/
 
-FAR mqmsg_t *mq_msgalloc(void)
+FAR mqmsg_t *mq_msgalloc(FAR msgq_t *msgq)
 {
   FAR mqmsg_t *mqmsg;
   irqstate_t   saved_state;
 
+#ifdef CONFIG_MQ_MSGPOOL
+  /* Try the message queue's own pool first.  Disable interrupts -- we might
+   * be called from an interrupt handler or a message might be freed by an
+   * interrupt handler.
+   */
+
+  saved_state = irqsave();
+  mqmsg = (FAR mqmsg_t*)sq_remfirst(&msgq->msgfree);
+  irqrestore(saved_state);
+
+  if (mqmsg)
+    {
+      return mqmsg;
+    }
+#endif
+
   /* If we were called from an interrupt handler, then try to get the message
    * from generally available list of messages. If this fails, then try the
    * list of messages reserved for interrupt handlers
@@ -306,10 +325,8 @@ int mq_waitsend(mqd_t mqdes)
  *
  * Description:
  *   This is internal, common logic shared by both mq_send and mq_timesend.
- *   This function adds the specificied message (msg) to the message queue
- *   (mqdes).  Then it notifies any tasks that were waiting for message
- *   queue notifications setup by mq_notify.  And, finally, it awakens any
- *   tasks that were waiting for the message not empty event.
+ *   This function copies the specificied message (msg) into the message
+ *   structure and adds it to the message queue (mqdes).
  * 
  * Parameters:
  *   mqdes - Message queue descriptor
@@ -325,27 +342,60 @@ int mq_waitsend(mqd_t mqdes)
  ****************************************************************************/
 
 int mq_dosend(mqd_t mqdes, FAR mqmsg_t *mqmsg, const void *msg, size_t msglen, int prio)
+{
+  /* Construct the message header info */
+
+  mqmsg->priority = prio;
+  mqmsg->msglen   = msglen;
+#ifdef CONFIG_MQ_SENDREF
+  mqmsg->flags    = 0;
+#endif
+
+  /* Copy the message data into the message */
+
+  memcpy((void*)mqmsg->u.mail, (const void*)msg, msglen);
+
+  /* And add the message to the message queue */
+
+  return mq_doenqueue(mqdes, mqmsg);
+}
+
+/****************************************************************************
+ * Name: mq_doenqueue
+ *
+ * Description:
+ *   This is internal, common logic shared by mq_dosend and mq_sendref.
+ *   This function adds the fully initialized message (mqmsg) to the
+ *   message queue (mqdes) in priority order.  Then it notifies any tasks
+ *   that were waiting for message queue notifications setup by mq_notify.
+ *   And, finally, it awakens any tasks that were waiting for the message
+ *   not empty event.
+ * 
+ * Parameters:
+ *   mqdes - Message queue descriptor
+ *   mqmsg - The message to add, with priority, length, and data set
+ *
+ * Return Value:
+ *   This function always returns OK.
+ *
+ * Assumptions/restrictions:
+ *
+ ****************************************************************************/
+
+int mq_doenqueue(mqd_t mqdes, FAR mqmsg_t *mqmsg)
 {
   FAR struct tcb_s *btcb;
   FAR msgq_t *msgq;
   FAR mqmsg_t *next;
   FAR mqmsg_t *prev;
   irqstate_t saved_state;
+  int prio = mqmsg->priority;
 
   /* Get a pointer to the message queue */
 
   sched_lock();
   msgq = mqdes->msgq;
 
-  /* Construct the message header info */
-
-  mqmsg->priority = prio;
-  mqmsg->msglen   = msglen;
-
-  /* Copy the message data into the message */
-
-  memcpy((void*)mqmsg->mail, (const void*)msg, msglen);
-
   /* Insert the new message in the message queue */
 
   saved_state = irqsave();
@@ -249,7 +249,7 @@ ssize_t mq_timedreceive(mqd_t mqdes, void *msg, size_t msglen,
        * return immediately.
        */
 
-      if (result == OK && ticks <= 0)
+      if (result == OK && CLOCK_EXPIRED(ticks))
         {
           result = ETIMEDOUT;
         }
@@ -234,7 +234,7 @@ int mq_timedsend(mqd_t mqdes, const char *msg, size_t msglen, int prio,
       /* Allocate the message */
 
       irqrestore(saved_state);
-      mqmsg = mq_msgalloc();
+      mqmsg = mq_msgalloc(msgq);
     }
   else
     {
@@ -253,7 +253,7 @@ int mq_timedsend(mqd_t mqdes, const char *msg, size_t msglen, int prio,
        * return immediately.
        */
 
-      if (result == OK && ticks <= 0)
+      if (result == OK && CLOCK_EXPIRED(ticks))
         {
           result = ETIMEDOUT;
         }
@@ -296,7 +296,7 @@ int mq_timedsend(mqd_t mqdes, const char *msg, size_t msglen, int prio,
 
       if (ret == OK)
         {
-          mqmsg = mq_msgalloc();
+          mqmsg = mq_msgalloc(msgq);
         }
     }
 
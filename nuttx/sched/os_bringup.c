@@ -44,6 +44,7 @@
 #include <nuttx/config.h>
 
 #include <sched.h>
+#include <semaphore.h>
 #include <stdlib.h>
 #include <debug.h>
 
@@ -115,8 +116,8 @@
  *
  *   - pg_worker:   The page-fault worker thread (only if CONFIG_PAGING is
  *                  defined.
- *   - work_thread: The work thread.  This general thread can be used to
- *                  perform most any kind of queued work.  Its primary
+ *   - work_thread: The work threads.  These general threads can be used to
+ *                  perform most any kind of queued work.  Their primary
  *                  function is to serve as the "bottom half" of device
  *                  drivers.
  *
@@ -130,6 +131,9 @@
 int os_bringup(void)
 {
   int taskid;
+#ifdef CONFIG_SCHED_HPWORK
+  int i;
+#endif
 
   /* Setup up the initial environment for the idle task.  At present, this
    * may consist of only the initial PATH variable.  The PATH variable is
@@ -169,10 +173,20 @@ int os_bringup(void)
   svdbg("Starting kernel worker thread\n");
 #endif
 
-  g_work[HPWORK].pid = KERNEL_THREAD(HPWORKNAME, CONFIG_SCHED_WORKPRIORITY,
-                                     CONFIG_SCHED_WORKSTACKSIZE,
-                                     (main_t)work_hpthread, (FAR char * const *)NULL);
-  DEBUGASSERT(g_work[HPWORK].pid > 0);
+  /* The worker threads wait on this semaphore for work that is ready to
+   * run.  It must be initialized before the first worker thread starts.
+   */
+
+  (void)sem_init(&g_work[HPWORK].sem, 0, 0);
+
+  for (i = 0; i < CONFIG_SCHED_WORKNTHREADS; i++)
+    {
+      g_work[HPWORK].pid[i] =
+        KERNEL_THREAD(HPWORKNAME, CONFIG_SCHED_WORKPRIORITY,
+                      CONFIG_SCHED_WORKSTACKSIZE,
+                      (main_t)work_hpthread, (FAR char * const *)NULL);
+      DEBUGASSERT(g_work[HPWORK].pid[i] > 0);
+    }
 
   /* Start a lower priority worker thread for other, non-critical continuation
    * tasks
@@ -182,10 +196,16 @@ int os_bringup(void)
 
   svdbg("Starting low-priority kernel worker thread\n");
 
-  g_work[LPWORK].pid = KERNEL_THREAD(LPWORKNAME, CONFIG_SCHED_LPWORKPRIORITY,
-                                     CONFIG_SCHED_LPWORKSTACKSIZE,
-                                     (main_t)work_lpthread, (FAR char * const *)NULL);
-  DEBUGASSERT(g_work[LPWORK].pid > 0);
+  (void)sem_init(&g_work[LPWORK].sem, 0, 0);
+
+  for (i = 0; i < CONFIG_SCHED_LPWORKNTHREADS; i++)
+    {
+      g_work[LPWORK].pid[i] =
+        KERNEL_THREAD(LPWORKNAME, CONFIG_SCHED_LPWORKPRIORITY,
+                      CONFIG_SCHED_LPWORKSTACKSIZE,
+                      (main_t)work_lpthread, (FAR char * const *)NULL);
+      DEBUGASSERT(g_work[LPWORK].pid[i] > 0);
+    }
 
 #endif /* CONFIG_SCHED_LPWORK */
 #endif /* CONFIG_SCHED_HPWORK */
@@ -81,6 +81,12 @@
 #  define KERNEL_THREAD(n,p,s,e,a)   kernel_thread(n,p,e,a)
 #endif
 
+/* The priority bitmap has one bit for each priority level */
+
+#ifdef CONFIG_SCHED_PRIOBITMAP
+#  define SCHED_PRIOINDEX_NWORDS ((SCHED_PRIORITY_MAX + 32) >> 5)
+#endif
+
 /* A more efficient ways to access the errno */
 
 #define SET_ERRNO(e) \
@@ -119,6 +125,23 @@ struct tasklist_s
 
 typedef struct tasklist_s tasklist_t;
 
+/* This structure is a constant-time index into a prioritized task list.
+ * The list itself is unchanged (it is still sorted by descending priority
+ * with FIFO order within each priority); the index remembers the last TCB
+ * of each priority and has a bit set for each priority that is present in
+ * the list.  A new TCB is inserted after the last TCB of the lowest
+ * non-empty priority that is greater than or equal to its own, which can
+ * be found with a find-first-set over the bitmap.
+ */
+
+#ifdef CONFIG_SCHED_PRIOBITMAP
+struct sched_prioindex_s
+{
+  uint32_t bitmap[SCHED_PRIOINDEX_NWORDS];    /* Non-empty priority levels */
+  FAR struct tcb_s *last[SCHED_PRIORITY_MAX+1]; /* Last TCB at each level */
+};
+#endif
+
 /****************************************************************************
  * Global Variables
  ****************************************************************************/
@@ -148,6 +171,16 @@ extern volatile dq_queue_t g_readytorun;
 
 extern volatile dq_queue_t g_pendingtasks;
 
+#ifdef CONFIG_SCHED_PRIOBITMAP
+/* These are the priority indices of the g_readytorun and g_pendingtasks
+ * lists.  They permit a TCB to be inserted into or removed from either list
+ * in constant time.
+ */
+
+extern struct sched_prioindex_s g_readytorunndx;
+extern struct sched_prioindex_s g_pendingndx;
+#endif
+
 /* This is the list of all tasks that are blocked waiting for a semaphore */
 
 extern volatile dq_queue_t g_waitingforsemaphore;
@@ -250,6 +283,19 @@ bool sched_addreadytorun(FAR struct tcb_s *rtrtcb);
 bool sched_removereadytorun(FAR struct tcb_s *rtrtcb);
 bool sched_addprioritized(FAR struct tcb_s *newTcb, DSEG dq_queue_t *list);
 bool sched_mergepending(void);
+#ifdef CONFIG_SCHED_PRIOBITMAP
+FAR struct sched_prioindex_s *sched_prioindex(DSEG dq_queue_t *list);
+FAR struct tcb_s *sched_prioindex_find(FAR struct sched_prioindex_s *ndx,
+                                       uint8_t sched_priority);
+void sched_prioindex_add(FAR struct sched_prioindex_s *ndx,
+                         FAR struct tcb_s *tcb);
+void sched_prioindex_remove(FAR struct sched_prioindex_s *ndx,
+                            FAR struct tcb_s *tcb);
+void sched_prioindex_clear(FAR struct sched_prioindex_s *ndx);
+void sched_remprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
+#else
+#  define sched_remprioritized(t,l) dq_rem((FAR dq_entry_t*)(t), (l))
+#endif
 void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state);
 void sched_removeblocked(FAR struct tcb_s *btcb);
 int  sched_setpriority(FAR struct tcb_s *tcb, int sched_priority);
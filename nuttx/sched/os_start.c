@@ -104,6 +104,15 @@ volatile dq_queue_t g_readytorun;
 
 volatile dq_queue_t g_pendingtasks;
 
+#ifdef CONFIG_SCHED_PRIOBITMAP
+/* These are the priority indices of the g_readytorun and g_pendingtasks
+ * lists.
+ */
+
+struct sched_prioindex_s g_readytorunndx;
+struct sched_prioindex_s g_pendingndx;
+#endif
+
 /* This is the list of all tasks that are blocked waiting for a semaphore */
 
 volatile dq_queue_t g_waitingforsemaphore;
@@ -311,6 +320,9 @@ void os_start(void)
   /* Then add the idle task's TCB to the head of the ready to run list */
 
   dq_addfirst((FAR dq_entry_t*)&g_idletcb, (FAR dq_queue_t*)&g_readytorun);
+#ifdef CONFIG_SCHED_PRIOBITMAP
+  sched_prioindex_add(&g_readytorunndx, &g_idletcb.cmn);
+#endif
 
   /* Initialize the processor-specific portion of the TCB */
 
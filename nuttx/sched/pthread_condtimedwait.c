@@ -255,7 +255,7 @@ int pthread_cond_timedwait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex,
                * just return with the timedout condition.
                */
 
-              if (ticks <= 0)
+              if (CLOCK_EXPIRED(ticks))
                 {
                   /* Restore interrupts and indicate that we have already timed out.
                    * (pre-emption will be enabled when we fall through the
@@ -99,6 +99,9 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 {
   FAR struct tcb_s *next;
   FAR struct tcb_s *prev;
+#ifdef CONFIG_SCHED_PRIOBITMAP
+  FAR struct sched_prioindex_s *ndx;
+#endif
   uint8_t sched_priority = tcb->sched_priority;
   bool ret = false;
 
@@ -106,13 +109,28 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 
   ASSERT(sched_priority >= SCHED_PRIORITY_MIN);
 
-  /* Search the list to find the location to insert the new Tcb.
-   * Each is list is maintained in ascending sched_priority order.
+#ifdef CONFIG_SCHED_PRIOBITMAP
+  /* If the list is indexed, then the location to insert the new TCB can
+   * be found without searching the list.
    */
 
-  for (next = (FAR struct tcb_s*)list->head;
-      (next && sched_priority <= next->sched_priority);
-      next = next->flink);
+  ndx = sched_prioindex(list);
+  if (ndx)
+    {
+      prev = sched_prioindex_find(ndx, sched_priority);
+      next = prev ? prev->flink : (FAR struct tcb_s*)list->head;
+    }
+  else
+#endif
+    {
+      /* Search the list to find the location to insert the new Tcb.
+       * Each is list is maintained in ascending sched_priority order.
+       */
+
+      for (next = (FAR struct tcb_s*)list->head;
+          (next && sched_priority <= next->sched_priority);
+          next = next->flink);
+    }
 
   /* Add the tcb to the spot found in the list.  Check if the tcb
    * goes at the end of the list. NOTE:  This could only happen if list
@@ -170,6 +188,15 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
         }
     }
 
+#ifdef CONFIG_SCHED_PRIOBITMAP
+  /* The new TCB is now the last TCB of its priority */
+
+  if (ndx)
+    {
+      sched_prioindex_add(ndx, tcb);
+    }
+#endif
+
   return ret;
 }
 
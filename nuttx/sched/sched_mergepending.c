@@ -97,9 +97,41 @@ bool sched_mergepending(void)
   FAR struct tcb_s *pndtcb;
   FAR struct tcb_s *pndnext;
   FAR struct tcb_s *rtrtcb;
+#ifndef CONFIG_SCHED_PRIOBITMAP
   FAR struct tcb_s *rtrprev;
+#endif
   bool ret = false;
 
+#ifdef CONFIG_SCHED_PRIOBITMAP
+  /* Process every TCB in the g_pendingtasks list.  The ready-to-run list is
+   * indexed, so each TCB can be inserted without searching the list.
+   */
+
+  for (pndtcb = (FAR struct tcb_s*)g_pendingtasks.head; pndtcb; pndtcb = pndnext)
+    {
+      pndnext = pndtcb->flink;
+      rtrtcb  = (FAR struct tcb_s*)g_readytorun.head;
+
+      if (sched_addprioritized(pndtcb, (FAR dq_queue_t*)&g_readytorun))
+        {
+          /* pndtcb was inserted at the head of the list. Inform the
+           * instrumentation layer that we are switching tasks.
+           */
+
+          sched_note_switch(rtrtcb, pndtcb);
+
+          rtrtcb->task_state = TSTATE_TASK_READYTORUN;
+          pndtcb->task_state = TSTATE_TASK_RUNNING;
+          ret                = true;
+        }
+      else
+        {
+          pndtcb->task_state = TSTATE_TASK_READYTORUN;
+        }
+    }
+
+  sched_prioindex_clear(&g_pendingndx);
+#else
   /* Initialize the inner search loop */
 
   rtrtcb = (FAR struct tcb_s*)g_readytorun.head;
@@ -162,6 +194,7 @@ bool sched_mergepending(void)
 
       rtrtcb = pndtcb;
     }
+#endif
 
   /* Mark the input list empty */
 
@@ -0,0 +1,289 @@
+/************************************************************************
+ * sched/sched_prioindex.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Included Files
+ ************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <queue.h>
+#include <assert.h>
+
+#include "os_internal.h"
+
+#ifdef CONFIG_SCHED_PRIOBITMAP
+
+/************************************************************************
+ * Pre-processor Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Private Type Declarations
+ ************************************************************************/
+
+/************************************************************************
+ * Global Variables
+ ************************************************************************/
+
+/************************************************************************
+ * Private Variables
+ ************************************************************************/
+
+/************************************************************************
+ * Private Function Prototypes
+ ************************************************************************/
+
+/************************************************************************
+ * Private Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name: sched_lowestbit
+ *
+ * Description:
+ *   Return the bit number of the least significant bit that is set in a
+ *   non-zero 32-bit word.
+ *
+ ************************************************************************/
+
+static inline int sched_lowestbit(uint32_t word)
+{
+  int bit = 0;
+
+  if ((word & 0x0000ffff) == 0)
+    {
+      word >>= 16;
+      bit   += 16;
+    }
+
+  if ((word & 0x000000ff) == 0)
+    {
+      word >>= 8;
+      bit   += 8;
+    }
+
+  if ((word & 0x0000000f) == 0)
+    {
+      word >>= 4;
+      bit   += 4;
+    }
+
+  if ((word & 0x00000003) == 0)
+    {
+      word >>= 2;
+      bit   += 2;
+    }
+
+  if ((word & 0x00000001) == 0)
+    {
+      bit   += 1;
+    }
+
+  return bit;
+}
+
+/************************************************************************
+ * Public Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name: sched_prioindex
+ *
+ * Description:
+ *   Return the priority index associated with a task list or NULL if the
+ *   list is not indexed (and must be searched linearly).
+ *
+ ************************************************************************/
+
+FAR struct sched_prioindex_s *sched_prioindex(DSEG dq_queue_t *list)
+{
+  if (list == (FAR dq_queue_t*)&g_readytorun)
+    {
+      return &g_readytorunndx;
+    }
+  else if (list == (FAR dq_queue_t*)&g_pendingtasks)
+    {
+      return &g_pendingndx;
+    }
+
+  return NULL;
+}
+
+/************************************************************************
+ * Name: sched_prioindex_find
+ *
+ * Description:
+ *   Find the TCB after which a new TCB of the given priority must be
+ *   inserted:  This is the last TCB in the list with a priority greater
+ *   than or equal to sched_priority.  The search examines at most
+ *   SCHED_PRIOINDEX_NWORDS words of the bitmap regardless of the number
+ *   of TCBs in the list.
+ *
+ * Return Value:
+ *   The predecessor TCB or NULL if the new TCB must be inserted at the
+ *   head of the list.
+ *
+ ************************************************************************/
+
+FAR struct tcb_s *sched_prioindex_find(FAR struct sched_prioindex_s *ndx,
+                                       uint8_t sched_priority)
+{
+  uint32_t word;
+  int wndx = sched_priority >> 5;
+
+  /* Mask off the priorities lower than sched_priority in the first word */
+
+  word = ndx->bitmap[wndx] & ~((1ul << (sched_priority & 31)) - 1);
+
+  /* Then look for the first non-empty priority level at or above
+   * sched_priority.
+   */
+
+  while (word == 0)
+    {
+      if (++wndx >= SCHED_PRIOINDEX_NWORDS)
+        {
+          return NULL;
+        }
+
+      word = ndx->bitmap[wndx];
+    }
+
+  return ndx->last[(wndx << 5) + sched_lowestbit(word)];
+}
+
+/************************************************************************
+ * Name: sched_prioindex_add
+ *
+ * Description:
+ *   Record that tcb has just been inserted into the indexed list after
+ *   all other TCBs of the same priority.
+ *
+ ************************************************************************/
+
+void sched_prioindex_add(FAR struct sched_prioindex_s *ndx,
+                         FAR struct tcb_s *tcb)
+{
+  uint8_t sched_priority = tcb->sched_priority;
+
+  ndx->last[sched_priority] = tcb;
+  ndx->bitmap[sched_priority >> 5] |= (1ul << (sched_priority & 31));
+}
+
+/************************************************************************
+ * Name: sched_prioindex_remove
+ *
+ * Description:
+ *   Update the index before tcb is removed from the indexed list.  This
+ *   must be called while tcb is still linked into the list.
+ *
+ ************************************************************************/
+
+void sched_prioindex_remove(FAR struct sched_prioindex_s *ndx,
+                            FAR struct tcb_s *tcb)
+{
+  uint8_t sched_priority = tcb->sched_priority;
+  FAR struct tcb_s *prev;
+
+  if (ndx->last[sched_priority] == tcb)
+    {
+      /* tcb was the last of its priority.  The previous TCB becomes the
+       * last one if it has the same priority; otherwise the priority level
+       * is now empty.
+       */
+
+      prev = (FAR struct tcb_s*)tcb->blink;
+      if (prev && prev->sched_priority == sched_priority)
+        {
+          ndx->last[sched_priority] = prev;
+        }
+      else
+        {
+          ndx->last[sched_priority] = NULL;
+          ndx->bitmap[sched_priority >> 5] &= ~(1ul << (sched_priority & 31));
+        }
+    }
+}
+
+/************************************************************************
+ * Name: sched_prioindex_clear
+ *
+ * Description:
+ *   Mark every priority level of the index empty.  The stale last[]
+ *   entries need not be cleared:  They are only consulted when the
+ *   corresponding bitmap bit is set and they are always rewritten when
+ *   the bit is set again.
+ *
+ ************************************************************************/
+
+void sched_prioindex_clear(FAR struct sched_prioindex_s *ndx)
+{
+  int i;
+
+  for (i = 0; i < SCHED_PRIOINDEX_NWORDS; i++)
+    {
+      ndx->bitmap[i] = 0;
+    }
+}
+
+/************************************************************************
+ * Name: sched_remprioritized
+ *
+ * Description:
+ *   Remove a TCB from a task list, keeping the priority index of the list
+ *   (if any) up to date.
+ *
+ * Assumptions:
+ * - The caller has established a critical section before calling this
+ *   function.
+ *
+ ************************************************************************/
+
+void sched_remprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
+{
+  FAR struct sched_prioindex_s *ndx = sched_prioindex(list);
+
+  if (ndx)
+    {
+      sched_prioindex_remove(ndx, tcb);
+    }
+
+  dq_rem((FAR dq_entry_t*)tcb, list);
+}
+
+#endif /* CONFIG_SCHED_PRIOBITMAP */
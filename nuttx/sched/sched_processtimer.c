@@ -45,6 +45,11 @@
 # include <nuttx/arch.h>
 #endif
 
+#ifdef CONFIG_SCHED_TICKLESS
+# include <nuttx/arch.h>
+# include <nuttx/clock.h>
+#endif
+
 #include "os_internal.h"
 #include "wd_internal.h"
 #include "clock_internal.h"
@@ -188,3 +193,39 @@ void sched_process_timer(void)
 
   sched_process_timeslice();
 }
+
+/************************************************************************
+ * Name:  sched_timer_expiration
+ *
+ * Description:
+ *   In tickless mode (CONFIG_SCHED_TICKLESS), the architecture specific
+ *   logic does not call sched_process_timer() periodically.  Instead, it
+ *   calls this function when the one-shot timer programmed by
+ *   up_timer_start() expires.  This function brings the system time and
+ *   the watchdog timers up to date with up_timer_gettick() and then
+ *   programs the timer for the next watchdog expiration.
+ *
+ * Inputs:
+ *   None
+ *
+ * Return Value:
+ *   None
+ *
+ ************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+void sched_timer_expiration(void)
+{
+  uint32_t now = up_timer_gettick();
+
+  /* Bring the system time up to date */
+
+#ifndef CONFIG_DISABLE_CLOCK
+  g_system_timer = now;
+#endif
+
+  /* Process the watchdogs that have expired and re-arm the timer */
+
+  wd_expiration(now);
+}
+#endif
@@ -114,7 +114,7 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
 
   /* Remove the TCB from the ready-to-run list */
 
-  dq_rem((FAR dq_entry_t*)rtcb, (dq_queue_t*)&g_readytorun);
+  sched_remprioritized(rtcb, (FAR dq_queue_t*)&g_readytorun);
 
   rtcb->task_state = TSTATE_TASK_INVALID;
   return ret;
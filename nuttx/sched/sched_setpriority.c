@@ -149,9 +149,18 @@ int sched_setpriority(FAR struct tcb_s *tcb, int sched_priority)
 
         else
           {
-            /* Change the task priority */
+            /* Change the task priority.  The task stays at the head of
+             * the ready-to-run list but its priority index entry must
+             * follow the new priority.
+             */
 
+#ifdef CONFIG_SCHED_PRIOBITMAP
+            sched_prioindex_remove(&g_readytorunndx, tcb);
+            tcb->sched_priority = (uint8_t)sched_priority;
+            sched_prioindex_add(&g_readytorunndx, tcb);
+#else
             tcb->sched_priority = (uint8_t)sched_priority;
+#endif
           }
         break;
 
@@ -204,7 +213,7 @@ int sched_setpriority(FAR struct tcb_s *tcb, int sched_priority)
           {
             /* Remove the TCB from the prioritized task list */
 
-            dq_rem((FAR dq_entry_t*)tcb, (FAR dq_queue_t*)g_tasklisttable[task_state].list);
+            sched_remprioritized(tcb, (FAR dq_queue_t*)g_tasklisttable[task_state].list);
 
             /* Change the task priority */
 
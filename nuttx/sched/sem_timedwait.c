@@ -237,7 +237,7 @@ int sem_timedwait(FAR sem_t *sem, FAR const struct timespec *abstime)
 
   /* If the time has already expired return immediately. */
 
-  if (err == OK && ticks <= 0)
+  if (err == OK && CLOCK_EXPIRED(ticks))
     {
       err = ETIMEDOUT;
       goto errout_disabled;
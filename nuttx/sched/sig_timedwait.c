@@ -242,7 +242,12 @@ int sigtimedwait(FAR const sigset_t *set, FAR struct siginfo *info,
            * time in nanoseconds.
            */
 
-#ifdef CONFIG_HAVE_LONG_LONG
+#if defined(CONFIG_CLOCK_HIRES)
+          int delay;
+
+          (void)clock_time2delay(timeout, &delay);
+          waitticks = delay > 0 ? delay : 0;
+#elif defined(CONFIG_HAVE_LONG_LONG)
           uint64_t waitticks64 = ((uint64_t)timeout->tv_sec * NSEC_PER_SEC +
                                   (uint64_t)timeout->tv_nsec + NSEC_PER_TICK - 1) /
                                   NSEC_PER_TICK;
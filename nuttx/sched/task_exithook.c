@@ -46,6 +46,7 @@
 #include <errno.h>
 
 #include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 
 #include "os_internal.h"
@@ -568,6 +569,30 @@ static inline void task_flushstreams(FAR struct tcb_s *tcb)
 #  define task_flushstreams(tcb)
 #endif
 
+/****************************************************************************
+ * Name: task_flushmmcache
+ *
+ * Description:
+ *   Return all chunks held in the task's allocation cache to the user heap.
+ *   sched_ufree() is used because it never blocks; it will defer the
+ *   deallocation if the heap is not available.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_TASKCACHE
+static inline void task_flushmmcache(FAR struct tcb_s *tcb)
+{
+  FAR void *mem;
+
+  while ((mem = mm_taskcache_remove(tcb)) != NULL)
+    {
+      sched_ufree(mem);
+    }
+}
+#else
+#  define task_flushmmcache(tcb)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -581,6 +606,7 @@ static inline void task_flushstreams(FAR struct tcb_s *tcb)
  *   required when a task exits:
  *
  *   - All open streams are flushed and closed.
+ *   - The task's allocation cache (if any) is returned to the heap.
  *   - All functions registered with atexit() and on_exit() are called, in
  *     the reverse order of their registration.
  *
@@ -667,6 +693,10 @@ void task_exithook(FAR struct tcb_s *tcb, int status, bool nonblocking)
       task_flushstreams(tcb);
     }
 
+  /* Return the chunks held in the task's allocation cache to the heap */
+
+  task_flushmmcache(tcb);
+
   /* Leave the task group.  Perhaps discarding any un-reaped child
    * status (no zombies here!)
    */
@@ -159,8 +159,8 @@ int task_restart(pid_t pid)
        */
 
       state = irqsave();
-      dq_rem((FAR dq_entry_t*)tcb,
-             (dq_queue_t*)g_tasklisttable[tcb->cmn.task_state].list);
+      sched_remprioritized((FAR struct tcb_s *)tcb,
+                           (FAR dq_queue_t*)g_tasklisttable[tcb->cmn.task_state].list);
       tcb->cmn.task_state = TSTATE_TASK_INVALID;
       irqrestore(state);
 
@@ -148,7 +148,7 @@ static struct posix_timer_s *timer_allocate(void)
  *
  *   Each implementation defines a set of clocks that can be used as timing bases
  *   for per-thread timers. All implementations shall support a clock_id of
- *   CLOCK_REALTIME.
+ *   CLOCK_REALTIME.  CLOCK_MONOTONIC is also supported.
  *
  * Parameters:
  *   clockid - Specifies the clock to use as the timing base.
@@ -180,15 +180,15 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp, FAR timer_t *timer
   struct posix_timer_s *ret;
   WDOG_ID               wdog;
 
-  /* Sanity checks.  Also, we support only CLOCK_REALTIME */
+  /* Sanity checks.  We support only CLOCK_REALTIME and CLOCK_MONOTONIC */
 
-  if (!timerid || clockid != CLOCK_REALTIME)
+  if (!timerid || (clockid != CLOCK_REALTIME && clockid != CLOCK_MONOTONIC))
     {
       errno = EINVAL;
       return ERROR;
     }
 
-  /* Allocate a watchdog to provide the underling CLOCK_REALTIME timer */
+  /* Allocate a watchdog to provide the underling timer */
 
   wdog = wd_create();
   if (!wdog)
@@ -210,6 +210,7 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp, FAR timer_t *timer
 
   ret->pt_crefs = 1;
   ret->pt_owner = getpid();
+  ret->pt_clock = clockid;
   ret->pt_delay = 0;
   ret->pt_wdog  = wdog;
 
@@ -44,6 +44,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <time.h>
 #include <wdog.h>
 
 #include <nuttx/compiler.h>
@@ -67,6 +68,7 @@ struct posix_timer_s
   uint8_t         pt_flags;        /* See PT_FLAGS_* definitions */
   uint8_t         pt_crefs;        /* Reference count */
   uint8_t         pt_signo;        /* Notification signal */
+  clockid_t       pt_clock;        /* Clock used for absolute times */
   pid_t           pt_owner;        /* Creator of timer */
   int             pt_delay;        /* If non-zero, used to reset repetitive timers */
   int             pt_last;         /* Last value used to set watchdog */
@@ -351,10 +351,11 @@ int timer_settime(timer_t timerid, int flags, FAR const struct itimerspec *value
 #else
       /* Calculate a delay corresponding to the absolute time in 'value'.
        * NOTE:  We have internal knowledge the clock_abstime2ticks only
-       * returns an error if clockid != CLOCK_REALTIME.
+       * returns an error if the clock is not supported by clock_gettime().
+       * timer_create() accepts only clocks that are.
        */
 
-      (void)clock_abstime2ticks(CLOCK_REALTIME, &value->it_value, &delay);
+      (void)clock_abstime2ticks(timer->pt_clock, &value->it_value, &delay);
 #endif
     }
   else
@@ -364,22 +365,26 @@ int timer_settime(timer_t timerid, int flags, FAR const struct itimerspec *value
        * returns success.
        */
 
+#ifdef CONFIG_CLOCK_HIRES
+      (void)clock_time2delay(&value->it_value, &delay);
+#else
       (void)clock_time2ticks(&value->it_value, &delay);
+#endif
     }
 
   /* If the time is in the past or now, then set up the next interval
    * instead (assuming a repititive timer).
    */
 
-  if (delay <= 0)
+  if (CLOCK_EXPIRED(delay))
     {
-      delay = timer->pt_delay;
+      delay = timer->pt_delay > 0 ? timer->pt_delay : -1;
     }
 
   /* Then start the watchdog */
 
 
-  if (delay > 0)
+  if (delay >= 0)
     {
       timer->pt_last = delay;
       ret = wd_start(timer->pt_wdog, delay, (wdentry_t)timer_timeout,
@@ -90,8 +90,10 @@
 
 int wd_cancel (WDOG_ID wdid)
 {
+#ifndef CONFIG_WDOG_TIMERWHEEL
   wdog_t    *curr;
   wdog_t    *prev;
+#endif
   irqstate_t saved_state;
   int        ret = ERROR;
 
@@ -105,6 +107,13 @@ int wd_cancel (WDOG_ID wdid)
 
   if (wdid && wdid->active)
     {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+      /* Each watchdog remembers the wheel slot that holds it, so it can
+       * be unlinked directly without searching.
+       */
+
+      wd_wheel_remove(wdid);
+#else
       /* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
        * to do this because there are additional operations that need to be
        * done.
@@ -145,6 +154,7 @@ int wd_cancel (WDOG_ID wdid)
           (void)sq_remfirst(&g_wdactivelist);
         }
 
+#endif
       wdid->next = NULL;
 
       /* Return success */
@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <wdog.h>
+#include <nuttx/arch.h>
 
 #include "os_internal.h"
 #include "wd_internal.h"
@@ -95,6 +96,20 @@ int wd_gettime(WDOG_ID wdog)
   flags = irqsave();
   if (wdog && wdog->active)
     {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+      /* The watchdog expires when the wheel processes its expiry tick.  In
+       * tickless mode, some elapsed ticks may not have been processed yet.
+       */
+
+#ifdef CONFIG_SCHED_TICKLESS
+      int32_t delay = (int32_t)(wdog->expiry - up_timer_gettick()) + 1;
+#else
+      int32_t delay = (int32_t)(wdog->expiry - g_wdtick) + 1;
+#endif
+
+      irqrestore(flags);
+      return delay > 0 ? (int)delay : 0;
+#else
       /* Traverse the watchdog list accumulating lag times until we find the wdog
        * that we are looking for
        */
@@ -111,6 +126,7 @@ int wd_gettime(WDOG_ID wdog)
               return delay;
             }
         }
+#endif
     }
 
   irqrestore(flags);
@@ -69,12 +69,37 @@ sq_queue_t g_wdfreelist;
 
 FAR wdog_t *g_wdpool;
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+/* g_wdwheel is the hierarchical timer wheel that holds the active
+ * watchdogs.  See wd_internal.h for a description of its organization.
+ */
+
+dq_queue_t g_wdwheel[WDOG_WHEEL_NLEVELS][WDOG_WHEEL_NSLOTS];
+
+/* g_wdtick is the next wheel tick to be processed and g_wdnactive is the
+ * number of watchdogs held in the wheel.
+ */
+
+uint32_t g_wdtick;
+unsigned int g_wdnactive;
+
+#ifdef CONFIG_SCHED_TICKLESS
+/* g_wdnext is the up_timer_gettick() value at which the architecture
+ * timer has been asked to expire.  It is valid only if g_wdarmed is true.
+ */
+
+uint32_t g_wdnext;
+bool g_wdarmed;
+#endif
+
+#else
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 sq_queue_t g_wdactivelist;
+#endif
 
 /************************************************************************
  * Private Variables
@@ -109,6 +134,11 @@ sq_queue_t g_wdactivelist;
 
 void wd_initialize(void)
 {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  int level;
+  int slot;
+
+#endif
   /* Initialize the free watchdog list */
 
   sq_init(&g_wdfreelist);
@@ -129,7 +159,25 @@ void wd_initialize(void)
         }
     }
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* The timer wheel must be reset at initialization time. */
+
+  for (level = 0; level < WDOG_WHEEL_NLEVELS; level++)
+    {
+      for (slot = 0; slot < WDOG_WHEEL_NSLOTS; slot++)
+        {
+          dq_init(&g_wdwheel[level][slot]);
+        }
+    }
+
+  g_wdtick    = 0;
+  g_wdnactive = 0;
+#ifdef CONFIG_SCHED_TICKLESS
+  g_wdarmed   = false;
+#endif
+#else
   /* The g_wdactivelist queue must be reset at initialization time. */
 
   sq_init(&g_wdactivelist);
+#endif
 }
@@ -46,12 +46,29 @@
 #include <stdbool.h>
 #include <wdog.h>
 
+#include <queue.h>
+
 #include <nuttx/compiler.h>
 
 /************************************************************************
  * Pre-processor Definitions
  ************************************************************************/
 
+/* Timer wheel geometry.  Each level of the wheel has WDOG_WHEEL_NSLOTS
+ * slots; enough levels are provided to hold any positive delay.
+ */
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+#  ifndef CONFIG_WDOG_WHEEL_BITS
+#    define CONFIG_WDOG_WHEEL_BITS 5
+#  endif
+
+#  define WDOG_WHEEL_NSLOTS  (1 << CONFIG_WDOG_WHEEL_BITS)
+#  define WDOG_WHEEL_MASK    (WDOG_WHEEL_NSLOTS - 1)
+#  define WDOG_WHEEL_NLEVELS \
+     ((31 + CONFIG_WDOG_WHEEL_BITS - 1) / CONFIG_WDOG_WHEEL_BITS)
+#endif
+
 /************************************************************************
  * Public Type Declarations
  ************************************************************************/
@@ -63,11 +80,19 @@
 struct wdog_s
 {
   FAR struct wdog_s *next;       /* Support for singly linked lists. */
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  FAR struct wdog_s *blink;      /* Support for doubly linked wheel slots */
+  FAR dq_queue_t    *slot;       /* Wheel slot that holds the watchdog */
+#endif
   wdentry_t          func;       /* Function to execute when delay expires */
 #ifdef CONFIG_PIC
   FAR void          *picbase;    /* PIC base address */
 #endif
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  uint32_t           expiry;     /* Wheel tick at which the delay expires */
+#else
   int                lag;        /* Timer associated with the delay */
+#endif
   bool               active;     /* true if the watchdog is actively timing */
   uint8_t            argc;       /* The number of parameters to pass */
   uint32_t           parm[CONFIG_MAX_WDOGPARMS];
@@ -90,12 +115,41 @@ extern sq_queue_t g_wdfreelist;
 
 extern FAR wdog_t *g_wdpool;
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+/* g_wdwheel is the hierarchical timer wheel that holds the active
+ * watchdogs.  Level 0 holds the watchdogs that expire within the next
+ * WDOG_WHEEL_NSLOTS ticks, one slot per tick.  Each slot of level n holds
+ * the watchdogs that expire within a span of WDOG_WHEEL_NSLOTS^n ticks;
+ * these are moved ("cascaded") to a lower level when the wheel reaches
+ * that span.
+ */
+
+extern dq_queue_t g_wdwheel[WDOG_WHEEL_NLEVELS][WDOG_WHEEL_NSLOTS];
+
+/* g_wdtick is the next wheel tick to be processed and g_wdnactive is the
+ * number of watchdogs held in the wheel.
+ */
+
+extern uint32_t g_wdtick;
+extern unsigned int g_wdnactive;
+
+#ifdef CONFIG_SCHED_TICKLESS
+/* g_wdnext is the up_timer_gettick() value at which the architecture
+ * timer has been asked to expire.  It is valid only if g_wdarmed is true.
+ */
+
+extern uint32_t g_wdnext;
+extern bool g_wdarmed;
+#endif
+
+#else
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 extern sq_queue_t g_wdactivelist;
+#endif
 
 /************************************************************************
  * Public Function Prototypes
@@ -111,6 +165,17 @@ extern "C" {
 EXTERN void weak_function wd_initialize(void);
 EXTERN void weak_function wd_timer(void);
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+EXTERN void wd_wheel_add(FAR wdog_t *wdog);
+EXTERN void wd_wheel_remove(FAR wdog_t *wdog);
+EXTERN void wd_wheel_advance(FAR dq_queue_t *expired);
+EXTERN bool wd_wheel_next(FAR uint32_t *tick);
+#endif
+
+#ifdef CONFIG_SCHED_TICKLESS
+EXTERN void wd_expiration(uint32_t now);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -88,6 +88,103 @@ typedef void (*wdentry4_t)(int argc, uint32_t arg1, uint32_t arg2,
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: wd_dispatch
+ *
+ * Description:
+ *   Execute the function of an expired watchdog.
+ *
+ * Parameters:
+ *   wdog - The watchdog that has expired.  It has already been removed
+ *     from the timer queue and marked inactive.
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static inline void wd_dispatch(FAR wdog_t *wdog)
+{
+  up_setpicbase(wdog->picbase);
+  switch (wdog->argc)
+    {
+      default:
+#ifdef CONFIG_DEBUG
+        PANIC();
+#endif
+      case 0:
+        (*((wdentry0_t)(wdog->func)))(0);
+        break;
+
+#if CONFIG_MAX_WDOGPARMS > 0
+      case 1:
+        (*((wdentry1_t)(wdog->func)))(1, wdog->parm[0]);
+        break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 1
+      case 2:
+        (*((wdentry2_t)(wdog->func)))(2,
+                        wdog->parm[0], wdog->parm[1]);
+        break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 2
+      case 3:
+        (*((wdentry3_t)(wdog->func)))(3,
+                        wdog->parm[0], wdog->parm[1],
+                        wdog->parm[2]);
+        break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 3
+      case 4:
+        (*((wdentry4_t)(wdog->func)))(4,
+                        wdog->parm[0], wdog->parm[1],
+                        wdog->parm[2] ,wdog->parm[3]);
+        break;
+#endif
+    }
+}
+
+/****************************************************************************
+ * Name: wd_rearm
+ *
+ * Description:
+ *   Program the architecture timer to expire when the wheel tick 'tick'
+ *   must be processed, unless it is already programmed to expire earlier.
+ *
+ * Parameters:
+ *   tick - The wheel tick that must be processed
+ *   now  - The current up_timer_gettick() value
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+static void wd_rearm(uint32_t tick, uint32_t now)
+{
+  /* Wheel tick 'tick' is processed once up_timer_gettick() has advanced
+   * beyond it.
+   */
+
+  tick++;
+  if ((int32_t)(tick - now) <= 0)
+    {
+      tick = now + 1;
+    }
+
+  if (!g_wdarmed || (int32_t)(tick - g_wdnext) < 0)
+    {
+      g_wdnext  = tick;
+      g_wdarmed = true;
+      up_timer_start(tick - now);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -128,10 +225,14 @@ typedef void (*wdentry4_t)(int argc, uint32_t arg1, uint32_t arg2,
 int wd_start(WDOG_ID wdog, int delay, wdentry_t wdentry,  int argc, ...)
 {
   va_list    ap;
+#ifndef CONFIG_WDOG_TIMERWHEEL
   FAR wdog_t *curr;
   FAR wdog_t *prev;
   FAR wdog_t *next;
   int32_t    now;
+#elif defined(CONFIG_SCHED_TICKLESS)
+  uint32_t   now;
+#endif
   irqstate_t saved_state;
   int        i;
 
@@ -185,6 +286,33 @@ int wd_start(WDOG_ID wdog, int delay, wdentry_t wdentry,  int argc, ...)
       delay--;
     }
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* The watchdog expires when the wheel processes its delay'th tick from
+   * now.  In tickless mode, the ticks that have elapsed since the timer
+   * last expired have not yet been processed and must be accounted for.
+   */
+
+#ifdef CONFIG_SCHED_TICKLESS
+  now = up_timer_gettick();
+  if (g_wdnactive == 0)
+    {
+      /* The wheel is empty and may simply be advanced to the present */
+
+      g_wdtick = now;
+    }
+
+  wdog->expiry = now + (uint32_t)delay - 1;
+#else
+  wdog->expiry = g_wdtick + (uint32_t)delay - 1;
+#endif
+
+  wd_wheel_add(wdog);
+
+#ifdef CONFIG_SCHED_TICKLESS
+  wd_rearm(wdog->expiry, now);
+#endif
+
+#else
   /* Do the easy case first -- when the watchdog timer queue is empty. */
 
   if (g_wdactivelist.head == NULL)
@@ -263,9 +391,13 @@ int wd_start(WDOG_ID wdog, int delay, wdentry_t wdentry,  int argc, ...)
         }
     }
 
-  /* Put the lag into the watchdog structure and mark it as active. */
+  /* Put the lag into the watchdog structure. */
 
   wdog->lag = delay;
+#endif
+
+  /* Mark the watchdog as active. */
+
   wdog->active = true;
 
   irqrestore(saved_state);
@@ -290,6 +422,38 @@ int wd_start(WDOG_ID wdog, int delay, wdentry_t wdentry,  int argc, ...)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+void wd_timer(void)
+{
+  FAR wdog_t *wdog;
+  dq_queue_t expired;
+
+  /* Advance the wheel by one tick, collecting the watchdogs that expire on
+   * this tick.
+   */
+
+  wd_wheel_advance(&expired);
+
+  /* Dispatch the expired watchdogs one at a time.  A watchdog function may
+   * cancel or restart any of the watchdogs that are still waiting in the
+   * expired list.
+   */
+
+  while ((wdog = (FAR wdog_t*)expired.head) != NULL)
+    {
+      /* Remove the watchdog from the expired list and indicate that it is
+       * no longer active.
+       */
+
+      wd_wheel_remove(wdog);
+      wdog->active = false;
+
+      /* Execute the watchdog function */
+
+      wd_dispatch(wdog);
+    }
+}
+#else
 void wd_timer(void)
 {
   FAR wdog_t *wdog;
@@ -332,44 +496,69 @@ void wd_timer(void)
 
               /* Execute the watchdog function */
 
-              up_setpicbase(wdog->picbase);
-              switch (wdog->argc)
-                {
-                  default:
-#ifdef CONFIG_DEBUG
-                    PANIC();
+              wd_dispatch(wdog);
+            }
+        }
+    }
+}
 #endif
-                  case 0:
-                    (*((wdentry0_t)(wdog->func)))(0);
-                    break;
 
-#if CONFIG_MAX_WDOGPARMS > 0
-                  case 1:
-                    (*((wdentry1_t)(wdog->func)))(1, wdog->parm[0]);
-                    break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 1
-                  case 2:
-                    (*((wdentry2_t)(wdog->func)))(2,
-                                    wdog->parm[0], wdog->parm[1]);
-                    break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 2
-                  case 3:
-                    (*((wdentry3_t)(wdog->func)))(3,
-                                    wdog->parm[0], wdog->parm[1],
-                                    wdog->parm[2]);
-                    break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 3
-                  case 4:
-                    (*((wdentry4_t)(wdog->func)))(4,
-                                    wdog->parm[0], wdog->parm[1],
-                                    wdog->parm[2] ,wdog->parm[3]);
-                    break;
-#endif
-                }
-            }
+/****************************************************************************
+ * Name: wd_expiration
+ *
+ * Description:
+ *   In tickless mode, this function is called from the architecture timer
+ *   interrupt handler (via sched_timer_expiration()) instead of calling
+ *   wd_timer() on every tick.  It processes every wheel tick that has
+ *   elapsed, skipping directly over the ticks on which nothing expires or
+ *   cascades, and then programs the timer for the next tick that needs
+ *   processing.
+ *
+ * Parameters:
+ *   now - The current up_timer_gettick() value
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from the timer interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+void wd_expiration(uint32_t now)
+{
+  uint32_t next;
+
+  g_wdarmed = false;
+
+  /* Process all wheel ticks before 'now' */
+
+  while (g_wdtick != now)
+    {
+      if (!wd_wheel_next(&next) || (int32_t)(next - now) >= 0)
+        {
+          /* Nothing needs processing before 'now' */
+
+          g_wdtick = now;
+          break;
         }
+
+      g_wdtick = next;
+      wd_timer();
+    }
+
+  /* Then program the timer for the next tick that needs processing.
+   * Watchdog functions may already have done that via wd_start().
+   */
+
+  if (wd_wheel_next(&next))
+    {
+      wd_rearm(next, now);
+    }
+  else if (!g_wdarmed)
+    {
+      up_timer_start(0);
     }
 }
+#endif
@@ -0,0 +1,319 @@
+/****************************************************************************
+ * sched/wd_wheel.c
+ *
+ *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <queue.h>
+#include <wdog.h>
+
+#include "os_internal.h"
+#include "wd_internal.h"
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of tick bits below the slot index of a wheel level */
+
+#define WDOG_WHEEL_SHIFT(l)  ((l) * CONFIG_WDOG_WHEEL_BITS)
+
+/* The slot index of a tick value at a wheel level */
+
+#define WDOG_WHEEL_INDEX(t,l) (((t) >> WDOG_WHEEL_SHIFT(l)) & WDOG_WHEEL_MASK)
+
+/****************************************************************************
+ * Private Type Declarations
+ ****************************************************************************/
+
+/****************************************************************************
+ * Global Variables
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Re-insert every watchdog held in one slot of a wheel level so that
+ *   each moves to a lower level as its expiration approaches.
+ *
+ * Return Value:
+ *   The slot index that was cascaded.  Zero means that the next higher
+ *   level must be cascaded as well.
+ *
+ ****************************************************************************/
+
+static int wd_wheel_cascade(int level)
+{
+  FAR dq_queue_t *slot;
+  FAR wdog_t *wdog;
+  dq_queue_t pending;
+  int index;
+
+  index = WDOG_WHEEL_INDEX(g_wdtick, level);
+  slot  = &g_wdwheel[level][index];
+
+  /* Detach the slot contents first:  Re-inserted watchdogs may land in the
+   * same slot of the same level.
+   */
+
+  pending.head = slot->head;
+  pending.tail = slot->tail;
+  dq_init(slot);
+
+  while ((wdog = (FAR wdog_t*)dq_remfirst(&pending)) != NULL)
+    {
+      g_wdnactive--;
+      wd_wheel_add(wdog);
+    }
+
+  return index;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_add
+ *
+ * Description:
+ *   Insert an active watchdog into the timer wheel.  The wdog->expiry
+ *   field must hold the wheel tick at which the watchdog expires.  This
+ *   takes constant time regardless of the number of active watchdogs.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_add(FAR wdog_t *wdog)
+{
+  uint32_t delta = wdog->expiry - g_wdtick;
+  FAR dq_queue_t *slot;
+  int level;
+
+  if ((int32_t)delta < 0)
+    {
+      /* Already due:  Expire the watchdog on the next tick processed */
+
+      slot = &g_wdwheel[0][WDOG_WHEEL_INDEX(g_wdtick, 0)];
+    }
+  else
+    {
+      /* Select the lowest level whose span covers the delay */
+
+      for (level = 0; level < WDOG_WHEEL_NLEVELS - 1; level++)
+        {
+          if (delta < ((uint32_t)1 << WDOG_WHEEL_SHIFT(level + 1)))
+            {
+              break;
+            }
+        }
+
+      slot = &g_wdwheel[level][WDOG_WHEEL_INDEX(wdog->expiry, level)];
+    }
+
+  dq_addlast((FAR dq_entry_t*)wdog, slot);
+  wdog->slot = slot;
+  g_wdnactive++;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove a watchdog from the timer wheel (or from the list of expired
+ *   watchdogs awaiting dispatch).
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR wdog_t *wdog)
+{
+  dq_rem((FAR dq_entry_t*)wdog, wdog->slot);
+  wdog->slot = NULL;
+  g_wdnactive--;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_advance
+ *
+ * Description:
+ *   Process one tick of the timer wheel:  Cascade higher levels as
+ *   necessary and move the watchdogs that expire on this tick to the
+ *   caller's 'expired' list.  The watchdogs remain active while they are
+ *   in that list so that they may still be canceled before they are
+ *   dispatched.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_advance(FAR dq_queue_t *expired)
+{
+  FAR dq_queue_t *slot;
+  FAR wdog_t *wdog;
+  int index;
+  int level;
+
+  index = WDOG_WHEEL_INDEX(g_wdtick, 0);
+
+  /* Cascade each level whose lower level has just wrapped around */
+
+  if (index == 0 && g_wdnactive > 0)
+    {
+      for (level = 1;
+           level < WDOG_WHEEL_NLEVELS && wd_wheel_cascade(level) == 0;
+           level++);
+    }
+
+  g_wdtick++;
+
+  /* Hand the expired watchdogs over to the caller */
+
+  slot = &g_wdwheel[0][index];
+  expired->head = slot->head;
+  expired->tail = slot->tail;
+  dq_init(slot);
+
+  for (wdog = (FAR wdog_t*)expired->head; wdog; wdog = wdog->next)
+    {
+      wdog->slot = expired;
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Find the first wheel tick that requires processing:  Either the tick
+ *   on which the earliest watchdog expires or an earlier tick on which
+ *   that watchdog is cascaded to a lower level.  All ticks before the
+ *   returned one may be skipped without calling wd_wheel_advance().  The
+ *   search examines at most WDOG_WHEEL_NSLOTS slots per level.
+ *
+ * Return Value:
+ *   false if the wheel is empty; true with the tick in 'tick' otherwise.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_next(FAR uint32_t *tick)
+{
+  uint32_t candidate;
+  uint32_t best = 0;
+  bool found = false;
+  int level;
+  int start;
+  int cur;
+  int d;
+
+  if (g_wdnactive == 0)
+    {
+      return false;
+    }
+
+  for (level = 0; level < WDOG_WHEEL_NLEVELS; level++)
+    {
+      int shift = WDOG_WHEEL_SHIFT(level);
+
+      /* The current slot of a higher level is cascaded on the next tick
+       * only if that tick is on a boundary of the level.  Otherwise, the
+       * slot has already been cascaded and whatever it holds now is not
+       * due until the level wraps around:  Search it last.
+       */
+
+      start = 0;
+      if (level > 0 && (g_wdtick & (((uint32_t)1 << shift) - 1)) != 0)
+        {
+          start = 1;
+        }
+
+      cur = WDOG_WHEEL_INDEX(g_wdtick, level);
+      for (d = start; d < start + WDOG_WHEEL_NSLOTS; d++)
+        {
+          if (g_wdwheel[level][(cur + d) & WDOG_WHEEL_MASK].head)
+            {
+              break;
+            }
+        }
+
+      if (d >= start + WDOG_WHEEL_NSLOTS)
+        {
+          continue;
+        }
+
+      if (level == 0)
+        {
+          candidate = g_wdtick + d;
+        }
+      else
+        {
+          candidate = ((g_wdtick >> shift) + d) << shift;
+        }
+
+      if (!found || (int32_t)(candidate - best) < 0)
+        {
+          best  = candidate;
+          found = true;
+        }
+    }
+
+  *tick = best;
+  return found;
+}
+
+#endif /* CONFIG_WDOG_TIMERWHEEL */
@@ -155,6 +155,12 @@ SYSCALL_LOOKUP(up_assert,                 2, STUB_up_assert)
 #  ifndef CONFIG_DISABLE_POLL
   SYSCALL_LOOKUP(poll,                    3, STUB_poll)
   SYSCALL_LOOKUP(select,                  5, STUB_select)
+#    if CONFIG_NFILE_DESCRIPTORS > 0
+  SYSCALL_LOOKUP(epoll_close,             1, STUB_epoll_close)
+  SYSCALL_LOOKUP(epoll_create,            1, STUB_epoll_create)
+  SYSCALL_LOOKUP(epoll_ctl,               4, STUB_epoll_ctl)
+  SYSCALL_LOOKUP(epoll_wait,              4, STUB_epoll_wait)
+#    endif
 #  endif
 #endif
 
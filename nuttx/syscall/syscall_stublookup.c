@@ -159,6 +159,12 @@ uintptr_t STUB_timer_settime(int nbr, uintptr_t parm1, uintptr_t parm2,
  */
 
 uintptr_t STUB_close(int nbr, uintptr_t parm1);
+uintptr_t STUB_epoll_close(int nbr, uintptr_t parm1);
+uintptr_t STUB_epoll_create(int nbr, uintptr_t parm1);
+uintptr_t STUB_epoll_ctl(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3, uintptr_t parm4);
+uintptr_t STUB_epoll_wait(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3, uintptr_t parm4);
 uintptr_t STUB_ioctl(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3);
 uintptr_t STUB_poll(int nbr, uintptr_t parm1, uintptr_t parm2,